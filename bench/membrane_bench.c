@@ -0,0 +1,686 @@
+// Banc d'essai: balayage de N, k, nombre de threads, solveurs et formats de stockage
+// sur les chemins critiques (assemblage, SpMV, résolution propre)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <omp.h>
+#include "membrane.h"
+#include "mesh.h"
+#include "matrix_builder.h"
+#include "solver.h"
+#include "lobpcg.h"
+#include "profiler.h"
+#include "visualization.h"
+
+#define BENCH_MAX_LIST 16
+#define BENCH_MAX_RESULTS 1024
+#define BENCH_SPMV_VECTORS 8
+#define BENCH_SPMV_TARGET_FLOPS 2e7     // Répétitions de SpMV par mesure
+
+typedef struct {
+    int sizes[BENCH_MAX_LIST];
+    int n_sizes;
+    int modes[BENCH_MAX_LIST];
+    int n_modes;
+    int threads[BENCH_MAX_LIST];
+    int n_threads;
+    SolverType solvers[SOLVER_N_TYPES];
+    int n_solvers;
+    int trials;
+    int warmup;
+    int dense_max_dof;          // Au-delà, le solveur dense est ignoré (coût n³)
+    const char* out_dir;
+    const char* label;
+    const char* baseline;       // CSV d'une exécution précédente
+    double threshold;           // Ralentissement relatif signalé comme régression
+} BenchOptions;
+
+typedef struct {
+    char kernel[16];            // assembly, spmv, eigensolve
+    char solver[16];            // Nom du solveur ou -
+    char format[8];             // csr (assemblée), csrb (projetée), stencil (sans matrice) ou -
+    char scaling[8];            // strong ou weak
+    int N;
+    int dof;
+    int k;
+    int threads;
+    int trials;
+    double median;
+    double min;
+    double max;
+    double q1;
+    double q3;
+    double peak_rss_mb;
+    double dof_per_s;
+    double modes_per_s;
+    double gflops;
+    double efficiency;          // Efficacité de scalabilité forte ou faible
+} BenchResult;
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static int n_results = 0;
+
+// ============ MESURES ============
+
+// Sorties des solveurs masquées pendant les mesures
+static int saved_stdout = -1;
+
+static void quiet_begin(void) {
+    fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+}
+
+static void quiet_end(void) {
+    fflush(stdout);
+    if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        saved_stdout = -1;
+    }
+}
+
+// Pic de RSS remis à zéro avant chaque mesure (Linux >= 4.0), en Mo
+static void reset_peak_rss(void) {
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file) {
+        fputs("5", file);
+        fclose(file);
+    }
+}
+
+static double read_peak_rss_mb(void) {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (!file) return 0.0;
+    char line[256];
+    double kb = 0.0;
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kb = atof(line + 6);
+            break;
+        }
+    }
+    fclose(file);
+    return kb / 1024.0;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Quantile par interpolation linéaire sur un échantillon trié
+static double quantile(const double* sorted, int n, double q) {
+    double position = q * (n - 1);
+    int lo = (int)floor(position);
+    int hi = lo + 1 < n ? lo + 1 : lo;
+    return sorted[lo] + (position - lo) * (sorted[hi] - sorted[lo]);
+}
+
+typedef int (*KernelFn)(void* arg);
+
+// Exécutions d'échauffement puis mesurées; remplit les statistiques de temps et de mémoire
+static int measure(KernelFn kernel, void* arg, const BenchOptions* opts, BenchResult* result) {
+    double* samples = (double*)malloc(opts->trials * sizeof(double));
+    if (!samples) return -1;
+
+    int status = 0;
+    double peak = 0.0;
+    quiet_begin();
+    for (int w = 0; w < opts->warmup && status == 0; w++) {
+        status = kernel(arg);
+    }
+    for (int t = 0; t < opts->trials && status == 0; t++) {
+        reset_peak_rss();
+        double start = profiler_now();
+        status = kernel(arg);
+        samples[t] = profiler_now() - start;
+        double rss = read_peak_rss_mb();
+        if (rss > peak) peak = rss;
+    }
+    quiet_end();
+
+    if (status == 0) {
+        qsort(samples, opts->trials, sizeof(double), compare_double);
+        result->trials = opts->trials;
+        result->median = quantile(samples, opts->trials, 0.5);
+        result->min = samples[0];
+        result->max = samples[opts->trials - 1];
+        result->q1 = quantile(samples, opts->trials, 0.25);
+        result->q3 = quantile(samples, opts->trials, 0.75);
+        result->peak_rss_mb = peak;
+    }
+    free(samples);
+    return status;
+}
+
+// ============ NOYAUX ============
+
+typedef struct {
+    Mesh* mesh;
+} AssemblyArgs;
+
+static int assembly_kernel(void* arg) {
+    AssemblyArgs* a = (AssemblyArgs*)arg;
+    SparseMatrixCSR* A = build_stiffness_matrix(a->mesh);
+    SparseMatrixCSR* B = build_mass_matrix(a->mesh);
+    int status = (A && B) ? 0 : -1;
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    return status;
+}
+
+typedef struct {
+    LinearOperator op;
+    double* X;
+    double* Y;
+    int repetitions;
+} SpmvArgs;
+
+static int spmv_kernel(void* arg) {
+    SpmvArgs* a = (SpmvArgs*)arg;
+    for (int r = 0; r < a->repetitions; r++) {
+        a->op.apply(a->op.data, BENCH_SPMV_VECTORS, a->X, a->Y);
+    }
+    return 0;
+}
+
+typedef struct {
+    SparseMatrixCSR* A;
+    SparseMatrixCSR* B;
+    const Mesh* mesh;
+    SolverType solver;
+    int k;
+} EigenArgs;
+
+static int eigen_kernel(void* arg) {
+    EigenArgs* a = (EigenArgs*)arg;
+    SolverConfig* config = create_solver_config(a->k);
+    if (!config) return -1;
+    config->solver = a->solver;
+    config->mesh = a->mesh;
+    config->mkl_threads = omp_get_max_threads();
+    EigenResults* res = solve_eigenproblem(a->A, a->B, config);
+    int status = (res && res->n_eigenvalues == a->k) ? 0 : -1;
+    free_eigen_results(res);
+    free_solver_config(config);
+    return status;
+}
+
+// ============ BALAYAGE ============
+
+static void set_threads(int threads) {
+    omp_set_num_threads(threads);
+    mkl_set_num_threads(threads);
+}
+
+static BenchResult* new_result(const char* kernel, const char* solver, const char* format,
+                               const char* scaling, int N, int k, int threads) {
+    if (n_results >= BENCH_MAX_RESULTS) return NULL;
+    BenchResult* r = &results[n_results];
+    memset(r, 0, sizeof(BenchResult));
+    snprintf(r->kernel, sizeof(r->kernel), "%s", kernel);
+    snprintf(r->solver, sizeof(r->solver), "%s", solver);
+    snprintf(r->format, sizeof(r->format), "%s", format);
+    snprintf(r->scaling, sizeof(r->scaling), "%s", scaling);
+    r->N = N;
+    r->dof = N * N;
+    r->k = k;
+    r->threads = threads;
+    return r;
+}
+
+static void print_result(const BenchResult* r) {
+    printf("  %-10s %-13s %-7s %-6s N=%-4d k=%-3d t=%-2d median %9.3e s  [%9.3e, %9.3e]  %7.1f MB",
+           r->kernel, r->solver, r->format, r->scaling, r->N, r->k, r->threads,
+           r->median, r->min, r->max, r->peak_rss_mb);
+    if (r->gflops > 0.0) printf("  %6.2f GFLOP/s", r->gflops);
+    if (r->modes_per_s > 0.0) printf("  %8.2f modes/s", r->modes_per_s);
+    if (r->gflops == 0.0 && r->modes_per_s == 0.0) printf("  %9.3e DOF/s", r->dof_per_s);
+    printf("\n");
+    fflush(stdout);
+}
+
+// Formats de stockage: CSR assemblée en mémoire, puis fichier .csrb projeté (mmap)
+static int load_format(const char* format, SparseMatrixCSR* A, SparseMatrixCSR* B,
+                       const BenchOptions* opts, SparseMatrixCSR** A_out,
+                       SparseMatrixCSR** B_out) {
+    if (strcmp(format, "csr") == 0) {
+        *A_out = A;
+        *B_out = B;
+        return 0;
+    }
+
+    char path_A[512], path_B[512];
+    snprintf(path_A, sizeof(path_A), "%s/.bench_A.csrb", opts->out_dir);
+    snprintf(path_B, sizeof(path_B), "%s/.bench_B.csrb", opts->out_dir);
+    quiet_begin();
+    int status = save_matrix_csr_binary(A, path_A) | save_matrix_csr_binary(B, path_B);
+    quiet_end();
+    if (status != 0) return -1;
+
+    *A_out = load_matrix_csr_binary(path_A);
+    *B_out = load_matrix_csr_binary(path_B);
+    unlink(path_A);             // La projection reste valide après unlink
+    unlink(path_B);
+    if (!*A_out || !*B_out) {
+        free_sparse_matrix(*A_out);
+        free_sparse_matrix(*B_out);
+        return -1;
+    }
+    return 0;
+}
+
+// flops_per_vector: 2 nnz pour la CSR, 9 n pour le stencil
+static void bench_spmv(LinearOperator op, double flops_per_vector, const char* format,
+                       const char* scaling, int N, int threads, const BenchOptions* opts) {
+    size_t n = (size_t)op.n;
+    SpmvArgs args;
+    args.op = op;
+    args.X = (double*)malloc(n * BENCH_SPMV_VECTORS * sizeof(double));
+    args.Y = (double*)malloc(n * BENCH_SPMV_VECTORS * sizeof(double));
+    double flops = flops_per_vector * BENCH_SPMV_VECTORS;
+    args.repetitions = (int)ceil(BENCH_SPMV_TARGET_FLOPS / flops);
+
+    BenchResult* r = new_result("spmv", "-", format, scaling, N, BENCH_SPMV_VECTORS, threads);
+    if (r && args.X && args.Y) {
+        for (size_t i = 0; i < n * BENCH_SPMV_VECTORS; i++) args.X[i] = 1.0 / (1.0 + i % 97);
+        if (measure(spmv_kernel, &args, opts, r) == 0) {
+            r->dof_per_s = n * BENCH_SPMV_VECTORS * args.repetitions / r->median;
+            r->gflops = flops * args.repetitions / r->median * 1e-9;
+            n_results++;
+            print_result(r);
+        }
+    }
+    free(args.X);
+    free(args.Y);
+}
+
+static void bench_eigensolve(SparseMatrixCSR* A, SparseMatrixCSR* B, const Mesh* mesh,
+                             SolverType solver, const char* format, const char* scaling,
+                             int N, int k, int threads, const BenchOptions* opts) {
+    int n = mesh->total_points;
+    int dense = solver == SOLVER_DENSE || solver == SOLVER_DENSE_PARTIAL;
+    int iterative = solver == SOLVER_LOBPCG || solver == SOLVER_MATRIX_FREE;
+    if (k > n) return;
+    if (dense && n > opts->dense_max_dof) return;
+    if (iterative && 3 * lobpcg_block_size(k) > n) return;
+
+    EigenArgs args = {A, B, mesh, solver, k};
+    BenchResult* r = new_result("eigensolve", solver_type_name(solver), format, scaling,
+                                N, k, threads);
+    if (!r) return;
+    if (measure(eigen_kernel, &args, opts, r) != 0) {
+        fprintf(stderr, "Warning: %s solve failed for N = %d, k = %d\n",
+                solver_type_name(solver), N, k);
+        return;
+    }
+    r->dof_per_s = n / r->median;
+    r->modes_per_s = k / r->median;
+    n_results++;
+    print_result(r);
+}
+
+// Assemblage, SpMV et résolutions pour une taille de grille et un nombre de threads
+static void bench_grid(int N, int threads, const char* scaling, const BenchOptions* opts,
+                       int first_k_only) {
+    set_threads(threads);
+
+    MembraneParams* params = create_default_params();
+    Mesh* mesh = params ? create_mesh(N, params) : NULL;
+    if (!mesh) {
+        fprintf(stderr, "Error: Failed to create mesh for N = %d\n", N);
+        free_membrane_params(params);
+        return;
+    }
+
+    AssemblyArgs assembly = {mesh};
+    BenchResult* r = new_result("assembly", "-", "-", scaling, N, 0, threads);
+    if (r && measure(assembly_kernel, &assembly, opts, r) == 0) {
+        r->dof_per_s = r->dof / r->median;
+        n_results++;
+        print_result(r);
+    }
+
+    SparseMatrixCSR* A = build_stiffness_matrix(mesh);
+    SparseMatrixCSR* B = build_mass_matrix(mesh);
+    const char* formats[2] = {"csr", "csrb"};
+    int n_k = first_k_only ? 1 : opts->n_modes;
+
+    // Sans matrice: stencil appliqué sur le maillage
+    bench_spmv(stencil_operator(mesh), 9.0 * mesh->total_points, "stencil", scaling, N, threads,
+               opts);
+    for (int s = 0; s < opts->n_solvers; s++) {
+        if (opts->solvers[s] != SOLVER_MATRIX_FREE) continue;
+        for (int m = 0; m < n_k; m++) {
+            bench_eigensolve(NULL, NULL, mesh, SOLVER_MATRIX_FREE, "stencil", scaling, N,
+                             opts->modes[m], threads, opts);
+        }
+    }
+
+    for (int f = 0; f < 2 && A && B; f++) {
+        SparseMatrixCSR* A_f = NULL;
+        SparseMatrixCSR* B_f = NULL;
+        if (load_format(formats[f], A, B, opts, &A_f, &B_f) != 0) {
+            fprintf(stderr, "Warning: Storage format %s unavailable\n", formats[f]);
+            continue;
+        }
+
+        bench_spmv(csr_operator(A_f), 2.0 * A_f->nnz, formats[f], scaling, N, threads, opts);
+        for (int s = 0; s < opts->n_solvers; s++) {
+            // Seul LOBPCG relit la matrice à chaque itération: un format suffit aux autres
+            SolverType solver = opts->solvers[s];
+            if (solver == SOLVER_MATRIX_FREE || (solver != SOLVER_LOBPCG && f > 0)) continue;
+            for (int m = 0; m < n_k; m++) {
+                bench_eigensolve(A_f, B_f, mesh, solver, formats[f], scaling, N,
+                                 opts->modes[m], threads, opts);
+            }
+        }
+
+        if (A_f != A) {
+            free_sparse_matrix(A_f);
+            free_sparse_matrix(B_f);
+        }
+    }
+
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    free_mesh(mesh);
+    free_membrane_params(params);
+}
+
+// Efficacités par rapport à la configuration de même noyau au plus petit nombre de threads:
+// forte T(t0)·t0 / (T(t)·t) à N fixé, faible T(t0, N0) / T(t, N0·sqrt(t/t0))
+static int same_series(const BenchResult* a, const BenchResult* b) {
+    if (strcmp(a->kernel, b->kernel) || strcmp(a->solver, b->solver) ||
+        strcmp(a->format, b->format) || strcmp(a->scaling, b->scaling) || a->k != b->k) {
+        return 0;
+    }
+    return strcmp(a->scaling, "weak") == 0 || a->N == b->N;
+}
+
+static void compute_efficiencies(void) {
+    for (int i = 0; i < n_results; i++) {
+        BenchResult* r = &results[i];
+        const BenchResult* ref = NULL;
+        for (int j = 0; j < n_results; j++) {
+            if (same_series(&results[j], r) && (!ref || results[j].threads < ref->threads)) {
+                ref = &results[j];
+            }
+        }
+        if (!ref || r->median <= 0.0) continue;
+        if (strcmp(r->scaling, "strong") == 0) {
+            r->efficiency = ref->median * ref->threads / (r->median * r->threads);
+        } else {
+            r->efficiency = ref->median / r->median;
+        }
+    }
+}
+
+// ============ SORTIES ============
+
+static const char* csv_header =
+    "kernel,solver,format,scaling,N,dof,k,threads,trials,median_s,min_s,max_s,q1_s,q3_s,"
+    "peak_rss_mb,dof_per_s,modes_per_s,gflops,efficiency\n";
+
+static int write_csv(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        return -1;
+    }
+    fputs(csv_header, file);
+    for (int i = 0; i < n_results; i++) {
+        const BenchResult* r = &results[i];
+        fprintf(file, "%s,%s,%s,%s,%d,%d,%d,%d,%d,%.6e,%.6e,%.6e,%.6e,%.6e,%.2f,%.6e,%.6e,%.4f,%.4f\n",
+                r->kernel, r->solver, r->format, r->scaling, r->N, r->dof, r->k, r->threads,
+                r->trials, r->median, r->min, r->max, r->q1, r->q3, r->peak_rss_mb,
+                r->dof_per_s, r->modes_per_s, r->gflops, r->efficiency);
+    }
+    fclose(file);
+    printf("Saved %s\n", filename);
+    return 0;
+}
+
+static int write_json(const char* filename, const BenchOptions* opts) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        return -1;
+    }
+    fprintf(file, "{\n  \"label\": \"%s\",\n  \"timestamp\": %ld,\n", opts->label, (long)time(NULL));
+    fprintf(file, "  \"processors\": %d,\n  \"trials\": %d,\n  \"warmup\": %d,\n",
+            omp_get_num_procs(), opts->trials, opts->warmup);
+    fprintf(file, "  \"results\": [");
+    for (int i = 0; i < n_results; i++) {
+        const BenchResult* r = &results[i];
+        fprintf(file, "%s\n    {\"kernel\": \"%s\", \"solver\": \"%s\", \"format\": \"%s\", "
+                "\"scaling\": \"%s\", \"N\": %d, \"dof\": %d, \"k\": %d, \"threads\": %d, "
+                "\"trials\": %d, \"median_s\": %.6e, \"min_s\": %.6e, \"max_s\": %.6e, "
+                "\"q1_s\": %.6e, \"q3_s\": %.6e, \"peak_rss_mb\": %.2f, \"dof_per_s\": %.6e, "
+                "\"modes_per_s\": %.6e, \"gflops\": %.4f, \"efficiency\": %.4f}",
+                i ? "," : "", r->kernel, r->solver, r->format, r->scaling, r->N, r->dof, r->k,
+                r->threads, r->trials, r->median, r->min, r->max, r->q1, r->q3,
+                r->peak_rss_mb, r->dof_per_s, r->modes_per_s, r->gflops, r->efficiency);
+    }
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+    printf("Saved %s\n", filename);
+    return 0;
+}
+
+// Comparaison des médianes avec une exécution de référence; renvoie le nombre de régressions
+static int compare_baseline(const BenchOptions* opts) {
+    FILE* file = fopen(opts->baseline, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open baseline %s\n", opts->baseline);
+        return -1;
+    }
+
+    printf("\n=== COMPARISON WITH %s (threshold %.0f%%) ===\n", opts->baseline,
+           100.0 * opts->threshold);
+    char line[1024];
+    int n_regressions = 0, n_matched = 0;
+    if (!fgets(line, sizeof(line), file)) line[0] = '\0';     // En-tête
+    while (fgets(line, sizeof(line), file)) {
+        BenchResult base;
+        memset(&base, 0, sizeof(base));
+        if (sscanf(line, "%15[^,],%15[^,],%7[^,],%7[^,],%d,%d,%d,%d,%d,%lf",
+                   base.kernel, base.solver, base.format, base.scaling, &base.N, &base.dof,
+                   &base.k, &base.threads, &base.trials, &base.median) != 10) continue;
+
+        for (int i = 0; i < n_results; i++) {
+            const BenchResult* r = &results[i];
+            if (strcmp(r->kernel, base.kernel) || strcmp(r->solver, base.solver) ||
+                strcmp(r->format, base.format) || strcmp(r->scaling, base.scaling) ||
+                r->N != base.N || r->k != base.k || r->threads != base.threads) continue;
+
+            double ratio = r->median / base.median;
+            int regression = ratio > 1.0 + opts->threshold;
+            n_matched++;
+            n_regressions += regression;
+            printf("  %-10s %-13s %-7s %-6s N=%-4d k=%-3d t=%-2d %9.3e s -> %9.3e s  x%.2f%s\n",
+                   r->kernel, r->solver, r->format, r->scaling, r->N, r->k, r->threads,
+                   base.median, r->median, ratio, regression ? "  REGRESSION" : "");
+        }
+    }
+    fclose(file);
+    printf("%d configurations compared, %d regressions\n", n_matched, n_regressions);
+    return n_regressions;
+}
+
+// ============ LIGNE DE COMMANDE ============
+
+static int parse_int_list(const char* text, int* values, int max_values) {
+    int count = 0;
+    const char* p = text;
+    while (*p && count < max_values) {
+        char* end;
+        long value = strtol(p, &end, 10);
+        if (end == p || value <= 0) return -1;
+        values[count++] = (int)value;
+        p = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return -1;
+    }
+    return count;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --sizes LIST       Grid sizes N (default 20,30,40)\n");
+    printf("  --modes LIST       Numbers of modes k (default 5,10)\n");
+    printf("  --threads LIST     Thread counts (default 1,2,4, capped to the processors)\n");
+    printf("  --solvers LIST     dense,dense-partial,banded,lobpcg,matrix-free (default all)\n");
+    printf("  --trials T         Timed repetitions per configuration (default 5)\n");
+    printf("  --warmup W         Untimed repetitions first (default 1)\n");
+    printf("  --dense-max-dof D  Skip the dense solver above D unknowns (default 2500)\n");
+    printf("  --out DIR          Output directory (default bench/results)\n");
+    printf("  --label NAME       Run label, e.g. a commit hash (default: timestamp)\n");
+    printf("  --baseline FILE    Compare medians with a previous CSV, exit 1 on regression\n");
+    printf("  --threshold R      Relative slowdown reported as a regression (default 0.10)\n");
+}
+
+static int parse_options(int argc, char* argv[], BenchOptions* opts) {
+    for (int a = 1; a < argc; a++) {
+        const char* arg = argv[a];
+        if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        }
+        if (a + 1 >= argc) {
+            fprintf(stderr, "Error: Option %s requires a value\n", arg);
+            return -1;
+        }
+        const char* value = argv[++a];
+
+        if (strcmp(arg, "--sizes") == 0) {
+            opts->n_sizes = parse_int_list(value, opts->sizes, BENCH_MAX_LIST);
+            if (opts->n_sizes <= 0) goto invalid;
+        } else if (strcmp(arg, "--modes") == 0) {
+            opts->n_modes = parse_int_list(value, opts->modes, BENCH_MAX_LIST);
+            if (opts->n_modes <= 0) goto invalid;
+        } else if (strcmp(arg, "--threads") == 0) {
+            opts->n_threads = parse_int_list(value, opts->threads, BENCH_MAX_LIST);
+            if (opts->n_threads <= 0) goto invalid;
+        } else if (strcmp(arg, "--solvers") == 0) {
+            char names[64];
+            snprintf(names, sizeof(names), "%s", value);
+            opts->n_solvers = 0;
+            for (char* name = strtok(names, ","); name && opts->n_solvers < SOLVER_N_TYPES;
+                 name = strtok(NULL, ",")) {
+                if (parse_solver_type(name, &opts->solvers[opts->n_solvers]) != 0) return -1;
+                if (opts->solvers[opts->n_solvers] == SOLVER_AUTO) {
+                    fprintf(stderr, "Error: The benchmark needs explicit solvers, not auto\n");
+                    return -1;
+                }
+                opts->n_solvers++;
+            }
+        } else if (strcmp(arg, "--trials") == 0) {
+            opts->trials = atoi(value);
+            if (opts->trials < 1) goto invalid;
+        } else if (strcmp(arg, "--warmup") == 0) {
+            opts->warmup = atoi(value);
+        } else if (strcmp(arg, "--dense-max-dof") == 0) {
+            opts->dense_max_dof = atoi(value);
+        } else if (strcmp(arg, "--out") == 0) {
+            opts->out_dir = value;
+        } else if (strcmp(arg, "--label") == 0) {
+            opts->label = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            opts->baseline = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            opts->threshold = atof(value);
+        } else {
+            fprintf(stderr, "Error: Unknown option %s\n", arg);
+            return -1;
+        }
+        continue;
+
+    invalid:
+        fprintf(stderr, "Error: Invalid value '%s' for %s\n", value, arg);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.n_sizes = parse_int_list("20,30,40", opts.sizes, BENCH_MAX_LIST);
+    opts.n_modes = parse_int_list("5,10", opts.modes, BENCH_MAX_LIST);
+    opts.n_threads = parse_int_list("1,2,4", opts.threads, BENCH_MAX_LIST);
+    for (int s = 0; s < SOLVER_N_TYPES; s++) opts.solvers[s] = (SolverType)s;
+    opts.n_solvers = SOLVER_N_TYPES;
+    opts.trials = 5;
+    opts.warmup = 1;
+    opts.dense_max_dof = 2500;
+    opts.out_dir = "bench/results";
+    opts.threshold = 0.10;
+    int explicit_threads = 0;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--threads") == 0) explicit_threads = 1;
+    }
+    if (parse_options(argc, argv, &opts) != 0) return 1;
+
+    // Sans liste explicite, pas plus de threads que de processeurs
+    if (!explicit_threads) {
+        int kept = 0;
+        for (int t = 0; t < opts.n_threads; t++) {
+            if (opts.threads[t] <= omp_get_num_procs() || kept == 0) {
+                opts.threads[kept++] = opts.threads[t];
+            }
+        }
+        opts.n_threads = kept;
+    }
+
+    char default_label[32];
+    if (!opts.label) {
+        snprintf(default_label, sizeof(default_label), "%ld", (long)time(NULL));
+        opts.label = default_label;
+    }
+
+    if (ensure_directory(opts.out_dir) != 0) return 1;
+
+    printf("=== MEMBRANE BENCHMARK (%s) ===\n", opts.label);
+    printf("Processors: %d, trials: %d, warmup: %d\n\n", omp_get_num_procs(), opts.trials,
+           opts.warmup);
+
+    // Scalabilité forte: chaque taille à chaque nombre de threads
+    printf("Strong scaling sweep\n");
+    for (int s = 0; s < opts.n_sizes; s++) {
+        for (int t = 0; t < opts.n_threads; t++) {
+            bench_grid(opts.sizes[s], opts.threads[t], "strong", &opts, 0);
+        }
+    }
+
+    // Scalabilité faible: DOF par thread constants à partir de la plus petite taille
+    if (opts.n_threads > 1) {
+        printf("\nWeak scaling sweep\n");
+        for (int t = 0; t < opts.n_threads; t++) {
+            int N = (int)lround(opts.sizes[0] * sqrt((double)opts.threads[t] / opts.threads[0]));
+            bench_grid(N, opts.threads[t], "weak", &opts, 1);
+        }
+    }
+
+    compute_efficiencies();
+
+    char filename[600];
+    snprintf(filename, sizeof(filename), "%s/bench_%s.csv", opts.out_dir, opts.label);
+    write_csv(filename);
+    snprintf(filename, sizeof(filename), "%s/bench_%s.json", opts.out_dir, opts.label);
+    write_json(filename, &opts);
+
+    if (opts.baseline) {
+        int n_regressions = compare_baseline(&opts);
+        if (n_regressions != 0) return 1;
+    }
+    return 0;
+}
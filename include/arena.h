@@ -0,0 +1,42 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Arène de blocs alignés, libérés tous ensemble par arena_reset. La mémoire reste acquise
+// d'un appel à l'autre: après le premier appel, ni malloc ni défaut de page
+#define ARENA_ALIGNMENT 64
+
+typedef struct Arena Arena;
+
+// Niveau de l'arène relevé par arena_mark
+typedef struct {
+    void* segment;
+    size_t used;            // Octets utilisés dans ce segment
+    size_t total;           // Octets alloués depuis le dernier arena_reset
+} ArenaMark;
+
+// initial_bytes: premier segment, prérempli (0: créé à la première allocation)
+Arena* arena_create(size_t initial_bytes);
+void arena_destroy(Arena* arena);
+
+// Bloc aligné sur ARENA_ALIGNMENT; arena NULL: tas (mkl_malloc), rendu par arena_free
+void* arena_alloc(Arena* arena, size_t bytes);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+
+// Sans effet dans une arène: la mémoire est rendue par arena_reset
+void arena_free(Arena* arena, void* ptr);
+
+// Rend toutes les allocations. Si le dernier appel a débordé sur plusieurs segments, ils sont
+// fusionnés en un seul, à la taille du pic
+void arena_reset(Arena* arena);
+
+// Rend les allocations faites depuis mark, les précédentes restent valides
+ArenaMark arena_mark(const Arena* arena);
+void arena_rewind(Arena* arena, ArenaMark mark);
+
+size_t arena_capacity(const Arena* arena);     // Octets réservés
+size_t arena_peak(const Arena* arena);         // Plus haut niveau d'utilisation
+long arena_segment_count(const Arena* arena);  // Segments alloués depuis la création
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+#include <stddef.h>
+
+// Tâche d'écriture: write(payload) sur un thread d'E/S, puis release(payload)
+typedef void (*AsyncWriteFn)(void* payload);
+typedef void (*AsyncReleaseFn)(void* payload);
+
+typedef struct AsyncWriter AsyncWriter;
+
+// n_threads = 0: exécution synchrone dans le thread appelant
+// max_pending_bytes: budget mémoire des tâches en attente (back-pressure)
+AsyncWriter* async_writer_create(int n_threads, size_t max_pending_bytes);
+
+// Soumet une tâche qui prend possession de payload (libéré par release, qui peut être NULL).
+// Bloque tant que le budget est dépassé.
+int async_writer_submit(AsyncWriter* writer, AsyncWriteFn write,
+                        AsyncReleaseFn release, void* payload, size_t bytes);
+
+// Attend la fin de toutes les tâches soumises
+void async_writer_barrier(AsyncWriter* writer);
+
+// Barrière puis arrêt des threads
+void async_writer_destroy(AsyncWriter* writer);
+
+// Statistiques: temps cumulé passé à écrire et à attendre (back-pressure)
+double async_writer_busy_time(AsyncWriter* writer);
+double async_writer_stall_time(AsyncWriter* writer);
+
+// Nombre de tâches en file ou en cours d'écriture
+int async_writer_pending(AsyncWriter* writer);
+
+#endif
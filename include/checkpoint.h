@@ -0,0 +1,58 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stddef.h>
+#include "async_io.h"
+
+// Etat d'un solveur itératif (LOBPCG) à une itération donnée
+// Tous les blocs sont colonne-major avec n lignes
+typedef struct {
+    int n;                      // Degrés de liberté
+    int n_requested;            // Nombre de modes demandés
+    int block_size;             // Colonnes actives de X (non verrouillées)
+    int n_locked;               // Paires propres convergées et verrouillées
+    int has_directions;         // P présent
+    int iteration;
+    double eps;
+    
+    double* ritz_values;        // block_size (décalages de la prochaine itération)
+    double* locked_values;      // n_locked
+    double* locked_residuals;   // n_locked
+    double* X;                  // n x block_size, sous-espace courant
+    double* P;                  // n x block_size, directions de recherche (ou NULL)
+    double* locked;             // n x n_locked, vecteurs verrouillés
+    
+    double* data;               // Bloc unique contenant tous les tableaux
+    size_t data_bytes;
+} SolverCheckpoint;
+
+// Allocation d'un état vide (un seul bloc mémoire)
+SolverCheckpoint* checkpoint_create(int n, int n_requested, int block_size,
+                                    int n_locked, int has_directions);
+void free_checkpoint(SolverCheckpoint* checkpoint);
+
+// Format binaire .ckpt: en-tête de 64 octets (magic, tailles, CRC-32) puis données brutes.
+// L'écriture passe par un fichier temporaire renommé: un arrêt brutal laisse l'ancien état.
+int checkpoint_save(const SolverCheckpoint* checkpoint, const char* filename);
+SolverCheckpoint* checkpoint_load(const char* filename);
+
+// Ecriture en arrière-plan: le solveur copie son état puis continue ses itérations
+typedef struct {
+    const char* filename;
+    AsyncWriter* writer;
+    int n_written;
+    int n_skipped;              // Ecriture précédente pas encore terminée
+    double snapshot_time;       // Temps de copie pris sur le solveur
+    size_t bytes_written;
+} CheckpointWriter;
+
+CheckpointWriter* checkpoint_writer_create(const char* filename);
+
+// Prend possession de checkpoint; renvoie 0 si l'écriture est lancée,
+// 1 si elle est sautée parce que la précédente est encore en cours
+int checkpoint_writer_submit(CheckpointWriter* writer, SolverCheckpoint* checkpoint);
+
+// Attend la dernière écriture, affiche le coût et libère
+void checkpoint_writer_destroy(CheckpointWriter* writer);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <stddef.h>
+
+// Taille d'un bloc de points évalué par instruction
+#define EXPR_BLOCK_SIZE 256
+
+// Expression compilée en bytecode à registres (opaque)
+typedef struct CoeffExpr CoeffExpr;
+
+// Compilation / libération
+// Grammaire: nombres, x, y, pi, e, + - * / ^, parenthèses,
+// sin cos tan exp log sqrt abs tanh sinh cosh atan, atan2 pow min max
+CoeffExpr* coeff_expr_compile(const char* source, char* error, size_t error_size);
+void free_coeff_expr(CoeffExpr* expr);
+
+// Evaluation sur la grille tensorielle: out[i*N + j] = f(x[i], y[j]). -1 si l'allocation
+// des registres échoue (out incomplet)
+int coeff_expr_eval_grid(const CoeffExpr* expr, const double* x,
+                          const double* y, int N, double* out);
+
+// Evaluation sur une liste de points (x[k], y[k]), même convention
+int coeff_expr_eval_points(const CoeffExpr* expr, const double* x,
+                            const double* y, int n_points, double* out);
+
+// Informations
+const char* coeff_expr_source(const CoeffExpr* expr);
+int coeff_expr_n_instructions(const CoeffExpr* expr);
+
+#endif
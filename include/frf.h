@@ -0,0 +1,40 @@
+#ifndef FRF_H
+#define FRF_H
+
+#include "lobpcg.h"
+
+// Fonctions de réponse en fréquence (réceptance: déplacement au capteur s par unité de force
+// ponctuelle à l'actionneur a) par somme modale:
+// H_sa(ω) = Σ_i φ_i(s) φ_i(a) / (m_i d_i(ω)) + R_sa
+// avec d_i = ω_i² - ω² + 2iζω_iω (visqueux) ou ω_i²(1 + 2iζ) - ω² (hystérétique),
+// et R_sa = A⁻¹_sa - Σ_i φ_i(s) φ_i(a) / (m_i ω_i²): flexibilité résiduelle des modes tronqués
+typedef enum {
+    FRF_VISCOUS,        // Amortissement visqueux modal ζ
+    FRF_HYSTERETIC      // Facteur de perte η = 2ζ sur la rigidité (A (1 + iη))
+} FrfDamping;
+
+typedef struct {
+    const int* sensors;          // Indices des points de mesure
+    int n_sensors;
+    const int* actuators;        // Indices des points d'excitation
+    int n_actuators;
+    const double* omegas;        // Pulsations (rad/s)
+    int n_frequencies;
+    double damping;              // ζ
+    FrfDamping model;
+    double point_load;           // Charge nodale d'une force unité (1/h² sur la grille)
+    const SparseMatrixCSR* A;    // Non NULL: correction de flexibilité résiduelle (Cholesky bande)
+    size_t memory_budget;        // Borne du facteur bande, gradient conjugué au-delà (0: défaut)
+} FrfProblem;
+
+// H: n_sensors x n_actuators x n_frequencies complexes (re, im entrelacés, ordre C):
+// chaque FRF est contiguë en fréquence. B: masse (NULL: identité). -1 si invalide
+int frf_modal(const EigenResults* modes, const LinearOperator* B, const FrfProblem* problem,
+              double* H);
+
+// Référence par résolution directe (A (1 + iη) - ω² B) x = e_a à une pulsation (LU bande
+// complexe), amortissement hystérétique seulement. H: n_sensors x n_actuators complexes
+int frf_direct(const SparseMatrixCSR* A, const SparseMatrixCSR* B, const FrfProblem* problem,
+               double omega, double* H);
+
+#endif
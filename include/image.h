@@ -0,0 +1,64 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Image RGB 8 bits, lignes de haut en bas
+typedef struct {
+    int width;
+    int height;
+    uint8_t* pixels;            // width * height * 3
+} Image;
+
+typedef struct {
+    uint8_t r, g, b;
+} Color;
+
+// Cartes de couleurs
+typedef enum {
+    COLORMAP_RDBU,              // Divergente (modes: négatif bleu, positif rouge)
+    COLORMAP_VIRIDIS,           // Séquentielle
+    COLORMAP_GRAYS              // Blanc -> noir
+} Colormap;
+
+#define COLOR_WHITE ((Color){255, 255, 255})
+#define COLOR_BLACK ((Color){0, 0, 0})
+
+// Police bitmap 5x7 (majuscules, chiffres, ponctuation courante)
+#define FONT_WIDTH 6
+#define FONT_HEIGHT 8
+
+// Création / libération
+Image* image_create(int width, int height, Color background);
+void free_image(Image* image);
+
+// Dessin (coordonnées hors image ignorées)
+void image_set_pixel(Image* image, int x, int y, Color color);
+void image_fill_rect(Image* image, int x, int y, int width, int height, Color color);
+void image_draw_rect(Image* image, int x, int y, int width, int height, Color color);
+void image_draw_line(Image* image, int x0, int y0, int x1, int y1, Color color);
+void image_draw_text(Image* image, int x, int y, const char* text, Color color);
+int image_text_width(const char* text);
+
+// Couleur associée à t dans [0, 1]
+Color colormap_color(Colormap colormap, double t);
+
+// Encodage PNG (RGB 8 bits, filtres adaptatifs, deflate)
+int image_write_png(const Image* image, const char* filename);
+
+// GIF animé: images indexées sur une palette globale de 256 couleurs
+typedef struct GifWriter GifWriter;
+
+// delay_cs: durée d'une image en centièmes de seconde
+GifWriter* gif_open(const char* filename, int width, int height, const Color* palette,
+                    int delay_cs);
+
+// Compression LZW d'une image indexée (sans état partagé: parallélisable)
+uint8_t* gif_encode_frame(const uint8_t* indices, int width, int height, size_t* size);
+
+// Ajout d'une image déjà compressée, dans l'ordre d'affichage
+int gif_add_encoded_frame(GifWriter* gif, const uint8_t* data, size_t size);
+int gif_close(GifWriter* gif);
+
+#endif
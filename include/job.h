@@ -0,0 +1,33 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include "membrane.h"
+
+#define JOB_EXPR_MAX 512
+
+// Description d'un calcul (fichier de job ou ligne de commande)
+typedef struct {
+    int N;                             // Points par dimension
+    int n_eigenvalues;                 // Nombre de modes
+    char tension[JOB_EXPR_MAX];        // Expression de p(x,y) ("" = défaut)
+    char density[JOB_EXPR_MAX];        // Expression de w(x,y)
+    char potential[JOB_EXPR_MAX];      // Expression de q(x,y)
+    double obstacle[4];                // Obstacle par défaut: centre x, y, intensité, largeur
+} JobSpec;
+
+// Initialisation avec les valeurs par défaut
+void job_spec_init(JobSpec* job);
+
+// Affectation d'une clé ("N", "modes", "p", "w", "q", "obstacle_x", ...)
+int job_spec_set(JobSpec* job, const char* key, const char* value);
+
+// Lecture d'une ligne "cle = valeur" ('#' pour les commentaires)
+int job_spec_parse_line(JobSpec* job, const char* line);
+
+// Lecture d'un fichier de job complet
+int job_spec_load_file(JobSpec* job, const char* filename);
+
+// Compilation des expressions dans les paramètres de la membrane
+int job_spec_apply(const JobSpec* job, MembraneParams* params);
+
+#endif
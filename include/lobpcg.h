@@ -0,0 +1,43 @@
+#ifndef LOBPCG_H
+#define LOBPCG_H
+
+#include "matrix_builder.h"
+#include "membrane.h"
+#include "solver.h"
+
+// Opérateur linéaire symétrique appliqué à un bloc de vecteurs:
+// Y = Op * X, X et Y colonne-major n x n_vectors
+typedef void (*OperatorApplyFn)(const void* data, int n_vectors, const double* X, double* Y);
+
+typedef struct {
+    int n;
+    OperatorApplyFn apply;
+    const void* data;
+} LinearOperator;
+
+// Opérateur associé à une matrice CSR (stockage complet des lignes)
+LinearOperator csr_operator(const SparseMatrixCSR* mat);
+
+// Opérateur de rigidité appliqué par stencil sur le maillage (A jamais assemblée)
+LinearOperator stencil_operator(const Mesh* mesh);
+
+// Masse diagonale w(x, y) du maillage (B jamais assemblée)
+LinearOperator mass_operator(const Mesh* mesh);
+
+// Taille de bloc utilisée pour k valeurs propres (k + vecteurs de garde);
+// LOBPCG demande au moins 3 fois plus de degrés de liberté
+int lobpcg_block_size(int n_eigenvalues);
+
+// LOBPCG avec verrouillage des paires convergées (plus petites valeurs propres)
+// inv_diagonal: préconditionneur de Jacobi (NULL = identité)
+// Checkpoints périodiques si config->checkpoint_file, reprise si config->restart
+EigenResults* solve_lobpcg_operator(const LinearOperator* A, const LinearOperator* B,
+                                    const double* inv_diagonal, SolverConfig* config);
+
+// Version CSR: Jacobi sur la diagonale de A
+EigenResults* solve_lobpcg(SparseMatrixCSR* A, SparseMatrixCSR* B, SolverConfig* config);
+
+// Version sans matrice: stencil pour A, w(x, y) pour B, Jacobi sur la diagonale du stencil
+EigenResults* solve_lobpcg_matrix_free(const Mesh* mesh, SolverConfig* config);
+
+#endif
@@ -12,16 +12,43 @@ typedef struct {
     double* values;       // Valeurs non nulles
     MKL_INT* columns;     // Indices de colonne
     MKL_INT* row_index;   // Indices de début de ligne
+    void* mapping;        // Fichier projeté (mmap) si chargé sans copie, sinon NULL
+    size_t mapping_size;
+    Arena* arena;         // Non NULL: structure et tableaux dans cette arène
 } SparseMatrixCSR;
 
-// Construction des matrices
+// Construction des matrices (dans l'arène du maillage s'il en a une)
 SparseMatrixCSR* build_stiffness_matrix(Mesh* mesh);
 SparseMatrixCSR* build_mass_matrix(Mesh* mesh);
 
+// Ligne (i, j) de la matrice de rigidité: voisins puis diagonale, au plus
+// STIFFNESS_ROW_MAX entrées. Renvoie le nombre d'entrées
+#define STIFFNESS_ROW_MAX 5   // Pour une grille 2D: diag + 4 voisins
+int stiffness_row(const Mesh* mesh, int i, int j, MKL_INT* columns, double* values);
+
 // Fonctions utilitaires pour matrices creuses
 SparseMatrixCSR* create_sparse_matrix(MKL_INT n, MKL_INT nnz_estimate);
+SparseMatrixCSR* create_sparse_matrix_in(MKL_INT n, MKL_INT nnz_estimate, Arena* arena);
 void free_sparse_matrix(SparseMatrixCSR* mat);
 void save_matrix_csr(SparseMatrixCSR* mat, const char* filename);
+void save_matrix_csr_npz(SparseMatrixCSR* mat, const char* filename);
+
+// Format binaire CSR (.csrb): en-tête de 64 octets puis sections
+// row_index, columns et values alignées sur 64 octets
+int save_matrix_csr_binary(SparseMatrixCSR* mat, const char* filename);
+
+// Chargement par mmap: les pointeurs CSR pointent directement dans le fichier. Les deux
+// chargements refusent une matrice non carrée ou non symétrique (à 1e-12 max|a| près)
+SparseMatrixCSR* load_matrix_csr_binary(const char* filename);
+
+// Import Matrix Market (coordinate real/integer/pattern, general/symmetric)
+SparseMatrixCSR* load_matrix_market(const char* filename);
+
+// Chargement selon l'extension (.csrb ou .mtx)
+SparseMatrixCSR* load_matrix(const char* filename);
+
+// Matrice identité (masse par défaut pour un opérateur importé)
+SparseMatrixCSR* build_identity_matrix(MKL_INT n);
 
 // Conversion pour MKL
 sparse_matrix_t convert_to_mkl_sparse(SparseMatrixCSR* csr);
@@ -2,6 +2,8 @@
 #define MEMBRANE_H
 
 #include <mkl/mkl.h>
+#include "expression.h"
+#include "arena.h"
 
 
 // Constantes physiques
@@ -17,16 +19,24 @@ typedef struct {
     double obstacle_center_y;
     double obstacle_strength;
     double obstacle_width;
+    CoeffExpr* tension_expr;     // Expression compilée pour p (prioritaire si non NULL)
+    CoeffExpr* density_expr;     // Expression compilée pour w
+    CoeffExpr* potential_expr;   // Expression compilée pour q
 } MembraneParams;
 
 // Structure pour les résultats
 typedef struct {
     int n_eigenvalues;          // Nombre de valeurs propres calculées
     double* eigenvalues;        // Valeurs propres
-    double** eigenvectors;      // Vecteurs propres (matrice N² x k)
+    double** eigenvectors;      // Vues sur les colonnes de modes (eigenvectors[i] = modes + i*n_dof)
+    double* modes;              // Vecteurs propres contigus, colonne-major n_dof x k, aligné 64 octets
+    int n_dof;                  // Longueur d'un vecteur propre (leading dimension de modes)
+    size_t mapped_bytes;        // > 0 si modes est projeté depuis un fichier (mmap)
+    void* mapping;              // Début de la projection (en-tête .npy compris)
     double* residuals;          // Résidus
     double computation_time;    // Temps de calcul
     int iterations;            // Nombre d'itérations
+    Arena* arena;               // Non NULL: structure et tableaux dans cette arène
 } EigenResults;
 
 // Fonctions pour les coefficients
@@ -34,8 +44,16 @@ double default_tension(double x, double y);
 double default_density(double x, double y);
 double default_potential(double x, double y);
 
+// Obstacle gaussien q = strength exp(-width r²), r distance au centre (obstacle_center_x,
+// obstacle_center_y): potentiel échantillonné quand potential vaut default_potential
+double obstacle_potential(const MembraneParams* params, double x, double y);
+
 // Initialisation/liberation des paramètres
 MembraneParams* create_default_params();
 void free_membrane_params(MembraneParams* params);
 
+// Remplace un coefficient ('p', 'w' ou 'q') par une expression compilée
+int set_coefficient_expression(MembraneParams* params, char coefficient,
+                               const char* source);
+
 #endif
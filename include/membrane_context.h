@@ -0,0 +1,58 @@
+#ifndef MEMBRANE_CONTEXT_H
+#define MEMBRANE_CONTEXT_H
+
+#include <stddef.h>
+#include "membrane.h"
+#include "matrix_builder.h"
+#include "solver.h"
+
+// API de la bibliothèque libmembrane: un contexte possède une arène où vivent le maillage,
+// les matrices CSR, les espaces de travail des solveurs et les résultats. L'arène est remise
+// à zéro à chaque appel sans rendre sa mémoire: après le premier appel de la plus grande
+// taille, une résolution ne fait plus d'allocation système ni de défaut de page.
+// Les appels sur un même contexte sont sérialisés; des contextes distincts sont indépendants
+typedef struct MembraneContext MembraneContext;
+
+typedef struct {
+    int N;                  // Grille N x N (membrane_solve)
+    int n_eigenvalues;
+    SolverType solver;      // SOLVER_AUTO: planificateur
+    double eps;             // 0: tolérance par défaut
+    int max_iterations;     // 0: valeur par défaut
+    int threads;            // Threads MKL/OpenMP (0: réglage du thread appelant)
+    size_t memory_budget;   // Budget de SOLVER_AUTO (0: selon la mémoire disponible)
+    int symmetry;           // Réduction par les symétries de la grille (défaut 1)
+} MembraneSolveRequest;
+
+typedef struct {
+    long calls;
+    size_t capacity;        // Octets réservés par l'arène
+    size_t peak;            // Plus grande utilisation sur un appel
+    long segments;          // Allocations système de l'arène depuis la création
+} MembraneContextStats;
+
+// initial_bytes: réservation initiale (0: à la première résolution)
+MembraneContext* membrane_context_create(size_t initial_bytes);
+void membrane_context_destroy(MembraneContext* context);
+
+void membrane_request_init(MembraneSolveRequest* request, int N, int n_eigenvalues);
+
+// Résolution sur une grille (coefficients de params). Les résultats appartiennent au contexte
+// et restent valides jusqu'à l'appel suivant sur ce contexte; NULL en cas d'échec
+const EigenResults* membrane_solve(MembraneContext* context, MembraneParams* params,
+                                   const MembraneSolveRequest* request);
+
+// Résolution sur un opérateur fourni (request->N ignoré, matrix-free impossible)
+const EigenResults* membrane_solve_matrices(MembraneContext* context, SparseMatrixCSR* A,
+                                            SparseMatrixCSR* B,
+                                            const MembraneSolveRequest* request);
+
+// Opérateur déjà construit hors du contexte (réutilisé d'un appel à l'autre). mesh peut être
+// NULL sauf en matrix-free; A et B peuvent être NULL si mesh est donné (matrix-free)
+const EigenResults* membrane_solve_operator(MembraneContext* context, const Mesh* mesh,
+                                            SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                            const MembraneSolveRequest* request);
+
+void membrane_context_stats(MembraneContext* context, MembraneContextStats* stats);
+
+#endif
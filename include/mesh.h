@@ -11,10 +11,12 @@ typedef struct {
     double* p_vals;    // Valeurs de p aux points (N²)
     double* w_vals;    // Valeurs de w aux points (N²)
     double* q_vals;    // Valeurs de q aux points (N²)
+    Arena* arena;      // Non NULL: maillage dans cette arène (matrices assemblées aussi)
 } Mesh;
 
 // Création et destruction du maillage
 Mesh* create_mesh(int N, MembraneParams* params);
+Mesh* create_mesh_in(int N, MembraneParams* params, Arena* arena);
 void free_mesh(Mesh* mesh);
 
 // Fonctions utilitaires
@@ -24,5 +26,6 @@ double mesh_y(int j, Mesh* mesh);
 
 // Sauvegarde du maillage
 void save_mesh(Mesh* mesh, const char* filename);
+void save_mesh_npz(Mesh* mesh, const char* filename);
 
 #endif
@@ -0,0 +1,48 @@
+#ifndef MODAL_RESPONSE_H
+#define MODAL_RESPONSE_H
+
+#include "membrane.h"
+#include "lobpcg.h"
+
+// Réponse temporelle par superposition modale de B ü + C u̇ + A u = f(x, y) g(t):
+// chaque coordonnée modale suit un oscillateur amorti intégré exactement pour un chargement
+// linéaire entre deux échantillons (Nigam-Jennings; exact pour un échelon ou la réponse libre).
+// Le champ est reconstruit par blocs de snapshots: U = Φ C en un seul GEMM par bloc
+#define RESPONSE_CHUNK_BYTES ((size_t)32 << 20)   // Taille visée d'un bloc de snapshots
+
+// Profil temporel g(t) de la charge (NULL: échelon, g = 1 pour t >= 0)
+typedef double (*LoadProfileFn)(double t, const void* data);
+
+typedef struct {
+    const double* initial_displacement;  // u(0), n valeurs (NULL: nul)
+    const double* initial_velocity;      // u̇(0), n valeurs (NULL: nul)
+    const double* load;                  // f aux points, n valeurs (NULL: pas de charge)
+    LoadProfileFn profile;
+    const void* profile_data;
+    double damping;                      // Taux d'amortissement modal ζ (0 <= ζ < 1)
+    double dt;                           // Pas d'échantillonnage
+    long n_steps;                        // Snapshots t = 0, dt, ..., (n_steps - 1) dt
+    int chunk;                           // Snapshots par GEMM (0: selon RESPONSE_CHUNK_BYTES)
+} ResponseProblem;
+
+// Reçoit count snapshots consécutifs à partir de first_step: U est n x count, colonne-major
+// (un snapshot contigu par colonne), valide pendant l'appel seulement. Non nul: arrêt
+typedef int (*ResponseSinkFn)(long first_step, int count, const double* U, void* data);
+
+typedef struct {
+    double captured;        // Part de u(0) représentée par les modes (norme B), 1 si u(0) nul
+    double seconds;         // Synthèse complète (hors puits)
+    double sink_seconds;    // Temps passé dans le puits
+    int chunk;              // Snapshots par bloc retenus
+} ResponseStats;
+
+// Projette les conditions initiales et la charge sur les modes (B: masse, NULL: identité)
+// puis livre les snapshots bloc par bloc. -1 si les données sont invalides
+int modal_response(const EigenResults* modes, const LinearOperator* B,
+                   const ResponseProblem* problem, ResponseSinkFn sink, void* data,
+                   ResponseStats* stats);
+
+// Profil harmonique sin(2π f t), data: pointeur sur la fréquence f (Hz)
+double harmonic_load_profile(double t, const void* data);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef MODE_ARCHIVE_H
+#define MODE_ARCHIVE_H
+
+#include <stdint.h>
+#include "mesh.h"
+
+// Archive compressée des modes propres (.modz): coordonnées et valeurs propres une seule fois,
+// puis chaque mode découpé en blocs de lignes de la grille codés indépendamment (compression
+// et lecture parallèles, lecture d'un mode à la demande):
+//   float64     valeurs exactes
+//   float32     arrondi (erreur relative 2⁻²⁴)
+//   quantized   q = round(φ / Δ), Δ = 2 ε max|φ|: erreur ≤ ε max|φ| garantie; résidus du
+//               prédicteur 2D q(i-1,j) + q(i,j-1) - q(i-1,j-1), petits pour un mode régulier
+// Codec optionnel: entiers (ou flottants) en zigzag sur la plus petite largeur d'octets,
+// octets regroupés par rang (shuffle) puis LZ77 à la LZ4 (décodage sans entropie, rapide)
+#define MODE_ARCHIVE_MAGIC "MODZ"
+#define MODE_ARCHIVE_VERSION 1
+#define MODE_ARCHIVE_BLOCK_VALUES 65536   // Valeurs par bloc (lignes entières de la grille)
+#define MODE_ARCHIVE_DEFAULT_ERROR 1e-5   // ε relatif à max|φ| par défaut
+
+typedef enum {
+    MODE_FLOAT64,
+    MODE_FLOAT32,
+    MODE_QUANTIZED
+} ModeEncoding;
+
+typedef struct {
+    ModeEncoding encoding;
+    double error_bound;        // ε relatif (quantized seulement)
+    int compress;              // Shuffle + LZ (sinon blocs bruts)
+} ModeArchiveOptions;
+
+typedef struct {
+    uint64_t file_bytes;
+    uint64_t raw_bytes;        // Modes en float64
+    uint64_t csv_bytes;        // Equivalent save_mode_to_csv (estimé, %.6f)
+    double max_error;          // Max sur les modes de |φ - φ décodé| / max|φ|
+    double seconds;
+} ModeArchiveStats;
+
+// En-tête de fichier (petit-boutiste, 64 octets), suivi de x[N], y[N], valeurs propres[k],
+// de la table des modes, de la table des blocs (mode-major) puis des blocs
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t N;                // Grille N x N
+    uint32_t n_modes;
+    uint32_t encoding;         // ModeEncoding
+    uint32_t compress;
+    uint32_t rows_per_block;
+    uint32_t n_blocks;         // Par mode
+    double error_bound;
+    uint8_t reserved[24];
+} ModeArchiveHeader;
+
+typedef struct {
+    double scale;              // Δ (quantized), 0 sinon
+    double max_abs;            // max|φ|
+    double max_error;          // Erreur absolue atteinte
+    uint64_t checksum;         // XOR des empreintes des blocs stockés (vérifiée à la lecture)
+} ModeArchiveMode;
+
+typedef struct {
+    uint64_t offset;
+    uint32_t stored_bytes;     // stored_bytes == raw_bytes: bloc non compressé
+    uint32_t raw_bytes;
+} ModeArchiveBlock;
+
+typedef struct ModeArchive ModeArchive;
+
+// Les n_modes premiers modes de results (n_dof = N²). stats peut être NULL. -1 en cas d'erreur
+int mode_archive_write(const char* filename, const Mesh* mesh, const EigenResults* results,
+                       int n_modes, const ModeArchiveOptions* options, ModeArchiveStats* stats);
+
+// Lecture: en-tête, coordonnées et tables seulement; les modes sont décodés à la demande
+ModeArchive* mode_archive_open(const char* filename);
+const ModeArchiveHeader* mode_archive_header(const ModeArchive* archive);
+const double* mode_archive_x(const ModeArchive* archive);
+const double* mode_archive_y(const ModeArchive* archive);
+const double* mode_archive_eigenvalues(const ModeArchive* archive);
+const ModeArchiveMode* mode_archive_mode(const ModeArchive* archive, int index);
+
+// Décode le mode index dans values (N² valeurs, rangement des modes), blocs en parallèle.
+// -1 si un bloc est illisible ou si l'empreinte du mode ne correspond pas (archive corrompue)
+int mode_archive_read_mode(const ModeArchive* archive, int index, double* values);
+void mode_archive_close(ModeArchive* archive);
+
+const char* mode_encoding_name(ModeEncoding encoding);
+int parse_mode_encoding(const char* name, ModeEncoding* encoding);
+
+#endif
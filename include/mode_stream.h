@@ -0,0 +1,41 @@
+#ifndef MODE_STREAM_H
+#define MODE_STREAM_H
+
+#include <stdint.h>
+#include "mesh.h"
+#include "npy_io.h"
+#include "solver.h"
+#include "async_io.h"
+
+// Consommateur des paires propres livrées pendant la résolution:
+//  - table des valeurs propres complétée ligne par ligne
+//  - fichiers des premiers modes écrits dès leur livraison (tâches de l'AsyncWriter)
+//  - flux binaire optionnel (fichier ou tube nommé), un enregistrement par paire
+typedef struct ModeStream ModeStream;
+
+// Enregistrement du flux binaire: en-tête de 40 octets puis n float64
+typedef struct {
+    char magic[4];          // "MEIG"
+    int32_t index;          // Rang dans le spectre (0: plus petite valeur)
+    int32_t n;
+    int32_t reserved;
+    double eigenvalue;
+    double residual;
+    double elapsed;         // Secondes depuis le début de la résolution
+} ModeStreamRecord;
+
+// mesh NULL: pas de fichiers de modes; sink_file NULL: pas de flux binaire
+ModeStream* mode_stream_create(Mesh* mesh, int n_modes_to_save, OutputFormat mode_format,
+                               const char* table_file, const char* sink_file,
+                               AsyncWriter* writer);
+
+// Branche le flux sur la configuration du solveur
+void mode_stream_attach(ModeStream* stream, SolverConfig* config);
+
+// 1 si le mode index a déjà été écrit pour cette valeur propre
+int mode_stream_saved(const ModeStream* stream, int index, double eigenvalue);
+
+// Bilan (délai de la première paire) et fermeture des fichiers
+void mode_stream_close(ModeStream* stream);
+
+#endif
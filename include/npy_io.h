@@ -0,0 +1,46 @@
+#ifndef NPY_IO_H
+#define NPY_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Format de sortie sélectionnable pour chaque fichier produit
+typedef enum {
+    OUTPUT_CSV,      // Texte, lisible directement
+    OUTPUT_NPY       // Binaire NumPy (.npy / .npz), pleine précision
+} OutputFormat;
+
+int parse_output_format(const char* name, OutputFormat* format);
+const char* output_format_name(OutputFormat format);
+
+// Types NumPy usuels
+#define NPY_FLOAT64 "<f8"
+#define NPY_FLOAT32 "<f4"
+#define NPY_INT32   "<i4"
+#define NPY_INT64   "<i8"
+#define NPY_UINT32  "<u4"
+#define NPY_COMPLEX128 "<c16"
+
+// Type NumPy correspondant à MKL_INT
+#define NPY_MKL_INT (sizeof(MKL_INT) == 8 ? NPY_INT64 : NPY_INT32)
+
+// En-tête .npy (magic + dict) aligné sur 64 octets, renvoie sa taille (0 si erreur)
+size_t npy_build_header(char* header, size_t capacity, const char* dtype,
+                        int fortran_order, int ndim, const size_t* shape);
+
+// Ecriture d'un tableau .npy (ordre C, écrit en un seul bloc contigu)
+int npy_save(const char* filename, const char* dtype,
+             int ndim, const size_t* shape, const void* data);
+
+// Archive .npz (zip non compressé, compatible numpy.load / scipy.sparse.load_npz)
+typedef struct NpzWriter NpzWriter;
+
+NpzWriter* npz_open(const char* filename);
+int npz_add_array(NpzWriter* npz, const char* name, const char* dtype,
+                  int ndim, const size_t* shape, const void* data);
+int npz_close(NpzWriter* npz);
+
+// CRC-32 (zip, png)
+uint32_t crc32_update(uint32_t crc, const void* data, size_t length);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Compteurs matériels (perf_event_open, Linux) lus par thread autour des phases du profileur.
+// Désactivés par défaut: une seule lecture de drapeau par phase
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_REFERENCES,
+    PERF_LLC_MISSES,
+    PERF_FP_SCALAR,             // Instructions flottantes double précision (Intel)
+    PERF_FP_128,
+    PERF_FP_256,
+    PERF_FP_512,
+    PERF_N_COUNTERS
+} PerfCounter;
+
+// Octets transférés par défaut de cache de dernier niveau (estimation du trafic mémoire)
+#define PERF_CACHE_LINE_BYTES 64.0
+
+// Activation: renvoie le nombre de compteurs disponibles (0 si perf_event_open est refusé)
+int perf_counters_enable(void);
+int perf_counters_enabled(void);
+int perf_counter_available(PerfCounter counter);
+const char* perf_counter_name(PerfCounter counter);
+
+// Valeurs cumulées du thread appelant et des threads qu'il crée ensuite (ouverture au
+// premier appel, mise à l'échelle en cas de multiplexage); -1 si indisponible
+int perf_counters_read(double values[PERF_N_COUNTERS]);
+
+// Opérations flottantes comptées par le matériel (0 sans compteurs vectoriels)
+double perf_counters_flops(const double values[PERF_N_COUNTERS]);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <stddef.h>
+#include "solver.h"
+
+// Modèle de machine pour les estimations de durée (ordres de grandeur, mesurés sur un cœur)
+#define PLANNER_BLAS3_GFLOPS 12.0       // Par cœur: Cholesky, réduction, tridiagonalisation
+#define PLANNER_QR_GFLOPS 3.5           // Par cœur: QR implicite avec vecteurs (DSYGV)
+#define PLANNER_ROTATION_GFLOPS 3.5     // Réduction de bande par rotations (un seul thread)
+#define PLANNER_MEMORY_GBS 6.0          // Bande passante mémoire (SpMV, stencil)
+#define PLANNER_LOBPCG_ITERATIONS 5.0   // Itérations LOBPCG ≈ c · sqrt(n) (Jacobi, grille)
+#define PLANNER_BUDGET_FRACTION 0.8     // Part de la mémoire disponible utilisée par défaut
+#define PLANNER_DOF_PER_CORE 2000.0     // Grain minimal d'un cœur: au-delà, pas d'accélération
+
+// Description du problème, connue avant l'assemblage pour une grille
+typedef struct {
+    int n;                  // Degrés de liberté
+    int k;                  // Paires propres demandées
+    int bandwidth;          // Demi-largeur de bande de A
+    double nnz_A;
+    double nnz_B;
+    int B_diagonal;         // Condition du solveur bande
+    int grid_size;          // > 0: maillage N x N (solveur sans matrice possible)
+    int needs_matrices;     // Sorties qui exigent A et B assemblées (motifs, export binaire)
+} PlanProblem;
+
+typedef struct {
+    int applicable;
+    double memory_bytes;    // Pic estimé, matrices et résultats compris
+    double seconds;         // Durée estimée de la résolution
+    const char* reason;     // Pourquoi la stratégie est écartée
+} PlanEstimate;
+
+typedef struct {
+    PlanEstimate estimates[SOLVER_N_TYPES];
+    SolverType requested;
+    SolverType chosen;      // SOLVER_AUTO si aucun plan ne convient
+    int n;
+    int k;
+    int cores;
+    size_t budget;
+} SolvePlan;
+
+PlanProblem plan_problem_from_grid(int N, int k);
+PlanProblem plan_problem_from_matrices(const SparseMatrixCSR* A, const SparseMatrixCSR* B, int k);
+
+// Budget par défaut: fraction de la mémoire disponible (limite cgroup comprise)
+size_t planner_memory_budget(void);
+
+// Estime chaque stratégie; SOLVER_AUTO retient la plus rapide qui tient dans budget
+// (0: budget par défaut), sinon vérifie la stratégie demandée. -1 si rien ne convient
+int plan_solve(const PlanProblem* problem, SolverType requested, size_t budget, SolvePlan* plan);
+void print_solve_plan(const SolvePlan* plan);
+
+// Durée estimée d'une stratégie sur un nombre de cœurs donné (modèle de coût des groupes de threads)
+double plan_estimate_seconds(const PlanProblem* problem, SolverType solver, int cores);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stddef.h>
+
+// Profileur de phases en temps réel (horloge murale), hiérarchique et multi-thread:
+// chaque thread a sa pile de phases; les phases de même chemin sont cumulées
+#define PROFILER_MAX_PHASES 128
+#define PROFILER_MAX_DEPTH 16
+
+// Horloge murale monotone (secondes)
+double profiler_now(void);
+
+// Début / fin de phase (imbriquées, dans le thread appelant)
+void profiler_begin(const char* name);
+void profiler_end(void);
+
+// Travail attribué à la phase courante du thread: opérations flottantes et octets transférés.
+// Comme le temps, il est aussi compté dans les phases englobantes du même thread
+void profiler_add_work(double flops, double bytes);
+
+// Métadonnées du rapport (N, modes, solveur, ...)
+void profiler_set_info(const char* key, const char* value);
+void profiler_set_info_int(const char* key, long value);
+
+// Rapport: tableau par phase sur stdout, JSON dans filename
+void profiler_print_summary(void);
+int profiler_write_json(const char* filename);
+
+#endif
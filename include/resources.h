@@ -0,0 +1,46 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include <stddef.h>
+
+// Partage des cœurs entre tâches concurrentes: chaque groupe de threads reçoit une tranche
+// contiguë de cœurs (affinité) et autant de threads MKL/OpenMP
+#define RESOURCES_MAX_CORES 256
+
+typedef struct {
+    int n_cores;
+    int cores[RESOURCES_MAX_CORES];     // Identifiants CPU
+} ThreadGroup;
+
+// Etat du thread avant thread_group_enter, rétabli par thread_group_leave
+typedef struct {
+    ThreadGroup affinity;
+    int pinned;
+    int omp_threads;
+    int mkl_threads;
+} ThreadState;
+
+// Durée estimée de la tâche task sur cores cœurs
+typedef double (*TaskCostFn)(int task, int cores, void* data);
+
+// Cœurs du masque d'affinité du processus; max_cores > 0 en limite le nombre
+// (au-delà du masque, les cœurs sont réutilisés: les groupes se partagent alors des cœurs)
+int resources_detect(int max_cores, ThreadGroup* all);
+
+// Répartit n_tasks tâches sur au plus max_groups groupes (0: pas de limite), en retenant le
+// nombre de groupes de plus courte durée estimée. Tâches plus longues d'abord vers le groupe
+// le moins chargé (exécution en file dans un groupe), puis cœurs restants un à un au groupe le
+// plus long qui en profite. task_group[t]: groupe de la tâche t; renvoie le nombre de groupes
+// (0 en cas d'échec), makespan: durée estimée de l'ensemble
+int resources_partition(const ThreadGroup* all, int n_tasks, TaskCostFn cost, void* data,
+                        int max_groups, int* task_group, ThreadGroup* groups, double* makespan);
+
+// Entrée dans un groupe (thread appelant): affinité si pin, threads MKL et OpenMP.
+// previous reçoit l'état courant pour thread_group_leave. -1 si l'affinité est refusée
+int thread_group_enter(const ThreadGroup* group, int pin, ThreadState* previous);
+void thread_group_leave(const ThreadState* previous);
+
+// "0-3", "4,6,8-9"
+void format_core_list(const ThreadGroup* group, char* text, size_t size);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "mesh.h"
+#include "matrix_builder.h"
+#include "solver.h"
+
+// Version de la discrétisation: à incrémenter si build_*_matrix change
+#define CACHE_DISCRETIZATION_VERSION 2
+
+// Empreinte 128 bits d'un problème (grille, coefficients, discrétisation, spectre visé)
+typedef struct {
+    uint64_t h[2];
+} ProblemKey;
+
+typedef struct {
+    char directory[512];
+    size_t max_bytes;       // Taille maximale du cache (éviction LRU au-delà)
+    int enabled;
+    int hits;
+    int misses;
+    pthread_mutex_t lock;   // Résolutions concurrentes (groupes de threads)
+} ResultCache;
+
+// Initialisation (crée le répertoire si besoin, supprime les écritures interrompues)
+int result_cache_init(ResultCache* cache, const char* directory, size_t max_bytes);
+
+// Empreintes: à partir des coefficients échantillonnés ou d'un opérateur importé
+ProblemKey problem_key_from_mesh(Mesh* mesh);
+ProblemKey problem_key_from_matrices(SparseMatrixCSR* A, SparseMatrixCSR* B);
+
+// Recherche: une entrée avec au moins k modes et une tolérance au moins aussi fine convient
+EigenResults* result_cache_lookup(ResultCache* cache, ProblemKey key,
+                                  SolverConfig* config);
+
+// Enregistrement (remplace une entrée moins complète), puis éviction des autres entrées.
+// Une entrée plus grande que max_bytes n'est pas enregistrée
+int result_cache_store(ResultCache* cache, ProblemKey key, EigenResults* results,
+                       SolverConfig* config);
+
+// Supprime les entrées les moins récemment utilisées jusqu'à max_bytes, sauf keep
+// (nom de fichier dans le répertoire, NULL: aucune)
+void result_cache_evict(ResultCache* cache, const char* keep);
+
+// Résolution avec cache: lookup, sinon solve_eigenproblem puis store.
+// Appelable depuis plusieurs threads: lookup et store sont sérialisés, pas la résolution
+EigenResults* solve_eigenproblem_cached(ResultCache* cache, ProblemKey key,
+                                        SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                        SolverConfig* config);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include "mesh.h"
+
+// Dérivées des valeurs propres (A symétrique, B = diag(w)): dλ = φᵀ(dA - λ dB)φ / φᵀBφ.
+// Par rapport aux valeurs nodales des coefficients:
+//   dλ/dq_k = φ_k² / m,  dλ/dw_k = -λ φ_k² / m,
+//   dλ/dp_k = Σ arêtes de k: ∂c/∂p_k (φ_k - φ_voisin)² / m (voisin nul au bord)
+// avec les arêtes c du stencil de build_stiffness_matrix. Gradient continu L² ≈ valeur / h²
+#define SENSITIVITY_N_OBSTACLE 4   // Centre x, centre y, intensité, largeur
+
+// Valeurs propres multiples (écart relatif sous SENSITIVITY_CLUSTER_GAP): la dérivée d'un
+// mode dépend de la base rendue par le solveur. Chaque mode d'un groupe reçoit celle de la
+// moyenne du groupe, Σ φᵀ(dA - λ dB)φ/m / taille, qui n'en dépend pas
+#define SENSITIVITY_CLUSTER_GAP 1e-6
+
+typedef struct {
+    int n_modes;
+    int n_points;
+    double* dp;          // n_points x n_modes, colonne-major (même rangement que les modes)
+    double* dw;
+    double* dq;
+    double* obstacle;    // n_modes x 4: dλ_i / d(centre x, centre y, intensité, largeur)
+    int has_obstacle;    // q est l'obstacle gaussien des paramètres (sinon obstacle = 0)
+    int* cluster;        // Premier mode du groupe de chaque mode (lui-même si isolé)
+    int n_clustered;     // Modes dans un groupe de valeurs propres multiples
+} EigenSensitivities;
+
+// Toutes les dérivées nodales en un passage parallèle sur le maillage, puis les paramètres
+// scalaires de l'obstacle par dérivation composée (un produit matriciel)
+EigenSensitivities* compute_eigen_sensitivities(const Mesh* mesh, const MembraneParams* params,
+                                                const EigenResults* modes);
+void free_eigen_sensitivities(EigenSensitivities* sens);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stddef.h>
+
+// Mode serveur: un processus résident reçoit des jobs ("cle = valeur", terminés par "solve")
+// sur une socket Unix ou sur l'entrée standard. Les groupes de threads, les arènes des
+// contextes et les opérateurs assemblés restent chauds d'un job à l'autre
+#define SERVER_MAX_WORKERS 64
+#define SERVER_QUEUE_DEPTH 256     // Jobs en attente par groupe
+#define SERVER_MAX_CLIENTS 64
+
+typedef struct {
+    const char* socket_path;   // NULL ou "-": requêtes sur stdin, réponses sur stdout
+    int workers;               // Groupes de threads (0: un pour deux cœurs)
+    int threads;               // Cœurs utilisés (0: masque d'affinité)
+    int pin;                   // Affinité des groupes
+    int operator_cache;        // Opérateurs (maillage, A, B) gardés en mémoire, LRU
+    size_t memory_budget;      // Budget du planificateur par job (0: mémoire disponible)
+} ServerOptions;
+
+void server_options_init(ServerOptions* options);
+
+// Bloque jusqu'à "shutdown" (socket) ou la fin de l'entrée standard; 0 si arrêt normal
+int run_server(const ServerOptions* options);
+
+#endif
@@ -5,21 +5,77 @@
 
 #include <mkl/mkl.h>
 
+// Méthode de résolution
+typedef enum {
+    SOLVER_DENSE,           // DSYGV sur les matrices densifiées (spectre complet)
+    SOLVER_DENSE_PARTIAL,   // DSYGVX: k plus petites paires seulement
+    SOLVER_BANDED,          // DSBEVX sur la bande puis itération inverse (B diagonale)
+    SOLVER_LOBPCG,          // Itératif par blocs, matrices creuses
+    SOLVER_MATRIX_FREE,     // LOBPCG, A appliquée par stencil sur le maillage
+    SOLVER_AUTO             // Choisi par le planificateur (planner.h)
+} SolverType;
+
+#define SOLVER_N_TYPES SOLVER_AUTO
+
+// Paire propre livrée dès qu'elle est connue (verrouillage LOBPCG, fin du solveur dense)
+typedef struct {
+    int index;              // Rang dans le spectre (0: plus petite valeur)
+    int n;                  // Taille du vecteur
+    double eigenvalue;
+    double residual;
+    const double* vector;   // Norme 2 unitaire, valide pendant l'appel seulement
+    double elapsed;         // Secondes depuis le début de la résolution
+} Eigenpair;
+
+// Appelé dans le thread du solveur: doit rendre la main rapidement
+typedef void (*EigenpairCallback)(const Eigenpair* pair, void* user_data);
+
 typedef struct {
     int n_eigenvalues;      // Nombre de valeurs à chercher
-    double eps;            // Tolérance (pour d'éventuels solveurs itératifs)
-    int mkl_threads;      // Nombre de threads MKL
+    double eps;            // Tolérance (résidu relatif des solveurs itératifs)
+    int mkl_threads;      // Threads MKL et OpenMP de la résolution (0: réglage du thread appelant)
+    const char* eigenvector_file;  // Si non NULL: modes projetés (mmap) dans ce fichier .npy
+    SolverType solver;
+    int max_iterations;           // Solveurs itératifs
+    const char* checkpoint_file;  // Etat du solveur itératif (NULL: pas de checkpoint)
+    int checkpoint_interval;      // Itérations entre deux checkpoints
+    int restart;                  // Reprendre depuis checkpoint_file
+    EigenpairCallback on_eigenpair;  // NULL: pas de livraison incrémentale
+    void* on_eigenpair_data;
+    const Mesh* mesh;             // Maillage du problème (requis par SOLVER_MATRIX_FREE)
+    size_t memory_budget;         // Octets pour SOLVER_AUTO (0: selon la mémoire disponible)
+    Arena* workspace;             // Espaces de travail et résultats (NULL: tas)
+    int symmetry;                 // Réduction par les symétries de mesh (symmetry.h), qui doit
+                                  // alors être le maillage de A et B
 } SolverConfig;
 
 // Configuration du solveur
 SolverConfig* create_solver_config(int n_eigenvalues);
+void solver_config_init(SolverConfig* config, int n_eigenvalues);   // Valeurs par défaut
 void free_solver_config(SolverConfig* config);
 
-// Résolution du problème (DSYGV uniquement)
+// Choix du solveur par nom ("dense", "dense-partial", "banded", "lobpcg", "matrix-free", "auto")
+int parse_solver_type(const char* name, SolverType* type);
+const char* solver_type_name(SolverType type);
+
+// Résolution du problème selon config->solver (A et B peuvent être NULL en SOLVER_MATRIX_FREE)
 EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B, 
                                  SolverConfig* config);
 
-// Libération des résultats
+// Demi-largeur de bande d'une matrice CSR (max |i - j|) et test de diagonalité
+int csr_bandwidth(const SparseMatrixCSR* mat);
+int csr_is_diagonal(const SparseMatrixCSR* mat);
+
+// Allocation des résultats: modes contigus n x k, en mémoire ou projetés
+// dans un fichier .npy (fortran_order) si backing_file n'est pas NULL
+EigenResults* create_eigen_results(int n, int k, const char* backing_file);
+EigenResults* create_eigen_results_in(int n, int k, const char* backing_file, Arena* arena);
+
+// Livre à config->on_eigenpair les paires first..k-1 de results
+void stream_eigenpairs(const SolverConfig* config, const EigenResults* results,
+                       int first, double elapsed);
+
+// Libération des résultats (rendus avec l'arène s'ils y ont été alloués)
 void free_eigen_results(EigenResults* results);
 
 // Utilitaires
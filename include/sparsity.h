@@ -0,0 +1,43 @@
+#ifndef SPARSITY_H
+#define SPARSITY_H
+
+#include <stdint.h>
+#include "matrix_builder.h"
+
+// Résolution par défaut de l'image de densité
+#define SPARSITY_DEFAULT_RESOLUTION 1024
+// Histogramme des non-nuls par ligne: classes 0..SPARSITY_HISTOGRAM_BINS-2, puis ">="
+#define SPARSITY_HISTOGRAM_BINS 65
+
+// Image de densité (spy plot par cases) et statistiques de structure
+typedef struct {
+    int image_rows;             // min(resolution, n_rows)
+    int image_cols;             // min(resolution, n_cols)
+    uint32_t* counts;           // counts[r * image_cols + c]: non-nuls de la case
+    uint32_t max_count;
+    
+    MKL_INT n_rows;
+    MKL_INT n_cols;
+    MKL_INT nnz;
+    MKL_INT lower_bandwidth;    // max(i - j) pour a_ij != 0
+    MKL_INT upper_bandwidth;    // max(j - i)
+    long long profile;          // Enveloppe: somme des i - min_j(a_ij != 0)
+    MKL_INT min_row_nnz;
+    MKL_INT max_row_nnz;
+    MKL_INT empty_rows;
+    MKL_INT missing_diagonal;   // Lignes sans terme diagonal
+    long long row_histogram[SPARSITY_HISTOGRAM_BINS];
+} SparsityPattern;
+
+// Une passe parallèle sur row_index/columns; coût et taille bornés par la résolution
+SparsityPattern* compute_sparsity_pattern(const SparseMatrixCSR* mat, int resolution);
+void free_sparsity_pattern(SparsityPattern* pattern);
+
+// Résumé lisible (stdout)
+void print_sparsity_stats(const SparsityPattern* pattern);
+
+// Statistiques (statistic,value) et histogramme (nnz_per_row,rows) en CSV
+int save_sparsity_stats(const SparsityPattern* pattern, const char* stats_file,
+                        const char* histogram_file);
+
+#endif
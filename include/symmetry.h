@@ -0,0 +1,36 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "solver.h"
+
+// Symétries du carré laissant p, w et q échantillonnés invariants. Avec u(i, j):
+//   SYMMETRY_X         x ↔ 1 - x   (i ↔ N-1-i)
+//   SYMMETRY_Y         y ↔ 1 - y   (j ↔ N-1-j)
+//   SYMMETRY_DIAGONAL  x ↔ y       (i ↔ j)
+// A et B commutent alors avec ces permutations: le problème se sépare en classes
+// (modes pairs/impairs), chacune résolue sur la base orthonormée de ses orbites:
+//   x ou y seul           2 classes de n/2
+//   x et y                4 classes de n/4 (parités en x et en y)
+//   diagonale seule       2 classes de n/2
+//   x, y et diagonale     4 classes de n/8 (++ et -- symétriques/antisymétriques en x ↔ y)
+//                         + la classe +- de n/4; la classe -+ s'en déduit par transposition
+#define SYMMETRY_X 1
+#define SYMMETRY_Y 2
+#define SYMMETRY_DIAGONAL 4
+#define SYMMETRY_TOLERANCE 1e-12     // Ecart relatif toléré sur les coefficients
+#define SYMMETRY_MAX_CLASSES 5
+
+// Symétries de la grille (combinaison de SYMMETRY_*), 0 si aucune
+int detect_mesh_symmetries(const Mesh* mesh, double tolerance);
+
+// "x, y, diagonal"
+void format_symmetries(int symmetries, char* text, size_t size);
+
+// Résolution par classes sur config->mesh (A et B: stencil de ce maillage, non utilisées).
+// Classes résolues en parallèle dans des groupes de threads (resources.h), k modes par
+// classe ajustés jusqu'à ce qu'aucune valeur manquante ne puisse passer sous la k-ième;
+// modes reconstruits sur la grille complète et triés comme ceux de solve_eigenproblem.
+// Avec config->workspace, tout vient de cette arène et les classes sont résolues en file
+EigenResults* solve_symmetric_eigenproblem(int symmetries, SolverConfig* config);
+
+#endif
@@ -4,23 +4,70 @@
 #include "matrix_builder.h"
 #include "membrane.h"
 #include "mesh.h"
+#include "npy_io.h"
+
+// Rendu des images: PNG en C (par défaut) ou scripts matplotlib
+typedef enum {
+    PLOT_NATIVE,
+    PLOT_PYTHON
+} PlotBackend;
+
+int parse_plot_backend(const char* name, PlotBackend* backend);
+void set_plot_backend(PlotBackend backend);
+
+// Structure de la matrice: image de densité bornée (par défaut) ou liste complète des non-nuls
+typedef enum {
+    SPARSITY_DENSITY,
+    SPARSITY_FULL
+} SparsityPlotMode;
+
+int parse_sparsity_mode(const char* name, SparsityPlotMode* mode);
+
+// Animation u(x,y,t) = somme des a_i phi_i(x,y) cos(omega_i t)
+typedef enum {
+    ANIMATION_NONE,
+    ANIMATION_GIF,          // GIF animé en boucle
+    ANIMATION_RAW           // Images RGB24 brutes (entrée rawvideo de ffmpeg)
+} AnimationFormat;
+
+typedef struct {
+    AnimationFormat format;
+    int n_frames;
+    int image_size;         // Côté de l'image en pixels
+    int fps;
+} AnimationOptions;
+
+int parse_animation_format(const char* name, AnimationFormat* format);
+void set_animation_options(const AnimationOptions* options);
+
+// Crée path et ses parents (mkdir -p sans shell), 0 si c'est bien un répertoire
+int ensure_directory(const char* path);
 
 void save_mode_to_csv(Mesh* mesh, double* mode, int mode_index, 
                      const char* filename);
 
-void generate_plots(Mesh* mesh, EigenResults* results, 
+// Mode en binaire: tableau N x N (float64), mode[i*N + j] en (x[i], y[j])
+void save_mode_to_npy(Mesh* mesh, double* mode, int mode_index,
+                      const char* filename);
+
+// Images des n_modes premiers modes (modes sauvegardés) et eigenvalues.csv dans output_dir
+void generate_plots(Mesh* mesh, EigenResults* results, int n_modes,
                    const char* output_dir);
 
 void plot_convergence(int* grid_sizes, double** eigenvalues, 
                      int n_sizes, int n_eigenvalues,
                      const char* filename);
 
-void plot_matrix_sparsity(SparseMatrixCSR* mat, const char* filename);
+// Densité: data/matrix_density.(csv|npy), data/matrix_stats.csv, data/matrix_row_nnz.csv
+// Complet: en plus data/matrix_pattern.(csv|npz), un élément par non-nul
+void plot_matrix_sparsity(SparseMatrixCSR* mat, const char* filename,
+                          OutputFormat pattern_format, SparsityPlotMode mode);
 
+// Superposition des n_modes premiers modes: output_dir/animation.gif (ou .rgb)
 void create_animation(Mesh* mesh, EigenResults* results, 
                      int n_modes, const char* output_dir);
 
 // Fonction pour générer les scripts Python
-void generate_python_script(const char* plot_type);
+void generate_python_script(const char* plot_type, int n_modes);
 
 #endif
@@ -0,0 +1,54 @@
+#ifndef WAVE_SOLVER_H
+#define WAVE_SOLVER_H
+
+#include "mesh.h"
+#include "modal_response.h"
+
+// Intégration explicite (saute-mouton) de w u_tt = ∇·(p∇u) − q u + f(x, y) g(t) sur le maillage,
+// avec les coefficients de build_stiffness_matrix et la masse de build_mass_matrix (A jamais
+// assemblée). Stable si dt² λmax(W⁻¹A) < 4, λmax étant majoré par Gershgorin: un pas au-delà
+// (dt imposé ou cfl > 1) est refusé
+#define WAVE_DEFAULT_CFL 0.9
+#define WAVE_TILE_ROWS 32          // Tuile balayée par un thread: 3 lignes de u restent en cache
+#define WAVE_TILE_COLS 512
+#define WAVE_SENSOR_BATCH 4096     // Echantillons livrés ensemble au puits
+
+typedef struct {
+    const double* initial_displacement;  // u(0), n valeurs (NULL: nul)
+    const double* initial_velocity;      // u̇(0), n valeurs (NULL: nul)
+    const double* load;                  // f aux points, n valeurs (NULL: pas de charge)
+    LoadProfileFn profile;               // g(t) (NULL: échelon)
+    const void* profile_data;
+    double t_end;                        // Intégration sur [0, t_end]
+    double dt;                           // Pas imposé (0: pas limite x cfl)
+    double cfl;                          // Fraction du pas limite, <= 1 (0: WAVE_DEFAULT_CFL)
+    const int* sensors;                  // Indices des points enregistrés
+    int n_sensors;
+    int sample_every;                    // Pas entre deux échantillons (0: chaque pas)
+} WaveProblem;
+
+// Reçoit count échantillons consécutifs à partir de first_sample: samples est count x n_sensors
+// (ordre C), alloué par malloc, et appartient désormais au puits qui le libère quand il veut
+// (typiquement après une écriture en arrière-plan). Non nul: arrêt
+typedef int (*WaveSensorSinkFn)(long first_sample, int count, double* samples, void* data);
+
+typedef struct {
+    double dt;                 // Pas retenu (t_end / n_steps)
+    double stable_dt;          // Pas limite de Gershgorin
+    long n_steps;
+    long n_samples;            // Echantillons t = 0, e dt, 2 e dt, ... (e = sample_every)
+    double seconds;            // Boucle en temps (hors puits)
+    double updates_per_second; // Points mis à jour par seconde
+} WaveStats;
+
+// Pas limite 2 / sqrt(max Gershgorin(W⁻¹A))
+double wave_stable_dt(const Mesh* mesh);
+
+// Pas, nombre de pas et d'échantillons, sans intégrer (dimensionne les sorties). -1 si invalide
+int wave_plan(const Mesh* mesh, const WaveProblem* problem, WaveStats* stats);
+
+// Intègre et livre les échantillons des capteurs par lots. -1 si les données sont invalides
+int wave_solve(const Mesh* mesh, const WaveProblem* problem, WaveSensorSinkFn sink, void* data,
+               WaveStats* stats);
+
+#endif
@@ -0,0 +1,172 @@
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mkl/mkl.h>
+
+// Plus petit segment créé par croissance (évite une série de petits segments au départ)
+#define ARENA_MIN_SEGMENT ((size_t)1 << 20)
+
+typedef struct Segment {
+    struct Segment* next;
+    char* data;
+    size_t size;
+    size_t used;
+} Segment;
+
+struct Arena {
+    Segment* first;
+    Segment* current;           // Segment où se font les allocations
+    size_t used;                // Octets alloués depuis le dernier arena_reset
+    size_t peak;
+    long segments_created;
+};
+
+static size_t align_up(size_t bytes) {
+    return (bytes + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// Segment prérempli: ses pages sont touchées une fois pour toutes
+static Segment* create_segment(Arena* arena, size_t size) {
+    Segment* segment = (Segment*)malloc(sizeof(Segment));
+    if (!segment) return NULL;
+    segment->data = (char*)mkl_malloc(size, ARENA_ALIGNMENT);
+    if (!segment->data) {
+        free(segment);
+        return NULL;
+    }
+    memset(segment->data, 0, size);
+    segment->next = NULL;
+    segment->size = size;
+    segment->used = 0;
+    arena->segments_created++;
+    return segment;
+}
+
+static void free_segments(Segment* segment) {
+    while (segment) {
+        Segment* next = segment->next;
+        mkl_free(segment->data);
+        free(segment);
+        segment = next;
+    }
+}
+
+Arena* arena_create(size_t initial_bytes) {
+    Arena* arena = (Arena*)calloc(1, sizeof(Arena));
+    if (!arena) {
+        fprintf(stderr, "Error: Failed to allocate arena\n");
+        return NULL;
+    }
+    if (initial_bytes > 0) {
+        arena->first = create_segment(arena, align_up(initial_bytes));
+        if (!arena->first) {
+            fprintf(stderr, "Error: Failed to reserve %zu bytes for the arena\n", initial_bytes);
+            free(arena);
+            return NULL;
+        }
+    }
+    arena->current = arena->first;
+    return arena;
+}
+
+void arena_destroy(Arena* arena) {
+    if (!arena) return;
+    free_segments(arena->first);
+    free(arena);
+}
+
+void* arena_alloc(Arena* arena, size_t bytes) {
+    if (!arena) return mkl_malloc(bytes > 0 ? bytes : 1, ARENA_ALIGNMENT);
+    
+    size_t size = align_up(bytes > 0 ? bytes : 1);
+    Segment* segment = arena->current;
+    while (segment && segment->size - segment->used < size) {
+        segment = segment->next;
+        if (segment) segment->used = 0;
+    }
+    
+    if (!segment) {
+        // Croissance géométrique: le nombre de segments reste logarithmique
+        size_t grown = arena->current ? 2 * arena->current->size : ARENA_MIN_SEGMENT;
+        segment = create_segment(arena, size > grown ? size : grown);
+        if (!segment) return NULL;
+        if (arena->current) {
+            segment->next = arena->current->next;
+            arena->current->next = segment;
+        } else {
+            arena->first = segment;
+        }
+    }
+    
+    arena->current = segment;
+    void* ptr = segment->data + segment->used;
+    segment->used += size;
+    arena->used += size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return ptr;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    void* ptr = arena_alloc(arena, count * size);
+    // Mémoire réutilisée: remise à zéro explicite
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void arena_free(Arena* arena, void* ptr) {
+    if (!arena && ptr) mkl_free(ptr);
+}
+
+void arena_reset(Arena* arena) {
+    if (!arena || !arena->first) return;
+    
+    if (arena->first->next) {
+        // Un seul segment à la taille du pic pour les appels suivants
+        size_t total = 0;
+        for (Segment* segment = arena->first; segment; segment = segment->next) {
+            total += segment->size;
+        }
+        free_segments(arena->first);
+        arena->first = create_segment(arena, align_up(total > arena->peak ? total : arena->peak));
+    }
+    if (arena->first) arena->first->used = 0;
+    arena->current = arena->first;
+    arena->used = 0;
+}
+
+ArenaMark arena_mark(const Arena* arena) {
+    ArenaMark mark = {NULL, 0, 0};
+    if (arena && arena->current) {
+        mark.segment = arena->current;
+        mark.used = arena->current->used;
+        mark.total = arena->used;
+    }
+    return mark;
+}
+
+void arena_rewind(Arena* arena, ArenaMark mark) {
+    if (!arena) return;
+    // Marque prise avant le premier segment: tout est rendu
+    Segment* segment = mark.segment ? (Segment*)mark.segment : arena->first;
+    if (!segment) return;
+    segment->used = mark.segment ? mark.used : 0;
+    arena->current = segment;
+    arena->used = mark.total;
+}
+
+size_t arena_capacity(const Arena* arena) {
+    size_t total = 0;
+    for (Segment* segment = arena ? arena->first : NULL; segment; segment = segment->next) {
+        total += segment->size;
+    }
+    return total;
+}
+
+size_t arena_peak(const Arena* arena) {
+    return arena ? arena->peak : 0;
+}
+
+long arena_segment_count(const Arena* arena) {
+    return arena ? arena->segments_created : 0;
+}
@@ -0,0 +1,196 @@
+#include "async_io.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+typedef struct AsyncTask {
+    AsyncWriteFn write;
+    AsyncReleaseFn release;
+    void* payload;
+    size_t bytes;
+    struct AsyncTask* next;
+} AsyncTask;
+
+struct AsyncWriter {
+    pthread_t* threads;
+    int n_threads;
+    size_t max_pending_bytes;
+    
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;   // file non vide ou arrêt
+    pthread_cond_t space_available;  // budget libéré
+    pthread_cond_t idle;             // plus aucune tâche en cours
+    
+    AsyncTask* head;
+    AsyncTask* tail;
+    size_t pending_bytes;            // Octets des tâches en file ou en cours
+    int active_tasks;                // Tâches en file ou en cours
+    int shutdown;
+    
+    double busy_time;
+    double stall_time;
+};
+
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void run_task(AsyncTask* task) {
+    task->write(task->payload);
+    if (task->release) task->release(task->payload);
+}
+
+static void* writer_thread(void* arg) {
+    AsyncWriter* writer = (AsyncWriter*)arg;
+    
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        while (!writer->head && !writer->shutdown) {
+            pthread_cond_wait(&writer->work_available, &writer->lock);
+        }
+        if (!writer->head) break;
+        
+        AsyncTask* task = writer->head;
+        writer->head = task->next;
+        if (!writer->head) writer->tail = NULL;
+        pthread_mutex_unlock(&writer->lock);
+        
+        double start = wall_time();
+        run_task(task);
+        double elapsed = wall_time() - start;
+        
+        pthread_mutex_lock(&writer->lock);
+        writer->busy_time += elapsed;
+        writer->pending_bytes -= task->bytes;
+        writer->active_tasks--;
+        pthread_cond_broadcast(&writer->space_available);
+        if (writer->active_tasks == 0) pthread_cond_broadcast(&writer->idle);
+        free(task);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    
+    return NULL;
+}
+
+AsyncWriter* async_writer_create(int n_threads, size_t max_pending_bytes) {
+    AsyncWriter* writer = (AsyncWriter*)calloc(1, sizeof(AsyncWriter));
+    if (!writer) return NULL;
+    
+    writer->max_pending_bytes = max_pending_bytes;
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->work_available, NULL);
+    pthread_cond_init(&writer->space_available, NULL);
+    pthread_cond_init(&writer->idle, NULL);
+    
+    if (n_threads > 0) {
+        writer->threads = (pthread_t*)malloc(n_threads * sizeof(pthread_t));
+        if (!writer->threads) {
+            free(writer);
+            return NULL;
+        }
+        for (int t = 0; t < n_threads; t++) {
+            if (pthread_create(&writer->threads[t], NULL, writer_thread, writer) != 0) {
+                fprintf(stderr, "Warning: Started only %d I/O threads\n", t);
+                break;
+            }
+            writer->n_threads++;
+        }
+    }
+    
+    return writer;
+}
+
+int async_writer_submit(AsyncWriter* writer, AsyncWriteFn write,
+                        AsyncReleaseFn release, void* payload, size_t bytes) {
+    AsyncTask* task = (AsyncTask*)malloc(sizeof(AsyncTask));
+    
+    // Sans thread (ou sans mémoire pour la tâche): écriture immédiate
+    if (!writer || writer->n_threads == 0 || !task) {
+        free(task);
+        AsyncTask sync_task = {write, release, payload, bytes, NULL};
+        double start = wall_time();
+        run_task(&sync_task);
+        if (writer) writer->busy_time += wall_time() - start;
+        return 0;
+    }
+    
+    task->write = write;
+    task->release = release;
+    task->payload = payload;
+    task->bytes = bytes;
+    task->next = NULL;
+    
+    pthread_mutex_lock(&writer->lock);
+    
+    // Back-pressure: on attend que le budget le permette
+    // (une tâche plus grosse que le budget passe seule)
+    double start = wall_time();
+    while (writer->active_tasks > 0 &&
+           writer->pending_bytes + bytes > writer->max_pending_bytes) {
+        pthread_cond_wait(&writer->space_available, &writer->lock);
+    }
+    writer->stall_time += wall_time() - start;
+    
+    if (writer->tail) writer->tail->next = task;
+    else writer->head = task;
+    writer->tail = task;
+    writer->pending_bytes += bytes;
+    writer->active_tasks++;
+    
+    pthread_cond_signal(&writer->work_available);
+    pthread_mutex_unlock(&writer->lock);
+    
+    return 0;
+}
+
+void async_writer_barrier(AsyncWriter* writer) {
+    if (!writer) return;
+    
+    pthread_mutex_lock(&writer->lock);
+    while (writer->active_tasks > 0) {
+        pthread_cond_wait(&writer->idle, &writer->lock);
+    }
+    pthread_mutex_unlock(&writer->lock);
+}
+
+void async_writer_destroy(AsyncWriter* writer) {
+    if (!writer) return;
+    
+    async_writer_barrier(writer);
+    
+    pthread_mutex_lock(&writer->lock);
+    writer->shutdown = 1;
+    pthread_cond_broadcast(&writer->work_available);
+    pthread_mutex_unlock(&writer->lock);
+    
+    for (int t = 0; t < writer->n_threads; t++) {
+        pthread_join(writer->threads[t], NULL);
+    }
+    
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->work_available);
+    pthread_cond_destroy(&writer->space_available);
+    pthread_cond_destroy(&writer->idle);
+    free(writer->threads);
+    free(writer);
+}
+
+double async_writer_busy_time(AsyncWriter* writer) {
+    return writer ? writer->busy_time : 0.0;
+}
+
+double async_writer_stall_time(AsyncWriter* writer) {
+    return writer ? writer->stall_time : 0.0;
+}
+
+int async_writer_pending(AsyncWriter* writer) {
+    if (!writer) return 0;
+    
+    pthread_mutex_lock(&writer->lock);
+    int pending = writer->active_tasks;
+    pthread_mutex_unlock(&writer->lock);
+    return pending;
+}
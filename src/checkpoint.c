@@ -0,0 +1,234 @@
+#include "checkpoint.h"
+#include "npy_io.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CHECKPOINT_MAGIC "MEMBCKP1"
+#define CHECKPOINT_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_requested;
+    uint64_t n_dof;
+    uint32_t block_size;
+    uint32_t n_locked;
+    uint32_t has_directions;
+    uint32_t iteration;
+    double eps;
+    uint64_t data_bytes;
+    uint32_t data_crc;
+    uint32_t reserved;
+} CheckpointHeader;
+
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+SolverCheckpoint* checkpoint_create(int n, int n_requested, int block_size,
+                                    int n_locked, int has_directions) {
+    SolverCheckpoint* checkpoint = (SolverCheckpoint*)calloc(1, sizeof(SolverCheckpoint));
+    if (!checkpoint) {
+        fprintf(stderr, "Error: Failed to allocate checkpoint\n");
+        return NULL;
+    }
+    
+    checkpoint->n = n;
+    checkpoint->n_requested = n_requested;
+    checkpoint->block_size = block_size;
+    checkpoint->n_locked = n_locked;
+    checkpoint->has_directions = has_directions;
+    
+    size_t m = (size_t)block_size;
+    size_t l = (size_t)n_locked;
+    size_t count = m + 2 * l + (size_t)n * (m * (has_directions ? 2 : 1) + l);
+    checkpoint->data_bytes = count * sizeof(double);
+    checkpoint->data = (double*)malloc(checkpoint->data_bytes > 0 ? checkpoint->data_bytes : 1);
+    if (!checkpoint->data) {
+        fprintf(stderr, "Error: Failed to allocate checkpoint data (%zu bytes)\n",
+                checkpoint->data_bytes);
+        free(checkpoint);
+        return NULL;
+    }
+    
+    // Même ordre que dans le fichier
+    double* cursor = checkpoint->data;
+    checkpoint->ritz_values = cursor;       cursor += m;
+    checkpoint->locked_values = cursor;     cursor += l;
+    checkpoint->locked_residuals = cursor;  cursor += l;
+    checkpoint->X = cursor;                 cursor += (size_t)n * m;
+    if (has_directions) {
+        checkpoint->P = cursor;             cursor += (size_t)n * m;
+    }
+    checkpoint->locked = cursor;
+    
+    return checkpoint;
+}
+
+void free_checkpoint(SolverCheckpoint* checkpoint) {
+    if (!checkpoint) return;
+    free(checkpoint->data);
+    free(checkpoint);
+}
+
+int checkpoint_save(const SolverCheckpoint* checkpoint, const char* filename) {
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, 8);
+    header.version = CHECKPOINT_VERSION;
+    header.n_requested = (uint32_t)checkpoint->n_requested;
+    header.n_dof = (uint64_t)checkpoint->n;
+    header.block_size = (uint32_t)checkpoint->block_size;
+    header.n_locked = (uint32_t)checkpoint->n_locked;
+    header.has_directions = (uint32_t)checkpoint->has_directions;
+    header.iteration = (uint32_t)checkpoint->iteration;
+    header.eps = checkpoint->eps;
+    header.data_bytes = checkpoint->data_bytes;
+    header.data_crc = crc32_update(0, checkpoint->data, checkpoint->data_bytes);
+    
+    char tmp_path[1024];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", filename);
+    FILE* file = fopen(tmp_path, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open checkpoint file %s\n", tmp_path);
+        return -1;
+    }
+    
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(checkpoint->data, 1, checkpoint->data_bytes, file) == checkpoint->data_bytes &&
+             fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (fclose(file) != 0) ok = 0;
+    
+    if (!ok || rename(tmp_path, filename) != 0) {
+        fprintf(stderr, "Error: Failed to write checkpoint %s\n", filename);
+        unlink(tmp_path);
+        return -1;
+    }
+    
+    return 0;
+}
+
+SolverCheckpoint* checkpoint_load(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open checkpoint %s\n", filename);
+        return NULL;
+    }
+    
+    CheckpointHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, CHECKPOINT_MAGIC, 8) != 0 ||
+        header.version != CHECKPOINT_VERSION) {
+        fprintf(stderr, "Error: %s is not a solver checkpoint\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    
+    SolverCheckpoint* checkpoint = checkpoint_create((int)header.n_dof, (int)header.n_requested,
+                                                     (int)header.block_size, (int)header.n_locked,
+                                                     (int)header.has_directions);
+    if (!checkpoint) {
+        fclose(file);
+        return NULL;
+    }
+    
+    if (checkpoint->data_bytes != header.data_bytes ||
+        fread(checkpoint->data, 1, checkpoint->data_bytes, file) != checkpoint->data_bytes) {
+        fprintf(stderr, "Error: Truncated checkpoint %s\n", filename);
+        fclose(file);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+    fclose(file);
+    
+    if (crc32_update(0, checkpoint->data, checkpoint->data_bytes) != header.data_crc) {
+        fprintf(stderr, "Error: Checksum mismatch in checkpoint %s\n", filename);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+    
+    checkpoint->iteration = (int)header.iteration;
+    checkpoint->eps = header.eps;
+    return checkpoint;
+}
+
+// ============ ECRITURE ASYNCHRONE ============
+
+typedef struct {
+    CheckpointWriter* owner;
+    SolverCheckpoint* checkpoint;
+} CheckpointTask;
+
+static void write_checkpoint_task(void* payload) {
+    CheckpointTask* task = (CheckpointTask*)payload;
+    if (checkpoint_save(task->checkpoint, task->owner->filename) == 0) {
+        // Un seul thread d'écriture: compteurs lus après la barrière
+        task->owner->n_written++;
+        task->owner->bytes_written += sizeof(CheckpointHeader) + task->checkpoint->data_bytes;
+    }
+}
+
+static void release_checkpoint_task(void* payload) {
+    CheckpointTask* task = (CheckpointTask*)payload;
+    free_checkpoint(task->checkpoint);
+    free(task);
+}
+
+CheckpointWriter* checkpoint_writer_create(const char* filename) {
+    CheckpointWriter* writer = (CheckpointWriter*)calloc(1, sizeof(CheckpointWriter));
+    if (!writer) return NULL;
+    
+    writer->filename = filename;
+    writer->writer = async_writer_create(1, (size_t)-1);
+    if (!writer->writer) {
+        free(writer);
+        return NULL;
+    }
+    
+    return writer;
+}
+
+int checkpoint_writer_submit(CheckpointWriter* writer, SolverCheckpoint* checkpoint) {
+    // Au plus un état en vol: on ne bloque jamais les itérations
+    if (async_writer_pending(writer->writer) > 0) {
+        writer->n_skipped++;
+        free_checkpoint(checkpoint);
+        return 1;
+    }
+    
+    CheckpointTask* task = (CheckpointTask*)malloc(sizeof(CheckpointTask));
+    if (!task) {
+        free_checkpoint(checkpoint);
+        return -1;
+    }
+    task->owner = writer;
+    task->checkpoint = checkpoint;
+    
+    async_writer_submit(writer->writer, write_checkpoint_task, release_checkpoint_task,
+                        task, checkpoint->data_bytes);
+    return 0;
+}
+
+void checkpoint_writer_destroy(CheckpointWriter* writer) {
+    if (!writer) return;
+    
+    double start = wall_time();
+    async_writer_barrier(writer->writer);
+    double final_wait = wall_time() - start;
+    
+    printf("Checkpoints: %d written (%.1f MB) to %s, %d skipped while busy\n",
+           writer->n_written, writer->bytes_written / 1048576.0, writer->filename,
+           writer->n_skipped);
+    printf("Checkpoint cost: %.3f s snapshot on solver thread, %.3f s background write, "
+           "%.3f s final wait\n", writer->snapshot_time,
+           async_writer_busy_time(writer->writer), final_wait);
+    
+    async_writer_destroy(writer->writer);
+    free(writer);
+}
@@ -0,0 +1,619 @@
+#include "expression.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <omp.h>
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+#define EXPR_MAX_NODES 512
+#define EXPR_MAX_ARGS 2
+
+// Registres réservés
+#define REG_X 0
+#define REG_Y 1
+
+typedef enum {
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_NEG, OP_SQR,
+    OP_SIN, OP_COS, OP_TAN, OP_EXP, OP_LOG, OP_SQRT, OP_ABS,
+    OP_TANH, OP_SINH, OP_COSH, OP_ATAN, OP_ATAN2, OP_MIN, OP_MAX, OP_COPY
+} ExprOp;
+
+typedef enum { NODE_CONST, NODE_X, NODE_Y, NODE_OP } NodeType;
+
+typedef struct {
+    NodeType type;
+    ExprOp op;
+    double value;
+    int args[EXPR_MAX_ARGS];
+} ExprNode;
+
+typedef struct {
+    unsigned char op;
+    unsigned short dst;
+    unsigned short a;
+    unsigned short b;
+} ExprInstr;
+
+struct CoeffExpr {
+    char* source;
+    ExprInstr* code;
+    int n_code;
+    double* constants;     // Valeurs des registres constants
+    int n_constants;       // Registres 2 .. 2+n_constants-1
+    int n_registers;       // Total (x, y, constantes, temporaires)
+};
+
+// ============ ANALYSE SYNTAXIQUE ============
+
+typedef struct {
+    const char* src;
+    const char* pos;
+    ExprNode nodes[EXPR_MAX_NODES];
+    int n_nodes;
+    char* error;
+    size_t error_size;
+    int failed;
+} Parser;
+
+typedef struct {
+    const char* name;
+    ExprOp op;
+    int n_args;
+} FunctionDef;
+
+static const FunctionDef functions[] = {
+    {"sin", OP_SIN, 1},   {"cos", OP_COS, 1},   {"tan", OP_TAN, 1},
+    {"exp", OP_EXP, 1},   {"log", OP_LOG, 1},   {"sqrt", OP_SQRT, 1},
+    {"abs", OP_ABS, 1},   {"tanh", OP_TANH, 1}, {"sinh", OP_SINH, 1},
+    {"cosh", OP_COSH, 1}, {"atan", OP_ATAN, 1}, {"atan2", OP_ATAN2, 2},
+    {"pow", OP_POW, 2},   {"min", OP_MIN, 2},   {"max", OP_MAX, 2}
+};
+
+static void parse_error(Parser* p, const char* message) {
+    if (p->failed) return;
+    p->failed = 1;
+    if (p->error && p->error_size > 0) {
+        snprintf(p->error, p->error_size, "%s at column %d in '%s'",
+                 message, (int)(p->pos - p->src) + 1, p->src);
+    }
+}
+
+static int new_node(Parser* p, NodeType type) {
+    if (p->n_nodes >= EXPR_MAX_NODES) {
+        parse_error(p, "Expression too long");
+        return 0;
+    }
+    ExprNode* node = &p->nodes[p->n_nodes];
+    memset(node, 0, sizeof(ExprNode));
+    node->type = type;
+    return p->n_nodes++;
+}
+
+static void skip_spaces(Parser* p) {
+    while (isspace((unsigned char)*p->pos)) p->pos++;
+}
+
+static double apply_op(ExprOp op, double a, double b) {
+    switch (op) {
+        case OP_ADD:   return a + b;
+        case OP_SUB:   return a - b;
+        case OP_MUL:   return a * b;
+        case OP_DIV:   return a / b;
+        case OP_POW:   return pow(a, b);
+        case OP_NEG:   return -a;
+        case OP_SQR:   return a * a;
+        case OP_SIN:   return sin(a);
+        case OP_COS:   return cos(a);
+        case OP_TAN:   return tan(a);
+        case OP_EXP:   return exp(a);
+        case OP_LOG:   return log(a);
+        case OP_SQRT:  return sqrt(a);
+        case OP_ABS:   return fabs(a);
+        case OP_TANH:  return tanh(a);
+        case OP_SINH:  return sinh(a);
+        case OP_COSH:  return cosh(a);
+        case OP_ATAN:  return atan(a);
+        case OP_ATAN2: return atan2(a, b);
+        case OP_MIN:   return a < b ? a : b;
+        case OP_MAX:   return a > b ? a : b;
+        case OP_COPY:  return a;
+    }
+    return 0.0;
+}
+
+static int op_arity(ExprOp op) {
+    switch (op) {
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_POW:
+        case OP_ATAN2: case OP_MIN: case OP_MAX:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+// Création d'un noeud opération avec repliement des constantes
+static int make_op(Parser* p, ExprOp op, int a, int b) {
+    if (p->failed) return 0;
+    int binary = op_arity(op) == 2;
+
+    if (p->nodes[a].type == NODE_CONST &&
+        (!binary || p->nodes[b].type == NODE_CONST)) {
+        double value = apply_op(op, p->nodes[a].value,
+                                binary ? p->nodes[b].value : 0.0);
+        int id = new_node(p, NODE_CONST);
+        p->nodes[id].value = value;
+        return id;
+    }
+
+    // a^2 -> a*a (cas très fréquent dans les profils gaussiens)
+    if (op == OP_POW && p->nodes[b].type == NODE_CONST && p->nodes[b].value == 2.0) {
+        op = OP_SQR;
+        binary = 0;
+    }
+
+    int id = new_node(p, NODE_OP);
+    p->nodes[id].op = op;
+    p->nodes[id].args[0] = a;
+    p->nodes[id].args[1] = binary ? b : a;
+    return id;
+}
+
+static int parse_expr(Parser* p);
+static int parse_unary(Parser* p);
+
+static int parse_primary(Parser* p) {
+    skip_spaces(p);
+    if (p->failed) return 0;
+
+    const char* c = p->pos;
+
+    if (isdigit((unsigned char)*c) || *c == '.') {
+        char* end;
+        double value = strtod(c, &end);
+        if (end == c) {
+            parse_error(p, "Invalid number");
+            return 0;
+        }
+        p->pos = end;
+        int id = new_node(p, NODE_CONST);
+        p->nodes[id].value = value;
+        return id;
+    }
+
+    if (*c == '(') {
+        p->pos++;
+        int id = parse_expr(p);
+        skip_spaces(p);
+        if (*p->pos != ')') {
+            parse_error(p, "Expected ')'");
+            return 0;
+        }
+        p->pos++;
+        return id;
+    }
+
+    if (isalpha((unsigned char)*c) || *c == '_') {
+        char name[32];
+        size_t len = 0;
+        while ((isalnum((unsigned char)*p->pos) || *p->pos == '_') && len < sizeof(name) - 1) {
+            name[len++] = *p->pos++;
+        }
+        name[len] = '\0';
+        skip_spaces(p);
+
+        if (*p->pos == '(') {
+            for (size_t f = 0; f < sizeof(functions) / sizeof(functions[0]); f++) {
+                if (strcmp(functions[f].name, name) != 0) continue;
+
+                p->pos++;
+                int args[EXPR_MAX_ARGS] = {0, 0};
+                for (int a = 0; a < functions[f].n_args; a++) {
+                    if (a > 0) {
+                        skip_spaces(p);
+                        if (*p->pos != ',') {
+                            parse_error(p, "Expected ','");
+                            return 0;
+                        }
+                        p->pos++;
+                    }
+                    args[a] = parse_expr(p);
+                }
+                skip_spaces(p);
+                if (*p->pos != ')') {
+                    parse_error(p, "Expected ')' after function arguments");
+                    return 0;
+                }
+                p->pos++;
+                return make_op(p, functions[f].op, args[0], args[1]);
+            }
+            parse_error(p, "Unknown function");
+            return 0;
+        }
+
+        if (strcmp(name, "x") == 0) return new_node(p, NODE_X);
+        if (strcmp(name, "y") == 0) return new_node(p, NODE_Y);
+        if (strcmp(name, "pi") == 0 || strcmp(name, "e") == 0) {
+            int id = new_node(p, NODE_CONST);
+            p->nodes[id].value = (name[0] == 'p') ? PI : exp(1.0);
+            return id;
+        }
+        parse_error(p, "Unknown identifier");
+        return 0;
+    }
+
+    parse_error(p, *c ? "Unexpected character" : "Unexpected end of expression");
+    return 0;
+}
+
+static int parse_power(Parser* p) {
+    int base = parse_primary(p);
+    skip_spaces(p);
+    if (*p->pos == '^') {
+        p->pos++;
+        int exponent = parse_unary(p);   // associativité à droite
+        return make_op(p, OP_POW, base, exponent);
+    }
+    return base;
+}
+
+static int parse_unary(Parser* p) {
+    skip_spaces(p);
+    if (*p->pos == '-') {
+        p->pos++;
+        int a = parse_unary(p);
+        return make_op(p, OP_NEG, a, a);
+    }
+    if (*p->pos == '+') {
+        p->pos++;
+        return parse_unary(p);
+    }
+    return parse_power(p);
+}
+
+static int parse_term(Parser* p) {
+    int left = parse_unary(p);
+    for (;;) {
+        skip_spaces(p);
+        char c = *p->pos;
+        if (c != '*' && c != '/') break;
+        p->pos++;
+        int right = parse_unary(p);
+        left = make_op(p, c == '*' ? OP_MUL : OP_DIV, left, right);
+    }
+    return left;
+}
+
+static int parse_expr(Parser* p) {
+    int left = parse_term(p);
+    for (;;) {
+        skip_spaces(p);
+        char c = *p->pos;
+        if (c != '+' && c != '-') break;
+        p->pos++;
+        int right = parse_term(p);
+        left = make_op(p, c == '+' ? OP_ADD : OP_SUB, left, right);
+    }
+    return left;
+}
+
+// ============ GENERATION DU BYTECODE ============
+
+typedef struct {
+    const Parser* parser;
+    CoeffExpr* expr;
+    int code_capacity;
+    int const_capacity;
+    int n_temps;          // Temporaires actuellement utilisés
+    int max_temps;
+} Compiler;
+
+static int constant_register(Compiler* c, double value) {
+    CoeffExpr* e = c->expr;
+    for (int i = 0; i < e->n_constants; i++) {
+        if (e->constants[i] == value) return 2 + i;
+    }
+    if (e->n_constants == c->const_capacity) {
+        c->const_capacity = c->const_capacity ? 2 * c->const_capacity : 8;
+        double* grown = (double*)realloc(e->constants, c->const_capacity * sizeof(double));
+        if (!grown) return -1;
+        e->constants = grown;
+    }
+    e->constants[e->n_constants] = value;
+    return 2 + e->n_constants++;
+}
+
+// Les temporaires sont numérotés à part puis décalés après les constantes
+#define TEMP_FLAG 0x8000
+
+static int emit(Compiler* c, int node_id) {
+    const ExprNode* node = &c->parser->nodes[node_id];
+
+    switch (node->type) {
+        case NODE_X:     return REG_X;
+        case NODE_Y:     return REG_Y;
+        case NODE_CONST: return constant_register(c, node->value);
+        case NODE_OP:    break;
+    }
+
+    int binary = op_arity(node->op) == 2;
+    int a = emit(c, node->args[0]);
+    int b = binary ? emit(c, node->args[1]) : a;
+    if (a < 0 || b < 0) return -1;
+
+    // Libération des temporaires des opérandes (discipline de pile)
+    if (binary && (b & TEMP_FLAG)) c->n_temps--;
+    if (a & TEMP_FLAG) c->n_temps--;
+    int dst = TEMP_FLAG | c->n_temps++;
+    if (c->n_temps > c->max_temps) c->max_temps = c->n_temps;
+
+    CoeffExpr* e = c->expr;
+    if (e->n_code == c->code_capacity) {
+        c->code_capacity = c->code_capacity ? 2 * c->code_capacity : 16;
+        ExprInstr* grown = (ExprInstr*)realloc(e->code, c->code_capacity * sizeof(ExprInstr));
+        if (!grown) return -1;
+        e->code = grown;
+    }
+    ExprInstr* ins = &e->code[e->n_code++];
+    ins->op = (unsigned char)node->op;
+    ins->dst = (unsigned short)dst;
+    ins->a = (unsigned short)a;
+    ins->b = (unsigned short)b;
+    return dst;
+}
+
+CoeffExpr* coeff_expr_compile(const char* source, char* error, size_t error_size) {
+    if (error && error_size > 0) error[0] = '\0';
+    if (!source) return NULL;
+
+    Parser* p = (Parser*)calloc(1, sizeof(Parser));
+    CoeffExpr* expr = (CoeffExpr*)calloc(1, sizeof(CoeffExpr));
+    if (!p || !expr) {
+        free(p);
+        free(expr);
+        return NULL;
+    }
+
+    p->src = source;
+    p->pos = source;
+    p->error = error;
+    p->error_size = error_size;
+
+    int root = parse_expr(p);
+    skip_spaces(p);
+    if (!p->failed && *p->pos != '\0') {
+        parse_error(p, "Unexpected trailing input");
+    }
+    if (p->failed) {
+        free(p);
+        free_coeff_expr(expr);
+        return NULL;
+    }
+
+    expr->source = (char*)malloc(strlen(source) + 1);
+    if (expr->source) strcpy(expr->source, source);
+
+    Compiler c = {p, expr, 0, 0, 0, 0};
+    int result = emit(&c, root);
+    free(p);
+
+    if (result < 0 || !expr->source) {
+        free_coeff_expr(expr);
+        return NULL;
+    }
+
+    // Expression réduite à une feuille: copie explicite dans un temporaire
+    if (!(result & TEMP_FLAG)) {
+        ExprInstr* grown = (ExprInstr*)realloc(expr->code, (expr->n_code + 1) * sizeof(ExprInstr));
+        if (!grown) {
+            free_coeff_expr(expr);
+            return NULL;
+        }
+        expr->code = grown;
+        ExprInstr* ins = &expr->code[expr->n_code++];
+        ins->op = OP_COPY;
+        ins->dst = TEMP_FLAG;
+        ins->a = (unsigned short)result;
+        ins->b = (unsigned short)result;
+        c.max_temps = c.max_temps > 1 ? c.max_temps : 1;
+    }
+
+    // Renumérotation des temporaires après x, y et les constantes
+    int temp_base = 2 + expr->n_constants;
+    for (int i = 0; i < expr->n_code; i++) {
+        ExprInstr* ins = &expr->code[i];
+        if (ins->dst & TEMP_FLAG) ins->dst = (unsigned short)(temp_base + (ins->dst & ~TEMP_FLAG));
+        if (ins->a & TEMP_FLAG) ins->a = (unsigned short)(temp_base + (ins->a & ~TEMP_FLAG));
+        if (ins->b & TEMP_FLAG) ins->b = (unsigned short)(temp_base + (ins->b & ~TEMP_FLAG));
+    }
+    expr->n_registers = temp_base + c.max_temps;
+
+    return expr;
+}
+
+void free_coeff_expr(CoeffExpr* expr) {
+    if (!expr) return;
+    free(expr->source);
+    free(expr->code);
+    free(expr->constants);
+    free(expr);
+}
+
+const char* coeff_expr_source(const CoeffExpr* expr) {
+    return expr ? expr->source : NULL;
+}
+
+int coeff_expr_n_instructions(const CoeffExpr* expr) {
+    return expr ? expr->n_code : 0;
+}
+
+// ============ EVALUATION PAR BLOCS ============
+
+// Banc de registres d'un thread: n_registers blocs alignés de EXPR_BLOCK_SIZE
+static double* create_register_file(const CoeffExpr* expr) {
+    double* regs = NULL;
+    size_t bytes = (size_t)expr->n_registers * EXPR_BLOCK_SIZE * sizeof(double);
+    if (posix_memalign((void**)&regs, 64, bytes) != 0) return NULL;
+
+    // Les constantes sont diffusées une seule fois par thread
+    for (int c = 0; c < expr->n_constants; c++) {
+        double* r = regs + (size_t)(2 + c) * EXPR_BLOCK_SIZE;
+        for (int k = 0; k < EXPR_BLOCK_SIZE; k++) r[k] = expr->constants[c];
+    }
+    return regs;
+}
+
+// Exécute le bytecode sur len points (x et y déjà chargés), renvoie le résultat
+static const double* run_block(const CoeffExpr* expr, double* regs, int len) {
+    const ExprInstr* code = expr->code;
+
+    for (int i = 0; i < expr->n_code; i++) {
+        double* d = regs + (size_t)code[i].dst * EXPR_BLOCK_SIZE;
+        const double* a = regs + (size_t)code[i].a * EXPR_BLOCK_SIZE;
+        const double* b = regs + (size_t)code[i].b * EXPR_BLOCK_SIZE;
+
+        switch ((ExprOp)code[i].op) {
+            case OP_ADD:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = a[k] + b[k];
+                break;
+            case OP_SUB:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = a[k] - b[k];
+                break;
+            case OP_MUL:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = a[k] * b[k];
+                break;
+            case OP_DIV:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = a[k] / b[k];
+                break;
+            case OP_NEG:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = -a[k];
+                break;
+            case OP_SQR:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = a[k] * a[k];
+                break;
+            case OP_ABS:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = fabs(a[k]);
+                break;
+            case OP_SQRT:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = sqrt(a[k]);
+                break;
+            case OP_MIN:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = a[k] < b[k] ? a[k] : b[k];
+                break;
+            case OP_MAX:
+                #pragma omp simd
+                for (int k = 0; k < len; k++) d[k] = a[k] > b[k] ? a[k] : b[k];
+                break;
+            case OP_COPY:
+                memcpy(d, a, len * sizeof(double));
+                break;
+            case OP_SIN:   for (int k = 0; k < len; k++) d[k] = sin(a[k]); break;
+            case OP_COS:   for (int k = 0; k < len; k++) d[k] = cos(a[k]); break;
+            case OP_TAN:   for (int k = 0; k < len; k++) d[k] = tan(a[k]); break;
+            case OP_EXP:   for (int k = 0; k < len; k++) d[k] = exp(a[k]); break;
+            case OP_LOG:   for (int k = 0; k < len; k++) d[k] = log(a[k]); break;
+            case OP_TANH:  for (int k = 0; k < len; k++) d[k] = tanh(a[k]); break;
+            case OP_SINH:  for (int k = 0; k < len; k++) d[k] = sinh(a[k]); break;
+            case OP_COSH:  for (int k = 0; k < len; k++) d[k] = cosh(a[k]); break;
+            case OP_ATAN:  for (int k = 0; k < len; k++) d[k] = atan(a[k]); break;
+            case OP_ATAN2: for (int k = 0; k < len; k++) d[k] = atan2(a[k], b[k]); break;
+            case OP_POW:   for (int k = 0; k < len; k++) d[k] = pow(a[k], b[k]); break;
+        }
+    }
+
+    return regs + (size_t)code[expr->n_code - 1].dst * EXPR_BLOCK_SIZE;
+}
+
+int coeff_expr_eval_grid(const CoeffExpr* expr, const double* x,
+                          const double* y, int N, double* out) {
+    int blocks_per_row = (N + EXPR_BLOCK_SIZE - 1) / EXPR_BLOCK_SIZE;
+    long n_blocks = (long)N * blocks_per_row;
+
+    int failed = 0;
+    #pragma omp parallel
+    {
+        double* regs = create_register_file(expr);
+        if (!regs) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+
+        // Un thread sans registres laisse ses blocs: le résultat entier est alors rejeté
+        #pragma omp for schedule(static)
+        for (long blk = 0; blk < n_blocks; blk++) {
+            if (!regs) continue;
+            int i = (int)(blk / blocks_per_row);
+            int j0 = (int)(blk % blocks_per_row) * EXPR_BLOCK_SIZE;
+            int len = (N - j0 < EXPR_BLOCK_SIZE) ? N - j0 : EXPR_BLOCK_SIZE;
+
+            // Un bloc = un segment de ligne: x constant, y contigu
+            double* rx = regs + REG_X * EXPR_BLOCK_SIZE;
+            double* ry = regs + REG_Y * EXPR_BLOCK_SIZE;
+            for (int k = 0; k < len; k++) {
+                rx[k] = x[i];
+                ry[k] = y[j0 + k];
+            }
+
+            const double* result = run_block(expr, regs, len);
+            memcpy(out + (size_t)i * N + j0, result, len * sizeof(double));
+        }
+
+        free(regs);
+    }
+
+    if (failed) {
+        fprintf(stderr, "Error: Cannot allocate expression registers\n");
+        return -1;
+    }
+    return 0;
+}
+
+int coeff_expr_eval_points(const CoeffExpr* expr, const double* x,
+                            const double* y, int n_points, double* out) {
+    long n_blocks = (n_points + EXPR_BLOCK_SIZE - 1) / EXPR_BLOCK_SIZE;
+
+    int failed = 0;
+    #pragma omp parallel
+    {
+        double* regs = create_register_file(expr);
+        if (!regs) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+
+        // Un thread sans registres laisse ses blocs: le résultat entier est alors rejeté
+        #pragma omp for schedule(static)
+        for (long blk = 0; blk < n_blocks; blk++) {
+            if (!regs) continue;
+            int k0 = (int)blk * EXPR_BLOCK_SIZE;
+            int len = (n_points - k0 < EXPR_BLOCK_SIZE) ? n_points - k0 : EXPR_BLOCK_SIZE;
+
+            memcpy(regs + REG_X * EXPR_BLOCK_SIZE, x + k0, len * sizeof(double));
+            memcpy(regs + REG_Y * EXPR_BLOCK_SIZE, y + k0, len * sizeof(double));
+
+            const double* result = run_block(expr, regs, len);
+            memcpy(out + k0, result, len * sizeof(double));
+        }
+
+        free(regs);
+    }
+
+    if (failed) {
+        fprintf(stderr, "Error: Cannot allocate expression registers\n");
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,393 @@
+#include "frf.h"
+#include "planner.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mkl/mkl.h>
+
+#define FRF_CG_TOLERANCE 1e-12         // Résidu relatif du gradient conjugué (repli)
+#define FRF_CG_MAX_ITERATIONS 20000
+
+static int check_problem(int n, const FrfProblem* problem) {
+    if (problem->n_sensors < 1 || problem->n_actuators < 1 || problem->damping < 0.0) {
+        fprintf(stderr, "Error: FRF needs at least one sensor, one actuator and damping >= 0\n");
+        return -1;
+    }
+    for (int s = 0; s < problem->n_sensors; s++) {
+        if (problem->sensors[s] < 0 || problem->sensors[s] >= n) {
+            fprintf(stderr, "Error: Sensor %d is outside the operator\n", s + 1);
+            return -1;
+        }
+    }
+    for (int a = 0; a < problem->n_actuators; a++) {
+        if (problem->actuators[a] < 0 || problem->actuators[a] >= n) {
+            fprintf(stderr, "Error: Actuator %d is outside the operator\n", a + 1);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Seconds membres e_a x charge nodale, n x n_actuators colonne-major
+static void fill_point_loads(int n, const FrfProblem* problem, double* X, int complex_values) {
+    int stride = complex_values ? 2 : 1;
+    memset(X, 0, (size_t)n * problem->n_actuators * stride * sizeof(double));
+    for (int a = 0; a < problem->n_actuators; a++) {
+        X[((size_t)a * n + problem->actuators[a]) * stride] = problem->point_load;
+    }
+}
+
+// Gradient conjugué préconditionné par la diagonale (A SPD), les colonnes de X ensemble:
+// B -> X = A⁻¹ B. 0 si toutes les colonnes convergent en moins de FRF_CG_MAX_ITERATIONS
+static int flexibility_cg(const SparseMatrixCSR* A, int n_rhs, const double* B, double* X) {
+    int n = (int)A->n_rows;
+    size_t size = (size_t)n * n_rhs;
+    LinearOperator op = csr_operator(A);
+    double* R = (double*)mkl_malloc(size * sizeof(double), 64);
+    double* Z = (double*)mkl_malloc(size * sizeof(double), 64);
+    double* P = (double*)mkl_malloc(size * sizeof(double), 64);
+    double* Q = (double*)mkl_malloc(size * sizeof(double), 64);
+    double* inv_diagonal = (double*)malloc((size_t)n * sizeof(double));
+    double* rz = (double*)malloc((size_t)n_rhs * 3 * sizeof(double));
+    if (!R || !Z || !P || !Q || !inv_diagonal || !rz) {
+        fprintf(stderr, "Error: Failed to allocate the iterative static solve\n");
+        mkl_free(R);
+        mkl_free(Z);
+        mkl_free(P);
+        mkl_free(Q);
+        free(inv_diagonal);
+        free(rz);
+        return -1;
+    }
+    double* target = rz + n_rhs;     // (tol |b|)² par colonne
+    double* active = rz + 2 * n_rhs; // 1 tant que la colonne n'a pas convergé
+    
+    for (int i = 0; i < n; i++) {
+        double d = 0.0;
+        for (MKL_INT p = A->row_index[i]; p < A->row_index[i + 1]; p++) {
+            if (A->columns[p] == i) d += A->values[p];
+        }
+        inv_diagonal[i] = d > 0.0 ? 1.0 / d : 1.0;
+    }
+    memset(X, 0, size * sizeof(double));
+    memcpy(R, B, size * sizeof(double));
+    int remaining = 0;
+    for (int c = 0; c < n_rhs; c++) {
+        double* r = R + (size_t)c * n;
+        double norm = cblas_dnrm2(n, r, 1);
+        target[c] = FRF_CG_TOLERANCE * FRF_CG_TOLERANCE * norm * norm;
+        active[c] = norm > 0.0;
+        remaining += norm > 0.0;
+        for (int i = 0; i < n; i++) Z[(size_t)c * n + i] = inv_diagonal[i] * r[i];
+        rz[c] = cblas_ddot(n, r, 1, Z + (size_t)c * n, 1);
+    }
+    memcpy(P, Z, size * sizeof(double));
+    
+    int iterations = 0;
+    while (remaining > 0 && iterations < FRF_CG_MAX_ITERATIONS) {
+        op.apply(op.data, n_rhs, P, Q);
+        iterations++;
+        remaining = 0;
+        for (int c = 0; c < n_rhs; c++) {
+            if (!active[c]) continue;
+            double* x = X + (size_t)c * n;
+            double* r = R + (size_t)c * n;
+            double* z = Z + (size_t)c * n;
+            double* p = P + (size_t)c * n;
+            double* q = Q + (size_t)c * n;
+            double alpha = rz[c] / cblas_ddot(n, p, 1, q, 1);
+            cblas_daxpy(n, alpha, p, 1, x, 1);
+            cblas_daxpy(n, -alpha, q, 1, r, 1);
+            if (cblas_ddot(n, r, 1, r, 1) <= target[c]) {
+                active[c] = 0.0;
+                continue;
+            }
+            for (int i = 0; i < n; i++) z[i] = inv_diagonal[i] * r[i];
+            double rz_next = cblas_ddot(n, r, 1, z, 1);
+            double beta = rz_next / rz[c];
+            rz[c] = rz_next;
+            for (int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+            remaining++;
+        }
+    }
+    profiler_add_work((double)iterations * n_rhs * (2.0 * A->nnz + 12.0 * n),
+                      (double)iterations * ((double)A->nnz * 12.0 + 8.0 * size * sizeof(double)));
+    
+    mkl_free(R);
+    mkl_free(Z);
+    mkl_free(P);
+    mkl_free(Q);
+    free(inv_diagonal);
+    free(rz);
+    return remaining == 0 ? 0 : 1;
+}
+
+// Flexibilité statique G_sa = (A⁻¹ e_a)_s, tous les actionneurs ensemble: Cholesky bande
+// (DPBTRF, kd + 1 lignes) si le facteur tient dans le budget, gradient conjugué sinon.
+// 0 si G est rempli, 1 si la correction est abandonnée (avertissement), -1 si erreur
+static int static_flexibility(const SparseMatrixCSR* A, const FrfProblem* problem, double* G) {
+    int n = (int)A->n_rows;
+    int kd = csr_bandwidth(A);
+    int ldab = kd + 1;
+    int n_act = problem->n_actuators;
+    size_t budget = problem->memory_budget ? problem->memory_budget : planner_memory_budget();
+    size_t band_bytes = (size_t)ldab * n * sizeof(double);
+    double* X = (double*)mkl_malloc((size_t)n * n_act * sizeof(double), 64);
+    if (!X) {
+        fprintf(stderr, "Error: Failed to allocate the static flexibility solve\n");
+        return -1;
+    }
+    fill_point_loads(n, problem, X, 0);
+    
+    int status;
+    if (band_bytes <= budget) {
+        double* band = (double*)mkl_calloc((size_t)ldab * n, sizeof(double), 64);
+        if (!band) {
+            fprintf(stderr, "Error: Failed to allocate the static flexibility solve\n");
+            mkl_free(X);
+            return -1;
+        }
+        // Triangle supérieur: A(i, j), i <= j, en band[j * ldab + kd + i - j]
+        for (int i = 0; i < n; i++) {
+            for (MKL_INT p = A->row_index[i]; p < A->row_index[i + 1]; p++) {
+                int j = (int)A->columns[p];
+                if (j >= i) band[(size_t)j * ldab + kd + i - j] += A->values[p];
+            }
+        }
+        MKL_INT n_mkl = n, kd_mkl = kd, ldab_mkl = ldab, nrhs = n_act, info;
+        char uplo = 'U';
+        dpbtrf(&uplo, &n_mkl, &kd_mkl, band, &ldab_mkl, &info);
+        if (info == 0) {
+            dpbtrs(&uplo, &n_mkl, &kd_mkl, &nrhs, band, &ldab_mkl, X, &n_mkl, &info);
+        }
+        profiler_add_work(n * (double)kd * (kd + 3.0) + 4.0 * n * (double)kd * n_act,
+                          (double)band_bytes);
+        mkl_free(band);
+        status = info == 0 ? 0 : 1;
+        if (info != 0) {
+            fprintf(stderr, "Warning: Stiffness is not positive definite (DPBTRF/DPBTRS info = "
+                    "%ld), residual flexibility skipped\n", (long)info);
+        }
+    } else {
+        printf("Banded Cholesky for the residual flexibility needs %.1f MB (budget %.1f MB), "
+               "using conjugate gradients\n", band_bytes / 1048576.0, budget / 1048576.0);
+        double* loads = (double*)mkl_malloc((size_t)n * n_act * sizeof(double), 64);
+        status = loads ? 0 : -1;
+        if (loads) {
+            memcpy(loads, X, (size_t)n * n_act * sizeof(double));
+            status = flexibility_cg(A, n_act, loads, X);
+            mkl_free(loads);
+        } else {
+            fprintf(stderr, "Error: Failed to allocate the static flexibility solve\n");
+        }
+        if (status > 0) {
+            fprintf(stderr, "Warning: Conjugate gradients did not reach %.0e in %d iterations, "
+                    "residual flexibility skipped\n", FRF_CG_TOLERANCE, FRF_CG_MAX_ITERATIONS);
+        }
+    }
+    
+    if (status == 0) {
+        for (int s = 0; s < problem->n_sensors; s++) {
+            for (int a = 0; a < n_act; a++) {
+                G[(size_t)s * n_act + a] = X[(size_t)a * n + problem->sensors[s]];
+            }
+        }
+    }
+    mkl_free(X);
+    return status;
+}
+
+int frf_modal(const EigenResults* modes, const LinearOperator* B, const FrfProblem* problem,
+              double* H) {
+    int n = modes->n_dof;
+    int k = modes->n_eigenvalues;
+    int n_pairs = problem->n_sensors * problem->n_actuators;
+    int n_freq = problem->n_frequencies;
+    size_t rows = 2 * (size_t)n_freq;     // Re et Im entrelacés: une FRF complexe par colonne
+    
+    if (check_problem(n, problem) != 0) return -1;
+    if (n_freq < 1) {
+        fprintf(stderr, "Error: FRF needs at least one frequency\n");
+        return -1;
+    }
+    if (B && B->n != n) {
+        fprintf(stderr, "Error: Mass operator size %d does not match the modes (%d)\n", B->n, n);
+        return -1;
+    }
+    for (int i = 0; i < k; i++) {
+        if (!(modes->eigenvalues[i] > 0.0)) {
+            fprintf(stderr, "Error: Mode %d has a non-positive eigenvalue (%g)\n", i + 1,
+                    modes->eigenvalues[i]);
+            return -1;
+        }
+    }
+    
+    double* BPhi = (double*)mkl_malloc((size_t)n * k * sizeof(double), 64);
+    double* P = (double*)mkl_malloc((size_t)k * n_pairs * sizeof(double), 64);
+    double* E = (double*)mkl_malloc(rows * k * sizeof(double), 64);
+    double* G = (double*)malloc((size_t)n_pairs * sizeof(double));
+    if (!BPhi || !P || !E || !G) {
+        fprintf(stderr, "Error: Memory allocation failed for the FRF\n");
+        mkl_free(BPhi);
+        mkl_free(P);
+        mkl_free(E);
+        free(G);
+        return -1;
+    }
+    
+    profiler_begin("frf");
+    int status = 0;
+    
+    // Facteurs de participation P_i,sa = φ_i(s) φ_i(a) f / m_i (k x paires)
+    if (B) B->apply(B->data, k, modes->modes, BPhi);
+    else memcpy(BPhi, modes->modes, (size_t)n * k * sizeof(double));
+    for (int i = 0; i < k; i++) {
+        const double* phi = modes->modes + (size_t)i * n;
+        double mass = cblas_ddot(n, phi, 1, BPhi + (size_t)i * n, 1);
+        for (int s = 0; s < problem->n_sensors; s++) {
+            for (int a = 0; a < problem->n_actuators; a++) {
+                size_t pair = (size_t)s * problem->n_actuators + a;
+                P[pair * k + i] = phi[problem->sensors[s]] * phi[problem->actuators[a]] *
+                                  problem->point_load / mass;
+            }
+        }
+    }
+    
+    // Facteurs dynamiques 1 / d_i(ω), une colonne complexe par mode (2F x k)
+    profiler_begin("frf_modal_sum");
+    double zeta = problem->damping;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < k; i++) {
+        double w2 = modes->eigenvalues[i];
+        double wi = sqrt(w2);
+        double* column = E + (size_t)i * rows;
+        for (int f = 0; f < n_freq; f++) {
+            double w = problem->omegas[f];
+            double re = w2 - w * w;
+            double im = problem->model == FRF_VISCOUS ? 2.0 * zeta * wi * w : 2.0 * zeta * w2;
+            double inv = 1.0 / (re * re + im * im);
+            column[2 * f] = re * inv;
+            column[2 * f + 1] = -im * inv;
+        }
+    }
+    
+    // Somme modale pour toutes les paires et fréquences: H (2F x paires) = E P
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, (MKL_INT)rows, n_pairs, k, 1.0,
+                E, (MKL_INT)rows, P, k, 0.0, H, (MKL_INT)rows);
+    profiler_add_work(2.0 * rows * n_pairs * k + 6.0 * k * n_freq,
+                      ((double)rows * k + (double)k * n_pairs + (double)rows * n_pairs) *
+                          sizeof(double));
+    profiler_end();
+    
+    // Modes tronqués: leur contribution quasi statique A⁻¹ - Σ φφᵀ/(m ω²)
+    int residual_flexibility = problem->A != NULL;
+    if (problem->A) {
+        profiler_begin("frf_residual");
+        status = static_flexibility(problem->A, problem, G);
+        profiler_end();
+        residual_flexibility = status == 0;
+        if (status > 0) status = 0;
+    }
+    if (residual_flexibility) {
+        double eta = 2.0 * zeta;
+        for (int pair = 0; pair < n_pairs; pair++) {
+            double residual = G[pair];
+            for (int i = 0; i < k; i++) {
+                residual -= P[(size_t)pair * k + i] / modes->eigenvalues[i];
+            }
+            // Hystérétique: A⁻¹ (1 + iη)⁻¹ pour la partie statique aussi
+            double re = residual, im = 0.0;
+            if (problem->model == FRF_HYSTERETIC) {
+                re = residual / (1.0 + eta * eta);
+                im = -eta * re;
+            }
+            double* frf = H + (size_t)pair * rows;
+            for (int f = 0; f < n_freq; f++) {
+                frf[2 * f] += re;
+                frf[2 * f + 1] += im;
+            }
+        }
+    }
+    profiler_end();
+    
+    mkl_free(BPhi);
+    mkl_free(P);
+    mkl_free(E);
+    free(G);
+    return status;
+}
+
+int frf_direct(const SparseMatrixCSR* A, const SparseMatrixCSR* B, const FrfProblem* problem,
+               double omega, double* H) {
+    int n = (int)A->n_rows;
+    int n_act = problem->n_actuators;
+    if (check_problem(n, problem) != 0) return -1;
+    if (problem->model == FRF_VISCOUS && problem->damping > 0.0) {
+        fprintf(stderr, "Error: The direct FRF needs hysteretic damping (modal viscous damping "
+                        "has no sparse form)\n");
+        return -1;
+    }
+    
+    int kd = csr_bandwidth(A);
+    if (B && csr_bandwidth(B) > kd) kd = csr_bandwidth(B);
+    int ldab = 3 * kd + 1;
+    MKL_Complex16* band = (MKL_Complex16*)mkl_calloc((size_t)ldab * n, sizeof(MKL_Complex16), 64);
+    MKL_Complex16* X = (MKL_Complex16*)mkl_malloc((size_t)n * n_act * sizeof(MKL_Complex16), 64);
+    MKL_INT* ipiv = (MKL_INT*)malloc((size_t)n * sizeof(MKL_INT));
+    if (!band || !X || !ipiv) {
+        fprintf(stderr, "Error: Failed to allocate the direct FRF solve\n");
+        mkl_free(band);
+        mkl_free(X);
+        free(ipiv);
+        return -1;
+    }
+    
+    profiler_begin("frf_direct");
+    // Bande générale de A (1 + iη) - ω² B (kl = ku = kd)
+    double eta = 2.0 * problem->damping;
+    double w2 = omega * omega;
+    for (int i = 0; i < n; i++) {
+        for (MKL_INT p = A->row_index[i]; p < A->row_index[i + 1]; p++) {
+            MKL_Complex16* entry = &band[(size_t)A->columns[p] * ldab + 2 * kd + i - A->columns[p]];
+            entry->real += A->values[p];
+            entry->imag += eta * A->values[p];
+        }
+        if (!B) {
+            band[(size_t)i * ldab + 2 * kd].real -= w2;
+            continue;
+        }
+        for (MKL_INT p = B->row_index[i]; p < B->row_index[i + 1]; p++) {
+            band[(size_t)B->columns[p] * ldab + 2 * kd + i - B->columns[p]].real -= w2 * B->values[p];
+        }
+    }
+    fill_point_loads(n, problem, (double*)X, 1);
+    
+    MKL_INT n_mkl = n, kl = kd, ldab_mkl = ldab, nrhs = n_act, info;
+    char trans = 'N';
+    zgbtrf(&n_mkl, &n_mkl, &kl, &kl, band, &ldab_mkl, ipiv, &info);
+    if (info == 0) {
+        zgbtrs(&trans, &n_mkl, &kl, &kl, &nrhs, band, &ldab_mkl, ipiv, X, &n_mkl, &info);
+    }
+    profiler_add_work(8.0 * n * (double)kd * (2.0 * kd + 1.0) + 24.0 * n * (double)kd * n_act,
+                      (double)ldab * n * sizeof(MKL_Complex16));
+    profiler_end();
+    
+    if (info != 0) {
+        fprintf(stderr, "Error: Direct FRF solve failed (ZGBTRF/ZGBTRS info = %ld)\n", (long)info);
+    } else {
+        for (int s = 0; s < problem->n_sensors; s++) {
+            for (int a = 0; a < n_act; a++) {
+                const MKL_Complex16* x = &X[(size_t)a * n + problem->sensors[s]];
+                H[2 * ((size_t)s * n_act + a)] = x->real;
+                H[2 * ((size_t)s * n_act + a) + 1] = x->imag;
+            }
+        }
+    }
+    
+    mkl_free(band);
+    mkl_free(X);
+    free(ipiv);
+    return info == 0 ? 0 : -1;
+}
@@ -0,0 +1,186 @@
+#include "image.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// LZW des GIF: codes de 9 à 12 bits, dictionnaire réinitialisé lorsqu'il est plein
+#define GIF_MIN_CODE_SIZE 8
+#define GIF_CLEAR_CODE (1 << GIF_MIN_CODE_SIZE)
+#define GIF_END_CODE (GIF_CLEAR_CODE + 1)
+#define GIF_MAX_CODE 4095
+#define GIF_HASH_SIZE 8192
+
+struct GifWriter {
+    FILE* file;
+    int width;
+    int height;
+    int delay;
+    int n_frames;
+};
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint32_t bits;
+    int n_bits;
+} CodeWriter;
+
+// Codes écrits bit de poids faible en premier
+static int put_code(CodeWriter* cw, int code, int code_size) {
+    if (cw->size + 4 > cw->capacity) {
+        size_t capacity = cw->capacity * 2;
+        uint8_t* data = (uint8_t*)realloc(cw->data, capacity);
+        if (!data) return -1;
+        cw->data = data;
+        cw->capacity = capacity;
+    }
+    cw->bits |= (uint32_t)code << cw->n_bits;
+    cw->n_bits += code_size;
+    while (cw->n_bits >= 8) {
+        cw->data[cw->size++] = (uint8_t)cw->bits;
+        cw->bits >>= 8;
+        cw->n_bits -= 8;
+    }
+    return 0;
+}
+
+// Dictionnaire (préfixe, octet) -> code par adressage ouvert
+typedef struct {
+    int32_t key[GIF_HASH_SIZE];
+    int16_t code[GIF_HASH_SIZE];
+} LzwTable;
+
+static inline int lzw_slot(const LzwTable* table, int32_t key) {
+    int slot = (int)(((uint32_t)key * 2654435761u) >> 19) & (GIF_HASH_SIZE - 1);
+    while (table->key[slot] >= 0 && table->key[slot] != key) {
+        slot = (slot + 1) & (GIF_HASH_SIZE - 1);
+    }
+    return slot;
+}
+
+uint8_t* gif_encode_frame(const uint8_t* indices, int width, int height, size_t* size) {
+    size_t n_pixels = (size_t)width * height;
+    LzwTable* table = (LzwTable*)malloc(sizeof(LzwTable));
+    CodeWriter cw = {0};
+    cw.capacity = n_pixels / 2 + 64;
+    cw.data = (uint8_t*)malloc(cw.capacity);
+    if (!table || !cw.data) {
+        free(table);
+        free(cw.data);
+        return NULL;
+    }
+    memset(table->key, 0xff, sizeof(table->key));
+    
+    int code_size = GIF_MIN_CODE_SIZE + 1;
+    int max_code = GIF_END_CODE;
+    int status = put_code(&cw, GIF_CLEAR_CODE, code_size);
+    int current = n_pixels > 0 ? indices[0] : 0;
+    
+    for (size_t p = 1; p < n_pixels && status == 0; p++) {
+        int32_t key = (current << 8) | indices[p];
+        int slot = lzw_slot(table, key);
+        if (table->key[slot] == key) {
+            current = table->code[slot];
+            continue;
+        }
+        
+        status = put_code(&cw, current, code_size);
+        table->key[slot] = key;
+        table->code[slot] = (int16_t)++max_code;
+        if (max_code >= (1 << code_size)) code_size++;
+        if (max_code == GIF_MAX_CODE) {
+            status |= put_code(&cw, GIF_CLEAR_CODE, code_size);
+            memset(table->key, 0xff, sizeof(table->key));
+            code_size = GIF_MIN_CODE_SIZE + 1;
+            max_code = GIF_END_CODE;
+        }
+        current = indices[p];
+    }
+    
+    status |= put_code(&cw, current, code_size);
+    status |= put_code(&cw, GIF_END_CODE, code_size);
+    if (status == 0 && cw.n_bits > 0) cw.data[cw.size++] = (uint8_t)cw.bits;
+    free(table);
+    
+    if (status != 0) {
+        free(cw.data);
+        return NULL;
+    }
+    *size = cw.size;
+    return cw.data;
+}
+
+static void store_le16(uint8_t* p, int v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+GifWriter* gif_open(const char* filename, int width, int height, const Color* palette,
+                    int delay_cs) {
+    GifWriter* gif = (GifWriter*)calloc(1, sizeof(GifWriter));
+    if (!gif) return NULL;
+    
+    gif->file = fopen(filename, "wb");
+    if (!gif->file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        free(gif);
+        return NULL;
+    }
+    gif->width = width;
+    gif->height = height;
+    gif->delay = delay_cs;
+    
+    // En-tête, écran logique avec palette globale de 256 couleurs
+    uint8_t header[13] = {'G', 'I', 'F', '8', '9', 'a'};
+    store_le16(header + 6, width);
+    store_le16(header + 8, height);
+    header[10] = 0xF7;
+    fwrite(header, 1, sizeof(header), gif->file);
+    for (int c = 0; c < 256; c++) {
+        uint8_t rgb[3] = {palette[c].r, palette[c].g, palette[c].b};
+        fwrite(rgb, 1, 3, gif->file);
+    }
+    
+    // Extension NETSCAPE2.0: lecture en boucle
+    static const uint8_t loop[19] = {
+        0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+        0x03, 0x01, 0x00, 0x00, 0x00
+    };
+    fwrite(loop, 1, sizeof(loop), gif->file);
+    
+    return gif;
+}
+
+int gif_add_encoded_frame(GifWriter* gif, const uint8_t* data, size_t size) {
+    uint8_t control[8] = {0x21, 0xF9, 0x04, 0x00, 0, 0, 0x00, 0x00};
+    store_le16(control + 4, gif->delay);
+    uint8_t descriptor[11] = {0x2C, 0, 0, 0, 0};
+    store_le16(descriptor + 5, gif->width);
+    store_le16(descriptor + 7, gif->height);
+    descriptor[9] = 0x00;
+    descriptor[10] = GIF_MIN_CODE_SIZE;
+    
+    fwrite(control, 1, sizeof(control), gif->file);
+    fwrite(descriptor, 1, sizeof(descriptor), gif->file);
+    
+    // Sous-blocs de 255 octets au plus
+    for (size_t offset = 0; offset < size; offset += 255) {
+        uint8_t length = (uint8_t)(size - offset < 255 ? size - offset : 255);
+        fputc(length, gif->file);
+        fwrite(data + offset, 1, length, gif->file);
+    }
+    fputc(0, gif->file);
+    
+    gif->n_frames++;
+    return ferror(gif->file) ? -1 : 0;
+}
+
+int gif_close(GifWriter* gif) {
+    if (!gif) return -1;
+    fputc(0x3B, gif->file);
+    int status = ferror(gif->file) ? -1 : 0;
+    if (fclose(gif->file) != 0) status = -1;
+    free(gif);
+    return status;
+}
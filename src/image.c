@@ -0,0 +1,217 @@
+#include "image.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Police 5x7: une ligne par octet (bit 4 = colonne de gauche), ASCII 32 à 95
+static const uint8_t font_5x7[64][7] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '!'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '#'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '$'
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // '%'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '&'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '''
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // '('
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // ')'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '*'
+    {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}, // '+'
+    {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}, // ','
+    {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // '.'
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // '/'
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // '0'
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // '1'
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // '2'
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // '3'
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // '4'
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // '5'
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // '6'
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // '7'
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // '8'
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // '9'
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ';'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '<'
+    {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, // '='
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '>'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '?'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '@'
+    {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'A'
+    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // 'B'
+    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // 'C'
+    {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // 'D'
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // 'E'
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // 'F'
+    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // 'G'
+    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'H'
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 'I'
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // 'J'
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // 'K'
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // 'L'
+    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // 'M'
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // 'N'
+    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'O'
+    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // 'P'
+    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // 'Q'
+    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // 'R'
+    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // 'S'
+    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // 'T'
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'U'
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // 'V'
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // 'W'
+    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // 'X'
+    {0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04}, // 'Y'
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // 'Z'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '['
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // 'backslash'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ']'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '^'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}, // '_'
+};
+
+Image* image_create(int width, int height, Color background) {
+    Image* image = (Image*)malloc(sizeof(Image));
+    if (!image) {
+        fprintf(stderr, "Error: Failed to allocate image\n");
+        return NULL;
+    }
+    
+    image->width = width;
+    image->height = height;
+    image->pixels = (uint8_t*)malloc((size_t)width * height * 3);
+    if (!image->pixels) {
+        fprintf(stderr, "Error: Failed to allocate %d x %d image\n", width, height);
+        free(image);
+        return NULL;
+    }
+    
+    image_fill_rect(image, 0, 0, width, height, background);
+    return image;
+}
+
+void free_image(Image* image) {
+    if (!image) return;
+    free(image->pixels);
+    free(image);
+}
+
+void image_set_pixel(Image* image, int x, int y, Color color) {
+    if (x < 0 || y < 0 || x >= image->width || y >= image->height) return;
+    uint8_t* p = image->pixels + ((size_t)y * image->width + x) * 3;
+    p[0] = color.r;
+    p[1] = color.g;
+    p[2] = color.b;
+}
+
+void image_fill_rect(Image* image, int x, int y, int width, int height, Color color) {
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = x + width > image->width ? image->width : x + width;
+    int y1 = y + height > image->height ? image->height : y + height;
+    
+    for (int row = y0; row < y1; row++) {
+        uint8_t* p = image->pixels + ((size_t)row * image->width + x0) * 3;
+        for (int col = x0; col < x1; col++) {
+            *p++ = color.r;
+            *p++ = color.g;
+            *p++ = color.b;
+        }
+    }
+}
+
+void image_draw_rect(Image* image, int x, int y, int width, int height, Color color) {
+    image_draw_line(image, x, y, x + width - 1, y, color);
+    image_draw_line(image, x, y + height - 1, x + width - 1, y + height - 1, color);
+    image_draw_line(image, x, y, x, y + height - 1, color);
+    image_draw_line(image, x + width - 1, y, x + width - 1, y + height - 1, color);
+}
+
+// Bresenham
+void image_draw_line(Image* image, int x0, int y0, int x1, int y1, Color color) {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    
+    for (;;) {
+        image_set_pixel(image, x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void image_draw_text(Image* image, int x, int y, const char* text, Color color) {
+    for (const char* c = text; *c; c++, x += FONT_WIDTH) {
+        int code = (unsigned char)*c;
+        if (code >= 'a' && code <= 'z') code -= 'a' - 'A';
+        if (code < 32 || code > 95) continue;
+        
+        const uint8_t* glyph = font_5x7[code - 32];
+        for (int row = 0; row < 7; row++) {
+            for (int col = 0; col < 5; col++) {
+                if (glyph[row] & (0x10 >> col)) image_set_pixel(image, x + col, y + row, color);
+            }
+        }
+    }
+}
+
+int image_text_width(const char* text) {
+    int length = (int)strlen(text);
+    return length > 0 ? length * FONT_WIDTH - 1 : 0;
+}
+
+// ============ CARTES DE COULEURS ============
+
+// Points de contrôle équirépartis, interpolation linéaire
+static const uint8_t rdbu_points[11][3] = {
+    {5, 48, 97}, {33, 102, 172}, {67, 147, 195}, {146, 197, 222}, {209, 229, 240},
+    {247, 247, 247}, {253, 219, 199}, {244, 165, 130}, {214, 96, 77}, {178, 24, 43},
+    {103, 0, 31}
+};
+
+static const uint8_t viridis_points[9][3] = {
+    {68, 1, 84}, {71, 44, 122}, {59, 81, 139}, {44, 113, 142}, {33, 144, 141},
+    {39, 173, 129}, {92, 200, 99}, {170, 220, 50}, {253, 231, 37}
+};
+
+static const uint8_t grays_points[2][3] = {
+    {255, 255, 255}, {0, 0, 0}
+};
+
+static Color interpolate_points(const uint8_t (*points)[3], int n_points, double t) {
+    if (!(t > 0.0)) t = 0.0;
+    if (t > 1.0) t = 1.0;
+    
+    double position = t * (n_points - 1);
+    int i = (int)position;
+    if (i >= n_points - 1) i = n_points - 2;
+    double f = position - i;
+    
+    Color color;
+    color.r = (uint8_t)lround(points[i][0] + f * (points[i + 1][0] - points[i][0]));
+    color.g = (uint8_t)lround(points[i][1] + f * (points[i + 1][1] - points[i][1]));
+    color.b = (uint8_t)lround(points[i][2] + f * (points[i + 1][2] - points[i][2]));
+    return color;
+}
+
+Color colormap_color(Colormap colormap, double t) {
+    switch (colormap) {
+        case COLORMAP_VIRIDIS:
+            return interpolate_points(viridis_points, 9, t);
+        case COLORMAP_GRAYS:
+            return interpolate_points(grays_points, 2, t);
+        case COLORMAP_RDBU:
+        default:
+            return interpolate_points(rdbu_points, 11, t);
+    }
+}
@@ -0,0 +1,118 @@
+#include "job.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+void job_spec_init(JobSpec* job) {
+    memset(job, 0, sizeof(JobSpec));
+    job->N = 50;
+    job->n_eigenvalues = 10;
+    job->obstacle[0] = 0.5;
+    job->obstacle[1] = 0.5;
+    job->obstacle[2] = 50.0;
+    job->obstacle[3] = 50.0;
+}
+
+static int copy_expression(char* dst, const char* value) {
+    if (strlen(value) >= JOB_EXPR_MAX) {
+        fprintf(stderr, "Error: Expression too long (max %d characters)\n", JOB_EXPR_MAX - 1);
+        return -1;
+    }
+    strcpy(dst, value);
+    return 0;
+}
+
+int job_spec_set(JobSpec* job, const char* key, const char* value) {
+    if (strcmp(key, "N") == 0 || strcmp(key, "grid") == 0) {
+        job->N = atoi(value);
+    } else if (strcmp(key, "modes") == 0 || strcmp(key, "k") == 0) {
+        job->n_eigenvalues = atoi(value);
+    } else if (strcmp(key, "p") == 0 || strcmp(key, "tension") == 0) {
+        return copy_expression(job->tension, value);
+    } else if (strcmp(key, "w") == 0 || strcmp(key, "density") == 0) {
+        return copy_expression(job->density, value);
+    } else if (strcmp(key, "q") == 0 || strcmp(key, "potential") == 0) {
+        return copy_expression(job->potential, value);
+    } else if (strcmp(key, "obstacle_x") == 0) {
+        job->obstacle[0] = atof(value);
+    } else if (strcmp(key, "obstacle_y") == 0) {
+        job->obstacle[1] = atof(value);
+    } else if (strcmp(key, "obstacle_strength") == 0) {
+        job->obstacle[2] = atof(value);
+    } else if (strcmp(key, "obstacle_width") == 0) {
+        job->obstacle[3] = atof(value);
+    } else {
+        fprintf(stderr, "Error: Unknown job key '%s'\n", key);
+        return -1;
+    }
+    return 0;
+}
+
+// Supprime les espaces en début et fin de chaîne (en place)
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+int job_spec_parse_line(JobSpec* job, const char* line) {
+    char buffer[JOB_EXPR_MAX + 64];
+    if (strlen(line) >= sizeof(buffer)) {
+        fprintf(stderr, "Error: Job line too long\n");
+        return -1;
+    }
+    strcpy(buffer, line);
+    
+    char* comment = strchr(buffer, '#');
+    if (comment) *comment = '\0';
+    
+    char* content = trim(buffer);
+    if (*content == '\0') return 0;
+    
+    char* equal = strchr(content, '=');
+    if (!equal) {
+        fprintf(stderr, "Error: Expected 'key = value' in job line '%s'\n", content);
+        return -1;
+    }
+    *equal = '\0';
+    
+    return job_spec_set(job, trim(content), trim(equal + 1));
+}
+
+int job_spec_load_file(JobSpec* job, const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open job file %s\n", filename);
+        return -1;
+    }
+    
+    char line[JOB_EXPR_MAX + 64];
+    int line_number = 0;
+    int status = 0;
+    
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (job_spec_parse_line(job, line) != 0) {
+            fprintf(stderr, "  (%s, line %d)\n", filename, line_number);
+            status = -1;
+            break;
+        }
+    }
+    
+    fclose(file);
+    return status;
+}
+
+int job_spec_apply(const JobSpec* job, MembraneParams* params) {
+    if (job->tension[0] && set_coefficient_expression(params, 'p', job->tension) != 0) return -1;
+    if (job->density[0] && set_coefficient_expression(params, 'w', job->density) != 0) return -1;
+    if (job->potential[0] && set_coefficient_expression(params, 'q', job->potential) != 0) return -1;
+    params->obstacle_center_x = job->obstacle[0];
+    params->obstacle_center_y = job->obstacle[1];
+    params->obstacle_strength = job->obstacle[2];
+    params->obstacle_width = job->obstacle[3];
+    return 0;
+}
@@ -0,0 +1,737 @@
+#include "lobpcg.h"
+#include "checkpoint.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+// Vecteurs de garde ajoutés au bloc (accélèrent la convergence des derniers modes)
+#define LOBPCG_MIN_GUARD 2
+#define LOBPCG_PRINT_EVERY 25
+// Recalcul explicite de AX, BX (et AP, BP) pour borner la dérive des mises à jour implicites
+#define LOBPCG_REFRESH_EVERY 10
+
+// Bloc de vecteurs avec ses images par A et B (colonne-major, n lignes)
+typedef struct {
+    double* v;
+    double* av;
+    double* bv;
+} Block;
+
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+// ============ OPERATEURS ============
+
+static void csr_apply(const void* data, int n_vectors, const double* X, double* Y) {
+    const SparseMatrixCSR* mat = (const SparseMatrixCSR*)data;
+    MKL_INT n = mat->n_rows;
+    
+    #pragma omp parallel for schedule(static)
+    for (MKL_INT i = 0; i < n; i++) {
+        MKL_INT row_start = mat->row_index[i];
+        MKL_INT row_end = mat->row_index[i + 1];
+        for (int v = 0; v < n_vectors; v++) {
+            const double* x = X + (size_t)v * n;
+            double sum = 0.0;
+            for (MKL_INT p = row_start; p < row_end; p++) {
+                sum += mat->values[p] * x[mat->columns[p]];
+            }
+            Y[(size_t)v * n + i] = sum;
+        }
+    }
+    
+    // Matrice lue une fois par bloc, vecteurs lus et écrits
+    profiler_add_work(2.0 * mat->nnz * n_vectors,
+                      (double)mat->nnz * (sizeof(double) + sizeof(MKL_INT)) +
+                      (double)(n + 1) * sizeof(MKL_INT) + 2.0 * n * n_vectors * sizeof(double));
+}
+
+LinearOperator csr_operator(const SparseMatrixCSR* mat) {
+    LinearOperator op;
+    op.n = (int)mat->n_rows;
+    op.apply = csr_apply;
+    op.data = mat;
+    return op;
+}
+
+// Stencil à 5 points de build_stiffness_matrix appliqué sans stocker A:
+// coefficients p(i±1/2, j), p(i, j±1/2) recalculés à chaque application
+static void stencil_apply(const void* data, int n_vectors, const double* X, double* Y) {
+    const Mesh* mesh = (const Mesh*)data;
+    int N = mesh->N;
+    size_t n = (size_t)mesh->total_points;
+    double inv_h2 = 1.0 / (mesh->h * mesh->h);
+    const double* p = mesh->p_vals;
+    
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            size_t idx = (size_t)i * N + j;
+            double c_bound = p[idx] * inv_h2;    // Voisin sur le bord (u = 0): diagonale seule
+            double c_right = i < N - 1 ? 0.5 * (p[idx] + p[idx + N]) * inv_h2 : c_bound;
+            double c_left = i > 0 ? 0.5 * (p[idx] + p[idx - N]) * inv_h2 : c_bound;
+            double c_up = j < N - 1 ? 0.5 * (p[idx] + p[idx + 1]) * inv_h2 : c_bound;
+            double c_down = j > 0 ? 0.5 * (p[idx] + p[idx - 1]) * inv_h2 : c_bound;
+            double diag = c_right + c_left + c_up + c_down + mesh->q_vals[idx];
+            
+            for (int v = 0; v < n_vectors; v++) {
+                const double* x = X + v * n;
+                double sum = diag * x[idx];
+                if (i < N - 1) sum -= c_right * x[idx + N];
+                if (i > 0) sum -= c_left * x[idx - N];
+                if (j < N - 1) sum -= c_up * x[idx + 1];
+                if (j > 0) sum -= c_down * x[idx - 1];
+                Y[v * n + idx] = sum;
+            }
+        }
+    }
+    
+    // Coefficients lus une fois par bloc, 9 flops par ligne et par vecteur
+    profiler_add_work(9.0 * n * n_vectors,
+                      2.0 * n * sizeof(double) + 2.0 * n * n_vectors * sizeof(double));
+}
+
+LinearOperator stencil_operator(const Mesh* mesh) {
+    LinearOperator op;
+    op.n = mesh->total_points;
+    op.apply = stencil_apply;
+    op.data = mesh;
+    return op;
+}
+
+// Masse diagonale w(x, y) aux points du maillage
+static void mass_apply(const void* data, int n_vectors, const double* X, double* Y) {
+    const Mesh* mesh = (const Mesh*)data;
+    size_t n = (size_t)mesh->total_points;
+    
+    #pragma omp parallel for schedule(static)
+    for (size_t idx = 0; idx < n; idx++) {
+        for (int v = 0; v < n_vectors; v++) {
+            Y[v * n + idx] = mesh->w_vals[idx] * X[v * n + idx];
+        }
+    }
+    profiler_add_work((double)n * n_vectors,
+                      n * sizeof(double) + 2.0 * n * n_vectors * sizeof(double));
+}
+
+LinearOperator mass_operator(const Mesh* mesh) {
+    LinearOperator op;
+    op.n = mesh->total_points;
+    op.apply = mass_apply;
+    op.data = mesh;
+    return op;
+}
+
+static void apply_operator(const LinearOperator* op, int n_vectors, const double* X, double* Y) {
+    if (n_vectors <= 0) return;
+    profiler_begin("spmv");
+    op->apply(op->data, n_vectors, X, Y);
+    profiler_end();
+}
+
+int lobpcg_block_size(int n_eigenvalues) {
+    int guard = n_eigenvalues / 5;
+    if (guard < LOBPCG_MIN_GUARD) guard = LOBPCG_MIN_GUARD;
+    return n_eigenvalues + guard;
+}
+
+// ============ ALGEBRE DE BLOCS ============
+
+static int alloc_block(Block* block, int n, int m, Arena* workspace) {
+    size_t bytes = (size_t)n * m * sizeof(double);
+    block->v = (double*)arena_alloc(workspace, bytes);
+    block->av = (double*)arena_alloc(workspace, bytes);
+    block->bv = (double*)arena_alloc(workspace, bytes);
+    return (block->v && block->av && block->bv) ? 0 : -1;
+}
+
+static void free_block(Block* block, Arena* workspace) {
+    arena_free(workspace, block->v);
+    arena_free(workspace, block->av);
+    arena_free(workspace, block->bv);
+    block->v = block->av = block->bv = NULL;
+}
+
+static void swap_blocks(Block* a, Block* b) {
+    Block tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+// Décale les colonnes [shift, m) vers [0, m - shift)
+static void shift_columns(double* V, int n, int m, int shift) {
+    if (V && shift > 0 && m > shift) {
+        memmove(V, V + (size_t)shift * n, (size_t)(m - shift) * n * sizeof(double));
+    }
+}
+
+// Regroupe les colonnes listées dans index (croissant) en tête de V
+static void gather_columns(double* V, int n, const int* index, int count) {
+    for (int t = 0; t < count; t++) {
+        if (index[t] != t) {
+            memcpy(V + (size_t)t * n, V + (size_t)index[t] * n, (size_t)n * sizeof(double));
+        }
+    }
+}
+
+// V <- V - Y (BY^T V): V devient B-orthogonal à Y (B-orthonormé).
+// AV et BV (si non NULL) reçoivent la même combinaison avec AY et BY.
+static void b_project(int n, int cy, const double* Y, const double* AY, const double* BY,
+                      int cv, double* V, double* AV, double* BV, double* M) {
+    if (cy == 0 || cv == 0) return;
+    
+    cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, cy, cv, n,
+                1.0, BY, n, V, n, 0.0, M, cy);
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, cv, cy,
+                -1.0, Y, n, M, cy, 1.0, V, n);
+    if (AV) {
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, cv, cy,
+                    -1.0, AY, n, M, cy, 1.0, AV, n);
+    }
+    if (BV) {
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, cv, cy,
+                    -1.0, BY, n, M, cy, 1.0, BV, n);
+    }
+}
+
+// B-orthonormalisation par Cholesky: V <- V U^{-1} avec U^T U = V^T B V.
+// Renvoie -1 si le bloc est (numériquement) de rang déficient.
+static int cholesky_orthonormalize(int n, int c, double* V, double* AV, double* BV, double* G) {
+    if (c == 0) return 0;
+    
+    cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, c, c, n,
+                1.0, V, n, BV, n, 0.0, G, c);
+    
+    char uplo = 'U';
+    MKL_INT order = c;
+    MKL_INT info;
+    dpotrf(&uplo, &order, G, &order, &info);
+    if (info != 0) return -1;
+    
+    double max_diag = 0.0, min_diag = INFINITY;
+    for (int j = 0; j < c; j++) {
+        double d = G[j + (size_t)j * c];
+        if (d > max_diag) max_diag = d;
+        if (d < min_diag) min_diag = d;
+    }
+    if (min_diag <= 1e-10 * max_diag) return -1;
+    
+    cblas_dtrsm(CblasColMajor, CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit,
+                n, c, 1.0, G, c, V, n);
+    cblas_dtrsm(CblasColMajor, CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit,
+                n, c, 1.0, G, c, BV, n);
+    if (AV) {
+        cblas_dtrsm(CblasColMajor, CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit,
+                    n, c, 1.0, G, c, AV, n);
+    }
+    
+    return 0;
+}
+
+// Rayleigh-Ritz sur la base B-orthonormée [X W P] (mx + na + np colonnes).
+// X reçoit les mx plus petits vecteurs de Ritz, P leur composante sur [W P].
+// T1 et T2 sont des blocs de travail échangés avec P et X.
+static int rayleigh_ritz(int n, int mx, int na, int np, Block* X, Block* W, Block* P,
+                         Block* T1, Block* T2, double* G, double* ritz, double* theta,
+                         double* work, MKL_INT lwork) {
+    const Block* blocks[3] = {X, W, P};
+    int cols[3] = {mx, na, np};
+    int offset[3] = {0, mx, mx + na};
+    int s = mx + na + np;
+    
+    // Matrice de Gram S^T A S
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            if (cols[a] == 0 || cols[b] == 0) continue;
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, cols[a], cols[b], n,
+                        1.0, blocks[a]->v, n, blocks[b]->av, n,
+                        0.0, G + offset[a] + (size_t)offset[b] * s, s);
+        }
+    }
+    for (int j = 0; j < s; j++) {
+        for (int i = 0; i < j; i++) {
+            double sym = 0.5 * (G[i + (size_t)j * s] + G[j + (size_t)i * s]);
+            G[i + (size_t)j * s] = sym;
+            G[j + (size_t)i * s] = sym;
+        }
+    }
+    
+    char jobz = 'V';
+    char uplo = 'U';
+    MKL_INT order = s;
+    MKL_INT info;
+    dsyev(&jobz, &uplo, &order, G, &order, ritz, work, &lwork, &info);
+    if (info != 0) {
+        fprintf(stderr, "Warning: Rayleigh-Ritz eigensolve failed (info = %ld)\n", (long)info);
+        return -1;
+    }
+    memcpy(theta, ritz, mx * sizeof(double));
+    
+    // Coefficients: lignes offset[b] .. offset[b] + cols[b] des mx premières colonnes de G
+    double* targets[3][3] = {
+        {X->v, X->av, X->bv}, {W->v, W->av, W->bv}, {P->v, P->av, P->bv}
+    };
+    double* spare1[3] = {T1->v, T1->av, T1->bv};
+    double* spare2[3] = {T2->v, T2->av, T2->bv};
+    
+    for (int r = 0; r < 3; r++) {
+        // T1 = W Cw + P Cp (nouvelles directions), T2 = X Cx + T1
+        double beta = 0.0;
+        for (int b = 1; b < 3; b++) {
+            if (cols[b] == 0) continue;
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, mx, cols[b],
+                        1.0, targets[b][r], n, G + offset[b], s, beta, spare1[r], n);
+            beta = 1.0;
+        }
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, mx, mx,
+                    1.0, targets[0][r], n, G, s, 0.0, spare2[r], n);
+        if (na + np > 0) {
+            cblas_daxpy((MKL_INT)((size_t)n * mx), 1.0, spare1[r], 1, spare2[r], 1);
+        }
+    }
+    
+    swap_blocks(X, T2);
+    if (na + np > 0) swap_blocks(P, T1);
+    
+    return 0;
+}
+
+// ============ CHECKPOINTS ============
+
+static void submit_checkpoint(CheckpointWriter* writer, int n, int k, int iteration, double eps,
+                              int mx, int n_locked, int have_directions,
+                              const Block* X, const Block* P, const double* theta,
+                              const double* Q, const double* locked_values,
+                              const double* locked_residuals) {
+    double start = wall_time();
+    
+    SolverCheckpoint* checkpoint = checkpoint_create(n, k, mx, n_locked, have_directions);
+    if (!checkpoint) return;
+    
+    checkpoint->iteration = iteration;
+    checkpoint->eps = eps;
+    memcpy(checkpoint->ritz_values, theta, mx * sizeof(double));
+    memcpy(checkpoint->locked_values, locked_values, n_locked * sizeof(double));
+    memcpy(checkpoint->locked_residuals, locked_residuals, n_locked * sizeof(double));
+    memcpy(checkpoint->X, X->v, (size_t)n * mx * sizeof(double));
+    if (have_directions) memcpy(checkpoint->P, P->v, (size_t)n * mx * sizeof(double));
+    memcpy(checkpoint->locked, Q, (size_t)n * n_locked * sizeof(double));
+    
+    writer->snapshot_time += wall_time() - start;
+    checkpoint_writer_submit(writer, checkpoint);
+}
+
+// ============ LIVRAISON INCREMENTALE ============
+
+// Paires verrouillées first..first+count-1 transmises au consommateur (norme 2 unitaire,
+// comme les résultats finaux); buffer: n doubles de travail
+static void deliver_locked(const SolverConfig* config, int n, int first, int count,
+                           const double* Q, const double* locked_values,
+                           const double* locked_residuals, double* buffer, double elapsed) {
+    if (!config->on_eigenpair) return;
+    for (int i = first; i < first + count; i++) {
+        memcpy(buffer, Q + (size_t)i * n, (size_t)n * sizeof(double));
+        double norm = cblas_dnrm2(n, buffer, 1);
+        if (norm > 1e-12) cblas_dscal(n, 1.0 / norm, buffer, 1);
+        Eigenpair pair = {i, n, locked_values[i], locked_residuals[i], buffer, elapsed};
+        config->on_eigenpair(&pair, config->on_eigenpair_data);
+    }
+}
+
+// ============ SOLVEUR ============
+
+EigenResults* solve_lobpcg_operator(const LinearOperator* A, const LinearOperator* B,
+                                    const double* inv_diagonal, SolverConfig* config) {
+    printf("\n=== SOLVING EIGENPROBLEM (LOBPCG ITERATIVE SOLVER) ===\n");
+    
+    double start = wall_time();
+    Arena* workspace = config->workspace;
+    int n = A->n;
+    int k = config->n_eigenvalues < n ? config->n_eigenvalues : n;
+    int m = lobpcg_block_size(k);
+    double tol = config->eps;
+    
+    if (3 * m > n) {
+        fprintf(stderr, "Error: LOBPCG needs at least %d DOF for %d eigenvalues (n = %d)\n",
+                3 * m, k, n);
+        return NULL;
+    }
+    
+    printf("Problem size: %d, block size: %d (%d requested), tolerance: %.1e\n", n, m, k, tol);
+    
+    // ===== ALLOCATIONS =====
+    Block X = {0}, W = {0}, P = {0}, T1 = {0}, T2 = {0};
+    int s_max = 3 * m;
+    double* Q = (double*)arena_alloc(workspace, (size_t)n * k * sizeof(double));
+    double* BQ = (double*)arena_alloc(workspace, (size_t)n * k * sizeof(double));
+    double* G = (double*)arena_alloc(workspace, (size_t)s_max * s_max * sizeof(double));
+    double* M = (double*)arena_alloc(workspace, (size_t)(m + k) * m * sizeof(double));
+    double* ritz = (double*)arena_alloc(workspace, s_max * sizeof(double));
+    double* theta = (double*)arena_alloc(workspace, m * sizeof(double));
+    double* resid = (double*)arena_alloc(workspace, m * sizeof(double));
+    double* locked_values = (double*)arena_alloc(workspace, k * sizeof(double));
+    double* locked_residuals = (double*)arena_alloc(workspace, k * sizeof(double));
+    int* active = (int*)arena_alloc(workspace, m * sizeof(int));
+    double* final_values = (double*)arena_alloc(workspace, 2 * k * sizeof(double));
+    const double** sources = (const double**)arena_alloc(workspace, k * sizeof(double*));
+    
+    // Workspace DSYEV pour la plus grande base
+    MKL_INT lwork = -1, order = s_max, info;
+    double work_query = 0.0;
+    char jobz = 'V', uplo = 'U';
+    dsyev(&jobz, &uplo, &order, G, &order, ritz, &work_query, &lwork, &info);
+    lwork = (info == 0 && work_query > 3 * s_max) ? (MKL_INT)work_query : 3 * s_max;
+    double* work = (double*)arena_alloc(workspace, lwork * sizeof(double));
+    
+    EigenResults* results = NULL;
+    CheckpointWriter* checkpoints = NULL;
+    
+    if (alloc_block(&X, n, m, workspace) || alloc_block(&W, n, m, workspace) ||
+        alloc_block(&P, n, m, workspace) || alloc_block(&T1, n, m, workspace) ||
+        alloc_block(&T2, n, m, workspace) || !Q || !BQ || !G || !M ||
+        !ritz || !theta || !resid || !locked_values || !locked_residuals || !active || !work ||
+        !final_values || !sources) {
+        fprintf(stderr, "Error: Failed to allocate LOBPCG workspace\n");
+        goto cleanup;
+    }
+    
+    // ===== ETAT INITIAL (aléatoire ou checkpoint) =====
+    int iteration = 0;
+    int mx = m;
+    int n_locked = 0;
+    int have_directions = 0;
+    
+    if (config->restart && config->checkpoint_file) {
+        SolverCheckpoint* checkpoint = checkpoint_load(config->checkpoint_file);
+        if (!checkpoint) goto cleanup;
+        if (checkpoint->n != n || checkpoint->n_requested != k ||
+            checkpoint->block_size + checkpoint->n_locked != m) {
+            fprintf(stderr, "Error: Checkpoint %s was written for n = %d, k = %d "
+                    "(current problem: n = %d, k = %d)\n", config->checkpoint_file,
+                    checkpoint->n, checkpoint->n_requested, n, k);
+            free_checkpoint(checkpoint);
+            goto cleanup;
+        }
+        
+        iteration = checkpoint->iteration;
+        n_locked = checkpoint->n_locked;
+        mx = checkpoint->block_size;
+        have_directions = checkpoint->has_directions;
+        memcpy(X.v, checkpoint->X, (size_t)n * mx * sizeof(double));
+        if (have_directions) memcpy(P.v, checkpoint->P, (size_t)n * mx * sizeof(double));
+        memcpy(Q, checkpoint->locked, (size_t)n * n_locked * sizeof(double));
+        memcpy(locked_values, checkpoint->locked_values, n_locked * sizeof(double));
+        memcpy(locked_residuals, checkpoint->locked_residuals, n_locked * sizeof(double));
+        free_checkpoint(checkpoint);
+        
+        apply_operator(B, n_locked, Q, BQ);
+        printf("Resuming from checkpoint %s: iteration %d, %d/%d pairs locked\n",
+               config->checkpoint_file, iteration, n_locked, k);
+        deliver_locked(config, n, 0, n_locked, Q, locked_values, locked_residuals, T2.v,
+                       wall_time() - start);
+    } else {
+        // Générateur xorshift déterministe: exécutions reproductibles
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < (size_t)n * m; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            X.v[i] = (double)(state >> 11) / 9007199254740992.0 - 0.5;
+        }
+    }
+    
+    // X B-orthonormé et B-orthogonal aux vecteurs verrouillés
+    apply_operator(B, mx, X.v, X.bv);
+    b_project(n, n_locked, Q, NULL, BQ, mx, X.v, NULL, X.bv, M);
+    if (cholesky_orthonormalize(n, mx, X.v, NULL, X.bv, G) != 0) {
+        fprintf(stderr, "Error: Initial LOBPCG block is rank deficient\n");
+        goto cleanup;
+    }
+    apply_operator(A, mx, X.v, X.av);
+    
+    int np = 0;
+    if (have_directions) {
+        b_project(n, n_locked, Q, NULL, BQ, mx, P.v, NULL, NULL, M);
+        apply_operator(A, mx, P.v, P.av);
+        apply_operator(B, mx, P.v, P.bv);
+        b_project(n, mx, X.v, X.av, X.bv, mx, P.v, P.av, P.bv, M);
+        if (cholesky_orthonormalize(n, mx, P.v, P.av, P.bv, G) == 0) np = mx;
+    }
+    have_directions = 0;
+    
+    if (config->checkpoint_file && config->checkpoint_interval > 0) {
+        checkpoints = checkpoint_writer_create(config->checkpoint_file);
+    }
+    
+    // ===== ITERATIONS =====
+    int na = 0;
+    int converged = 0;
+    
+    for (;;) {
+        profiler_begin("rayleigh_ritz");
+        int rr_status = rayleigh_ritz(n, mx, na, np, &X, &W, &P, &T1, &T2, G, ritz, theta,
+                                      work, lwork);
+        int s_dim = mx + na + np;
+        profiler_add_work(4.0 * n * s_dim * s_dim + 6.0 * n * s_dim * mx,
+                          3.0 * n * (s_dim + mx) * sizeof(double));
+        profiler_end();
+        if (rr_status != 0) break;
+        if (na + np > 0) have_directions = 1;
+        iteration++;
+        
+        // Résidus R = AX - BX Θ (dans T1, libre après Rayleigh-Ritz)
+        double* R = T1.v;
+        double max_resid = 0.0;
+        memcpy(R, X.av, (size_t)n * mx * sizeof(double));
+        for (int j = 0; j < mx; j++) {
+            size_t col = (size_t)j * n;
+            cblas_daxpy(n, -theta[j], X.bv + col, 1, R + col, 1);
+            double scale = cblas_dnrm2(n, X.av + col, 1) +
+                           fabs(theta[j]) * cblas_dnrm2(n, X.bv + col, 1);
+            resid[j] = cblas_dnrm2(n, R + col, 1) / (scale > 0.0 ? scale : 1.0);
+            if (j < k - n_locked && resid[j] > max_resid) max_resid = resid[j];
+        }
+        
+        // Verrouillage des premières paires convergées (dans l'ordre du spectre)
+        int n_new = 0;
+        while (n_new < mx && n_locked + n_new < k && resid[n_new] <= tol) n_new++;
+        if (n_new > 0) {
+            memcpy(Q + (size_t)n_locked * n, X.v, (size_t)n * n_new * sizeof(double));
+            memcpy(BQ + (size_t)n_locked * n, X.bv, (size_t)n * n_new * sizeof(double));
+            memcpy(locked_values + n_locked, theta, n_new * sizeof(double));
+            memcpy(locked_residuals + n_locked, resid, n_new * sizeof(double));
+            
+            double* shifted[7] = {X.v, X.av, X.bv, P.v, P.av, P.bv, R};
+            for (int b = 0; b < 7; b++) {
+                if (b >= 3 && b < 6 && !have_directions) continue;
+                shift_columns(shifted[b], n, mx, n_new);
+            }
+            memmove(theta, theta + n_new, (mx - n_new) * sizeof(double));
+            memmove(resid, resid + n_new, (mx - n_new) * sizeof(double));
+            mx -= n_new;
+            n_locked += n_new;
+            printf("  Iteration %4d: %d/%d eigenpairs locked\n", iteration, n_locked, k);
+            
+            // T2 (ancien X) est libre jusqu'au prochain Rayleigh-Ritz
+            deliver_locked(config, n, n_locked - n_new, n_new, Q, locked_values,
+                           locked_residuals, T2.v, wall_time() - start);
+        }
+        
+        if (n_locked >= k) {
+            converged = 1;
+            break;
+        }
+        if (iteration % LOBPCG_PRINT_EVERY == 0) {
+            printf("  Iteration %4d: max residual %.2e, λ%d ≈ %.6f\n",
+                   iteration, max_resid, n_locked + 1, theta[0]);
+        }
+        if (iteration >= config->max_iterations) break;
+        
+        if (checkpoints && iteration % config->checkpoint_interval == 0) {
+            submit_checkpoint(checkpoints, n, k, iteration, tol, mx, n_locked, have_directions,
+                              &X, &P, theta, Q, locked_values, locked_residuals);
+        }
+        
+        // ===== NOUVELLES DIRECTIONS (colonnes non convergées) =====
+        na = 0;
+        for (int j = 0; j < mx; j++) {
+            if (resid[j] > tol) active[na++] = j;
+        }
+        if (na == 0) break;
+        
+        // Rafraîchissement: X re-B-orthonormé, images recalculées
+        if (iteration % LOBPCG_REFRESH_EVERY == 0) {
+            apply_operator(B, mx, X.v, X.bv);
+            b_project(n, n_locked, Q, NULL, BQ, mx, X.v, NULL, X.bv, M);
+            if (cholesky_orthonormalize(n, mx, X.v, NULL, X.bv, G) != 0) {
+                fprintf(stderr, "Warning: LOBPCG lost orthogonality at iteration %d\n", iteration);
+                break;
+            }
+            apply_operator(A, mx, X.v, X.av);
+            if (have_directions) {
+                apply_operator(A, mx, P.v, P.av);
+                apply_operator(B, mx, P.v, P.bv);
+            }
+        }
+        
+        // W = T R (Jacobi), B-orthonormé contre Q et X (deux passes)
+        for (int t = 0; t < na; t++) {
+            const double* r = R + (size_t)active[t] * n;
+            double* w = W.v + (size_t)t * n;
+            if (inv_diagonal) {
+                for (int i = 0; i < n; i++) w[i] = inv_diagonal[i] * r[i];
+            } else {
+                memcpy(w, r, (size_t)n * sizeof(double));
+            }
+        }
+        b_project(n, n_locked, Q, NULL, BQ, na, W.v, NULL, NULL, M);
+        b_project(n, mx, X.v, NULL, X.bv, na, W.v, NULL, NULL, M);
+        apply_operator(B, na, W.v, W.bv);
+        int w_ok = cholesky_orthonormalize(n, na, W.v, NULL, W.bv, G) == 0;
+        if (w_ok) {
+            b_project(n, mx, X.v, NULL, X.bv, na, W.v, NULL, W.bv, M);
+            w_ok = cholesky_orthonormalize(n, na, W.v, NULL, W.bv, G) == 0;
+        }
+        if (!w_ok) {
+            fprintf(stderr, "Warning: LOBPCG stagnated at iteration %d (residual block is rank deficient)\n",
+                    iteration);
+            break;
+        }
+        apply_operator(A, na, W.v, W.av);
+        
+        // P restreint aux colonnes actives, B-orthonormé contre X et W
+        np = 0;
+        if (have_directions) {
+            gather_columns(P.v, n, active, na);
+            gather_columns(P.av, n, active, na);
+            gather_columns(P.bv, n, active, na);
+            b_project(n, mx, X.v, X.av, X.bv, na, P.v, P.av, P.bv, M);
+            b_project(n, na, W.v, W.av, W.bv, na, P.v, P.av, P.bv, M);
+            if (cholesky_orthonormalize(n, na, P.v, P.av, P.bv, G) == 0) np = na;
+        }
+    }
+    
+    if (!converged) {
+        printf("Warning: LOBPCG stopped after %d iterations with %d/%d eigenpairs converged\n",
+               iteration, n_locked, k);
+    }
+    
+    // ===== RESULTATS (verrouillés puis meilleurs vecteurs de Ritz) =====
+    results = create_eigen_results_in(n, k, config->eigenvector_file, workspace);
+    if (!results) goto cleanup;
+    
+    int* order_index = active;  // Réutilisé: m >= k
+    double* values = final_values;
+    double* residuals = final_values + k;
+    for (int i = 0; i < k; i++) {
+        if (i < n_locked) {
+            sources[i] = Q + (size_t)i * n;
+            values[i] = locked_values[i];
+            residuals[i] = locked_residuals[i];
+        } else {
+            sources[i] = X.v + (size_t)(i - n_locked) * n;
+            values[i] = theta[i - n_locked];
+            residuals[i] = resid[i - n_locked];
+        }
+        order_index[i] = i;
+    }
+    
+    // Tri par insertion des valeurs propres (k petit)
+    for (int i = 1; i < k; i++) {
+        int current = order_index[i];
+        int j = i - 1;
+        while (j >= 0 && values[order_index[j]] > values[current]) {
+            order_index[j + 1] = order_index[j];
+            j--;
+        }
+        order_index[j + 1] = current;
+    }
+    
+    for (int i = 0; i < k; i++) {
+        int src = order_index[i];
+        results->eigenvalues[i] = values[src];
+        results->residuals[i] = residuals[src];
+        memcpy(results->eigenvectors[i], sources[src], (size_t)n * sizeof(double));
+        
+        // Même normalisation que le solveur dense
+        double norm = cblas_dnrm2(n, results->eigenvectors[i], 1);
+        if (norm > 1e-12) cblas_dscal(n, 1.0 / norm, results->eigenvectors[i], 1);
+    }
+    
+    results->iterations = iteration;
+    results->computation_time = wall_time() - start;
+    stream_eigenpairs(config, results, n_locked, results->computation_time);
+    printf("LOBPCG finished: %d iterations, %d/%d converged\n", iteration, n_locked, k);
+    printf("Computation time: %.3f seconds\n", results->computation_time);
+    
+cleanup:
+    checkpoint_writer_destroy(checkpoints);
+    free_block(&X, workspace);
+    free_block(&W, workspace);
+    free_block(&P, workspace);
+    free_block(&T1, workspace);
+    free_block(&T2, workspace);
+    arena_free(workspace, Q);
+    arena_free(workspace, BQ);
+    arena_free(workspace, G);
+    arena_free(workspace, M);
+    arena_free(workspace, ritz);
+    arena_free(workspace, theta);
+    arena_free(workspace, resid);
+    arena_free(workspace, locked_values);
+    arena_free(workspace, locked_residuals);
+    arena_free(workspace, active);
+    arena_free(workspace, work);
+    arena_free(workspace, final_values);
+    arena_free(workspace, sources);
+    
+    return results;
+}
+
+EigenResults* solve_lobpcg(SparseMatrixCSR* A, SparseMatrixCSR* B, SolverConfig* config) {
+    Arena* workspace = config->workspace;
+    int n = (int)A->n_rows;
+    double* inv_diagonal = (double*)arena_alloc(workspace, n * sizeof(double));
+    if (!inv_diagonal) {
+        fprintf(stderr, "Error: Failed to allocate preconditioner\n");
+        return NULL;
+    }
+    
+    // Jacobi: inverse de la diagonale de A (1 si absente ou non positive)
+    for (int i = 0; i < n; i++) {
+        inv_diagonal[i] = 1.0;
+        for (MKL_INT p = A->row_index[i]; p < A->row_index[i + 1]; p++) {
+            if (A->columns[p] == i && A->values[p] > 0.0) {
+                inv_diagonal[i] = 1.0 / A->values[p];
+            }
+        }
+    }
+    
+    LinearOperator op_A = csr_operator(A);
+    LinearOperator op_B = csr_operator(B);
+    EigenResults* results = solve_lobpcg_operator(&op_A, &op_B, inv_diagonal, config);
+    
+    arena_free(workspace, inv_diagonal);
+    return results;
+}
+
+EigenResults* solve_lobpcg_matrix_free(const Mesh* mesh, SolverConfig* config) {
+    Arena* workspace = config->workspace;
+    int N = mesh->N;
+    int n = mesh->total_points;
+    double* inv_diagonal = (double*)arena_alloc(workspace, n * sizeof(double));
+    if (!inv_diagonal) {
+        fprintf(stderr, "Error: Failed to allocate preconditioner\n");
+        return NULL;
+    }
+    
+    // Jacobi: diagonale du stencil, comme la version assemblée
+    double inv_h2 = 1.0 / (mesh->h * mesh->h);
+    const double* p = mesh->p_vals;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            int idx = i * N + j;
+            double c_bound = p[idx] * inv_h2;
+            double diag = mesh->q_vals[idx];
+            diag += i < N - 1 ? 0.5 * (p[idx] + p[idx + N]) * inv_h2 : c_bound;
+            diag += i > 0 ? 0.5 * (p[idx] + p[idx - N]) * inv_h2 : c_bound;
+            diag += j < N - 1 ? 0.5 * (p[idx] + p[idx + 1]) * inv_h2 : c_bound;
+            diag += j > 0 ? 0.5 * (p[idx] + p[idx - 1]) * inv_h2 : c_bound;
+            inv_diagonal[idx] = diag > 0.0 ? 1.0 / diag : 1.0;
+        }
+    }
+    
+    LinearOperator op_A = stencil_operator(mesh);
+    LinearOperator op_B = mass_operator(mesh);
+    EigenResults* results = solve_lobpcg_operator(&op_A, &op_B, inv_diagonal, config);
+    
+    arena_free(workspace, inv_diagonal);
+    return results;
+}
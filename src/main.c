@@ -3,34 +3,1258 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "membrane.h"
 #include "mesh.h"
 #include "matrix_builder.h"
 #include "solver.h"
 #include "visualization.h"
+#include "job.h"
+#include "npy_io.h"
+#include "expression.h"
+#include "async_io.h"
+#include "result_cache.h"
+#include "mode_stream.h"
+#include "profiler.h"
+#include "perf_counters.h"
+#include "planner.h"
+#include "resources.h"
+#include "server.h"
+#include "modal_response.h"
+#include "wave_solver.h"
+#include "frf.h"
+#include "sensitivity.h"
+#include "mode_archive.h"
 
 // Définitions pour PI si non défini
 #ifndef PI
 #define PI 3.14159265358979323846
 #endif
 
+#define MAX_PROBES 64          // Capteurs --sensor et actionneurs --actuator
+#define MAX_FRF_DIRECT 16      // Fréquences de validation --frf-direct
+
+// Format choisi pour chaque type de sortie
+typedef struct {
+    OutputFormat mesh;
+    OutputFormat matrices;
+    OutputFormat pattern;
+    OutputFormat modes;
+    SparsityPlotMode sparsity;
+} OutputOptions;
+
+// ============ TACHES D'ECRITURE ASYNCHRONES ============
+
+typedef struct {
+    Mesh* mesh;
+    SparseMatrixCSR* A;
+    SparseMatrixCSR* B;
+    EigenResults* results;     // Possédé par la tâche des modes
+    int modes_to_save;
+    OutputOptions outputs;
+    const char* binary_prefix; // Préfixe des fichiers .csrb
+    const ModeStream* stream;  // Modes déjà écrits pendant la résolution
+    const char* mode_archive;  // Tous les modes compressés (NULL: pas d'archive)
+    ModeArchiveOptions archive;
+} OutputTask;
+
+// Options de la ligne de commande
+typedef struct {
+    JobSpec job;
+    OutputOptions outputs;
+    const char* modes_file;    // Vecteurs propres projetés (mmap)
+    const char* mode_archive;  // Archive compressée de tous les modes (.modz)
+    ModeArchiveOptions archive;
+    int io_threads;
+    size_t io_budget;
+    const char* load_A;        // Opérateur précalculé (.csrb ou .mtx)
+    const char* load_B;
+    const char* save_prefix;   // Export binaire de A et B
+    const char* cache_dir;     // NULL: cache désactivé
+    size_t cache_limit;
+    SolverType solver;         // SOLVER_AUTO: choisi par le planificateur
+    size_t memory_budget;      // 0: fraction de la mémoire disponible
+    double tolerance;          // 0: valeur par défaut du solveur
+    int max_iterations;        // 0: valeur par défaut du solveur
+    const char* checkpoint_file;
+    int checkpoint_interval;
+    int restart;
+    PlotBackend plots;
+    AnimationOptions animation;
+    const char* stream_sink;   // Paires propres en flux binaire (fichier ou tube)
+    const char* profile_file;  // Rapport de performance JSON
+    int perf_counters;         // Compteurs matériels (--perf ou MEMBRANE_PERF)
+    int threads;               // Threads de calcul (0: cœurs du masque d'affinité)
+    int pin_threads;           // Affinité des groupes de threads
+    const char* serve;         // Mode serveur: socket Unix ("-": stdin/stdout)
+    int workers;               // Groupes de threads du serveur (0: un pour deux cœurs)
+    int operator_cache;        // Opérateurs gardés par le serveur
+    double response_time;      // Réponse temporelle sur [0, T] (0: pas de réponse)
+    long response_steps;       // Snapshots de la réponse
+    const char* response_initial;   // Déplacement initial u(0)(x, y)
+    const char* response_load;      // Charge répartie f(x, y)
+    int point_force;           // Force ponctuelle en (force_x, force_y)
+    double force_x;
+    double force_y;
+    double force_amplitude;
+    double load_frequency;     // Charge harmonique (Hz), 0: échelon
+    double damping;            // Amortissement modal ζ
+    const char* response_file;
+    double wave_time;          // Intégration explicite sur [0, T] (0: calcul des modes)
+    double wave_dt;            // Pas imposé (0: limite CFL)
+    double cfl;
+    int n_sensors;             // Capteurs (x, y) de --wave et --frf
+    double sensors[MAX_PROBES][2];
+    int sample_every;
+    const char* wave_file;
+    int frf_count;             // Fonctions de réponse en fréquence (0: aucune)
+    double frf_min;            // Bande en Hz
+    double frf_max;
+    int n_actuators;           // Actionneurs (x, y) (défaut: les capteurs)
+    double actuators[MAX_PROBES][2];
+    FrfDamping frf_damping;
+    int frf_residual;          // Correction de flexibilité résiduelle
+    int n_frf_direct;          // Fréquences (Hz) de la validation par résolution directe
+    double frf_direct[MAX_FRF_DIRECT];
+    const char* frf_file;
+    int sensitivities;         // Dérivées des valeurs propres (data/sensitivities.npz)
+    int symmetry;              // Résolution par classes de symétrie si p, w, q s'y prêtent
+} RunOptions;
+
+typedef struct {
+    int* grid_sizes;
+    double** eigenvalues;      // Possédé par la tâche
+    int n_sizes;
+    int n_eigenvalues;
+} ConvergenceTask;
+
+// ============ RESOLUTIONS CONCURRENTES ============
+
+#define CONVERGENCE_MODES 5
+#define MAX_SOLVE_TASKS 8
+
+// Tâche 0: résolution principale; suivantes: grilles de l'étude de convergence
+typedef struct {
+    int N;
+    PlanProblem problem;
+    SolverType solver;
+    int group;
+    int n_found;                // Valeurs propres obtenues (0: échec)
+    double eigenvalues[CONVERGENCE_MODES];
+    double seconds;
+} SolveTask;
+
+// File de tâches d'un groupe de threads, exécutées l'une après l'autre
+typedef struct {
+    SolveTask* tasks;
+    int n_tasks;
+    int group;
+    const ThreadGroup* threads;
+    int pin;
+    MembraneParams* params;
+    ResultCache* cache;
+    const SolverConfig* reference;  // Tolérance et itérations de la résolution principale
+    pthread_t thread;
+    int started;
+} SolveLane;
+
+// Taille d'une matrice CSR (valeurs, colonnes, pointeurs de lignes)
+static double csr_bytes(const SparseMatrixCSR* mat) {
+    return (double)mat->nnz * (sizeof(double) + sizeof(MKL_INT)) +
+           (double)(mat->n_rows + 1) * sizeof(MKL_INT);
+}
+
+static OutputTask* create_output_task(Mesh* mesh, SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                      EigenResults* results, OutputOptions outputs) {
+    OutputTask* task = (OutputTask*)calloc(1, sizeof(OutputTask));
+    if (!task) return NULL;
+    task->mesh = mesh;
+    task->A = A;
+    task->B = B;
+    task->results = results;
+    task->outputs = outputs;
+    return task;
+}
+
+static void queue_output(AsyncWriter* writer, AsyncWriteFn write, OutputTask* task,
+                         size_t bytes) {
+    if (!task) {
+        fprintf(stderr, "Warning: Failed to queue output task\n");
+        return;
+    }
+    async_writer_submit(writer, write, free, task, bytes);
+}
+
+static void write_mesh_task(void* payload) {
+    OutputTask* task = (OutputTask*)payload;
+    profiler_begin("write_mesh");
+    if (task->outputs.mesh == OUTPUT_NPY) {
+        save_mesh_npz(task->mesh, "data/mesh_data.npz");
+    } else {
+        save_mesh(task->mesh, "data/mesh_data.csv");
+    }
+    profiler_end();
+}
+
+static void write_binary_matrices_task(void* payload) {
+    OutputTask* task = (OutputTask*)payload;
+    char filename[512];
+    
+    profiler_begin("write_binary_matrices");
+    snprintf(filename, sizeof(filename), "%s_A.csrb", task->binary_prefix);
+    if (save_matrix_csr_binary(task->A, filename) == 0) printf("Saved %s\n", filename);
+    snprintf(filename, sizeof(filename), "%s_B.csrb", task->binary_prefix);
+    if (save_matrix_csr_binary(task->B, filename) == 0) printf("Saved %s\n", filename);
+    profiler_end();
+}
+
+static void write_matrices_task(void* payload) {
+    OutputTask* task = (OutputTask*)payload;
+    profiler_begin("write_matrices");
+    if (task->outputs.matrices == OUTPUT_NPY) {
+        save_matrix_csr_npz(task->A, "data/matrix_A.npz");
+        save_matrix_csr_npz(task->B, "data/matrix_B.npz");
+    } else {
+        save_matrix_csr(task->A, "data/matrix_A_pattern.csv");
+        save_matrix_csr(task->B, "data/matrix_B_pattern.csv");
+    }
+    profiler_end();
+    
+    profiler_begin("plot_sparsity");
+    plot_matrix_sparsity(task->A, "plots/matrix_sparsity.png", task->outputs.pattern,
+                         task->outputs.sparsity);
+    profiler_end();
+}
+
+// Sauvegarde des modes propres puis génération des plots
+static void write_modes_task(void* payload) {
+    OutputTask* task = (OutputTask*)payload;
+    EigenResults* results = task->results;
+    
+    // Sans grille (opérateur importé non carré): pas de coordonnées pour les modes
+    int modes_to_save = task->mesh ? task->modes_to_save : 0;
+    profiler_begin("write_modes");
+    for (int i = 0; i < modes_to_save; i++) {
+        if (mode_stream_saved(task->stream, i, results->eigenvalues[i])) continue;
+        char filename[256];
+        sprintf(filename, "data/mode_%02d.%s", i+1, output_format_name(task->outputs.modes));
+        printf("DEBUG: Saving mode %d to %s\n", i+1, filename);
+        if (task->outputs.modes == OUTPUT_NPY) {
+            save_mode_to_npy(task->mesh, results->eigenvectors[i], i, filename);
+        } else {
+            save_mode_to_csv(task->mesh, results->eigenvectors[i], i, filename);
+        }
+    }
+    
+    profiler_end();
+    
+    if (task->mode_archive && task->mesh) {
+        ModeArchiveStats stats;
+        if (mode_archive_write(task->mode_archive, task->mesh, results, results->n_eigenvalues,
+                               &task->archive, &stats) == 0) {
+            printf("Saved %d modes to %s (%s%s): %.2f MB, %.1fx smaller than CSV, "
+                   "%.1fx than float64, max error %.2e x max|phi|, %.3f s\n",
+                   results->n_eigenvalues, task->mode_archive,
+                   mode_encoding_name(task->archive.encoding),
+                   task->archive.compress ? " + lz" : "", stats.file_bytes / 1e6,
+                   (double)stats.csv_bytes / stats.file_bytes,
+                   (double)stats.raw_bytes / stats.file_bytes, stats.max_error, stats.seconds);
+        }
+    } else if (task->mode_archive) {
+        fprintf(stderr, "Warning: No grid for the mode archive, %s not written\n",
+                task->mode_archive);
+    }
+    
+    profiler_begin("plot_modes");
+    generate_plots(task->mesh, results, modes_to_save, "plots");
+    profiler_end();
+    
+    profiler_begin("animation");
+    create_animation(task->mesh, results, task->modes_to_save, "plots");
+    profiler_end();
+}
+
+static void release_modes_task(void* payload) {
+    OutputTask* task = (OutputTask*)payload;
+    free_eigen_results(task->results);
+    free(task);
+}
+
+static void write_convergence_task(void* payload) {
+    ConvergenceTask* task = (ConvergenceTask*)payload;
+    profiler_begin("plot_convergence");
+    plot_convergence(task->grid_sizes, task->eigenvalues, task->n_sizes,
+                     task->n_eigenvalues, "plots/convergence.png");
+    profiler_end();
+}
+
+static void release_convergence_task(void* payload) {
+    ConvergenceTask* task = (ConvergenceTask*)payload;
+    for (int s = 0; s < task->n_sizes; s++) {
+        free(task->eigenvalues[s]);
+    }
+    free(task->eigenvalues);
+    free(task->grid_sizes);
+    free(task);
+}
+
+static double solve_task_cost(int task, int cores, void* data) {
+    const SolveTask* tasks = (const SolveTask*)data;
+    return plan_estimate_seconds(&tasks[task].problem, tasks[task].solver, cores);
+}
+
+// Une grille de l'étude de convergence, dans le groupe de threads du thread appelant
+static void run_convergence_solve(SolveTask* task, const SolveLane* lane) {
+    double start = profiler_now();
+    profiler_begin("convergence_solve");
+    int assemble = task->solver != SOLVER_MATRIX_FREE;
+    Mesh* mesh = create_mesh(task->N, lane->params);
+    SparseMatrixCSR* A = mesh && assemble ? build_stiffness_matrix(mesh) : NULL;
+    SparseMatrixCSR* B = mesh && assemble ? build_mass_matrix(mesh) : NULL;
+    SolverConfig* config = create_solver_config(CONVERGENCE_MODES);
+    
+    if (!mesh || !config || (assemble && (!A || !B))) {
+        fprintf(stderr, "Warning: Failed to set up the convergence solve for N=%d\n", task->N);
+    } else {
+        config->solver = task->solver;
+        config->mesh = mesh;
+        config->eps = lane->reference->eps;
+        config->max_iterations = lane->reference->max_iterations;
+        config->mkl_threads = lane->threads->n_cores;
+        config->symmetry = lane->reference->symmetry;
+        
+        EigenResults* results = solve_eigenproblem_cached(lane->cache, problem_key_from_mesh(mesh),
+                                                          A, B, config);
+        if (results) {
+            task->n_found = results->n_eigenvalues < CONVERGENCE_MODES ? results->n_eigenvalues
+                                                                       : CONVERGENCE_MODES;
+            for (int i = 0; i < task->n_found; i++) task->eigenvalues[i] = results->eigenvalues[i];
+            free_eigen_results(results);
+        }
+    }
+    
+    free_solver_config(config);
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    free_mesh(mesh);
+    profiler_end();
+    task->seconds = profiler_now() - start;
+}
+
+static void run_lane_tasks(SolveLane* lane) {
+    for (int t = 1; t < lane->n_tasks; t++) {
+        if (lane->tasks[t].group == lane->group) run_convergence_solve(&lane->tasks[t], lane);
+    }
+}
+
+static void* lane_thread(void* arg) {
+    SolveLane* lane = (SolveLane*)arg;
+    ThreadState previous;
+    thread_group_enter(lane->threads, lane->pin, &previous);
+    run_lane_tasks(lane);
+    thread_group_leave(&previous);
+    return NULL;
+}
+
+// Fin des résolutions: file du groupe principal (si run_pending), puis attente des autres groupes
+static void join_lanes(SolveLane* lanes, int n_groups, int main_group, int run_pending) {
+    if (run_pending) run_lane_tasks(&lanes[main_group]);
+    for (int g = 0; g < n_groups; g++) {
+        if (g == main_group) continue;
+        if (lanes[g].started) pthread_join(lanes[g].thread, NULL);
+        else if (run_pending) run_lane_tasks(&lanes[g]);   // Thread refusé: dans le thread principal
+    }
+}
+
+static void print_thread_groups(const ThreadGroup* groups, int n_groups, const SolveTask* tasks,
+                                int n_tasks, int pin, double makespan, double sequential) {
+    printf("\n=== THREAD GROUPS (%d group%s%s) ===\n", n_groups, n_groups > 1 ? "s" : "",
+           pin ? ", pinned" : "");
+    printf("  %-5s %-12s %7s  %s\n", "Group", "Cores", "Threads", "Tasks");
+    for (int g = 0; g < n_groups; g++) {
+        char cores[64];
+        format_core_list(&groups[g], cores, sizeof(cores));
+        printf("  %-5d %-12s %7d ", g, cores, groups[g].n_cores);
+        for (int t = 0; t < n_tasks; t++) {
+            if (tasks[t].group != g) continue;
+            printf(" %s N=%d (%s, %.3f s)", t == 0 ? "solve" : "study", tasks[t].N,
+                   solver_type_name(tasks[t].solver),
+                   plan_estimate_seconds(&tasks[t].problem, tasks[t].solver, groups[g].n_cores));
+        }
+        printf("\n");
+    }
+    printf("Estimated time: %.3f s concurrent, %.3f s one after another\n", makespan, sequential);
+}
+
+// ============ REPONSE TEMPORELLE ============
+
+// Snapshots ajoutés à la suite d'un .npy (S x N x N) dont l'en-tête est écrit d'avance:
+// l'historique complet n'est jamais en mémoire
+typedef struct {
+    FILE* file;
+    int n;
+} ResponseWriter;
+
+static int write_response_chunk(long first_step, int count, const double* U, void* data) {
+    ResponseWriter* writer = (ResponseWriter*)data;
+    (void)first_step;
+    // Bloc n x count colonne-major = count lignes consécutives en ordre C
+    if (fwrite(U, sizeof(double), (size_t)writer->n * count, writer->file) !=
+        (size_t)writer->n * count) {
+        fprintf(stderr, "Error: Failed to write the response\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Champ f(x, y) d'une expression sur les points du maillage
+static double* sample_expression(const char* source, const Mesh* mesh) {
+    char error[256];
+    CoeffExpr* expr = coeff_expr_compile(source, error, sizeof(error));
+    if (!expr) {
+        fprintf(stderr, "Error: Invalid expression '%s': %s\n", source, error);
+        return NULL;
+    }
+    double* values = (double*)malloc((size_t)mesh->total_points * sizeof(double));
+    if (values && coeff_expr_eval_grid(expr, mesh->x, mesh->y, mesh->N, values) != 0) {
+        free(values);
+        values = NULL;
+    }
+    free_coeff_expr(expr);
+    return values;
+}
+
+// Point intérieur le plus proche de (x, y)
+static int nearest_point(Mesh* mesh, double x, double y) {
+    int i = (int)lround(x / mesh->h) - 1;
+    int j = (int)lround(y / mesh->h) - 1;
+    if (i < 0) i = 0;
+    if (i >= mesh->N) i = mesh->N - 1;
+    if (j < 0) j = 0;
+    if (j >= mesh->N) j = mesh->N - 1;
+    return mesh_index(i, j, mesh);
+}
+
+// Points du maillage les plus proches des coordonnées demandées (aucune: centre)
+static int place_probes(Mesh* mesh, const double (*coords)[2], int count, int* indices) {
+    if (count == 0) {
+        indices[0] = nearest_point(mesh, 0.5, 0.5);
+        return 1;
+    }
+    for (int k = 0; k < count; k++) indices[k] = nearest_point(mesh, coords[k][0], coords[k][1]);
+    return count;
+}
+
+// Excitation commune à --response et --wave: u(0) (--initial), charge répartie (--load)
+// et force ponctuelle (--force) échantillonnées sur le maillage. NULL si absente
+static int sample_excitation(const RunOptions* opts, Mesh* mesh, double** initial_out,
+                             double** load_out) {
+    int n = mesh->total_points;
+    double* initial = opts->response_initial ? sample_expression(opts->response_initial, mesh)
+                                             : NULL;
+    double* load = NULL;
+    if (opts->response_load) {
+        load = sample_expression(opts->response_load, mesh);
+    } else if (opts->point_force) {
+        load = (double*)calloc(n, sizeof(double));
+    }
+    if ((opts->response_initial && !initial) ||
+        ((opts->response_load || opts->point_force) && !load)) {
+        free(initial);
+        free(load);
+        return -1;
+    }
+    if (opts->point_force) {
+        // Force ponctuelle: densité P / h² au point intérieur le plus proche
+        int idx = nearest_point(mesh, opts->force_x, opts->force_y);
+        load[idx] += opts->force_amplitude / (mesh->h * mesh->h);
+    }
+    *initial_out = initial;
+    *load_out = load;
+    return 0;
+}
+
+static int run_modal_response(const RunOptions* opts, Mesh* mesh, const SparseMatrixCSR* B,
+                              const EigenResults* results) {
+    if (!mesh || mesh->total_points != results->n_dof) {
+        printf("Modal response skipped: the operator is not on a square grid\n");
+        return -1;
+    }
+    if (opts->response_steps < 2) {
+        fprintf(stderr, "Error: --response-steps needs at least 2 snapshots\n");
+        return -1;
+    }
+    
+    int n = mesh->total_points;
+    double* initial;
+    double* load;
+    if (sample_excitation(opts, mesh, &initial, &load) != 0) return -1;
+    
+    ResponseProblem problem = {0};
+    problem.initial_displacement = initial;
+    problem.load = load;
+    problem.damping = opts->damping;
+    problem.dt = opts->response_time / (opts->response_steps - 1);
+    problem.n_steps = opts->response_steps;
+    if (opts->load_frequency > 0.0) {
+        problem.profile = harmonic_load_profile;
+        problem.profile_data = &opts->load_frequency;
+    }
+    
+    LinearOperator mass = B ? csr_operator(B) : mass_operator(mesh);
+    
+    size_t shape[3] = {(size_t)opts->response_steps, (size_t)mesh->N, (size_t)mesh->N};
+    char header[256];
+    size_t header_size = npy_build_header(header, sizeof(header), NPY_FLOAT64, 0, 3, shape);
+    ResponseWriter writer = {fopen(opts->response_file, "wb"), n};
+    if (!writer.file || header_size == 0 ||
+        fwrite(header, 1, header_size, writer.file) != header_size) {
+        fprintf(stderr, "Error: Cannot write %s\n", opts->response_file);
+        if (writer.file) fclose(writer.file);
+        free(initial);
+        free(load);
+        return -1;
+    }
+    
+    ResponseStats stats;
+    int status = modal_response(results, &mass, &problem, write_response_chunk, &writer, &stats);
+    if (fclose(writer.file) != 0) status = -1;
+    
+    if (status == 0) {
+        double bytes = (double)n * opts->response_steps * sizeof(double);
+        printf("%ld snapshots over %.3f s (dt = %.3e), %d modes, %s\n",
+               opts->response_steps, opts->response_time, problem.dt, results->n_eigenvalues,
+               !load ? "free response" : problem.profile ? "harmonic load" : "step load");
+        if (initial) printf("Initial displacement captured by the modes: %.2f%%\n",
+                            100.0 * stats.captured);
+        printf("Synthesis: %.3f s in chunks of %d snapshots, %.1f MB written in %.3f s -> %s\n",
+               stats.seconds, stats.chunk, bytes / 1e6, stats.sink_seconds, opts->response_file);
+    }
+    free(initial);
+    free(load);
+    return status;
+}
+
+// ============ INTEGRATION EXPLICITE ============
+
+// Lots de capteurs écrits par le thread d'E/S à leur place dans le .npy (pwrite):
+// l'ordre de passage des lots est indifférent et la boucle en temps n'attend pas
+typedef struct {
+    int fd;
+    int n_sensors;
+    size_t header_size;
+    AsyncWriter* writer;
+    int failed;
+} SensorFile;
+
+typedef struct {
+    SensorFile* file;
+    long first_sample;
+    int count;
+    double* samples;
+} SensorBatch;
+
+static void write_sensor_batch(void* payload) {
+    SensorBatch* batch = (SensorBatch*)payload;
+    SensorFile* file = batch->file;
+    size_t bytes = (size_t)batch->count * file->n_sensors * sizeof(double);
+    off_t offset = (off_t)(file->header_size +
+                           (size_t)batch->first_sample * file->n_sensors * sizeof(double));
+    if (pwrite(file->fd, batch->samples, bytes, offset) != (ssize_t)bytes) file->failed = 1;
+}
+
+static void release_sensor_batch(void* payload) {
+    SensorBatch* batch = (SensorBatch*)payload;
+    free(batch->samples);
+    free(batch);
+}
+
+static int submit_sensor_batch(long first_sample, int count, double* samples, void* data) {
+    SensorFile* file = (SensorFile*)data;
+    SensorBatch* batch = (SensorBatch*)malloc(sizeof(SensorBatch));
+    if (!batch) {
+        free(samples);
+        return -1;
+    }
+    batch->file = file;
+    batch->first_sample = first_sample;
+    batch->count = count;
+    batch->samples = samples;
+    return async_writer_submit(file->writer, write_sensor_batch, release_sensor_batch, batch,
+                               (size_t)count * file->n_sensors * sizeof(double));
+}
+
+static int run_wave(const RunOptions* opts, Mesh* mesh, AsyncWriter* writer) {
+    double* initial;
+    double* load;
+    if (sample_excitation(opts, mesh, &initial, &load) != 0) return -1;
+    
+    int sensors[MAX_PROBES];
+    int n_sensors = place_probes(mesh, opts->sensors, opts->n_sensors, sensors);
+    
+    WaveProblem problem = {0};
+    problem.initial_displacement = initial;
+    problem.load = load;
+    problem.t_end = opts->wave_time;
+    problem.dt = opts->wave_dt;
+    problem.cfl = opts->cfl;
+    problem.sensors = sensors;
+    problem.n_sensors = n_sensors;
+    problem.sample_every = opts->sample_every;
+    if (opts->load_frequency > 0.0) {
+        problem.profile = harmonic_load_profile;
+        problem.profile_data = &opts->load_frequency;
+    }
+    
+    WaveStats stats;
+    if (wave_plan(mesh, &problem, &stats) != 0) {
+        free(initial);
+        free(load);
+        return -1;
+    }
+    printf("Time step: %.3e (stability bound %.3e), %ld steps, %ld samples x %d sensors\n",
+           stats.dt, stats.stable_dt, stats.n_steps, stats.n_samples, n_sensors);
+    
+    size_t shape[2] = {(size_t)stats.n_samples, (size_t)n_sensors};
+    char header[256];
+    SensorFile file = {-1, n_sensors, 0, writer, 0};
+    file.header_size = npy_build_header(header, sizeof(header), NPY_FLOAT64, 0, 2, shape);
+    file.fd = open(opts->wave_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file.fd < 0 || file.header_size == 0 ||
+        pwrite(file.fd, header, file.header_size, 0) != (ssize_t)file.header_size) {
+        fprintf(stderr, "Error: Cannot write %s\n", opts->wave_file);
+        if (file.fd >= 0) close(file.fd);
+        free(initial);
+        free(load);
+        return -1;
+    }
+    
+    int status = wave_solve(mesh, &problem, submit_sensor_batch, &file, &stats);
+    async_writer_barrier(writer);
+    if (close(file.fd) != 0 || file.failed) {
+        fprintf(stderr, "Error: Failed to write %s\n", opts->wave_file);
+        status = -1;
+    }
+    
+    if (status == 0) {
+        printf("Integrated in %.3f s: %.1f M cell-updates/s\n", stats.seconds,
+               stats.updates_per_second / 1e6);
+        printf("Sensor samples saved in %s\n", opts->wave_file);
+    }
+    free(initial);
+    free(load);
+    return status;
+}
+
+// ============ REPONSE EN FREQUENCE ============
+
+// Coordonnées des points retenus, pour situer les FRF sans le maillage
+static void probe_coordinates(Mesh* mesh, const int* indices, int count, double* xy) {
+    for (int k = 0; k < count; k++) {
+        xy[2 * k] = mesh->x[indices[k] / mesh->N];
+        xy[2 * k + 1] = mesh->y[indices[k] % mesh->N];
+    }
+}
+
+static int run_frf(const RunOptions* opts, Mesh* mesh, int loaded, SparseMatrixCSR* A,
+                   SparseMatrixCSR* B, const EigenResults* results) {
+    if (!mesh || mesh->total_points != results->n_dof) {
+        printf("FRF skipped: sensors and actuators need a square grid\n");
+        return -1;
+    }
+    
+    int sensors[MAX_PROBES], actuators[MAX_PROBES];
+    int n_sensors = place_probes(mesh, opts->sensors, opts->n_sensors, sensors);
+    int n_actuators = opts->n_actuators > 0
+                          ? place_probes(mesh, opts->actuators, opts->n_actuators, actuators)
+                          : place_probes(mesh, opts->sensors, opts->n_sensors, actuators);
+    int n_freq = opts->frf_count;
+    
+    // Matrices assemblées pour la correction statique et la validation (solveur sans matrice)
+    SparseMatrixCSR* built_A = NULL;
+    SparseMatrixCSR* built_B = NULL;
+    if (!A && (opts->frf_residual || opts->n_frf_direct > 0)) {
+        A = built_A = build_stiffness_matrix(mesh);
+        B = built_B = build_mass_matrix(mesh);
+    }
+    
+    size_t n_values = (size_t)n_sensors * n_actuators * n_freq;
+    double* frequencies = (double*)malloc((size_t)n_freq * sizeof(double));
+    double* omegas = (double*)malloc((size_t)n_freq * sizeof(double));
+    double* H = (double*)malloc(2 * n_values * sizeof(double));
+    double* H_direct = (double*)malloc(2 * (size_t)n_sensors * n_actuators *
+                                       (opts->n_frf_direct > 0 ? opts->n_frf_direct : 1) *
+                                       sizeof(double));
+    if (!frequencies || !omegas || !H || !H_direct ||
+        ((opts->frf_residual || opts->n_frf_direct > 0) && !A)) {
+        fprintf(stderr, "Error: Memory allocation failed for the FRF\n");
+        free(frequencies);
+        free(omegas);
+        free(H);
+        free(H_direct);
+        free_sparse_matrix(built_A);
+        free_sparse_matrix(built_B);
+        return -1;
+    }
+    for (int f = 0; f < n_freq; f++) {
+        frequencies[f] = n_freq > 1 ? opts->frf_min + (opts->frf_max - opts->frf_min) * f /
+                                                          (n_freq - 1)
+                                    : opts->frf_min;
+        omegas[f] = 2.0 * PI * frequencies[f];
+    }
+    
+    // Force unité au point: densité 1/h² sur la grille, charge nodale 1 sur un opérateur importé
+    FrfProblem problem = {sensors, n_sensors, actuators, n_actuators, omegas, n_freq,
+                          opts->damping, opts->frf_damping,
+                          loaded ? 1.0 : 1.0 / (mesh->h * mesh->h),
+                          opts->frf_residual ? A : NULL, opts->memory_budget};
+    LinearOperator mass = B ? csr_operator(B) : mass_operator(mesh);
+    
+    double start = profiler_now();
+    int status = frf_modal(results, &mass, &problem, H);
+    double seconds = profiler_now() - start;
+    if (status == 0) {
+        printf("%d sensors x %d actuators x %d frequencies (%.3g-%.3g Hz), %d modes, %s damping "
+               "%.3g%s\n", n_sensors, n_actuators, n_freq, frequencies[0], frequencies[n_freq - 1],
+               results->n_eigenvalues, opts->frf_damping == FRF_VISCOUS ? "viscous" : "hysteretic",
+               opts->damping, opts->frf_residual ? ", residual flexibility" : "");
+        printf("Modal sum: %.3f s (%.1f M FRF values/s)\n", seconds,
+               seconds > 0.0 ? n_values / seconds / 1e6 : 0.0);
+    }
+    
+    // Validation: résolution directe aux fréquences choisies, écart à la somme modale
+    int n_direct = opts->n_frf_direct;
+    int n_pairs = n_sensors * n_actuators;
+    if (n_direct > 0 && status == 0) {
+        double direct_omegas[MAX_FRF_DIRECT];
+        for (int d = 0; d < n_direct; d++) direct_omegas[d] = 2.0 * PI * opts->frf_direct[d];
+        FrfProblem checked = problem;
+        checked.omegas = direct_omegas;
+        checked.n_frequencies = n_direct;
+        double* Hm = (double*)malloc(2 * (size_t)n_pairs * n_direct * sizeof(double));
+        status = Hm ? frf_modal(results, &mass, &checked, Hm) : -1;
+        for (int d = 0; d < n_direct && status == 0; d++) {
+            double* Hd = H_direct + 2 * (size_t)d * n_pairs;
+            if (frf_direct(A, B, &problem, direct_omegas[d], Hd) != 0) {
+                status = -1;
+                break;
+            }
+            double diff = 0.0, norm = 0.0;
+            for (int pair = 0; pair < n_pairs; pair++) {
+                const double* h = Hm + 2 * ((size_t)pair * n_direct + d);
+                diff = fmax(diff, hypot(h[0] - Hd[2 * pair], h[1] - Hd[2 * pair + 1]));
+                norm = fmax(norm, hypot(Hd[2 * pair], Hd[2 * pair + 1]));
+            }
+            printf("Direct solve at %8.3f Hz: max |H| = %.4e, modal sum deviation %.2e\n",
+                   opts->frf_direct[d], norm, norm > 0.0 ? diff / norm : diff);
+        }
+        free(Hm);
+    }
+    
+    // Archive: H (capteurs x actionneurs x fréquences, complexe), fréquences, positions
+    if (status == 0) {
+        double sensor_xy[2 * MAX_PROBES], actuator_xy[2 * MAX_PROBES];
+        probe_coordinates(mesh, sensors, n_sensors, sensor_xy);
+        probe_coordinates(mesh, actuators, n_actuators, actuator_xy);
+        size_t shape_H[3] = {(size_t)n_sensors, (size_t)n_actuators, (size_t)n_freq};
+        size_t shape_f[1] = {(size_t)n_freq};
+        size_t shape_s[2] = {(size_t)n_sensors, 2};
+        size_t shape_a[2] = {(size_t)n_actuators, 2};
+        size_t shape_d[3] = {(size_t)opts->n_frf_direct, (size_t)n_sensors, (size_t)n_actuators};
+        size_t shape_df[1] = {(size_t)opts->n_frf_direct};
+        NpzWriter* npz = npz_open(opts->frf_file);
+        int failed = !npz ||
+                     npz_add_array(npz, "H", NPY_COMPLEX128, 3, shape_H, H) != 0 ||
+                     npz_add_array(npz, "frequencies", NPY_FLOAT64, 1, shape_f, frequencies) != 0 ||
+                     npz_add_array(npz, "sensors", NPY_FLOAT64, 2, shape_s, sensor_xy) != 0 ||
+                     npz_add_array(npz, "actuators", NPY_FLOAT64, 2, shape_a, actuator_xy) != 0;
+        if (!failed && opts->n_frf_direct > 0) {
+            failed = npz_add_array(npz, "H_direct", NPY_COMPLEX128, 3, shape_d, H_direct) != 0 ||
+                     npz_add_array(npz, "frequencies_direct", NPY_FLOAT64, 1, shape_df,
+                                   opts->frf_direct) != 0;
+        }
+        if (npz && npz_close(npz) != 0) failed = 1;
+        if (failed) {
+            fprintf(stderr, "Error: Cannot write %s\n", opts->frf_file);
+            status = -1;
+        } else {
+            printf("FRF saved in %s (%.1f MB)\n", opts->frf_file, 16.0 * n_values / 1e6);
+        }
+    }
+    
+    free(frequencies);
+    free(omegas);
+    free(H);
+    free(H_direct);
+    free_sparse_matrix(built_A);
+    free_sparse_matrix(built_B);
+    return status;
+}
+
+// ============ SENSIBILITES ============
+
+static int run_sensitivities(Mesh* mesh, const MembraneParams* params,
+                             const EigenResults* results) {
+    if (!mesh || mesh->total_points != results->n_dof) {
+        printf("Sensitivities skipped: the operator is not on a square grid\n");
+        return -1;
+    }
+    
+    double start = profiler_now();
+    EigenSensitivities* sens = compute_eigen_sensitivities(mesh, params, results);
+    if (!sens) return -1;
+    printf("%d modes x %d points in %.3f s\n", sens->n_modes, sens->n_points,
+           profiler_now() - start);
+    if (sens->n_clustered > 0) {
+        fprintf(stderr, "Warning: %d modes belong to repeated eigenvalues, they get the "
+                "derivative of their group mean (see 'cluster')\n", sens->n_clustered);
+    }
+    
+    if (sens->has_obstacle) {
+        printf("Mode   dλ/dx0        dλ/dy0        dλ/dstrength  dλ/dwidth\n");
+        for (int i = 0; i < sens->n_modes && i < 10; i++) {
+            const double* g = sens->obstacle + (size_t)i * SENSITIVITY_N_OBSTACLE;
+            printf("%4d  %12.5e  %12.5e  %12.5e  %12.5e\n", i + 1, g[0], g[1], g[2], g[3]);
+        }
+    } else {
+        printf("q is not the default obstacle: no obstacle gradients\n");
+    }
+    
+    // Dérivées nodales rangées comme les modes: (mode, i, j) en ordre C
+    const char* filename = "data/sensitivities.npz";
+    size_t shape_fields[3] = {(size_t)sens->n_modes, (size_t)mesh->N, (size_t)mesh->N};
+    size_t shape_modes[1] = {(size_t)sens->n_modes};
+    size_t shape_obstacle[2] = {(size_t)sens->n_modes, SENSITIVITY_N_OBSTACLE};
+    NpzWriter* npz = npz_open(filename);
+    int failed = !npz ||
+                 npz_add_array(npz, "eigenvalues", NPY_FLOAT64, 1, shape_modes,
+                               results->eigenvalues) != 0 ||
+                 npz_add_array(npz, "dp", NPY_FLOAT64, 3, shape_fields, sens->dp) != 0 ||
+                 npz_add_array(npz, "dw", NPY_FLOAT64, 3, shape_fields, sens->dw) != 0 ||
+                 npz_add_array(npz, "dq", NPY_FLOAT64, 3, shape_fields, sens->dq) != 0 ||
+                 npz_add_array(npz, "cluster", NPY_INT32, 1, shape_modes, sens->cluster) != 0;
+    if (!failed && sens->has_obstacle) {
+        failed = npz_add_array(npz, "obstacle", NPY_FLOAT64, 2, shape_obstacle,
+                               sens->obstacle) != 0;
+    }
+    if (npz && npz_close(npz) != 0) failed = 1;
+    if (failed) fprintf(stderr, "Error: Cannot write %s\n", filename);
+    else printf("Sensitivities saved in %s\n", filename);
+    
+    free_eigen_sensitivities(sens);
+    return failed ? -1 : 0;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s [N] [modes] [options]\n", program);
+    printf("  --job FILE   Job file (lines 'key = value': N, modes, p, w, q, obstacle_x, ...)\n");
+    printf("  --N N        Grid size, --modes K  Number of modes (same as positional)\n");
+    printf("  --p EXPR     Tension p(x,y), e.g. \"1 + 0.5*sin(2*pi*x)*cos(2*pi*y)\"\n");
+    printf("  --w EXPR     Density w(x,y)\n");
+    printf("  --q EXPR     Potential q(x,y) (default: Gaussian obstacle)\n");
+    printf("  --obstacle X,Y,S,W   Default obstacle q = S exp(-W r^2) centered at (X, Y)\n");
+    printf("  --format F           Format of all data outputs: csv or npy\n");
+    printf("  --mesh-format F      Mesh output (mesh_data.csv / mesh_data.npz)\n");
+    printf("  --matrix-format F    Matrices A and B (CSV triplets / scipy .npz)\n");
+    printf("  --pattern-format F   Density image (and full pattern) of A\n");
+    printf("  --sparsity M         Sparsity output: density (binned image + stats, default)\n");
+    printf("                       or full (also one entry per nonzero)\n");
+    printf("  --mode-format F      Mode shapes (mode_XX.csv / mode_XX.npy)\n");
+    printf("  --modes-file FILE    Keep all eigenvectors in a memory-mapped .npy (n x k)\n");
+    printf("  --mode-archive FILE  All modes in one compressed archive (.modz, coordinates once)\n");
+    printf("  --mode-encoding E    Archive values: quantized (default), float32 or float64\n");
+    printf("  --mode-error EPS     Quantization error bound relative to max|phi| (default %g)\n",
+           MODE_ARCHIVE_DEFAULT_ERROR);
+    printf("  --mode-codec C       Archive blocks: lz (byte shuffle + LZ, default) or none\n");
+    printf("  --io-threads T       Background writer threads (0 = synchronous, default 1)\n");
+    printf("  --io-budget MB       Memory allowed for pending outputs (default 512)\n");
+    printf("  --load-A FILE        Solve on a precomputed operator (.csrb or .mtx)\n");
+    printf("  --load-B FILE        Mass matrix for --load-A (default: identity)\n");
+    printf("  --save-matrices P    Write A and B as P_A.csrb / P_B.csrb\n");
+    printf("  --plots B            Image rendering: native (PNG in-process, default) or python\n");
+    printf("  --animation F        Mode animation: gif (default), raw (RGB24 frames for ffmpeg) or none\n");
+    printf("  --frames N           Animation length in frames (default 120)\n");
+    printf("  --solver S           Eigensolver: auto (default: fastest plan within the memory\n");
+    printf("                       budget), dense, dense-partial, banded, lobpcg or matrix-free\n");
+    printf("  --no-symmetry        Solve the full grid even when p, w and q are invariant under\n");
+    printf("                       x <-> 1-x, y <-> 1-y or x <-> y (default: one solve per class)\n");
+    printf("  --memory-budget MB   Memory allowed to the solve (default: 80%% of available)\n");
+    printf("  --threads T          Compute threads shared by the concurrent solves\n");
+    printf("                       (default: all cores of the affinity mask)\n");
+    printf("  --no-pin             Do not pin thread groups to their cores\n");
+    printf("  --tol EPS            Relative residual tolerance of the iterative solver\n");
+    printf("  --max-iter N         Iteration limit of the iterative solver\n");
+    printf("  --checkpoint FILE    Save the iterative solver state periodically\n");
+    printf("  --checkpoint-every N Iterations between checkpoints (default 50)\n");
+    printf("  --restart            Resume the iterative solve from --checkpoint\n");
+    printf("  --stream FILE        Send each eigenpair to FILE (or a named pipe) as it converges\n");
+    printf("  --profile FILE       Performance report (JSON, default data/profile.json)\n");
+    printf("  --perf               Hardware counters per phase (also MEMBRANE_PERF=1)\n");
+    printf("  --response T         Modal time response over [0, T] (data/response.npy, S x N x N)\n");
+    printf("  --response-steps S   Snapshots of the response (default 200)\n");
+    printf("  --initial EXPR       Initial displacement u0(x,y) of the response\n");
+    printf("  --load EXPR          Distributed load f(x,y), step or harmonic (--load-freq)\n");
+    printf("  --force X,Y[,P]      Point load of magnitude P (default 1) at (X, Y)\n");
+    printf("  --load-freq F        Harmonic load sin(2 pi F t) instead of a step\n");
+    printf("  --damping Z          Modal damping ratio of the response (default 0)\n");
+    printf("  --response-file F    Output of the response (default data/response.npy)\n");
+    printf("  --wave T             Explicit leapfrog integration over [0, T] instead of modes\n");
+    printf("                       (uses --initial, --load, --force, --load-freq)\n");
+    printf("  --wave-dt DT         Time step of --wave (default: CFL limit x --cfl)\n");
+    printf("  --cfl C              Fraction of the stability limit (default 0.9)\n");
+    printf("  --sensor X,Y         Record u(X, Y) in --wave / --frf (repeatable, default center)\n");
+    printf("  --sample-every K     Steps between two sensor samples (default 1)\n");
+    printf("  --wave-file F        Sensor samples of --wave (default data/wave_sensors.npy)\n");
+    printf("  --frf FMIN:FMAX:COUNT  Frequency responses over COUNT frequencies in Hz (data/frf.npz)\n");
+    printf("  --actuator X,Y       FRF excitation point (repeatable, default: the sensors)\n");
+    printf("  --frf-damping M      Modal damping model of --damping: viscous or hysteretic\n");
+    printf("  --frf-direct F1,...  Check the modal FRF by direct banded solves at these Hz\n");
+    printf("  --no-residual        No residual flexibility correction for truncated modes\n");
+    printf("  --frf-file F         Output of the FRF (default data/frf.npz)\n");
+    printf("  --sensitivities      dλ/dp, dλ/dw, dλ/dq at every point and obstacle gradients\n");
+    printf("                       (data/sensitivities.npz)\n");
+    printf("  --serve PATH         Stay resident and solve jobs received on a Unix socket\n");
+    printf("                       (\"-\": jobs on stdin, replies on stdout)\n");
+    printf("  --workers W          Server worker groups sharing --threads (default: cores / 2)\n");
+    printf("  --operator-cache N   Assembled operators kept by the server (default 8)\n");
+    printf("  --cache DIR          Result cache directory (default: cache)\n");
+    printf("  --no-cache           Always solve, never read or write the cache\n");
+    printf("  --cache-limit MB     Cache size before LRU eviction (default 1024)\n");
+}
+
+// Arguments positionnels [N] [modes] puis options, appliqués dans l'ordre
+static int parse_arguments(int argc, char* argv[], RunOptions* opts) {
+    JobSpec* job = &opts->job;
+    OutputOptions* outputs = &opts->outputs;
+    int positional = 0;
+    
+    for (int a = 1; a < argc; a++) {
+        const char* arg = argv[a];
+        
+        if (strncmp(arg, "--", 2) != 0) {
+            if (positional == 0) job->N = atoi(arg);
+            else if (positional == 1) job->n_eigenvalues = atoi(arg);
+            else {
+                fprintf(stderr, "Error: Unexpected argument '%s'\n", arg);
+                return -1;
+            }
+            positional++;
+            continue;
+        }
+        
+        if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        }
+        if (strcmp(arg, "--no-cache") == 0) {
+            opts->cache_dir = NULL;
+            continue;
+        }
+        if (strcmp(arg, "--restart") == 0) {
+            opts->restart = 1;
+            continue;
+        }
+        if (strcmp(arg, "--perf") == 0) {
+            opts->perf_counters = 1;
+            continue;
+        }
+        if (strcmp(arg, "--no-pin") == 0) {
+            opts->pin_threads = 0;
+            continue;
+        }
+        if (strcmp(arg, "--sensitivities") == 0) {
+            opts->sensitivities = 1;
+            continue;
+        }
+        if (strcmp(arg, "--no-residual") == 0) {
+            opts->frf_residual = 0;
+            continue;
+        }
+        if (strcmp(arg, "--no-symmetry") == 0) {
+            opts->symmetry = 0;
+            continue;
+        }
+        
+        if (a + 1 >= argc) {
+            fprintf(stderr, "Error: Option %s requires a value\n", arg);
+            return -1;
+        }
+        const char* value = argv[++a];
+        
+        if (strcmp(arg, "--job") == 0) {
+            if (job_spec_load_file(job, value) != 0) return -1;
+        } else if (strcmp(arg, "--p") == 0 || strcmp(arg, "--w") == 0 || strcmp(arg, "--q") == 0 ||
+                   strcmp(arg, "--N") == 0 || strcmp(arg, "--modes") == 0) {
+            if (job_spec_set(job, arg + 2, value) != 0) return -1;
+        } else if (strcmp(arg, "--obstacle") == 0) {
+            if (sscanf(value, "%lf,%lf,%lf,%lf", &job->obstacle[0], &job->obstacle[1],
+                       &job->obstacle[2], &job->obstacle[3]) != 4) {
+                fprintf(stderr, "Error: --obstacle expects X,Y,STRENGTH,WIDTH\n");
+                return -1;
+            }
+        } else if (strcmp(arg, "--format") == 0) {
+            OutputFormat format;
+            if (parse_output_format(value, &format) != 0) return -1;
+            outputs->mesh = outputs->matrices = outputs->pattern = outputs->modes = format;
+        } else if (strcmp(arg, "--mesh-format") == 0) {
+            if (parse_output_format(value, &outputs->mesh) != 0) return -1;
+        } else if (strcmp(arg, "--matrix-format") == 0) {
+            if (parse_output_format(value, &outputs->matrices) != 0) return -1;
+        } else if (strcmp(arg, "--pattern-format") == 0) {
+            if (parse_output_format(value, &outputs->pattern) != 0) return -1;
+        } else if (strcmp(arg, "--sparsity") == 0) {
+            if (parse_sparsity_mode(value, &outputs->sparsity) != 0) return -1;
+        } else if (strcmp(arg, "--mode-format") == 0) {
+            if (parse_output_format(value, &outputs->modes) != 0) return -1;
+        } else if (strcmp(arg, "--modes-file") == 0) {
+            opts->modes_file = value;
+        } else if (strcmp(arg, "--mode-archive") == 0) {
+            opts->mode_archive = value;
+        } else if (strcmp(arg, "--mode-encoding") == 0) {
+            if (parse_mode_encoding(value, &opts->archive.encoding) != 0) return -1;
+        } else if (strcmp(arg, "--mode-error") == 0) {
+            opts->archive.error_bound = atof(value);
+        } else if (strcmp(arg, "--mode-codec") == 0) {
+            if (strcmp(value, "lz") != 0 && strcmp(value, "none") != 0) {
+                fprintf(stderr, "Error: Unknown mode codec '%s' (expected lz or none)\n", value);
+                return -1;
+            }
+            opts->archive.compress = strcmp(value, "lz") == 0;
+        } else if (strcmp(arg, "--io-threads") == 0) {
+            opts->io_threads = atoi(value);
+        } else if (strcmp(arg, "--io-budget") == 0) {
+            opts->io_budget = (size_t)atol(value) << 20;
+        } else if (strcmp(arg, "--animation") == 0) {
+            if (parse_animation_format(value, &opts->animation.format) != 0) return -1;
+        } else if (strcmp(arg, "--frames") == 0) {
+            opts->animation.n_frames = atoi(value);
+        } else if (strcmp(arg, "--profile") == 0) {
+            opts->profile_file = value;
+        } else if (strcmp(arg, "--stream") == 0) {
+            opts->stream_sink = value;
+        } else if (strcmp(arg, "--load-A") == 0) {
+            opts->load_A = value;
+        } else if (strcmp(arg, "--load-B") == 0) {
+            opts->load_B = value;
+        } else if (strcmp(arg, "--save-matrices") == 0) {
+            opts->save_prefix = value;
+        } else if (strcmp(arg, "--plots") == 0) {
+            if (parse_plot_backend(value, &opts->plots) != 0) return -1;
+        } else if (strcmp(arg, "--solver") == 0) {
+            if (parse_solver_type(value, &opts->solver) != 0) return -1;
+        } else if (strcmp(arg, "--memory-budget") == 0) {
+            opts->memory_budget = (size_t)atol(value) << 20;
+        } else if (strcmp(arg, "--threads") == 0) {
+            opts->threads = atoi(value);
+        } else if (strcmp(arg, "--response") == 0) {
+            opts->response_time = atof(value);
+        } else if (strcmp(arg, "--response-steps") == 0) {
+            opts->response_steps = atol(value);
+        } else if (strcmp(arg, "--initial") == 0) {
+            opts->response_initial = value;
+        } else if (strcmp(arg, "--load") == 0) {
+            opts->response_load = value;
+        } else if (strcmp(arg, "--force") == 0) {
+            opts->force_amplitude = 1.0;
+            if (sscanf(value, "%lf,%lf,%lf", &opts->force_x, &opts->force_y,
+                       &opts->force_amplitude) < 2) {
+                fprintf(stderr, "Error: --force expects X,Y or X,Y,P\n");
+                return -1;
+            }
+            opts->point_force = 1;
+        } else if (strcmp(arg, "--load-freq") == 0) {
+            opts->load_frequency = atof(value);
+        } else if (strcmp(arg, "--damping") == 0) {
+            opts->damping = atof(value);
+        } else if (strcmp(arg, "--response-file") == 0) {
+            opts->response_file = value;
+        } else if (strcmp(arg, "--wave") == 0) {
+            opts->wave_time = atof(value);
+        } else if (strcmp(arg, "--wave-dt") == 0) {
+            opts->wave_dt = atof(value);
+        } else if (strcmp(arg, "--cfl") == 0) {
+            opts->cfl = atof(value);
+        } else if (strcmp(arg, "--sensor") == 0) {
+            if (opts->n_sensors == MAX_PROBES) {
+                fprintf(stderr, "Error: At most %d sensors\n", MAX_PROBES);
+                return -1;
+            }
+            double* sensor = opts->sensors[opts->n_sensors];
+            if (sscanf(value, "%lf,%lf", &sensor[0], &sensor[1]) != 2) {
+                fprintf(stderr, "Error: --sensor expects X,Y\n");
+                return -1;
+            }
+            opts->n_sensors++;
+        } else if (strcmp(arg, "--sample-every") == 0) {
+            opts->sample_every = atoi(value);
+        } else if (strcmp(arg, "--wave-file") == 0) {
+            opts->wave_file = value;
+        } else if (strcmp(arg, "--frf") == 0) {
+            if (sscanf(value, "%lf:%lf:%d", &opts->frf_min, &opts->frf_max, &opts->frf_count) != 3 ||
+                opts->frf_count < 1 || opts->frf_min < 0.0 || opts->frf_max < opts->frf_min) {
+                fprintf(stderr, "Error: --frf expects FMIN:FMAX:COUNT (Hz)\n");
+                return -1;
+            }
+        } else if (strcmp(arg, "--actuator") == 0) {
+            if (opts->n_actuators == MAX_PROBES) {
+                fprintf(stderr, "Error: At most %d actuators\n", MAX_PROBES);
+                return -1;
+            }
+            double* actuator = opts->actuators[opts->n_actuators];
+            if (sscanf(value, "%lf,%lf", &actuator[0], &actuator[1]) != 2) {
+                fprintf(stderr, "Error: --actuator expects X,Y\n");
+                return -1;
+            }
+            opts->n_actuators++;
+        } else if (strcmp(arg, "--frf-damping") == 0) {
+            if (strcmp(value, "viscous") == 0) {
+                opts->frf_damping = FRF_VISCOUS;
+            } else if (strcmp(value, "hysteretic") == 0) {
+                opts->frf_damping = FRF_HYSTERETIC;
+            } else {
+                fprintf(stderr, "Error: Unknown damping model '%s' (expected viscous or "
+                                "hysteretic)\n", value);
+                return -1;
+            }
+        } else if (strcmp(arg, "--frf-direct") == 0) {
+            char list[256];
+            snprintf(list, sizeof(list), "%s", value);
+            opts->n_frf_direct = 0;
+            for (char* item = strtok(list, ","); item; item = strtok(NULL, ",")) {
+                if (opts->n_frf_direct == MAX_FRF_DIRECT) {
+                    fprintf(stderr, "Error: At most %d direct FRF frequencies\n", MAX_FRF_DIRECT);
+                    return -1;
+                }
+                opts->frf_direct[opts->n_frf_direct++] = atof(item);
+            }
+        } else if (strcmp(arg, "--frf-file") == 0) {
+            opts->frf_file = value;
+        } else if (strcmp(arg, "--serve") == 0) {
+            opts->serve = value;
+        } else if (strcmp(arg, "--workers") == 0) {
+            opts->workers = atoi(value);
+        } else if (strcmp(arg, "--operator-cache") == 0) {
+            opts->operator_cache = atoi(value);
+        } else if (strcmp(arg, "--tol") == 0) {
+            opts->tolerance = atof(value);
+        } else if (strcmp(arg, "--max-iter") == 0) {
+            opts->max_iterations = atoi(value);
+        } else if (strcmp(arg, "--checkpoint") == 0) {
+            opts->checkpoint_file = value;
+        } else if (strcmp(arg, "--checkpoint-every") == 0) {
+            opts->checkpoint_interval = atoi(value);
+        } else if (strcmp(arg, "--cache") == 0) {
+            opts->cache_dir = value;
+        } else if (strcmp(arg, "--cache-limit") == 0) {
+            opts->cache_limit = (size_t)atol(value) << 20;
+        } else {
+            fprintf(stderr, "Error: Unknown option %s\n", arg);
+            print_usage(argv[0]);
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+
+// --serve -: la sortie standard ne porte que le protocole, dès la première ligne
+static int serves_on_stdin(int argc, char* argv[]) {
+    for (int a = 1; a + 1 < argc; a++) {
+        if (strcmp(argv[a], "--serve") == 0 && strcmp(argv[a + 1], "-") == 0) return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
-    printf("========================================\n");
-    printf("  Membrane Vibration Solver\n");
-    printf("  Using Intel MKL\n");
-    printf("========================================\n\n");
+    FILE* banner = serves_on_stdin(argc, argv) ? stderr : stdout;
+    fprintf(banner, "========================================\n");
+    fprintf(banner, "  Membrane Vibration Solver\n");
+    fprintf(banner, "  Using Intel MKL\n");
+    fprintf(banner, "========================================\n\n");
     
-    clock_t start_time = clock();
+    double start_time = profiler_now();
     
     // ============ CONFIGURATION ============
-    int N = 50;                     // Points par dimension (50x50 = 2500 DOF)
-    int n_eigenvalues = 10;        // Nombre de modes à calculer
+    RunOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    job_spec_init(&opts.job);      // N = 50 (2500 DOF), 10 modes
+    opts.outputs = (OutputOptions){OUTPUT_CSV, OUTPUT_CSV, OUTPUT_CSV, OUTPUT_CSV, SPARSITY_DENSITY};
+    opts.io_threads = 1;
+    opts.io_budget = (size_t)512 << 20;
+    opts.cache_dir = "cache";
+    opts.cache_limit = (size_t)1024 << 20;
+    opts.solver = SOLVER_AUTO;
+    opts.plots = PLOT_NATIVE;
+    opts.animation = (AnimationOptions){ANIMATION_GIF, 120, 320, 25};
+    opts.checkpoint_interval = 50;
+    opts.profile_file = "data/profile.json";
+    opts.pin_threads = 1;
+    opts.operator_cache = 8;
+    opts.response_steps = 200;
+    opts.response_file = "data/response.npy";
+    opts.wave_file = "data/wave_sensors.npy";
+    opts.frf_damping = FRF_VISCOUS;
+    opts.frf_residual = 1;
+    opts.frf_file = "data/frf.npz";
+    opts.symmetry = 1;
+    opts.archive = (ModeArchiveOptions){MODE_QUANTIZED, MODE_ARCHIVE_DEFAULT_ERROR, 1};
+    const char* perf_env = getenv("MEMBRANE_PERF");
+    opts.perf_counters = perf_env && strcmp(perf_env, "0") != 0;
+    if (parse_arguments(argc, argv, &opts) != 0) return 1;
+    if (opts.restart && !opts.checkpoint_file) {
+        fprintf(stderr, "Error: --restart requires --checkpoint FILE\n");
+        return 1;
+    }
+    if ((opts.response_time > 0.0 || opts.wave_time > 0.0) && !opts.response_initial &&
+        !opts.response_load && !opts.point_force) {
+        fprintf(stderr, "Error: --response and --wave need --initial, --load or --force\n");
+        return 1;
+    }
+    if (opts.n_frf_direct > 0 && opts.frf_count == 0) {
+        fprintf(stderr, "Error: --frf-direct requires --frf\n");
+        return 1;
+    }
+    if (opts.n_frf_direct > 0 && opts.frf_damping == FRF_VISCOUS && opts.damping > 0.0) {
+        fprintf(stderr, "Error: --frf-direct with --damping needs --frf-damping hysteretic\n");
+        return 1;
+    }
+    if (opts.wave_time > 0.0 && opts.load_A) {
+        fprintf(stderr, "Error: --wave integrates on the grid, not on a loaded operator\n");
+        return 1;
+    }
+    if (opts.sensitivities && opts.load_A) {
+        fprintf(stderr, "Error: --sensitivities differentiates the grid coefficients, "
+                "not a loaded operator\n");
+        return 1;
+    }
+    if (opts.serve) {
+        // Processus résident: les jobs arrivent ensuite par la socket (ou stdin)
+        ServerOptions server;
+        server_options_init(&server);
+        server.socket_path = opts.serve;
+        server.workers = opts.workers;
+        server.threads = opts.threads;
+        server.pin = opts.pin_threads;
+        server.operator_cache = opts.operator_cache;
+        server.memory_budget = opts.memory_budget;
+        return run_server(&server) == 0 ? 0 : 1;
+    }
+    set_plot_backend(opts.plots);
+    set_animation_options(&opts.animation);
     
-    if (argc > 1) N = atoi(argv[1]);
-    if (argc > 2) n_eigenvalues = atoi(argv[2]);
+    const JobSpec job = opts.job;
+    const OutputOptions outputs = opts.outputs;
+    int N = job.N;                  // Points par dimension
+    int n_eigenvalues = job.n_eigenvalues;  // Nombre de modes à calculer
+    int loaded = opts.load_A != NULL;
     
-    // Validation des paramètres
-    if (N < 10) {
+    // Validation des paramètres (la taille d'un opérateur importé est vérifiée au chargement)
+    if (!loaded && N < 10) {
         fprintf(stderr, "Error: Grid size N must be at least 10\n");
         return 1;
     }
@@ -38,20 +1262,34 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Error: Must compute at least 1 eigenvalue\n");
         return 1;
     }
-    if (n_eigenvalues > N * N) {
+    if (!loaded && n_eigenvalues > N * N) {
         fprintf(stderr, "Error: Cannot compute more eigenvalues than DOF\n");
         return 1;
     }
     
     printf("Configuration:\n");
-    printf("  Grid size: %d x %d\n", N, N);
-    printf("  Total DOF: %d\n", N * N);
-    printf("  Eigenvalues to compute: %d\n\n", n_eigenvalues);
+    if (loaded) {
+        printf("  Operator: %s (mass: %s)\n", opts.load_A, opts.load_B ? opts.load_B : "identity");
+    } else {
+        printf("  Grid size: %d x %d\n", N, N);
+        printf("  Total DOF: %d\n", N * N);
+    }
+    printf("  Eigenvalues to compute: %d\n", n_eigenvalues);
+    printf("  p(x,y) = %s\n", job.tension[0] ? job.tension : "default");
+    printf("  w(x,y) = %s\n", job.density[0] ? job.density : "default");
+    printf("  q(x,y) = %s\n\n", job.potential[0] ? job.potential : "default");
     
-    // ============ INITIALISATION MKL ============
-    int mkl_threads = 4;
-    mkl_set_num_threads(mkl_threads);
-    printf("MKL configured with %d threads\n\n", mkl_threads);
+    // ============ RESSOURCES DE CALCUL ============
+    // Cœurs partagés ensuite entre la résolution principale et l'étude de convergence
+    ThreadGroup all_cores;
+    resources_detect(opts.threads, &all_cores);
+    if (opts.threads > 0) {
+        mkl_set_num_threads(all_cores.n_cores);
+#ifdef _OPENMP
+        omp_set_num_threads(all_cores.n_cores);
+#endif
+    }
+    printf("Compute threads: %d\n\n", all_cores.n_cores);
     
     // ============ CREATION DU PROBLEME ============
     printf("Creating membrane problem...\n");
@@ -61,58 +1299,231 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
-    Mesh* mesh = create_mesh(N, params);
-    if (!mesh) {
-        fprintf(stderr, "Error: Failed to create mesh\n");
+    if (job_spec_apply(&job, params) != 0) {
         free_membrane_params(params);
         return 1;
     }
     
-    printf("Mesh created with h = %.6f\n", mesh->h);
-    printf("Saving mesh data...\n");
-    
-    // Créer le répertoire data s'il n'existe pas
-    int ret = system("mkdir -p data"); (void)ret;
+    // Créer les répertoires de sortie s'ils n'existent pas
+    int ret = system("mkdir -p data plots"); (void)ret;
     
-    save_mesh(mesh, "data/mesh_data.csv");
-    
-    // ============ CONSTRUCTION DES MATRICES ============
-    printf("\nBuilding stiffness matrix A...\n");
-    SparseMatrixCSR* A = build_stiffness_matrix(mesh);
-    if (!A) {
-        fprintf(stderr, "Error: Failed to build stiffness matrix\n");
-        free_mesh(mesh);
+    // Les sorties sont écrites en arrière-plan pendant les calculs suivants
+    AsyncWriter* writer = async_writer_create(opts.io_threads, opts.io_budget);
+    if (!writer) {
+        fprintf(stderr, "Error: Failed to create output writer\n");
         free_membrane_params(params);
         return 1;
     }
     
-    printf("A: %d x %d, NNZ = %d (Sparsity: %.2f%%)\n", 
-           (int)A->n_rows, (int)A->n_cols, (int)A->nnz, 
-           100.0 * A->nnz / ((double)A->n_rows * A->n_cols));
+    // Compteurs ouverts après le thread d'écriture (qui a les siens), avant les équipes OpenMP
+    if (opts.perf_counters) {
+        int n_counters = perf_counters_enable();
+        if (n_counters > 0) printf("Hardware counters enabled (%d events)\n", n_counters);
+    }
     
-    printf("Building mass matrix B...\n");
-    SparseMatrixCSR* B = build_mass_matrix(mesh);
-    if (!B) {
-        fprintf(stderr, "Error: Failed to build mass matrix\n");
-        free_sparse_matrix(A);
-        free_mesh(mesh);
+    if (opts.wave_time > 0.0) {
+        // ============ INTEGRATION EXPLICITE ============
+        // Pas de modes: le maillage suffit, A et B restent implicites dans le stencil
+        printf("\n=== EXPLICIT WAVE INTEGRATION ===\n");
+        Mesh* wave_mesh = create_mesh(N, params);
+        int status = wave_mesh ? run_wave(&opts, wave_mesh, writer) : -1;
+        async_writer_destroy(writer);
+        free_mesh(wave_mesh);
         free_membrane_params(params);
-        return 1;
+        profiler_print_summary();
+        if (opts.profile_file) profiler_write_json(opts.profile_file);
+        printf("\nTotal execution time: %.2f seconds\n", profiler_now() - start_time);
+        return status == 0 ? 0 : 1;
     }
     
-    printf("B: %d x %d, NNZ = %d\n", 
-           (int)B->n_rows, (int)B->n_cols, (int)B->nnz);
+    Mesh* mesh = NULL;
+    SparseMatrixCSR* A = NULL;
+    SparseMatrixCSR* B = NULL;
+    PlanProblem problem;
+    SolvePlan plan;
     
-    // Sauvegarde des matrices pour analyse
-    save_matrix_csr(A, "data/matrix_A_pattern.csv");
-    save_matrix_csr(B, "data/matrix_B_pattern.csv");
-    plot_matrix_sparsity(A, "plots/matrix_sparsity.png");
+    if (loaded) {
+        // ============ CHARGEMENT DES MATRICES ============
+        printf("\nLoading operator A from %s...\n", opts.load_A);
+        profiler_begin("load_matrices");
+        A = load_matrix(opts.load_A);
+        if (A) {
+            B = opts.load_B ? load_matrix(opts.load_B) : build_identity_matrix(A->n_rows);
+        }
+        profiler_end();
+        
+        if (!A || !B || A->n_rows != A->n_cols ||
+            B->n_rows != A->n_rows || B->n_cols != A->n_cols ||
+            n_eigenvalues > A->n_rows) {
+            fprintf(stderr, "Error: Failed to load a consistent A/B pair\n");
+            async_writer_destroy(writer);
+            free_sparse_matrix(A);
+            free_sparse_matrix(B);
+            free_membrane_params(params);
+            return 1;
+        }
+        
+        // Opérateur sur une grille carrée: maillage utilisé pour les coordonnées des modes
+        N = (int)lround(sqrt((double)A->n_rows));
+        if ((MKL_INT)N * N == A->n_rows) mesh = create_mesh(N, params);
+        
+        printf("A: %d x %d, NNZ = %d%s\n", (int)A->n_rows, (int)A->n_cols, (int)A->nnz,
+               A->mapping ? " (memory-mapped)" : "");
+        printf("B: %d x %d, NNZ = %d\n", (int)B->n_rows, (int)B->n_cols, (int)B->nnz);
+        
+        problem = plan_problem_from_matrices(A, B, n_eigenvalues);
+        int plan_status = plan_solve(&problem, opts.solver, opts.memory_budget, &plan);
+        print_solve_plan(&plan);
+        if (plan_status != 0) {
+            async_writer_destroy(writer);
+            free_sparse_matrix(A);
+            free_sparse_matrix(B);
+            free_mesh(mesh);
+            free_membrane_params(params);
+            return 1;
+        }
+    } else {
+        // ============ PLANIFICATION ============
+        // Avant toute allocation: une grille qu'aucune stratégie ne peut traiter est refusée ici
+        problem = plan_problem_from_grid(N, n_eigenvalues);
+        // Motifs, densité et statistiques de A et B sont écrits à chaque résolution sur grille:
+        // seul un matrix-free explicite s'en passe (l'export binaire les exige toujours)
+        problem.needs_matrices = opts.save_prefix != NULL || opts.solver != SOLVER_MATRIX_FREE;
+        int plan_status = plan_solve(&problem, opts.solver, opts.memory_budget, &plan);
+        if (plan_status != 0 && opts.solver == SOLVER_AUTO && !opts.save_prefix) {
+            // Aucune stratégie assemblée ne tient: sans matrice, sorties matricielles omises
+            problem.needs_matrices = 0;
+            plan_status = plan_solve(&problem, opts.solver, opts.memory_budget, &plan);
+            if (plan_status == 0) {
+                printf("Warning: Only the matrix-free solver fits, matrix outputs are skipped\n");
+            }
+        }
+        print_solve_plan(&plan);
+        if (plan_status != 0) {
+            async_writer_destroy(writer);
+            free_membrane_params(params);
+            return 1;
+        }
+        
+        profiler_begin("mesh");
+        mesh = create_mesh(N, params);
+        profiler_end();
+        if (!mesh) {
+            fprintf(stderr, "Error: Failed to create mesh\n");
+            async_writer_destroy(writer);
+            free_membrane_params(params);
+            return 1;
+        }
+        
+        printf("Mesh created with h = %.6f\n", mesh->h);
+        printf("Saving mesh data...\n");
+        
+        size_t mesh_bytes = 5 * (size_t)mesh->total_points * sizeof(double);
+        queue_output(writer, write_mesh_task,
+                     create_output_task(mesh, NULL, NULL, NULL, outputs), mesh_bytes);
+        
+        if (plan.chosen == SOLVER_MATRIX_FREE) {
+            // Opérateur appliqué par stencil: ni A ni B en mémoire, pas de sorties matricielles
+            printf("\nMatrix-free solve: A and B are not assembled\n");
+        } else {
+            // ============ CONSTRUCTION DES MATRICES ============
+            printf("\nBuilding stiffness matrix A...\n");
+            profiler_begin("assembly");
+            profiler_begin("stiffness");
+            A = build_stiffness_matrix(mesh);
+            if (A) profiler_add_work(0.0, csr_bytes(A));
+            profiler_end();
+            if (!A) {
+                fprintf(stderr, "Error: Failed to build stiffness matrix\n");
+                async_writer_destroy(writer);
+                free_mesh(mesh);
+                free_membrane_params(params);
+                return 1;
+            }
+            
+            printf("A: %d x %d, NNZ = %d (Sparsity: %.2f%%)\n", 
+                   (int)A->n_rows, (int)A->n_cols, (int)A->nnz, 
+                   100.0 * A->nnz / ((double)A->n_rows * A->n_cols));
+            
+            printf("Building mass matrix B...\n");
+            profiler_begin("mass");
+            B = build_mass_matrix(mesh);
+            if (B) profiler_add_work(0.0, csr_bytes(B));
+            profiler_end();
+            profiler_end();
+            if (!B) {
+                fprintf(stderr, "Error: Failed to build mass matrix\n");
+                async_writer_destroy(writer);
+                free_sparse_matrix(A);
+                free_mesh(mesh);
+                free_membrane_params(params);
+                return 1;
+            }
+            
+            printf("B: %d x %d, NNZ = %d\n", 
+                   (int)B->n_rows, (int)B->n_cols, (int)B->nnz);
+            
+            // Sauvegarde des matrices pour analyse (A et B restent valides jusqu'à la barrière finale)
+            size_t matrix_bytes = (size_t)(A->nnz + B->nnz) * (sizeof(double) + sizeof(MKL_INT));
+            queue_output(writer, write_matrices_task,
+                         create_output_task(mesh, A, B, NULL, outputs), matrix_bytes);
+        }
+    }
+    
+    // Export binaire pour les résolutions suivantes (assembler une fois, résoudre souvent)
+    if (opts.save_prefix) {
+        OutputTask* binary_task = create_output_task(mesh, A, B, NULL, outputs);
+        if (binary_task) binary_task->binary_prefix = opts.save_prefix;
+        size_t binary_bytes = (size_t)(A->nnz + B->nnz) * (sizeof(double) + sizeof(MKL_INT));
+        queue_output(writer, write_binary_matrices_task, binary_task, binary_bytes);
+    }
     
     // ============ CONFIGURATION DU SOLVEUR ============
     printf("\nConfiguring solver...\n");
     SolverConfig* config = create_solver_config(n_eigenvalues);
     if (!config) {
         fprintf(stderr, "Error: Failed to create solver configuration\n");
+        async_writer_destroy(writer);
+        free_sparse_matrix(A);
+        free_sparse_matrix(B);
+        free_mesh(mesh);
+        free_membrane_params(params);
+        return 1;
+    }
+    config->eigenvector_file = opts.modes_file;
+    config->solver = plan.chosen;
+    config->mesh = mesh;
+    config->memory_budget = opts.memory_budget;
+    if (opts.tolerance > 0.0) config->eps = opts.tolerance;
+    if (opts.max_iterations > 0) config->max_iterations = opts.max_iterations;
+    config->checkpoint_file = opts.checkpoint_file;
+    config->checkpoint_interval = opts.checkpoint_interval;
+    config->restart = opts.restart;
+    // Maillage d'un opérateur importé: coordonnées seulement, ses coefficients ne décrivent pas A
+    config->symmetry = opts.symmetry && !loaded;
+    printf("Solver: %s\n", solver_type_name(config->solver));
+    profiler_set_info("solver", solver_type_name(config->solver));
+    profiler_set_info_int("dof", A ? (long)A->n_rows : (long)mesh->total_points);
+    profiler_set_info_int("grid_size", loaded ? 0 : N);
+    profiler_set_info_int("modes", n_eigenvalues);
+    profiler_set_info_int("nnz_A", A ? (long)A->nnz : 0);
+    
+    // Cache des résultats: clé = coefficients échantillonnés ou opérateur importé
+    ResultCache cache;
+    memset(&cache, 0, sizeof(cache));
+    if (opts.cache_dir) result_cache_init(&cache, opts.cache_dir, opts.cache_limit);
+    ProblemKey problem_key = mesh && !loaded ? problem_key_from_mesh(mesh)
+                                             : problem_key_from_matrices(A, B);
+    
+    // Livraison des paires dès leur convergence: table, premiers modes, flux optionnel
+    int modes_to_save = n_eigenvalues < 5 ? n_eigenvalues : 5;
+    ModeStream* stream = mode_stream_create(mesh, modes_to_save, outputs.modes, "data/eigenvalues.csv",
+                                            opts.stream_sink, writer);
+    if (stream) {
+        mode_stream_attach(stream, config);
+    } else if (opts.stream_sink) {
+        async_writer_destroy(writer);
+        free_solver_config(config);
         free_sparse_matrix(A);
         free_sparse_matrix(B);
         free_mesh(mesh);
@@ -120,17 +1531,103 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
+    // ============ REPARTITION DES COEURS ============
+    // Résolution principale et grilles de l'étude en parallèle, chacune dans son groupe de
+    // threads dimensionné par le modèle de coût du planificateur
+    int test_sizes[] = {20, 30, 40, 50, 60};
+    int n_sizes = loaded ? 0 : (N < 60 ? 3 : 5);     // Seulement 3 tailles si N est petit
+    int size_task[5];               // Tâche de chaque grille (0: résolution principale, -1: aucune)
+    SolveTask tasks[MAX_SOLVE_TASKS];
+    memset(tasks, 0, sizeof(tasks));
+    tasks[0].N = N;
+    tasks[0].problem = problem;
+    tasks[0].solver = plan.chosen;
+    int n_tasks = 1;
+    double study_memory = plan.estimates[plan.chosen].memory_bytes;
+    
+    for (int s = 0; s < n_sizes; s++) {
+        // La grille principale n'est pas résolue deux fois
+        size_task[s] = test_sizes[s] == N && n_eigenvalues >= CONVERGENCE_MODES ? 0 : -1;
+        if (size_task[s] == 0) continue;
+        
+        SolveTask* task = &tasks[n_tasks];
+        SolvePlan size_plan;
+        task->N = test_sizes[s];
+        task->problem = plan_problem_from_grid(test_sizes[s], CONVERGENCE_MODES);
+        // Stratégie demandée si elle convient à cette grille, sinon la plus rapide
+        if (plan_solve(&task->problem, opts.solver, opts.memory_budget, &size_plan) != 0 &&
+            plan_solve(&task->problem, SOLVER_AUTO, opts.memory_budget, &size_plan) != 0) {
+            fprintf(stderr, "Warning: No solver fits the convergence grid N=%d\n", test_sizes[s]);
+            continue;
+        }
+        task->solver = size_plan.chosen;
+        study_memory += size_plan.estimates[size_plan.chosen].memory_bytes;
+        size_task[s] = n_tasks++;
+    }
+    
+    // Résolutions simultanées au-delà du budget mémoire: un seul groupe, tâches en file
+    int max_groups = study_memory <= (double)plan.budget ? 0 : 1;
+    if (max_groups == 1 && n_tasks > 1) {
+        printf("Convergence solves run one after another to stay within the memory budget\n");
+    }
+    
+    ThreadGroup groups[MAX_SOLVE_TASKS];
+    int task_group[MAX_SOLVE_TASKS];
+    double makespan = 0.0, sequential = 0.0;
+    int n_groups = resources_partition(&all_cores, n_tasks, solve_task_cost, tasks, max_groups,
+                                       task_group, groups, &makespan);
+    if (n_groups == 0) {
+        n_groups = 1;
+        groups[0] = all_cores;
+        for (int t = 0; t < n_tasks; t++) task_group[t] = 0;
+    }
+    for (int t = 0; t < n_tasks; t++) {
+        tasks[t].group = task_group[t];
+        sequential += solve_task_cost(t, all_cores.n_cores, tasks);
+    }
+    int pin = opts.pin_threads && n_groups > 1;
+    if (n_tasks > 1) print_thread_groups(groups, n_groups, tasks, n_tasks, pin, makespan, sequential);
+    profiler_set_info_int("compute_threads", all_cores.n_cores);
+    profiler_set_info_int("thread_groups", n_groups);
+    
+    SolveLane lanes[MAX_SOLVE_TASKS];
+    memset(lanes, 0, sizeof(lanes));
+    int main_group = tasks[0].group;
+    for (int g = 0; g < n_groups; g++) {
+        lanes[g].tasks = tasks;
+        lanes[g].n_tasks = n_tasks;
+        lanes[g].group = g;
+        lanes[g].threads = &groups[g];
+        lanes[g].pin = pin;
+        lanes[g].params = params;
+        lanes[g].cache = &cache;
+        lanes[g].reference = config;
+        if (g != main_group) {
+            lanes[g].started = pthread_create(&lanes[g].thread, NULL, lane_thread, &lanes[g]) == 0;
+        }
+    }
+    
+    // Le thread principal travaille dans son propre groupe jusqu'à la fin de l'étude
+    ThreadState main_state;
+    thread_group_enter(&groups[main_group], pin, &main_state);
+    config->mkl_threads = groups[main_group].n_cores;
+    
     // ============ RESOLUTION ============
     printf("\nSolving eigenvalue problem...\n");
-    clock_t solve_start = clock();
+    double solve_start = profiler_now();
     
-    EigenResults* results = solve_eigenproblem(A, B, config);
+    profiler_begin("solve");
+    EigenResults* results = solve_eigenproblem_cached(&cache, problem_key, A, B, config);
+    profiler_end();
     
-    clock_t solve_end = clock();
-    double solve_time = ((double)(solve_end - solve_start)) / CLOCKS_PER_SEC;
+    double solve_time = profiler_now() - solve_start;
     
     if (!results) {
         fprintf(stderr, "Error: Eigenvalue solver failed\n");
+        join_lanes(lanes, n_groups, main_group, 0);
+        thread_group_leave(&main_state);
+        async_writer_destroy(writer);
+        mode_stream_close(stream);
         free_solver_config(config);
         free_sparse_matrix(A);
         free_sparse_matrix(B);
@@ -147,6 +1644,11 @@ int main(int argc, char *argv[]) {
     }
     printf("\n");
     
+    tasks[0].seconds = solve_time;
+    tasks[0].n_found = results->n_eigenvalues < CONVERGENCE_MODES ? results->n_eigenvalues
+                                                                  : CONVERGENCE_MODES;
+    for (int i = 0; i < tasks[0].n_found; i++) tasks[0].eigenvalues[i] = results->eigenvalues[i];
+    
     // ============ RESULTATS ============
     printf("\n=== EIGENVALUES ===\n");
     print_eigenvalues(results, n_eigenvalues);
@@ -159,113 +1661,129 @@ int main(int argc, char *argv[]) {
                i+1, results->eigenvalues[i], freq);
     }
     
-    // ============ VISUALISATION ============
-    printf("\nGenerating visualizations...\n");
-    
-    // Créer le répertoire data s'il n'existe pas
-    ret = system("mkdir -p data"); (void)ret;
+    // ============ REPONSE TEMPORELLE ============
+    if (opts.response_time > 0.0) {
+        printf("\n=== MODAL TIME RESPONSE ===\n");
+        run_modal_response(&opts, mesh, B, results);
+    }
     
-    // Sauvegarde des modes propres avec messages DEBUG
-    int modes_to_save = (results->n_eigenvalues < 5) ? results->n_eigenvalues : 5;
-    for (int i = 0; i < modes_to_save; i++) {
-        char filename[256];
-        sprintf(filename, "data/mode_%02d.csv", i+1);
-        printf("DEBUG: Saving mode %d to %s\n", i+1, filename);
-        save_mode_to_csv(mesh, results->eigenvectors[i], i, filename);
+    // ============ REPONSE EN FREQUENCE ============
+    if (opts.frf_count > 0) {
+        printf("\n=== FREQUENCY RESPONSE FUNCTIONS ===\n");
+        profiler_begin("frf_total");
+        run_frf(&opts, mesh, loaded, A, B, results);
+        profiler_end();
     }
     
-    // Générer les plots
-    generate_plots(mesh, results, "plots");
+    // ============ SENSIBILITES ============
+    if (opts.sensitivities) {
+        printf("\n=== EIGENVALUE SENSITIVITIES ===\n");
+        run_sensitivities(mesh, params, results);
+    }
     
-    // ============ ANALYSE DE CONVERGENCE ============
-    printf("\nPerforming convergence analysis...\n");
-    printf("\n=== CONVERGENCE ANALYSIS ===\n");
-    int test_sizes[] = {20, 30, 40, 50, 60};
-    int n_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    // ============ VISUALISATION ============
+    printf("\nGenerating visualizations...\n");
     
-    // Limiter le nombre de tailles de grille si N est grand
-    if (N < 60) {
-        n_sizes = 3; // Prendre seulement 3 tailles
+    // Sauvegarde des modes et plots: la tâche prend possession des résultats
+    OutputTask* modes_task = create_output_task(mesh, A, B, results, outputs);
+    if (!modes_task) {
+        fprintf(stderr, "Error: Failed to queue mode outputs\n");
+        free_eigen_results(results);
+    } else {
+        modes_task->modes_to_save = (results->n_eigenvalues < 5) ? results->n_eigenvalues : 5;
+        modes_task->stream = stream;
+        modes_task->mode_archive = opts.mode_archive;
+        modes_task->archive = opts.archive;
+        size_t modes_bytes = (size_t)results->n_dof * results->n_eigenvalues * sizeof(double);
+        async_writer_submit(writer, write_modes_task, release_modes_task,
+                            modes_task, modes_bytes);
     }
+    results = NULL;
     
-    double** eigenvalues_grid = malloc(n_sizes * sizeof(double*));
-    if (!eigenvalues_grid) {
-        fprintf(stderr, "Error: Memory allocation failed for convergence analysis\n");
+    // ============ ANALYSE DE CONVERGENCE ============
+    // Sans maillage (opérateur importé), la famille de grilles n'est pas définie
+    if (loaded) {
+        printf("\nSkipping convergence analysis (operator loaded from file)\n");
     } else {
-        for (int s = 0; s < n_sizes; s++) {
-            printf("  Testing N = %d...\n", test_sizes[s]);
-            Mesh* test_mesh = create_mesh(test_sizes[s], params);
-            if (!test_mesh) {
-                fprintf(stderr, "Warning: Failed to create mesh for N=%d\n", test_sizes[s]);
-                eigenvalues_grid[s] = NULL;
-                continue;
-            }
-            
-            SparseMatrixCSR* test_A = build_stiffness_matrix(test_mesh);
-            SparseMatrixCSR* test_B = build_mass_matrix(test_mesh);
-            
-            if (!test_A || !test_B) {
-                fprintf(stderr, "Warning: Failed to build matrices for N=%d\n", test_sizes[s]);
-                free_mesh(test_mesh);
+        printf("\nPerforming convergence analysis...\n");
+        profiler_begin("convergence_study");
+        join_lanes(lanes, n_groups, main_group, 1);
+        printf("\n=== CONVERGENCE ANALYSIS ===\n");
+        
+        double** eigenvalues_grid = malloc(n_sizes * sizeof(double*));
+        if (!eigenvalues_grid) {
+            fprintf(stderr, "Error: Memory allocation failed for convergence analysis\n");
+        } else {
+            for (int s = 0; s < n_sizes; s++) {
+                const SolveTask* task = size_task[s] >= 0 ? &tasks[size_task[s]] : NULL;
                 eigenvalues_grid[s] = NULL;
-                continue;
+                if (!task || task->n_found == 0) {
+                    fprintf(stderr, "Warning: No eigenvalues for N=%d\n", test_sizes[s]);
+                    continue;
+                }
+                
+                if (size_task[s] == 0) {
+                    printf("  N = %d: main solve\n", test_sizes[s]);
+                } else {
+                    printf("  N = %d: %s, %d threads, %.2f s\n", test_sizes[s],
+                           solver_type_name(task->solver), groups[task->group].n_cores, task->seconds);
+                }
+                for (int i = 0; i < task->n_found; i++) {
+                    double freq = sqrt(task->eigenvalues[i]) / (2 * PI);
+                    printf("  λ%d = %.6f, f = %.3f Hz\n", i+1, task->eigenvalues[i], freq);
+                }
+                
+                eigenvalues_grid[s] = calloc(CONVERGENCE_MODES, sizeof(double));
+                if (eigenvalues_grid[s]) {
+                    memcpy(eigenvalues_grid[s], task->eigenvalues, task->n_found * sizeof(double));
+                }
             }
             
-            SolverConfig* test_config = create_solver_config(5);
-            if (!test_config) {
-                fprintf(stderr, "Warning: Failed to create solver config for N=%d\n", test_sizes[s]);
-                free_sparse_matrix(test_A);
-                free_sparse_matrix(test_B);
-                free_mesh(test_mesh);
-                eigenvalues_grid[s] = NULL;
-                continue;
+            // Générer le plot de convergence seulement si nous avons des données
+            int valid_sizes = 0;
+            for (int s = 0; s < n_sizes; s++) {
+                if (eigenvalues_grid[s] != NULL) valid_sizes++;
             }
             
-            EigenResults* test_results = solve_eigenproblem(test_A, test_B, test_config);
-            if (test_results) {
-                printf("Computed %d eigenvalues:\n", test_results->n_eigenvalues);
-                for (int i = 0; i < test_results->n_eigenvalues && i < 5; i++) {
-                    double freq = sqrt(test_results->eigenvalues[i]) / (2 * 3.141592653589793);
-                    printf("  λ%d = %.6f, f = %.3f Hz\n", i+1, test_results->eigenvalues[i], freq);
-                }
-            }
+            ConvergenceTask* conv_task = (ConvergenceTask*)malloc(sizeof(ConvergenceTask));
+            int* sizes_copy = (int*)malloc(n_sizes * sizeof(int));
             
-            if (test_results) {
-                eigenvalues_grid[s] = malloc(5 * sizeof(double));
-                if (eigenvalues_grid[s]) {
-                    for (int i = 0; i < 5 && i < test_results->n_eigenvalues; i++) {
-                        eigenvalues_grid[s][i] = test_results->eigenvalues[i];
-                    }
-                }
-                free_eigen_results(test_results);
+            if (valid_sizes >= 2 && conv_task && sizes_copy) {
+                memcpy(sizes_copy, test_sizes, n_sizes * sizeof(int));
+                conv_task->grid_sizes = sizes_copy;
+                conv_task->eigenvalues = eigenvalues_grid;
+                conv_task->n_sizes = n_sizes;
+                conv_task->n_eigenvalues = CONVERGENCE_MODES;
+                async_writer_submit(writer, write_convergence_task, release_convergence_task,
+                                    conv_task, n_sizes * CONVERGENCE_MODES * sizeof(double));
             } else {
-                eigenvalues_grid[s] = NULL;
+                if (valid_sizes < 2) printf("Insufficient data for convergence analysis\n");
+                
+                // Libérer la mémoire
+                for (int s = 0; s < n_sizes; s++) {
+                    if (eigenvalues_grid[s]) free(eigenvalues_grid[s]);
+                }
+                free(eigenvalues_grid);
+                free(conv_task);
+                free(sizes_copy);
             }
-            
-            free_sparse_matrix(test_A);
-            free_sparse_matrix(test_B);
-            free_mesh(test_mesh);
-            free_solver_config(test_config);
         }
-        
-        // Générer le plot de convergence seulement si nous avons des données
-        int valid_sizes = 0;
-        for (int s = 0; s < n_sizes; s++) {
-            if (eigenvalues_grid[s] != NULL) valid_sizes++;
-        }
-        
-        if (valid_sizes >= 2) {
-            plot_convergence(test_sizes, eigenvalues_grid, n_sizes, 5, 
-                            "plots/convergence.png");
-        } else {
-            printf("Insufficient data for convergence analysis\n");
-        }
-        
-        // Libérer la mémoire
-        for (int s = 0; s < n_sizes; s++) {
-            if (eigenvalues_grid[s]) free(eigenvalues_grid[s]);
-        }
-        free(eigenvalues_grid);
+        profiler_end();
+    }
+    thread_group_leave(&main_state);
+    
+    // ============ BARRIERE DES SORTIES ============
+    printf("\nWaiting for pending outputs...\n");
+    profiler_begin("output_barrier");
+    async_writer_barrier(writer);
+    profiler_end();
+    printf("Background I/O: %.2f s writing, %.2f s stalled by back-pressure\n",
+           async_writer_busy_time(writer), async_writer_stall_time(writer));
+    async_writer_destroy(writer);
+    mode_stream_close(stream);
+    
+    if (cache.enabled) {
+        printf("Result cache (%s): %d hits, %d misses\n", cache.directory, cache.hits, cache.misses);
     }
     
     // ============ NETTOYAGE ============
@@ -275,10 +1793,11 @@ int main(int argc, char *argv[]) {
     free_mesh(mesh);
     free_membrane_params(params);
     free_solver_config(config);
-    free_eigen_results(results);
     
-    clock_t end_time = clock();
-    double total_time = ((double)(end_time - start_time)) / CLOCKS_PER_SEC;
+    double total_time = profiler_now() - start_time;
+    
+    profiler_print_summary();
+    if (opts.profile_file) profiler_write_json(opts.profile_file);
     
     printf("\n========================================\n");
     printf("Total execution time: %.2f seconds\n", total_time);
@@ -1,22 +1,53 @@
 #include "matrix_builder.h"
+#include "npy_io.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#define MAX_NNZ_PER_ROW 5  // Pour une grille 2D: diag + 4 voisins
+// En-tête du format binaire .csrb (64 octets)
+#define CSR_FILE_MAGIC "MEMBCSR1"
+#define CSR_FILE_VERSION 1
+#define CSR_FILE_ALIGN 64
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t index_size;        // sizeof(MKL_INT) à l'écriture
+    uint64_t n_rows;
+    uint64_t n_cols;
+    uint64_t nnz;
+    uint64_t row_index_offset;  // Offsets des sections, multiples de 64
+    uint64_t columns_offset;
+    uint64_t values_offset;
+} CSRFileHeader;
 
 SparseMatrixCSR* create_sparse_matrix(MKL_INT n, MKL_INT nnz_estimate) {
-    SparseMatrixCSR* mat = (SparseMatrixCSR*)malloc(sizeof(SparseMatrixCSR));
+    return create_sparse_matrix_in(n, nnz_estimate, NULL);
+}
+
+SparseMatrixCSR* create_sparse_matrix_in(MKL_INT n, MKL_INT nnz_estimate, Arena* arena) {
+    SparseMatrixCSR* mat = (SparseMatrixCSR*)(arena ? arena_alloc(arena, sizeof(SparseMatrixCSR))
+                                                    : malloc(sizeof(SparseMatrixCSR)));
     if (!mat) return NULL;
     
     mat->n_rows = n;
     mat->n_cols = n;
     mat->nnz = 0;
+    mat->mapping = NULL;
+    mat->mapping_size = 0;
+    mat->arena = arena;
     
-    // Allocation avec mkl_malloc pour l'alignement
-    mat->values = (double*)mkl_malloc(nnz_estimate * sizeof(double), 64);
-    mat->columns = (MKL_INT*)mkl_malloc(nnz_estimate * sizeof(MKL_INT), 64);
-    mat->row_index = (MKL_INT*)mkl_malloc((n + 1) * sizeof(MKL_INT), 64);
+    // Allocation alignée (mkl_malloc hors arène)
+    mat->values = (double*)arena_alloc(arena, nnz_estimate * sizeof(double));
+    mat->columns = (MKL_INT*)arena_alloc(arena, nnz_estimate * sizeof(MKL_INT));
+    mat->row_index = (MKL_INT*)arena_alloc(arena, (n + 1) * sizeof(MKL_INT));
     
     if (!mat->values || !mat->columns || !mat->row_index) {
         free_sparse_matrix(mat);
@@ -29,23 +60,84 @@ SparseMatrixCSR* create_sparse_matrix(MKL_INT n, MKL_INT nnz_estimate) {
 }
 
 void free_sparse_matrix(SparseMatrixCSR* mat) {
-    if (!mat) return;
+    if (!mat || mat->arena) return;     // Rendue avec l'arène
     
-    if (mat->values) mkl_free(mat->values);
-    if (mat->columns) mkl_free(mat->columns);
-    if (mat->row_index) mkl_free(mat->row_index);
+    if (mat->mapping) {
+        munmap(mat->mapping, mat->mapping_size);
+    } else {
+        if (mat->values) mkl_free(mat->values);
+        if (mat->columns) mkl_free(mat->columns);
+        if (mat->row_index) mkl_free(mat->row_index);
+    }
     free(mat);
 }
 
+int stiffness_row(const Mesh* mesh, int i, int j, MKL_INT* columns, double* values) {
+    int N = mesh->N;
+    double h2 = mesh->h * mesh->h;
+    int idx = i * N + j;
+    int count = 0;
+    
+    // Coefficients diagonaux et voisins
+    double diag_coeff = 0.0;
+    
+    // Contribution de p(i+1/2, j)
+    if (i < N - 1) {
+        int idx_right = idx + N;
+        double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_right]);
+        values[count] = -p_half / h2;
+        columns[count++] = idx_right;
+        diag_coeff += p_half / h2;
+    } else {
+        diag_coeff += mesh->p_vals[idx] / h2;   // Bord (u = 0): terme diagonal seul
+    }
+    
+    // Contribution de p(i-1/2, j)
+    if (i > 0) {
+        int idx_left = idx - N;
+        double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_left]);
+        values[count] = -p_half / h2;
+        columns[count++] = idx_left;
+        diag_coeff += p_half / h2;
+    } else {
+        diag_coeff += mesh->p_vals[idx] / h2;
+    }
+    
+    // Contribution de p(i, j+1/2)
+    if (j < N - 1) {
+        int idx_up = idx + 1;
+        double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_up]);
+        values[count] = -p_half / h2;
+        columns[count++] = idx_up;
+        diag_coeff += p_half / h2;
+    } else {
+        diag_coeff += mesh->p_vals[idx] / h2;
+    }
+    
+    // Contribution de p(i, j-1/2)
+    if (j > 0) {
+        int idx_down = idx - 1;
+        double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_down]);
+        values[count] = -p_half / h2;
+        columns[count++] = idx_down;
+        diag_coeff += p_half / h2;
+    } else {
+        diag_coeff += mesh->p_vals[idx] / h2;
+    }
+    
+    // Terme diagonal final
+    values[count] = diag_coeff + mesh->q_vals[idx];
+    columns[count++] = idx;
+    return count;
+}
+
 SparseMatrixCSR* build_stiffness_matrix(Mesh* mesh) {
     int N = mesh->N;
     int total_points = mesh->total_points;
-    double h = mesh->h;
-    double h2 = h * h;
     
     // Estimation du nombre d'éléments non nuls
-    MKL_INT nnz_estimate = total_points * MAX_NNZ_PER_ROW;
-    SparseMatrixCSR* A = create_sparse_matrix(total_points, nnz_estimate);
+    MKL_INT nnz_estimate = total_points * STIFFNESS_ROW_MAX;
+    SparseMatrixCSR* A = create_sparse_matrix_in(total_points, nnz_estimate, mesh->arena);
     
     if (!A) return NULL;
     
@@ -53,56 +145,8 @@ SparseMatrixCSR* build_stiffness_matrix(Mesh* mesh) {
     
     for (int i = 0; i < N; i++) {
         for (int j = 0; j < N; j++) {
-            int idx = mesh_index(i, j, mesh);
-            A->row_index[idx] = nnz;
-            
-            // Coefficients diagonaux et voisins
-            double diag_coeff = 0.0;
-            
-            // Contribution de p(i+1/2, j)
-            if (i < N - 1) {
-                int idx_right = mesh_index(i + 1, j, mesh);
-                double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_right]);
-                A->values[nnz] = -p_half / h2;
-                A->columns[nnz] = idx_right;
-                nnz++;
-                diag_coeff += p_half / h2;
-            }
-            
-            // Contribution de p(i-1/2, j)
-            if (i > 0) {
-                int idx_left = mesh_index(i - 1, j, mesh);
-                double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_left]);
-                A->values[nnz] = -p_half / h2;
-                A->columns[nnz] = idx_left;
-                nnz++;
-                diag_coeff += p_half / h2;
-            }
-            
-            // Contribution de p(i, j+1/2)
-            if (j < N - 1) {
-                int idx_up = mesh_index(i, j + 1, mesh);
-                double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_up]);
-                A->values[nnz] = -p_half / h2;
-                A->columns[nnz] = idx_up;
-                nnz++;
-                diag_coeff += p_half / h2;
-            }
-            
-            // Contribution de p(i, j-1/2)
-            if (j > 0) {
-                int idx_down = mesh_index(i, j - 1, mesh);
-                double p_half = 0.5 * (mesh->p_vals[idx] + mesh->p_vals[idx_down]);
-                A->values[nnz] = -p_half / h2;
-                A->columns[nnz] = idx_down;
-                nnz++;
-                diag_coeff += p_half / h2;
-            }
-            
-            // Terme diagonal final
-            A->values[nnz] = diag_coeff + mesh->q_vals[idx];
-            A->columns[nnz] = idx;
-            nnz++;
+            A->row_index[mesh_index(i, j, mesh)] = nnz;
+            nnz += stiffness_row(mesh, i, j, A->columns + nnz, A->values + nnz);
         }
     }
     
@@ -116,7 +160,7 @@ SparseMatrixCSR* build_mass_matrix(Mesh* mesh) {
     int total_points = mesh->total_points;
     
     // La matrice de masse est diagonale
-    SparseMatrixCSR* B = create_sparse_matrix(total_points, total_points);
+    SparseMatrixCSR* B = create_sparse_matrix_in(total_points, total_points, mesh->arena);
     
     if (!B) return NULL;
     
@@ -149,6 +193,401 @@ void save_matrix_csr(SparseMatrixCSR* mat, const char* filename) {
     fclose(file);
 }
 
+// Format scipy.sparse.save_npz: lisible avec scipy.sparse.load_npz
+void save_matrix_csr_npz(SparseMatrixCSR* mat, const char* filename) {
+    NpzWriter* npz = npz_open(filename);
+    if (!npz) return;
+    
+    long long shape_values[2] = {(long long)mat->n_rows, (long long)mat->n_cols};
+    size_t two[1] = {2};
+    size_t nnz[1] = {(size_t)mat->nnz};
+    size_t rows[1] = {(size_t)mat->n_rows + 1};
+    
+    npz_add_array(npz, "format", "|S3", 0, NULL, "csr");
+    npz_add_array(npz, "shape", NPY_INT64, 1, two, shape_values);
+    npz_add_array(npz, "data", NPY_FLOAT64, 1, nnz, mat->values);
+    npz_add_array(npz, "indices", NPY_MKL_INT, 1, nnz, mat->columns);
+    npz_add_array(npz, "indptr", NPY_MKL_INT, 1, rows, mat->row_index);
+    
+    npz_close(npz);
+}
+
+SparseMatrixCSR* build_identity_matrix(MKL_INT n) {
+    SparseMatrixCSR* identity = create_sparse_matrix(n, n);
+    if (!identity) return NULL;
+    
+    for (MKL_INT i = 0; i < n; i++) {
+        identity->row_index[i] = i;
+        identity->columns[i] = i;
+        identity->values[i] = 1.0;
+    }
+    identity->row_index[n] = n;
+    identity->nnz = n;
+    
+    return identity;
+}
+
+// ============ FORMAT BINAIRE CSR ============
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + CSR_FILE_ALIGN - 1) / CSR_FILE_ALIGN * CSR_FILE_ALIGN;
+}
+
+static int write_section(int fd, const void* data, size_t bytes, uint64_t offset) {
+    const char* p = (const char*)data;
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, p, bytes, (off_t)offset);
+        if (written <= 0) return -1;
+        p += written;
+        offset += (uint64_t)written;
+        bytes -= (size_t)written;
+    }
+    return 0;
+}
+
+int save_matrix_csr_binary(SparseMatrixCSR* mat, const char* filename) {
+    CSRFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CSR_FILE_MAGIC, 8);
+    header.version = CSR_FILE_VERSION;
+    header.index_size = (uint32_t)sizeof(MKL_INT);
+    header.n_rows = (uint64_t)mat->n_rows;
+    header.n_cols = (uint64_t)mat->n_cols;
+    header.nnz = (uint64_t)mat->nnz;
+    
+    size_t row_bytes = ((size_t)mat->n_rows + 1) * sizeof(MKL_INT);
+    size_t col_bytes = (size_t)mat->nnz * sizeof(MKL_INT);
+    size_t val_bytes = (size_t)mat->nnz * sizeof(double);
+    header.row_index_offset = align_offset(sizeof(header));
+    header.columns_offset = align_offset(header.row_index_offset + row_bytes);
+    header.values_offset = align_offset(header.columns_offset + col_bytes);
+    uint64_t total = header.values_offset + val_bytes;
+    
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        return -1;
+    }
+    
+    // ftruncate remplit les trous d'alignement avec des zéros
+    int status = ftruncate(fd, (off_t)total) == 0 &&
+                 write_section(fd, &header, sizeof(header), 0) == 0 &&
+                 write_section(fd, mat->row_index, row_bytes, header.row_index_offset) == 0 &&
+                 write_section(fd, mat->columns, col_bytes, header.columns_offset) == 0 &&
+                 write_section(fd, mat->values, val_bytes, header.values_offset) == 0 ? 0 : -1;
+    
+    if (close(fd) != 0) status = -1;
+    if (status != 0) fprintf(stderr, "Error: Failed writing %s\n", filename);
+    return status;
+}
+
+// Plus grand entier représentable par MKL_INT (LP64 ou ILP64)
+#define MKL_INT_LIMIT (sizeof(MKL_INT) == 4 ? (uint64_t)INT32_MAX : (uint64_t)INT64_MAX)
+
+// Fin d'une section de count éléments: -1 en cas de dépassement de uint64 ou du fichier
+static int section_end(uint64_t offset, uint64_t count, uint64_t element, uint64_t size) {
+    if (count > (UINT64_MAX - offset) / element) return -1;
+    return offset + count * element <= size ? 0 : -1;
+}
+
+// row_index croissant de 0 à nnz, colonnes dans [0, n_cols): aucun accès hors des sections
+static const char* check_csr_structure(const SparseMatrixCSR* mat) {
+    if (mat->row_index[0] != 0 || mat->row_index[mat->n_rows] != mat->nnz) {
+        return "inconsistent row_index";
+    }
+    for (MKL_INT i = 0; i < mat->n_rows; i++) {
+        if (mat->row_index[i + 1] < mat->row_index[i]) return "row_index is not nondecreasing";
+    }
+    for (MKL_INT j = 0; j < mat->nnz; j++) {
+        if (mat->columns[j] < 0 || mat->columns[j] >= mat->n_cols) return "column index out of range";
+    }
+    return NULL;
+}
+
+// Symétrie relative tolérée à l'import: les solveurs denses recopient un triangle sur l'autre
+// et une matrice non symétrique y deviendrait silencieusement une autre matrice
+#define CSR_SYMMETRY_TOLERANCE 1e-12
+
+// a_ij sur une ligne (colonnes triées: dichotomie, sinon parcours), 0 si absent
+static double csr_entry(const SparseMatrixCSR* mat, MKL_INT row, MKL_INT col, int sorted) {
+    MKL_INT lo = mat->row_index[row], hi = mat->row_index[row + 1];
+    if (!sorted) {
+        for (MKL_INT e = lo; e < hi; e++) {
+            if (mat->columns[e] == col) return mat->values[e];
+        }
+        return 0.0;
+    }
+    while (lo < hi) {
+        MKL_INT mid = lo + (hi - lo) / 2;
+        if (mat->columns[mid] < col) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < mat->row_index[row + 1] && mat->columns[lo] == col ? mat->values[lo] : 0.0;
+}
+
+// |a_ij - a_ji| ≤ CSR_SYMMETRY_TOLERANCE max|a| (structure déjà vérifiée); sinon message
+// sur stderr avec le pire couple
+static int check_csr_symmetry(const SparseMatrixCSR* mat, const char* filename) {
+    if (mat->n_rows != mat->n_cols) {
+        fprintf(stderr, "Error: Matrix in %s is not square (%ld x %ld)\n", filename,
+                (long)mat->n_rows, (long)mat->n_cols);
+        return -1;
+    }
+    double max_abs = 0.0;
+    int sorted = 1;
+    #pragma omp parallel for reduction(max:max_abs) reduction(&&:sorted) schedule(static)
+    for (MKL_INT i = 0; i < mat->n_rows; i++) {
+        for (MKL_INT e = mat->row_index[i]; e < mat->row_index[i + 1]; e++) {
+            if (fabs(mat->values[e]) > max_abs) max_abs = fabs(mat->values[e]);
+            if (e > mat->row_index[i] && mat->columns[e] <= mat->columns[e - 1]) sorted = 0;
+        }
+    }
+    
+    double worst = 0.0;
+    MKL_INT worst_row = 0;
+    #pragma omp parallel
+    {
+        double local = 0.0;
+        MKL_INT local_row = 0;
+        #pragma omp for schedule(static)
+        for (MKL_INT i = 0; i < mat->n_rows; i++) {
+            for (MKL_INT e = mat->row_index[i]; e < mat->row_index[i + 1]; e++) {
+                double diff = fabs(mat->values[e] - csr_entry(mat, mat->columns[e], i, sorted));
+                if (diff > local) {
+                    local = diff;
+                    local_row = i;
+                }
+            }
+        }
+        #pragma omp critical
+        if (local > worst) {
+            worst = local;
+            worst_row = local_row;
+        }
+    }
+    if (worst <= CSR_SYMMETRY_TOLERANCE * max_abs) return 0;
+    fprintf(stderr, "Error: Matrix in %s is not symmetric (|a_ij - a_ji| = %.3e in row %ld, "
+            "max|a| = %.3e)\n", filename, worst, (long)worst_row, max_abs);
+    return -1;
+}
+
+SparseMatrixCSR* load_matrix_csr_binary(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open matrix file %s\n", filename);
+        return NULL;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CSRFileHeader)) {
+        fprintf(stderr, "Error: %s is not a binary CSR file\n", filename);
+        close(fd);
+        return NULL;
+    }
+    
+    // Copie privée à l'écriture: aucune copie tant que le solveur ne fait que lire
+    size_t size = (size_t)st.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map matrix file %s\n", filename);
+        return NULL;
+    }
+    
+    const CSRFileHeader* header = (const CSRFileHeader*)mapping;
+    
+    const char* problem = NULL;
+    if (memcmp(header->magic, CSR_FILE_MAGIC, 8) != 0) {
+        problem = "bad magic";
+    } else if (header->version != CSR_FILE_VERSION) {
+        problem = "unsupported version";
+    } else if (header->index_size != sizeof(MKL_INT)) {
+        problem = "index size differs from MKL_INT";
+    } else if (header->n_rows >= MKL_INT_LIMIT || header->n_cols > MKL_INT_LIMIT ||
+               header->nnz > MKL_INT_LIMIT) {
+        problem = "dimensions exceed MKL_INT";
+    } else if (section_end(header->row_index_offset, header->n_rows + 1, sizeof(MKL_INT), size) != 0 ||
+               section_end(header->columns_offset, header->nnz, sizeof(MKL_INT), size) != 0 ||
+               section_end(header->values_offset, header->nnz, sizeof(double), size) != 0 ||
+               header->row_index_offset % CSR_FILE_ALIGN != 0 ||
+               header->columns_offset % CSR_FILE_ALIGN != 0 ||
+               header->values_offset % CSR_FILE_ALIGN != 0) {
+        problem = "truncated or misaligned sections";
+    }
+    
+    SparseMatrixCSR* mat = NULL;
+    if (!problem) {
+        mat = (SparseMatrixCSR*)malloc(sizeof(SparseMatrixCSR));
+        if (!mat) problem = "out of memory";
+    }
+    if (!problem) {
+        mat->n_rows = (MKL_INT)header->n_rows;
+        mat->n_cols = (MKL_INT)header->n_cols;
+        mat->nnz = (MKL_INT)header->nnz;
+        mat->row_index = (MKL_INT*)((char*)mapping + header->row_index_offset);
+        mat->columns = (MKL_INT*)((char*)mapping + header->columns_offset);
+        mat->values = (double*)((char*)mapping + header->values_offset);
+        mat->mapping = mapping;
+        mat->mapping_size = size;
+        mat->arena = NULL;
+        problem = check_csr_structure(mat);
+        if (problem) {
+            free(mat);
+            mat = NULL;
+        }
+    }
+    
+    if (problem) {
+        fprintf(stderr, "Error: Invalid binary CSR file %s (%s)\n", filename, problem);
+        munmap(mapping, size);
+        return NULL;
+    }
+    if (check_csr_symmetry(mat, filename) != 0) {
+        free_sparse_matrix(mat);
+        return NULL;
+    }
+    
+    return mat;
+}
+
+// ============ IMPORT MATRIX MARKET ============
+
+typedef struct {
+    MKL_INT row;
+    MKL_INT col;
+    double value;
+} MatrixEntry;
+
+static int compare_entries(const void* a, const void* b) {
+    const MatrixEntry* ea = (const MatrixEntry*)a;
+    const MatrixEntry* eb = (const MatrixEntry*)b;
+    if (ea->row != eb->row) return ea->row < eb->row ? -1 : 1;
+    if (ea->col != eb->col) return ea->col < eb->col ? -1 : 1;
+    return 0;
+}
+
+SparseMatrixCSR* load_matrix_market(const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open matrix file %s\n", filename);
+        return NULL;
+    }
+    
+    char line[1024];
+    char object[64], format[64], field[64], symmetry[64];
+    if (!fgets(line, sizeof(line), file) ||
+        sscanf(line, "%%%%MatrixMarket %63s %63s %63s %63s", object, format, field, symmetry) != 4) {
+        fprintf(stderr, "Error: %s is not a Matrix Market file\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    for (char* c = field; *c; c++) *c = (char)tolower((unsigned char)*c);
+    for (char* c = symmetry; *c; c++) *c = (char)tolower((unsigned char)*c);
+    
+    int pattern = strcmp(field, "pattern") == 0;
+    int symmetric = strcmp(symmetry, "symmetric") == 0;
+    if (strcmp(format, "coordinate") != 0 || strcmp(field, "complex") == 0 ||
+        (!symmetric && strcmp(symmetry, "general") != 0)) {
+        fprintf(stderr, "Error: Unsupported Matrix Market type in %s (%s %s %s)\n",
+                filename, format, field, symmetry);
+        fclose(file);
+        return NULL;
+    }
+    
+    // Commentaires puis ligne de taille
+    long n_rows = 0, n_cols = 0, n_entries = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '%') continue;
+        if (sscanf(line, "%ld %ld %ld", &n_rows, &n_cols, &n_entries) == 3) break;
+    }
+    if (n_rows <= 0 || n_cols <= 0 || n_entries < 0) {
+        fprintf(stderr, "Error: Missing size line in %s\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    
+    // Les matrices symétriques sont stockées complètes (les deux triangles)
+    size_t capacity = (size_t)n_entries * (symmetric ? 2 : 1);
+    MatrixEntry* entries = (MatrixEntry*)malloc((capacity ? capacity : 1) * sizeof(MatrixEntry));
+    if (!entries) {
+        fprintf(stderr, "Error: Failed to allocate Matrix Market entries\n");
+        fclose(file);
+        return NULL;
+    }
+    
+    size_t count = 0;
+    for (long e = 0; e < n_entries; e++) {
+        long r, c;
+        double v = 1.0;
+        int read = pattern ? fscanf(file, "%ld %ld", &r, &c)
+                           : fscanf(file, "%ld %ld %lf", &r, &c, &v);
+        if (read != (pattern ? 2 : 3) || r < 1 || r > n_rows || c < 1 || c > n_cols) {
+            fprintf(stderr, "Error: Invalid entry %ld in %s\n", e + 1, filename);
+            free(entries);
+            fclose(file);
+            return NULL;
+        }
+        entries[count].row = (MKL_INT)(r - 1);
+        entries[count].col = (MKL_INT)(c - 1);
+        entries[count].value = v;
+        count++;
+        if (symmetric && r != c) {
+            entries[count].row = (MKL_INT)(c - 1);
+            entries[count].col = (MKL_INT)(r - 1);
+            entries[count].value = v;
+            count++;
+        }
+    }
+    fclose(file);
+    
+    qsort(entries, count, sizeof(MatrixEntry), compare_entries);
+    
+    // Les doublons sont additionnés (convention Matrix Market)
+    size_t unique = 0;
+    for (size_t e = 0; e < count; e++) {
+        if (unique > 0 && entries[unique - 1].row == entries[e].row &&
+            entries[unique - 1].col == entries[e].col) {
+            entries[unique - 1].value += entries[e].value;
+        } else {
+            entries[unique++] = entries[e];
+        }
+    }
+    
+    SparseMatrixCSR* mat = create_sparse_matrix((MKL_INT)n_rows, (MKL_INT)(unique ? unique : 1));
+    if (!mat) {
+        free(entries);
+        return NULL;
+    }
+    mat->n_cols = (MKL_INT)n_cols;
+    
+    size_t e = 0;
+    for (MKL_INT i = 0; i < mat->n_rows; i++) {
+        mat->row_index[i] = (MKL_INT)e;
+        while (e < unique && entries[e].row == i) {
+            mat->columns[e] = entries[e].col;
+            mat->values[e] = entries[e].value;
+            e++;
+        }
+    }
+    mat->row_index[mat->n_rows] = (MKL_INT)unique;
+    mat->nnz = (MKL_INT)unique;
+    
+    free(entries);
+    if (check_csr_symmetry(mat, filename) != 0) {
+        free_sparse_matrix(mat);
+        return NULL;
+    }
+    return mat;
+}
+
+SparseMatrixCSR* load_matrix(const char* filename) {
+    const char* ext = strrchr(filename, '.');
+    if (ext && (strcmp(ext, ".mtx") == 0 || strcmp(ext, ".mm") == 0)) {
+        return load_matrix_market(filename);
+    }
+    return load_matrix_csr_binary(filename);
+}
+
 sparse_matrix_t convert_to_mkl_sparse(SparseMatrixCSR* csr) {
     sparse_matrix_t mkl_mat;
     sparse_status_t status;
@@ -1,5 +1,6 @@
 #include "membrane.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <math.h>
 
 double default_tension(double x, double y) {
@@ -16,6 +17,12 @@ double default_potential(double x, double y) {
     return 50.0 * exp(-50.0 * r2);
 }
 
+double obstacle_potential(const MembraneParams* params, double x, double y) {
+    double dx = x - params->obstacle_center_x;
+    double dy = y - params->obstacle_center_y;
+    return params->obstacle_strength * exp(-params->obstacle_width * (dx * dx + dy * dy));
+}
+
 MembraneParams* create_default_params() {
     MembraneParams* params = (MembraneParams*)malloc(sizeof(MembraneParams));
     if (!params) return NULL;
@@ -27,10 +34,43 @@ MembraneParams* create_default_params() {
     params->obstacle_center_y = 0.5;
     params->obstacle_strength = 50.0;
     params->obstacle_width = 50.0;
+    params->tension_expr = NULL;
+    params->density_expr = NULL;
+    params->potential_expr = NULL;
     
     return params;
 }
 
 void free_membrane_params(MembraneParams* params) {
-    if (params) free(params);
+    if (!params) return;
+    
+    free_coeff_expr(params->tension_expr);
+    free_coeff_expr(params->density_expr);
+    free_coeff_expr(params->potential_expr);
+    free(params);
+}
+
+int set_coefficient_expression(MembraneParams* params, char coefficient,
+                               const char* source) {
+    char error[256];
+    CoeffExpr** slot;
+    
+    switch (coefficient) {
+        case 'p': slot = &params->tension_expr; break;
+        case 'w': slot = &params->density_expr; break;
+        case 'q': slot = &params->potential_expr; break;
+        default:
+            fprintf(stderr, "Error: Unknown coefficient '%c' (expected p, w or q)\n", coefficient);
+            return -1;
+    }
+    
+    CoeffExpr* expr = coeff_expr_compile(source, error, sizeof(error));
+    if (!expr) {
+        fprintf(stderr, "Error: Invalid expression for %c: %s\n", coefficient, error);
+        return -1;
+    }
+    
+    free_coeff_expr(*slot);
+    *slot = expr;
+    return 0;
 }
@@ -0,0 +1,148 @@
+#include "membrane_context.h"
+#include "mesh.h"
+#include "planner.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+struct MembraneContext {
+    Arena* arena;
+    pthread_mutex_t lock;
+    long calls;
+};
+
+MembraneContext* membrane_context_create(size_t initial_bytes) {
+    MembraneContext* context = (MembraneContext*)calloc(1, sizeof(MembraneContext));
+    if (!context) {
+        fprintf(stderr, "Error: Failed to allocate membrane context\n");
+        return NULL;
+    }
+    context->arena = arena_create(initial_bytes);
+    if (!context->arena) {
+        free(context);
+        return NULL;
+    }
+    pthread_mutex_init(&context->lock, NULL);
+    return context;
+}
+
+void membrane_context_destroy(MembraneContext* context) {
+    if (!context) return;
+    pthread_mutex_destroy(&context->lock);
+    arena_destroy(context->arena);
+    free(context);
+}
+
+void membrane_request_init(MembraneSolveRequest* request, int N, int n_eigenvalues) {
+    memset(request, 0, sizeof(MembraneSolveRequest));
+    request->N = N;
+    request->n_eigenvalues = n_eigenvalues;
+    request->solver = SOLVER_AUTO;
+    request->symmetry = 1;
+}
+
+// Configuration sur la pile: rien n'est alloué hors de l'arène
+static void configure(SolverConfig* config, const MembraneSolveRequest* request, Arena* arena) {
+    solver_config_init(config, request->n_eigenvalues);
+    config->solver = request->solver;
+    config->mkl_threads = request->threads;
+    config->workspace = arena;
+    config->memory_budget = request->memory_budget;
+    config->symmetry = request->symmetry;
+    if (request->eps > 0.0) config->eps = request->eps;
+    if (request->max_iterations > 0) config->max_iterations = request->max_iterations;
+}
+
+const EigenResults* membrane_solve(MembraneContext* context, MembraneParams* params,
+                                   const MembraneSolveRequest* request) {
+    if (request->N < 2 || request->n_eigenvalues < 1 ||
+        request->n_eigenvalues > request->N * request->N) {
+        fprintf(stderr, "Error: Invalid request (N = %d, %d eigenvalues)\n",
+                request->N, request->n_eigenvalues);
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&context->lock);
+    arena_reset(context->arena);
+    context->calls++;
+    
+    SolverConfig config;
+    configure(&config, request, context->arena);
+    
+    // Stratégie choisie sur la grille, avant assemblage (matrix-free: rien à assembler)
+    if (config.solver == SOLVER_AUTO) {
+        PlanProblem problem = plan_problem_from_grid(request->N, request->n_eigenvalues);
+        SolvePlan plan;
+        if (plan_solve(&problem, SOLVER_AUTO, request->memory_budget, &plan) != 0) {
+            print_solve_plan(&plan);
+            pthread_mutex_unlock(&context->lock);
+            return NULL;
+        }
+        config.solver = plan.chosen;
+    }
+    
+    EigenResults* results = NULL;
+    Mesh* mesh = create_mesh_in(request->N, params, context->arena);
+    SparseMatrixCSR* A = NULL;
+    SparseMatrixCSR* B = NULL;
+    if (mesh && config.solver != SOLVER_MATRIX_FREE) {
+        A = build_stiffness_matrix(mesh);
+        B = build_mass_matrix(mesh);
+    }
+    
+    if (!mesh || (config.solver != SOLVER_MATRIX_FREE && (!A || !B))) {
+        fprintf(stderr, "Error: Failed to build the problem in the context arena\n");
+    } else {
+        config.mesh = mesh;
+        results = solve_eigenproblem(A, B, &config);
+    }
+    
+    pthread_mutex_unlock(&context->lock);
+    return results;
+}
+
+const EigenResults* membrane_solve_matrices(MembraneContext* context, SparseMatrixCSR* A,
+                                            SparseMatrixCSR* B,
+                                            const MembraneSolveRequest* request) {
+    return membrane_solve_operator(context, NULL, A, B, request);
+}
+
+const EigenResults* membrane_solve_operator(MembraneContext* context, const Mesh* mesh,
+                                            SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                            const MembraneSolveRequest* request) {
+    int n = A ? A->n_rows : (mesh ? mesh->total_points : 0);
+    if ((!A || !B) && !mesh) {
+        fprintf(stderr, "Error: No operator or grid to solve on\n");
+        return NULL;
+    }
+    if (request->n_eigenvalues < 1 || request->n_eigenvalues > n) {
+        fprintf(stderr, "Error: Invalid operator or number of eigenvalues\n");
+        return NULL;
+    }
+    if (request->solver == SOLVER_MATRIX_FREE && !mesh) {
+        fprintf(stderr, "Error: The matrix-free solver needs a grid, use membrane_solve\n");
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&context->lock);
+    arena_reset(context->arena);
+    context->calls++;
+    
+    SolverConfig config;
+    configure(&config, request, context->arena);
+    config.mesh = mesh;
+    EigenResults* results = solve_eigenproblem(A, B, &config);
+    
+    pthread_mutex_unlock(&context->lock);
+    return results;
+}
+
+void membrane_context_stats(MembraneContext* context, MembraneContextStats* stats) {
+    pthread_mutex_lock(&context->lock);
+    stats->calls = context->calls;
+    stats->capacity = arena_capacity(context->arena);
+    stats->peak = arena_peak(context->arena);
+    stats->segments = arena_segment_count(context->arena);
+    pthread_mutex_unlock(&context->lock);
+}
@@ -1,22 +1,42 @@
 #include "mesh.h"
+#include "npy_io.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
+static int sample_coefficient(Mesh* mesh, const CoeffExpr* expr,
+                              double (*func)(double, double), double* values) {
+    int N = mesh->N;
+    
+    if (expr) return coeff_expr_eval_grid(expr, mesh->x, mesh->y, N, values);
+    
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            values[mesh_index(i, j, mesh)] = func(mesh_x(i, mesh), mesh_y(j, mesh));
+        }
+    }
+    return 0;
+}
+
 Mesh* create_mesh(int N, MembraneParams* params) {
-    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    return create_mesh_in(N, params, NULL);
+}
+
+Mesh* create_mesh_in(int N, MembraneParams* params, Arena* arena) {
+    Mesh* mesh = (Mesh*)arena_alloc(arena, sizeof(Mesh));
     if (!mesh) return NULL;
     
     mesh->N = N;
     mesh->total_points = N * N;
     mesh->h = DOMAIN_SIZE / (N + 1);
+    mesh->arena = arena;
     
     // Allocation
-    mesh->x = (double*)malloc(N * sizeof(double));
-    mesh->y = (double*)malloc(N * sizeof(double));
-    mesh->p_vals = (double*)malloc(mesh->total_points * sizeof(double));
-    mesh->w_vals = (double*)malloc(mesh->total_points * sizeof(double));
-    mesh->q_vals = (double*)malloc(mesh->total_points * sizeof(double));
+    mesh->x = (double*)arena_alloc(arena, N * sizeof(double));
+    mesh->y = (double*)arena_alloc(arena, N * sizeof(double));
+    mesh->p_vals = (double*)arena_alloc(arena, mesh->total_points * sizeof(double));
+    mesh->w_vals = (double*)arena_alloc(arena, mesh->total_points * sizeof(double));
+    mesh->q_vals = (double*)arena_alloc(arena, mesh->total_points * sizeof(double));
     
     if (!mesh->x || !mesh->y || !mesh->p_vals || !mesh->w_vals || !mesh->q_vals) {
         free_mesh(mesh);
@@ -29,31 +49,42 @@ Mesh* create_mesh(int N, MembraneParams* params) {
         mesh->y[i] = (i + 1) * mesh->h;
     }
     
-    // Calcul des coefficients
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            int idx = mesh_index(i, j, mesh);
-            double x = mesh_x(i, mesh);
-            double y = mesh_y(j, mesh);
-            
-            mesh->p_vals[idx] = params->tension(x, y);
-            mesh->w_vals[idx] = params->density(x, y);
-            mesh->q_vals[idx] = params->potential(x, y);
+    // Calcul des coefficients: expressions compilées (par blocs) ou fonctions C
+    int status = sample_coefficient(mesh, params->tension_expr, params->tension, mesh->p_vals);
+    if (status == 0) {
+        status = sample_coefficient(mesh, params->density_expr, params->density, mesh->w_vals);
+    }
+    if (!params->potential_expr && params->potential == default_potential) {
+        // Obstacle par défaut: centre, intensité et largeur pris dans les paramètres
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                mesh->q_vals[mesh_index(i, j, mesh)] = obstacle_potential(params, mesh->x[i],
+                                                                          mesh->y[j]);
+            }
         }
+    } else if (status == 0) {
+        status = sample_coefficient(mesh, params->potential_expr, params->potential, mesh->q_vals);
     }
     
+    // Coefficients incomplets: le maillage n'est pas utilisable
+    if (status != 0) {
+        free_mesh(mesh);
+        return NULL;
+    }
     return mesh;
 }
 
 void free_mesh(Mesh* mesh) {
     if (!mesh) return;
     
-    free(mesh->x);
-    free(mesh->y);
-    free(mesh->p_vals);
-    free(mesh->w_vals);
-    free(mesh->q_vals);
-    free(mesh);
+    // Sans effet dans une arène (rendu par arena_reset)
+    Arena* arena = mesh->arena;
+    arena_free(arena, mesh->x);
+    arena_free(arena, mesh->y);
+    arena_free(arena, mesh->p_vals);
+    arena_free(arena, mesh->w_vals);
+    arena_free(arena, mesh->q_vals);
+    arena_free(arena, mesh);
 }
 
 int mesh_index(int i, int j, Mesh* mesh) {
@@ -84,3 +115,19 @@ void save_mesh(Mesh* mesh, const char* filename) {
     
     fclose(file);
 }
+
+void save_mesh_npz(Mesh* mesh, const char* filename) {
+    NpzWriter* npz = npz_open(filename);
+    if (!npz) return;
+    
+    size_t axis[1] = {(size_t)mesh->N};
+    size_t grid[2] = {(size_t)mesh->N, (size_t)mesh->N};
+    
+    npz_add_array(npz, "x", NPY_FLOAT64, 1, axis, mesh->x);
+    npz_add_array(npz, "y", NPY_FLOAT64, 1, axis, mesh->y);
+    npz_add_array(npz, "p", NPY_FLOAT64, 2, grid, mesh->p_vals);
+    npz_add_array(npz, "w", NPY_FLOAT64, 2, grid, mesh->w_vals);
+    npz_add_array(npz, "q", NPY_FLOAT64, 2, grid, mesh->q_vals);
+    
+    npz_close(npz);
+}
@@ -0,0 +1,195 @@
+#include "modal_response.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mkl/mkl.h>
+
+// Récurrence exacte d'un oscillateur ü + 2ζω u̇ + ω² u = p(t), p linéaire sur [t, t + dt]:
+// u' = a11 u + a12 v + b11 p + b12 p',  v' = a21 u + a22 v + b21 p + b22 p'
+typedef struct {
+    double a11, a12, b11, b12;
+    double a21, a22, b21, b22;
+} ModalStep;
+
+static void modal_step(double omega, double zeta, double dt, ModalStep* s) {
+    double root = sqrt(1.0 - zeta * zeta);
+    double omega_d = omega * root;
+    double e = exp(-zeta * omega * dt);
+    double sn = sin(omega_d * dt);
+    double cs = cos(omega_d * dt);
+    double k = omega * omega;
+    double wdt = omega * dt;
+    
+    s->a11 = e * (zeta / root * sn + cs);
+    s->a12 = e * sn / omega_d;
+    s->b11 = (2.0 * zeta / wdt +
+              e * (((1.0 - 2.0 * zeta * zeta) / (omega_d * dt) - zeta / root) * sn -
+                   (1.0 + 2.0 * zeta / wdt) * cs)) / k;
+    s->b12 = (1.0 - 2.0 * zeta / wdt +
+              e * ((2.0 * zeta * zeta - 1.0) / (omega_d * dt) * sn + 2.0 * zeta / wdt * cs)) / k;
+    
+    s->a21 = -e * omega / root * sn;
+    s->a22 = e * (cs - zeta / root * sn);
+    s->b21 = (-1.0 / dt + e * ((omega / root + zeta / (dt * root)) * sn + cs / dt)) / k;
+    s->b22 = (1.0 - e * (zeta / root * sn + cs)) / (k * dt);
+}
+
+double harmonic_load_profile(double t, const void* data) {
+    return sin(2.0 * PI * *(const double*)data * t);
+}
+
+static double load_at(const ResponseProblem* problem, double t) {
+    return problem->profile ? problem->profile(t, problem->profile_data) : 1.0;
+}
+
+static void apply_mass(const LinearOperator* B, int n, int n_vectors, const double* X, double* Y) {
+    if (B) B->apply(B->data, n_vectors, X, Y);
+    else memcpy(Y, X, (size_t)n * n_vectors * sizeof(double));
+}
+
+// Coordonnées modales c = Φᵀ B x / m (modes non nécessairement B-normés)
+static void project(int n, int k, const double* BPhi, const double* mass, const double* x,
+                    double* c) {
+    for (int i = 0; i < k; i++) c[i] = 0.0;
+    if (!x) return;
+    cblas_dgemv(CblasColMajor, CblasTrans, n, k, 1.0, BPhi, n, x, 1, 0.0, c, 1);
+    for (int i = 0; i < k; i++) c[i] /= mass[i];
+}
+
+int modal_response(const EigenResults* modes, const LinearOperator* B,
+                   const ResponseProblem* problem, ResponseSinkFn sink, void* data,
+                   ResponseStats* stats) {
+    int n = modes->n_dof;
+    int k = modes->n_eigenvalues;
+    double zeta = problem->damping;
+    
+    if (problem->dt <= 0.0 || problem->n_steps < 1 || zeta < 0.0 || zeta >= 1.0) {
+        fprintf(stderr, "Error: Response needs dt > 0, at least one step and 0 <= damping < 1\n");
+        return -1;
+    }
+    if (B && B->n != n) {
+        fprintf(stderr, "Error: Mass operator size %d does not match the modes (%d)\n", B->n, n);
+        return -1;
+    }
+    for (int i = 0; i < k; i++) {
+        if (!(modes->eigenvalues[i] > 0.0)) {
+            fprintf(stderr, "Error: Mode %d has a non-positive eigenvalue (%g)\n", i + 1,
+                    modes->eigenvalues[i]);
+            return -1;
+        }
+    }
+    
+    long n_steps = problem->n_steps;
+    long chunk = problem->chunk > 0 ? problem->chunk
+                                    : (long)(RESPONSE_CHUNK_BYTES / ((size_t)n * sizeof(double)));
+    if (chunk < 1) chunk = 1;
+    if (chunk > n_steps) chunk = n_steps;
+    
+    double* BPhi = (double*)mkl_malloc((size_t)n * k * sizeof(double), 64);
+    double* Bu = (double*)mkl_malloc((size_t)n * sizeof(double), 64);
+    double* modal = (double*)malloc((size_t)k * 4 * sizeof(double));
+    ModalStep* steps = (ModalStep*)malloc((size_t)k * sizeof(ModalStep));
+    double* C = (double*)mkl_malloc((size_t)k * chunk * sizeof(double), 64);
+    double* U = (double*)mkl_malloc((size_t)n * chunk * sizeof(double), 64);
+    if (!BPhi || !Bu || !modal || !steps || !C || !U) {
+        fprintf(stderr, "Error: Memory allocation failed for the modal response\n");
+        mkl_free(BPhi);
+        mkl_free(Bu);
+        free(modal);
+        free(steps);
+        mkl_free(C);
+        mkl_free(U);
+        return -1;
+    }
+    double* mass = modal;           // m_i = φ_iᵀ B φ_i
+    double* x = modal + k;          // Déplacement modal courant
+    double* v = modal + 2 * k;      // Vitesse modale courante
+    double* force = modal + 3 * k;  // Charge modale φ_iᵀ f / m_i
+    
+    double start = profiler_now();
+    double sink_seconds = 0.0;
+    profiler_begin("modal_response");
+    
+    // ============ PROJECTION ============
+    profiler_begin("projection");
+    apply_mass(B, n, k, modes->modes, BPhi);
+    for (int i = 0; i < k; i++) {
+        mass[i] = cblas_ddot(n, modes->modes + (size_t)i * n, 1, BPhi + (size_t)i * n, 1);
+        modal_step(sqrt(modes->eigenvalues[i]), zeta, problem->dt, &steps[i]);
+    }
+    project(n, k, BPhi, mass, problem->initial_displacement, x);
+    project(n, k, BPhi, mass, problem->initial_velocity, v);
+    for (int i = 0; i < k; i++) force[i] = 0.0;
+    if (problem->load) {
+        cblas_dgemv(CblasColMajor, CblasTrans, n, k, 1.0, modes->modes, n, problem->load, 1,
+                    0.0, force, 1);
+        for (int i = 0; i < k; i++) force[i] /= mass[i];
+    }
+    
+    // Part de u(0) captée: |Φ x|_B / |u(0)|_B (modes B-orthogonaux)
+    double captured = 1.0;
+    if (problem->initial_displacement) {
+        apply_mass(B, n, 1, problem->initial_displacement, Bu);
+        double total = cblas_ddot(n, problem->initial_displacement, 1, Bu, 1);
+        double kept = 0.0;
+        for (int i = 0; i < k; i++) kept += x[i] * x[i] * mass[i];
+        if (total > 0.0) captured = sqrt(kept / total);
+    }
+    profiler_end();
+    
+    // ============ SYNTHESE PAR BLOCS ============
+    int status = 0;
+    double g_previous = load_at(problem, 0.0);
+    for (long first = 0; first < n_steps && status == 0; first += chunk) {
+        int count = (int)(first + chunk <= n_steps ? chunk : n_steps - first);
+    
+        profiler_begin("modal_coordinates");
+        for (int j = 0; j < count; j++) {
+            long step = first + j;
+            if (step > 0) {
+                double g = load_at(problem, step * problem->dt);
+                for (int i = 0; i < k; i++) {
+                    const ModalStep* s = &steps[i];
+                    double p0 = force[i] * g_previous, p1 = force[i] * g;
+                    double xi = s->a11 * x[i] + s->a12 * v[i] + s->b11 * p0 + s->b12 * p1;
+                    v[i] = s->a21 * x[i] + s->a22 * v[i] + s->b21 * p0 + s->b22 * p1;
+                    x[i] = xi;
+                }
+                g_previous = g;
+            }
+            memcpy(C + (size_t)j * k, x, k * sizeof(double));
+        }
+        profiler_add_work(8.0 * k * count, (double)k * count * sizeof(double));
+        profiler_end();
+    
+        // U = Φ C: les modes sont relus une fois par bloc et non par snapshot
+        profiler_begin("reconstruction");
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, count, k, 1.0, modes->modes,
+                    n, C, k, 0.0, U, n);
+        profiler_add_work(2.0 * n * k * count,
+                          ((double)n * k + (double)k * count + (double)n * count) * sizeof(double));
+        profiler_end();
+    
+        double sink_start = profiler_now();
+        if (sink && sink(first, count, U, data) != 0) status = -1;
+        sink_seconds += profiler_now() - sink_start;
+    }
+    profiler_end();
+    
+    if (stats) {
+        stats->captured = captured;
+        stats->sink_seconds = sink_seconds;
+        stats->seconds = profiler_now() - start - sink_seconds;
+        stats->chunk = (int)chunk;
+    }
+    
+    mkl_free(BPhi);
+    mkl_free(Bu);
+    free(modal);
+    free(steps);
+    mkl_free(C);
+    mkl_free(U);
+    return status;
+}
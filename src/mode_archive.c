@@ -0,0 +1,680 @@
+#include "mode_archive.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// LZ77 à octets alignés (format de séquence de LZ4): jeton (littéraux << 4 | match - 4),
+// longueurs >= 15 prolongées par octets de 255, distance sur 16 bits. La dernière
+// séquence ne contient que des littéraux
+#define LZ_HASH_BITS 14
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+#define LZ_SKIP_SHIFT 6         // Accélère la recherche dans les données incompressibles
+
+struct ModeArchive {
+    int fd;
+    uint64_t file_bytes;
+    ModeArchiveHeader header;
+    double* x;
+    double* y;
+    double* eigenvalues;
+    ModeArchiveMode* modes;
+    ModeArchiveBlock* blocks;   // n_modes x n_blocks
+};
+
+int parse_mode_encoding(const char* name, ModeEncoding* encoding) {
+    if (strcmp(name, "float64") == 0) {
+        *encoding = MODE_FLOAT64;
+    } else if (strcmp(name, "float32") == 0) {
+        *encoding = MODE_FLOAT32;
+    } else if (strcmp(name, "quantized") == 0) {
+        *encoding = MODE_QUANTIZED;
+    } else {
+        fprintf(stderr, "Error: Unknown mode encoding '%s' (expected float64, float32 "
+                "or quantized)\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+const char* mode_encoding_name(ModeEncoding encoding) {
+    switch (encoding) {
+        case MODE_FLOAT64: return "float64";
+        case MODE_FLOAT32: return "float32";
+        default: return "quantized";
+    }
+}
+
+// ============ CODEC LZ ============
+
+static uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t lz_hash(uint32_t v) {
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static uint8_t* put_length(uint8_t* out, size_t length) {
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = (uint8_t)length;
+    return out;
+}
+
+// Taille compressée, 0 si elle dépasse capacity. table: 1 << LZ_HASH_BITS positions
+static size_t lz_compress(const uint8_t* in, size_t n, uint8_t* out, size_t capacity,
+                          uint32_t* table) {
+    uint8_t* op = out;
+    const uint8_t* end = out + capacity;
+    size_t anchor = 0;
+    size_t pos = 0;
+    memset(table, 0, sizeof(uint32_t) << LZ_HASH_BITS);   // Position + 1, 0: vide
+    
+    while (pos + LZ_MIN_MATCH <= n) {
+        uint32_t sequence = read32(in + pos);
+        uint32_t h = lz_hash(sequence);
+        size_t candidate = table[h];
+        table[h] = (uint32_t)pos + 1;
+        if (candidate == 0 || pos - (candidate - 1) > LZ_MAX_OFFSET ||
+            read32(in + candidate - 1) != sequence) {
+            pos += 1 + ((pos - anchor) >> LZ_SKIP_SHIFT);
+            continue;
+        }
+        candidate--;
+        size_t length = LZ_MIN_MATCH;
+        while (pos + length < n && in[candidate + length] == in[pos + length]) length++;
+    
+        size_t literals = pos - anchor;
+        size_t extra = length - LZ_MIN_MATCH;
+        if ((size_t)(end - op) < literals + literals / 255 + extra / 255 + 6) return 0;
+        uint8_t* token = op++;
+        *token = (uint8_t)(((literals < 15 ? literals : 15) << 4) | (extra < 15 ? extra : 15));
+        if (literals >= 15) op = put_length(op, literals - 15);
+        memcpy(op, in + anchor, literals);
+        op += literals;
+        size_t offset = pos - candidate;
+        *op++ = (uint8_t)(offset & 0xFF);
+        *op++ = (uint8_t)(offset >> 8);
+        if (extra >= 15) op = put_length(op, extra - 15);
+        pos += length;
+        anchor = pos;
+    }
+    
+    size_t literals = n - anchor;
+    if ((size_t)(end - op) < literals + literals / 255 + 2) return 0;
+    *op++ = (uint8_t)((literals < 15 ? literals : 15) << 4);
+    if (literals >= 15) op = put_length(op, literals - 15);
+    memcpy(op, in + anchor, literals);
+    op += literals;
+    return (size_t)(op - out);
+}
+
+// -1 si le flux est corrompu ou ne redonne pas exactement raw octets
+static int lz_decompress(const uint8_t* in, size_t n, uint8_t* out, size_t raw) {
+    size_t ip = 0, op = 0;
+    while (ip < n) {
+        uint8_t token = in[ip++];
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            uint8_t b;
+            do {
+                if (ip >= n) return -1;
+                b = in[ip++];
+                literals += b;
+            } while (b == 255);
+        }
+        if (literals > n - ip || literals > raw - op) return -1;
+        memcpy(out + op, in + ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == n) break;
+    
+        if (n - ip < 2) return -1;
+        size_t offset = (size_t)in[ip] | ((size_t)in[ip + 1] << 8);
+        ip += 2;
+        size_t length = token & 15;
+        if (length == 15) {
+            uint8_t b;
+            do {
+                if (ip >= n) return -1;
+                b = in[ip++];
+                length += b;
+            } while (b == 255);
+        }
+        length += LZ_MIN_MATCH;
+        if (offset == 0 || offset > op || length > raw - op) return -1;
+        if (offset >= length) {
+            memcpy(out + op, out + op - offset, length);
+        } else {
+            for (size_t i = 0; i < length; i++) out[op + i] = out[op + i - offset];
+        }
+        op += length;
+    }
+    return op == raw ? 0 : -1;
+}
+
+// ============ CODAGE DES BLOCS ============
+
+static int word_width(ModeEncoding encoding, uint64_t bits) {
+    if (encoding == MODE_FLOAT64) return 8;
+    if (encoding == MODE_FLOAT32) return 4;
+    int width = 1;
+    while (width < 8 && (bits >> (8 * width))) width++;
+    return width;
+}
+
+// Mots du bloc (lignes r0..r1-1): bits des flottants ou résidus en zigzag. Renvoie l'erreur max
+static double block_words(const double* phi, int N, int r0, int r1, ModeEncoding encoding,
+                          double scale, uint64_t* words, int64_t* rows, uint64_t* bits) {
+    size_t count = (size_t)(r1 - r0) * N;
+    const double* f = phi + (size_t)r0 * N;
+    double max_error = 0.0;
+    uint64_t all = 0;
+    
+    if (encoding == MODE_FLOAT64) {
+        memcpy(words, f, count * sizeof(double));
+    } else if (encoding == MODE_FLOAT32) {
+        for (size_t e = 0; e < count; e++) {
+            float v = (float)f[e];
+            uint32_t u;
+            memcpy(&u, &v, sizeof(u));
+            words[e] = u;
+            double error = fabs(f[e] - (double)v);
+            if (error > max_error) max_error = error;
+        }
+    } else {
+        // Prédicteur 2D sur les entiers: la ligne au-dessus du bloc compte pour zéro
+        int64_t* above = rows;
+        int64_t* current = rows + N;
+        memset(above, 0, (size_t)N * sizeof(int64_t));
+        double inv = 1.0 / scale;
+        for (int r = 0; r < r1 - r0; r++) {
+            const double* line = f + (size_t)r * N;
+            uint64_t* out = words + (size_t)r * N;
+            for (int j = 0; j < N; j++) {
+                int64_t q = llround(line[j] * inv);
+                current[j] = q;
+                int64_t prediction = above[j] + (j > 0 ? current[j - 1] - above[j - 1] : 0);
+                int64_t e = q - prediction;
+                uint64_t z = ((uint64_t)e << 1) ^ (uint64_t)(e >> 63);
+                out[j] = z;
+                all |= z;
+                double error = fabs(line[j] - (double)q * scale);
+                if (error > max_error) max_error = error;
+            }
+            int64_t* swap = above;
+            above = current;
+            current = swap;
+        }
+    }
+    *bits = all;
+    return max_error;
+}
+
+// Octet b du mot e en position b * count + e (mots petits: octets de poids fort presque nuls)
+static void shuffle_words(const uint64_t* words, size_t count, int width, uint8_t* raw) {
+    for (int b = 0; b < width; b++) {
+        uint8_t* plane = raw + (size_t)b * count;
+        int shift = 8 * b;
+        for (size_t e = 0; e < count; e++) plane[e] = (uint8_t)(words[e] >> shift);
+    }
+}
+
+static void unshuffle_words(const uint8_t* raw, size_t count, int width, uint64_t* words) {
+    memset(words, 0, count * sizeof(uint64_t));
+    for (int b = 0; b < width; b++) {
+        const uint8_t* plane = raw + (size_t)b * count;
+        int shift = 8 * b;
+        for (size_t e = 0; e < count; e++) words[e] |= (uint64_t)plane[e] << shift;
+    }
+}
+
+static void decode_words(const uint64_t* words, int N, int n_rows, ModeEncoding encoding,
+                         double scale, int64_t* rows, double* values) {
+    size_t count = (size_t)n_rows * N;
+    if (encoding == MODE_FLOAT64) {
+        memcpy(values, words, count * sizeof(double));
+    } else if (encoding == MODE_FLOAT32) {
+        for (size_t e = 0; e < count; e++) {
+            uint32_t u = (uint32_t)words[e];
+            float v;
+            memcpy(&v, &u, sizeof(v));
+            values[e] = v;
+        }
+    } else {
+        int64_t* above = rows;
+        int64_t* current = rows + N;
+        memset(above, 0, (size_t)N * sizeof(int64_t));
+        for (int r = 0; r < n_rows; r++) {
+            const uint64_t* in = words + (size_t)r * N;
+            double* out = values + (size_t)r * N;
+            for (int j = 0; j < N; j++) {
+                int64_t e = (int64_t)(in[j] >> 1) ^ -(int64_t)(in[j] & 1);
+                int64_t q = e + above[j] + (j > 0 ? current[j - 1] - above[j - 1] : 0);
+                current[j] = q;
+                out[j] = (double)q * scale;
+            }
+            int64_t* swap = above;
+            above = current;
+            current = swap;
+        }
+    }
+}
+
+// Longueur de "%.6f" (estimation de la taille CSV équivalente)
+static size_t csv_field_bytes(double v) {
+    double a = fabs(v) + 5e-7;
+    size_t digits = 1;
+    while (a >= 10.0 && digits < 20) {
+        a /= 10.0;
+        digits++;
+    }
+    return digits + 7 + (signbit(v) ? 1 : 0);
+}
+
+// ============ EMPREINTES ============
+
+// Empreinte des octets stockés d'un bloc, graine = rang du bloc dans le mode. Chaque mot
+// passe par une bijection de l'état: un mot modifié change toujours le résultat
+static uint64_t block_checksum(const uint8_t* bytes, size_t n, uint64_t seed) {
+    uint64_t h = ((seed + 1) * 0x9E3779B97F4A7C15ull) ^ n;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        memcpy(&w, bytes + i, sizeof(w));
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, bytes + i, n - i);
+    h = (h ^ tail) * 0xFF51AFD7ED558CCDull;
+    return h ^ (h >> 29);
+}
+
+// ============ ECRITURE ============
+
+// Début des blocs: en-tête, coordonnées, valeurs propres, table des modes, table des blocs
+static uint64_t archive_data_offset(uint64_t N, uint64_t n_blocks, uint64_t n_modes) {
+    return sizeof(ModeArchiveHeader) + 2 * N * sizeof(double) +
+           n_modes * (sizeof(double) + sizeof(ModeArchiveMode)) +
+           n_modes * n_blocks * sizeof(ModeArchiveBlock);
+}
+
+int mode_archive_write(const char* filename, const Mesh* mesh, const EigenResults* results,
+                       int n_modes, const ModeArchiveOptions* options, ModeArchiveStats* stats) {
+    int N = mesh ? mesh->N : 0;
+    if (!mesh || results->n_dof != mesh->total_points) {
+        fprintf(stderr, "Error: Mode archive needs modes on the mesh grid\n");
+        return -1;
+    }
+    if (n_modes < 1 || n_modes > results->n_eigenvalues) {
+        fprintf(stderr, "Error: Invalid number of modes for the archive (%d of %d)\n",
+                n_modes, results->n_eigenvalues);
+        return -1;
+    }
+    double epsilon = options->error_bound;
+    if (options->encoding == MODE_QUANTIZED && !(epsilon >= 1e-12 && epsilon <= 0.5)) {
+        fprintf(stderr, "Error: Mode error bound must be in [1e-12, 0.5] (got %g)\n", epsilon);
+        return -1;
+    }
+    
+    double start = profiler_now();
+    profiler_begin("mode_archive");
+    size_t n = (size_t)mesh->total_points;
+    int rows_per_block = MODE_ARCHIVE_BLOCK_VALUES / N;
+    if (rows_per_block < 1) rows_per_block = 1;
+    if (rows_per_block > N) rows_per_block = N;
+    int n_blocks = (N + rows_per_block - 1) / rows_per_block;
+    int n_tasks = n_modes * n_blocks;
+    
+    ModeArchiveMode* modes = (ModeArchiveMode*)calloc(n_modes, sizeof(ModeArchiveMode));
+    ModeArchiveBlock* blocks = (ModeArchiveBlock*)calloc(n_tasks, sizeof(ModeArchiveBlock));
+    uint8_t** payloads = (uint8_t**)calloc(n_tasks, sizeof(uint8_t*));
+    double* block_error = (double*)calloc(n_tasks, sizeof(double));
+    uint64_t* block_hash = (uint64_t*)calloc(n_tasks, sizeof(uint64_t));
+    FILE* file = NULL;
+    int status = -1;
+    if (!modes || !blocks || !payloads || !block_error || !block_hash) {
+        fprintf(stderr, "Error: Memory allocation failed for the mode archive\n");
+        goto cleanup;
+    }
+    
+    // Pas de quantification: erreur ≤ Δ/2 = ε max|φ| (marge pour l'arrondi de φ/Δ)
+    for (int v = 0; v < n_modes; v++) {
+        const double* phi = results->modes + (size_t)v * results->n_dof;
+        double max_abs = 0.0;
+        #pragma omp parallel for reduction(max:max_abs) schedule(static)
+        for (size_t idx = 0; idx < n; idx++) {
+            double a = fabs(phi[idx]);
+            if (a > max_abs) max_abs = a;
+        }
+        modes[v].max_abs = max_abs;
+        if (options->encoding == MODE_QUANTIZED) {
+            modes[v].scale = max_abs > 0.0 ? 2.0 * epsilon * max_abs * (1.0 - 1e-9) : 1.0;
+        }
+    }
+    
+    // Blocs de tous les modes en parallèle; chaque bloc garde son tampon jusqu'à l'écriture
+    int failed = 0;
+    #pragma omp parallel reduction(|:failed)
+    {
+        size_t block_values = (size_t)rows_per_block * N;
+        uint64_t* words = (uint64_t*)malloc(block_values * sizeof(uint64_t));
+        int64_t* rows = (int64_t*)malloc(2 * (size_t)N * sizeof(int64_t));
+        uint8_t* raw = (uint8_t*)malloc(block_values * sizeof(uint64_t));
+        uint32_t* table = (uint32_t*)malloc(sizeof(uint32_t) << LZ_HASH_BITS);
+        if (!words || !rows || !raw || !table) failed = 1;
+    
+        #pragma omp for schedule(dynamic)
+        for (int t = 0; t < n_tasks; t++) {
+            if (failed) continue;
+            int v = t / n_blocks;
+            int r0 = (t % n_blocks) * rows_per_block;
+            int r1 = r0 + rows_per_block < N ? r0 + rows_per_block : N;
+            size_t count = (size_t)(r1 - r0) * N;
+            const double* phi = results->modes + (size_t)v * results->n_dof;
+            uint64_t bits;
+            block_error[t] = block_words(phi, N, r0, r1, options->encoding, modes[v].scale,
+                                         words, rows, &bits);
+            int width = word_width(options->encoding, bits);
+            size_t raw_bytes = count * width;
+            shuffle_words(words, count, width, raw);
+    
+            uint8_t* payload = (uint8_t*)malloc(raw_bytes);
+            if (!payload) {
+                failed = 1;
+                continue;
+            }
+            size_t stored = options->compress ?
+                            lz_compress(raw, raw_bytes, payload, raw_bytes - 1, table) : 0;
+            if (stored == 0) {
+                memcpy(payload, raw, raw_bytes);
+                stored = raw_bytes;
+            }
+            payloads[t] = payload;
+            block_hash[t] = block_checksum(payload, stored, (uint64_t)(t % n_blocks));
+            blocks[t].stored_bytes = (uint32_t)stored;
+            blocks[t].raw_bytes = (uint32_t)raw_bytes;
+        }
+        free(words);
+        free(rows);
+        free(raw);
+        free(table);
+    }
+    if (failed) {
+        fprintf(stderr, "Error: Memory allocation failed while compressing modes\n");
+        goto cleanup;
+    }
+    
+    uint64_t offset = archive_data_offset(N, n_blocks, n_modes);
+    for (int t = 0; t < n_tasks; t++) {
+        blocks[t].offset = offset;
+        offset += blocks[t].stored_bytes;
+        ModeArchiveMode* mode = &modes[t / n_blocks];
+        if (block_error[t] > mode->max_error) mode->max_error = block_error[t];
+        mode->checksum ^= block_hash[t];
+    }
+    
+    ModeArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MODE_ARCHIVE_MAGIC, 4);
+    header.version = MODE_ARCHIVE_VERSION;
+    header.N = (uint32_t)N;
+    header.n_modes = (uint32_t)n_modes;
+    header.encoding = (uint32_t)options->encoding;
+    header.compress = options->compress ? 1 : 0;
+    header.rows_per_block = (uint32_t)rows_per_block;
+    header.n_blocks = (uint32_t)n_blocks;
+    header.error_bound = options->encoding == MODE_QUANTIZED ? epsilon : 0.0;
+    
+    file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        goto cleanup;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(mesh->x, sizeof(double), N, file) == (size_t)N &&
+             fwrite(mesh->y, sizeof(double), N, file) == (size_t)N &&
+             fwrite(results->eigenvalues, sizeof(double), n_modes, file) == (size_t)n_modes &&
+             fwrite(modes, sizeof(ModeArchiveMode), n_modes, file) == (size_t)n_modes &&
+             fwrite(blocks, sizeof(ModeArchiveBlock), n_tasks, file) == (size_t)n_tasks;
+    for (int t = 0; ok && t < n_tasks; t++) {
+        ok = fwrite(payloads[t], 1, blocks[t].stored_bytes, file) == blocks[t].stored_bytes;
+    }
+    if (fclose(file) != 0) ok = 0;
+    file = NULL;
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to write mode archive %s\n", filename);
+        goto cleanup;
+    }
+    
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+        stats->file_bytes = offset;
+        stats->raw_bytes = (uint64_t)n * n_modes * sizeof(double);
+        for (int v = 0; v < n_modes; v++) {
+            double relative = modes[v].max_abs > 0.0 ? modes[v].max_error / modes[v].max_abs : 0.0;
+            if (relative > stats->max_error) stats->max_error = relative;
+        }
+        // Une ligne "x,y,valeur\n" par point et par mode
+        uint64_t coordinates = 0;
+        for (int i = 0; i < N; i++) {
+            coordinates += (uint64_t)N * (csv_field_bytes(mesh->x[i]) + csv_field_bytes(mesh->y[i]));
+        }
+        uint64_t values = 0;
+        for (int v = 0; v < n_modes; v++) {
+            const double* phi = results->modes + (size_t)v * results->n_dof;
+            #pragma omp parallel for reduction(+:values) schedule(static)
+            for (size_t idx = 0; idx < n; idx++) values += csv_field_bytes(phi[idx]) + 3;
+        }
+        stats->csv_bytes = coordinates * n_modes + values;
+        stats->seconds = profiler_now() - start;
+    }
+    status = 0;
+
+cleanup:
+    profiler_add_work(0.0, (double)n * n_modes * sizeof(double));
+    profiler_end();
+    if (file) fclose(file);
+    if (payloads) {
+        for (int t = 0; t < n_tasks; t++) free(payloads[t]);
+    }
+    free(payloads);
+    free(blocks);
+    free(modes);
+    free(block_error);
+    free(block_hash);
+    return status;
+}
+
+// ============ LECTURE ============
+
+static int read_at(int fd, void* buffer, size_t bytes, uint64_t offset) {
+    uint8_t* p = (uint8_t*)buffer;
+    while (bytes > 0) {
+        ssize_t got = pread(fd, p, bytes, (off_t)offset);
+        if (got <= 0) return -1;
+        p += got;
+        bytes -= (size_t)got;
+        offset += (uint64_t)got;
+    }
+    return 0;
+}
+
+void mode_archive_close(ModeArchive* archive) {
+    if (!archive) return;
+    if (archive->fd >= 0) close(archive->fd);
+    free(archive->x);
+    free(archive->y);
+    free(archive->eigenvalues);
+    free(archive->modes);
+    free(archive->blocks);
+    free(archive);
+}
+
+ModeArchive* mode_archive_open(const char* filename) {
+    ModeArchive* archive = (ModeArchive*)calloc(1, sizeof(ModeArchive));
+    if (!archive) return NULL;
+    archive->fd = open(filename, O_RDONLY);
+    if (archive->fd < 0) {
+        fprintf(stderr, "Error: Cannot open mode archive %s\n", filename);
+        free(archive);
+        return NULL;
+    }
+    struct stat st;
+    ModeArchiveHeader* header = &archive->header;
+    if (fstat(archive->fd, &st) != 0 ||
+        read_at(archive->fd, header, sizeof(*header), 0) != 0 ||
+        memcmp(header->magic, MODE_ARCHIVE_MAGIC, 4) != 0 ||
+        header->version != MODE_ARCHIVE_VERSION) {
+        fprintf(stderr, "Error: %s is not a mode archive\n", filename);
+        mode_archive_close(archive);
+        return NULL;
+    }
+    archive->file_bytes = (uint64_t)st.st_size;
+    
+    uint32_t N = header->N;
+    uint32_t k = header->n_modes;
+    uint32_t rows = header->rows_per_block;
+    if (N == 0 || k == 0 || rows == 0 || rows > N || header->encoding > MODE_QUANTIZED ||
+        header->n_blocks != (N + rows - 1) / rows) {
+        fprintf(stderr, "Error: Corrupted mode archive header in %s\n", filename);
+        mode_archive_close(archive);
+        return NULL;
+    }
+    size_t n_blocks = (size_t)k * header->n_blocks;
+    uint64_t data_offset = archive_data_offset(N, header->n_blocks, k);
+    archive->x = (double*)malloc(N * sizeof(double));
+    archive->y = (double*)malloc(N * sizeof(double));
+    archive->eigenvalues = (double*)malloc(k * sizeof(double));
+    archive->modes = (ModeArchiveMode*)malloc(k * sizeof(ModeArchiveMode));
+    archive->blocks = (ModeArchiveBlock*)malloc(n_blocks * sizeof(ModeArchiveBlock));
+    if (!archive->x || !archive->y || !archive->eigenvalues || !archive->modes ||
+        !archive->blocks || data_offset > archive->file_bytes) {
+        fprintf(stderr, "Error: Cannot load the tables of mode archive %s\n", filename);
+        mode_archive_close(archive);
+        return NULL;
+    }
+    
+    uint64_t offset = sizeof(ModeArchiveHeader);
+    int ok = read_at(archive->fd, archive->x, N * sizeof(double), offset) == 0;
+    offset += N * sizeof(double);
+    ok = ok && read_at(archive->fd, archive->y, N * sizeof(double), offset) == 0;
+    offset += N * sizeof(double);
+    ok = ok && read_at(archive->fd, archive->eigenvalues, k * sizeof(double), offset) == 0;
+    offset += k * sizeof(double);
+    ok = ok && read_at(archive->fd, archive->modes, k * sizeof(ModeArchiveMode), offset) == 0;
+    offset += k * sizeof(ModeArchiveMode);
+    ok = ok && read_at(archive->fd, archive->blocks, n_blocks * sizeof(ModeArchiveBlock),
+                       offset) == 0;
+    for (size_t b = 0; ok && b < n_blocks; b++) {
+        const ModeArchiveBlock* block = &archive->blocks[b];
+        ok = block->stored_bytes <= block->raw_bytes &&
+             block->offset + block->stored_bytes <= archive->file_bytes;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Corrupted tables in mode archive %s\n", filename);
+        mode_archive_close(archive);
+        return NULL;
+    }
+    return archive;
+}
+
+const ModeArchiveHeader* mode_archive_header(const ModeArchive* archive) {
+    return &archive->header;
+}
+
+const double* mode_archive_x(const ModeArchive* archive) {
+    return archive->x;
+}
+
+const double* mode_archive_y(const ModeArchive* archive) {
+    return archive->y;
+}
+
+const double* mode_archive_eigenvalues(const ModeArchive* archive) {
+    return archive->eigenvalues;
+}
+
+const ModeArchiveMode* mode_archive_mode(const ModeArchive* archive, int index) {
+    if (index < 0 || index >= (int)archive->header.n_modes) return NULL;
+    return &archive->modes[index];
+}
+
+int mode_archive_read_mode(const ModeArchive* archive, int index, double* values) {
+    const ModeArchiveHeader* header = &archive->header;
+    if (index < 0 || index >= (int)header->n_modes) {
+        fprintf(stderr, "Error: Mode %d is not in the archive (%u modes)\n", index + 1,
+                header->n_modes);
+        return -1;
+    }
+    int N = (int)header->N;
+    int rows_per_block = (int)header->rows_per_block;
+    int n_blocks = (int)header->n_blocks;
+    ModeEncoding encoding = (ModeEncoding)header->encoding;
+    double scale = archive->modes[index].scale;
+    const ModeArchiveBlock* blocks = archive->blocks + (size_t)index * n_blocks;
+    
+    profiler_begin("mode_archive_read");
+    int failed = 0;
+    uint64_t checksum = 0;
+    #pragma omp parallel reduction(|:failed) reduction(^:checksum)
+    {
+        size_t block_values = (size_t)rows_per_block * N;
+        uint64_t* words = (uint64_t*)malloc(block_values * sizeof(uint64_t));
+        int64_t* rows = (int64_t*)malloc(2 * (size_t)N * sizeof(int64_t));
+        uint8_t* stored = (uint8_t*)malloc(block_values * sizeof(uint64_t));
+        uint8_t* raw = (uint8_t*)malloc(block_values * sizeof(uint64_t));
+        if (!words || !rows || !stored || !raw) failed = 1;
+    
+        #pragma omp for schedule(dynamic)
+        for (int b = 0; b < n_blocks; b++) {
+            if (failed) continue;
+            int r0 = b * rows_per_block;
+            int n_rows = r0 + rows_per_block < N ? rows_per_block : N - r0;
+            size_t count = (size_t)n_rows * N;
+            const ModeArchiveBlock* block = &blocks[b];
+            size_t raw_bytes = block->raw_bytes;
+            int width = (int)(raw_bytes / count);
+            if (width < 1 || width > 8 || raw_bytes != count * width ||
+                (encoding == MODE_FLOAT64 && width != 8) ||
+                (encoding == MODE_FLOAT32 && width != 4)) {
+                failed = 1;
+                continue;
+            }
+            uint8_t* bytes = block->stored_bytes == raw_bytes ? raw : stored;
+            if (read_at(archive->fd, bytes, block->stored_bytes, block->offset) != 0) {
+                failed = 1;
+                continue;
+            }
+            checksum ^= block_checksum(bytes, block->stored_bytes, (uint64_t)b);
+            if (bytes == stored && lz_decompress(stored, block->stored_bytes, raw, raw_bytes) != 0) {
+                failed = 1;
+                continue;
+            }
+            unshuffle_words(raw, count, width, words);
+            decode_words(words, N, n_rows, encoding, scale, rows, values + (size_t)r0 * N);
+        }
+        free(words);
+        free(rows);
+        free(stored);
+        free(raw);
+    }
+    profiler_add_work(0.0, (double)N * N * sizeof(double));
+    profiler_end();
+    if (failed || checksum != archive->modes[index].checksum) {
+        fprintf(stderr, "Error: Cannot decode mode %d of the archive\n", index + 1);
+        return -1;
+    }
+    return 0;
+}
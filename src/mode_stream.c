@@ -0,0 +1,172 @@
+#include "mode_stream.h"
+#include "visualization.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Définitions pour PI si non défini
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+struct ModeStream {
+    Mesh* mesh;
+    int n_modes_to_save;
+    OutputFormat mode_format;
+    AsyncWriter* writer;
+    FILE* table;
+    FILE* sink;
+    double* saved_values;      // Valeur propre des modes déjà écrits (NAN sinon)
+    int n_delivered;
+    double first_elapsed;
+    double last_elapsed;
+};
+
+// Copie d'un mode en attente d'écriture
+typedef struct {
+    Mesh* mesh;
+    int index;
+    OutputFormat format;
+    double* vector;
+} ModeWriteTask;
+
+static void write_mode_task(void* payload) {
+    ModeWriteTask* task = (ModeWriteTask*)payload;
+    char filename[256];
+    snprintf(filename, sizeof(filename), "data/mode_%02d.%s", task->index + 1,
+             output_format_name(task->format));
+    if (task->format == OUTPUT_NPY) {
+        save_mode_to_npy(task->mesh, task->vector, task->index, filename);
+    } else {
+        save_mode_to_csv(task->mesh, task->vector, task->index, filename);
+    }
+}
+
+static void release_mode_task(void* payload) {
+    ModeWriteTask* task = (ModeWriteTask*)payload;
+    free(task->vector);
+    free(task);
+}
+
+static void mode_stream_callback(const Eigenpair* pair, void* user_data) {
+    ModeStream* stream = (ModeStream*)user_data;
+    
+    if (stream->n_delivered == 0) stream->first_elapsed = pair->elapsed;
+    stream->last_elapsed = pair->elapsed;
+    stream->n_delivered++;
+    
+    if (stream->table) {
+        double freq = sqrt(pair->eigenvalue) / (2 * PI);
+        fprintf(stream->table, "%d,%.6f,%.10e,%.10e,%.6f\n", pair->index + 1, freq,
+                pair->eigenvalue, pair->residual, pair->elapsed);
+        fflush(stream->table);
+    }
+    
+    if (stream->sink) {
+        ModeStreamRecord record;
+        memset(&record, 0, sizeof(record));
+        memcpy(record.magic, "MEIG", 4);
+        record.index = pair->index;
+        record.n = pair->n;
+        record.eigenvalue = pair->eigenvalue;
+        record.residual = pair->residual;
+        record.elapsed = pair->elapsed;
+        if (fwrite(&record, sizeof(record), 1, stream->sink) != 1 ||
+            fwrite(pair->vector, sizeof(double), pair->n, stream->sink) != (size_t)pair->n ||
+            fflush(stream->sink) != 0) {
+            fprintf(stderr, "Warning: Mode stream sink closed, disabling it\n");
+            fclose(stream->sink);
+            stream->sink = NULL;
+        }
+    }
+    
+    // Le vecteur n'est valide que pendant l'appel: copie pour la tâche d'écriture
+    if (stream->mesh && pair->index < stream->n_modes_to_save) {
+        ModeWriteTask* task = (ModeWriteTask*)malloc(sizeof(ModeWriteTask));
+        double* vector = (double*)malloc((size_t)pair->n * sizeof(double));
+        if (!task || !vector) {
+            fprintf(stderr, "Warning: Failed to queue streamed mode %d\n", pair->index + 1);
+            free(task);
+            free(vector);
+            return;
+        }
+        memcpy(vector, pair->vector, (size_t)pair->n * sizeof(double));
+        task->mesh = stream->mesh;
+        task->index = pair->index;
+        task->format = stream->mode_format;
+        task->vector = vector;
+        stream->saved_values[pair->index] = pair->eigenvalue;
+        async_writer_submit(stream->writer, write_mode_task, release_mode_task, task,
+                            (size_t)pair->n * sizeof(double));
+    }
+}
+
+ModeStream* mode_stream_create(Mesh* mesh, int n_modes_to_save, OutputFormat mode_format,
+                               const char* table_file, const char* sink_file,
+                               AsyncWriter* writer) {
+    ModeStream* stream = (ModeStream*)calloc(1, sizeof(ModeStream));
+    if (!stream) {
+        fprintf(stderr, "Error: Failed to allocate mode stream\n");
+        return NULL;
+    }
+    
+    stream->mesh = mesh;
+    stream->n_modes_to_save = mesh ? n_modes_to_save : 0;
+    stream->mode_format = mode_format;
+    stream->writer = writer;
+    stream->saved_values = (double*)malloc((n_modes_to_save > 0 ? n_modes_to_save : 1) *
+                                           sizeof(double));
+    if (!stream->saved_values) {
+        fprintf(stderr, "Error: Failed to allocate mode stream\n");
+        free(stream);
+        return NULL;
+    }
+    for (int i = 0; i < n_modes_to_save; i++) stream->saved_values[i] = NAN;
+    
+    if (table_file) {
+        stream->table = fopen(table_file, "w");
+        if (!stream->table) {
+            fprintf(stderr, "Error: Cannot open file %s for writing\n", table_file);
+            mode_stream_close(stream);
+            return NULL;
+        }
+        fprintf(stream->table, "mode,frequency_hz,eigenvalue,residual,time_s\n");
+        fflush(stream->table);
+    }
+    
+    // Un tube nommé bloque ici jusqu'à l'ouverture par le lecteur
+    if (sink_file) {
+        stream->sink = fopen(sink_file, "wb");
+        if (!stream->sink) {
+            fprintf(stderr, "Error: Cannot open stream sink %s\n", sink_file);
+            mode_stream_close(stream);
+            return NULL;
+        }
+    }
+    
+    return stream;
+}
+
+void mode_stream_attach(ModeStream* stream, SolverConfig* config) {
+    config->on_eigenpair = mode_stream_callback;
+    config->on_eigenpair_data = stream;
+}
+
+int mode_stream_saved(const ModeStream* stream, int index, double eigenvalue) {
+    if (!stream || index >= stream->n_modes_to_save) return 0;
+    return stream->saved_values[index] == eigenvalue;
+}
+
+void mode_stream_close(ModeStream* stream) {
+    if (!stream) return;
+    
+    if (stream->n_delivered > 0) {
+        printf("Mode stream: %d eigenpairs delivered, first after %.3f s, last after %.3f s\n",
+               stream->n_delivered, stream->first_elapsed, stream->last_elapsed);
+    }
+    if (stream->table) fclose(stream->table);
+    if (stream->sink) fclose(stream->sink);
+    free(stream->saved_values);
+    free(stream);
+}
@@ -0,0 +1,275 @@
+#include "npy_io.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#define NPY_HEADER_ALIGN 64
+#define NPZ_MAX_ENTRIES 64
+
+int parse_output_format(const char* name, OutputFormat* format) {
+    if (strcmp(name, "csv") == 0) {
+        *format = OUTPUT_CSV;
+    } else if (strcmp(name, "npy") == 0 || strcmp(name, "npz") == 0) {
+        *format = OUTPUT_NPY;
+    } else {
+        fprintf(stderr, "Error: Unknown output format '%s' (expected csv or npy)\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+const char* output_format_name(OutputFormat format) {
+    return format == OUTPUT_NPY ? "npy" : "csv";
+}
+
+// ============ CRC-32 (slicing-by-8) ============
+
+static uint32_t crc_table[8][256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static void init_crc_table(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        crc_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            uint32_t prev = crc_table[t - 1][i];
+            crc_table[t][i] = (prev >> 8) ^ crc_table[0][prev & 0xFF];
+        }
+    }
+}
+
+uint32_t crc32_update(uint32_t crc, const void* data, size_t length) {
+    pthread_once(&crc_once, init_crc_table);
+    
+    const unsigned char* p = (const unsigned char*)data;
+    crc = ~crc;
+    
+    while (length >= 8) {
+        uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 |
+                             (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+        uint32_t hi = (uint32_t)p[4] | (uint32_t)p[5] << 8 |
+                      (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+        crc = crc_table[7][lo & 0xFF] ^ crc_table[6][(lo >> 8) & 0xFF] ^
+              crc_table[5][(lo >> 16) & 0xFF] ^ crc_table[4][lo >> 24] ^
+              crc_table[3][hi & 0xFF] ^ crc_table[2][(hi >> 8) & 0xFF] ^
+              crc_table[1][(hi >> 16) & 0xFF] ^ crc_table[0][hi >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = crc_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    
+    return ~crc;
+}
+
+// ============ EN-TETE NPY ============
+
+// Taille d'un élément déduite du descripteur ("<f8" -> 8, "<c16" -> 16, "|S3" -> 3)
+static size_t dtype_size(const char* dtype) {
+    const char* digits = dtype;
+    while (*digits && (*digits < '0' || *digits > '9')) digits++;
+    return (size_t)atol(digits);
+}
+
+static size_t array_bytes(const char* dtype, int ndim, const size_t* shape) {
+    size_t count = 1;
+    for (int d = 0; d < ndim; d++) count *= shape[d];
+    return count * dtype_size(dtype);
+}
+
+size_t npy_build_header(char* header, size_t capacity, const char* dtype,
+                        int fortran_order, int ndim, const size_t* shape) {
+    char dict[256];
+    int len = snprintf(dict, sizeof(dict), "{'descr': '%s', 'fortran_order': %s, 'shape': (",
+                       dtype, fortran_order ? "True" : "False");
+    for (int d = 0; d < ndim; d++) {
+        // Tuple Python: (n,) en 1-D, (n, m) sinon
+        len += snprintf(dict + len, sizeof(dict) - len, "%zu%s", shape[d],
+                        (ndim == 1) ? "," : (d + 1 < ndim) ? ", " : "");
+    }
+    len += snprintf(dict + len, sizeof(dict) - len, "), }");
+    
+    size_t total = 10 + (size_t)len + 1;
+    total = (total + NPY_HEADER_ALIGN - 1) / NPY_HEADER_ALIGN * NPY_HEADER_ALIGN;
+    if (total > capacity) return 0;
+    
+    size_t dict_len = total - 10;
+    memcpy(header, "\x93NUMPY", 6);
+    header[6] = 1;    // version 1.0
+    header[7] = 0;
+    header[8] = (char)(dict_len & 0xFF);
+    header[9] = (char)(dict_len >> 8);
+    memcpy(header + 10, dict, len);
+    memset(header + 10 + len, ' ', dict_len - len - 1);
+    header[total - 1] = '\n';
+    
+    return total;
+}
+
+int npy_save(const char* filename, const char* dtype,
+             int ndim, const size_t* shape, const void* data) {
+    char header[512];
+    size_t header_len = npy_build_header(header, sizeof(header), dtype, 0, ndim, shape);
+    if (header_len == 0) return -1;
+    
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        return -1;
+    }
+    
+    size_t bytes = array_bytes(dtype, ndim, shape);
+    int ok = fwrite(header, 1, header_len, file) == header_len &&
+             fwrite(data, 1, bytes, file) == bytes;
+    
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Error: Failed writing %s\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// ============ ARCHIVE NPZ (ZIP "stored") ============
+
+typedef struct {
+    char name[64];
+    uint32_t crc;
+    uint32_t size;
+    uint32_t offset;
+} NpzEntry;
+
+struct NpzWriter {
+    FILE* file;
+    char* filename;
+    NpzEntry entries[NPZ_MAX_ENTRIES];
+    int n_entries;
+    int failed;
+};
+
+static void put_u16(unsigned char* p, uint16_t v) {
+    p[0] = (unsigned char)(v & 0xFF);
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void put_u32(unsigned char* p, uint32_t v) {
+    put_u16(p, (uint16_t)(v & 0xFFFF));
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+NpzWriter* npz_open(const char* filename) {
+    NpzWriter* npz = (NpzWriter*)calloc(1, sizeof(NpzWriter));
+    if (!npz) return NULL;
+    
+    npz->file = fopen(filename, "wb");
+    npz->filename = (char*)malloc(strlen(filename) + 1);
+    if (!npz->file || !npz->filename) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        if (npz->file) fclose(npz->file);
+        free(npz->filename);
+        free(npz);
+        return NULL;
+    }
+    strcpy(npz->filename, filename);
+    
+    return npz;
+}
+
+int npz_add_array(NpzWriter* npz, const char* name, const char* dtype,
+                  int ndim, const size_t* shape, const void* data) {
+    if (!npz || npz->failed) return -1;
+    
+    char header[512];
+    size_t header_len = npy_build_header(header, sizeof(header), dtype, 0, ndim, shape);
+    size_t bytes = array_bytes(dtype, ndim, shape);
+    long offset = ftell(npz->file);
+    
+    // Archive sans zip64: chaque membre et l'archive restent sous 4 Go
+    if (header_len == 0 || npz->n_entries == NPZ_MAX_ENTRIES ||
+        strlen(name) + 5 > sizeof(npz->entries[0].name) ||
+        header_len + bytes > 0xFFFFFFFFu || offset < 0 ||
+        (uint64_t)offset + header_len + bytes > 0xFFFFFFFFu) {
+        fprintf(stderr, "Error: Cannot add array '%s' to %s\n", name, npz->filename);
+        npz->failed = 1;
+        return -1;
+    }
+    
+    NpzEntry* entry = &npz->entries[npz->n_entries++];
+    snprintf(entry->name, sizeof(entry->name), "%s.npy", name);
+    entry->crc = crc32_update(crc32_update(0, header, header_len), data, bytes);
+    entry->size = (uint32_t)(header_len + bytes);
+    entry->offset = (uint32_t)offset;
+    
+    size_t name_len = strlen(entry->name);
+    unsigned char local[30];
+    memset(local, 0, sizeof(local));
+    put_u32(local, 0x04034b50);
+    put_u16(local + 4, 20);            // version nécessaire
+    put_u32(local + 14, entry->crc);
+    put_u32(local + 18, entry->size);  // taille compressée (stockage)
+    put_u32(local + 22, entry->size);
+    put_u16(local + 26, (uint16_t)name_len);
+    
+    if (fwrite(local, 1, sizeof(local), npz->file) != sizeof(local) ||
+        fwrite(entry->name, 1, name_len, npz->file) != name_len ||
+        fwrite(header, 1, header_len, npz->file) != header_len ||
+        fwrite(data, 1, bytes, npz->file) != bytes) {
+        fprintf(stderr, "Error: Failed writing %s\n", npz->filename);
+        npz->failed = 1;
+        return -1;
+    }
+    
+    return 0;
+}
+
+int npz_close(NpzWriter* npz) {
+    if (!npz) return -1;
+    
+    int status = npz->failed ? -1 : 0;
+    long dir_offset = ftell(npz->file);
+    uint32_t dir_size = 0;
+    
+    for (int i = 0; i < npz->n_entries && status == 0; i++) {
+        NpzEntry* entry = &npz->entries[i];
+        size_t name_len = strlen(entry->name);
+        unsigned char central[46];
+        memset(central, 0, sizeof(central));
+        put_u32(central, 0x02014b50);
+        put_u16(central + 4, 20);
+        put_u16(central + 6, 20);
+        put_u32(central + 16, entry->crc);
+        put_u32(central + 20, entry->size);
+        put_u32(central + 24, entry->size);
+        put_u16(central + 28, (uint16_t)name_len);
+        put_u32(central + 42, entry->offset);
+        
+        if (fwrite(central, 1, sizeof(central), npz->file) != sizeof(central) ||
+            fwrite(entry->name, 1, name_len, npz->file) != name_len) {
+            status = -1;
+        }
+        dir_size += (uint32_t)(sizeof(central) + name_len);
+    }
+    
+    unsigned char end[22];
+    memset(end, 0, sizeof(end));
+    put_u32(end, 0x06054b50);
+    put_u16(end + 8, (uint16_t)npz->n_entries);
+    put_u16(end + 10, (uint16_t)npz->n_entries);
+    put_u32(end + 12, dir_size);
+    put_u32(end + 16, (uint32_t)dir_offset);
+    if (status == 0 && fwrite(end, 1, sizeof(end), npz->file) != sizeof(end)) status = -1;
+    
+    if (fclose(npz->file) != 0) status = -1;
+    if (status != 0) fprintf(stderr, "Error: Failed writing %s\n", npz->filename);
+    
+    free(npz->filename);
+    free(npz);
+    return status;
+}
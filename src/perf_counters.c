@@ -0,0 +1,186 @@
+#ifdef __linux__
+#define _GNU_SOURCE             // syscall()
+#endif
+#include "perf_counters.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#endif
+
+// Deux groupes ordonnancés séparément: cycles/instructions/LLC, puis flottants vectoriels
+#define PERF_N_GROUPS 2
+#define PERF_GROUP_SIZE 4
+
+static int counters_enabled = 0;
+static int counter_available[PERF_N_COUNTERS];
+
+static const char* counter_names[PERF_N_COUNTERS] = {
+    "cycles", "instructions", "llc_references", "llc_misses",
+    "fp_scalar", "fp_128", "fp_256", "fp_512"
+};
+
+// Descripteurs propres à chaque thread, ouverts au premier appel
+static __thread int fds[PERF_N_COUNTERS];
+static __thread int thread_state = 0;       // 0: non ouvert, 1: ouvert, -1: échec
+
+#ifdef __linux__
+// FP_ARITH_INST_RETIRED (événement 0xC7) sur Intel depuis Haswell: masques double précision
+static const uint64_t fp_umasks[4] = {0x01, 0x04, 0x10, 0x40};
+
+static int intel_cpu(void) {
+    FILE* file = fopen("/proc/cpuinfo", "r");
+    if (!file) return 0;
+    char line[256];
+    int intel = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "vendor_id", 9) == 0) {
+            intel = strstr(line, "GenuineIntel") != NULL;
+            break;
+        }
+    }
+    fclose(file);
+    return intel;
+}
+
+static int open_counter(PerfCounter counter, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    
+    switch (counter) {
+        case PERF_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_LLC_REFERENCES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_REFERENCES;
+            break;
+        case PERF_LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        default:
+            attr.type = PERF_TYPE_RAW;
+            attr.config = (fp_umasks[counter - PERF_FP_SCALAR] << 8) | 0xC7;
+            break;
+    }
+    
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled = group_fd < 0;   // Le chef de groupe démarre l'ensemble
+    attr.inherit = 1;               // Threads OpenMP créés ensuite par ce thread
+    attr.exclude_kernel = 1;        // Autorisé avec perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+// Ouverture des groupes du thread appelant; les compteurs refusés restent à -1
+static int open_thread_counters(void) {
+    int opened = 0;
+    for (int c = 0; c < PERF_N_COUNTERS; c++) fds[c] = -1;
+    
+    for (int g = 0; g < PERF_N_GROUPS; g++) {
+        int first = g * PERF_GROUP_SIZE;
+        if (!counter_available[first]) continue;
+        int leader = open_counter((PerfCounter)first, -1);
+        if (leader < 0) continue;
+        fds[first] = leader;
+        opened++;
+        for (int c = first + 1; c < first + PERF_GROUP_SIZE; c++) {
+            if (!counter_available[c]) continue;
+            fds[c] = open_counter((PerfCounter)c, leader);
+            if (fds[c] >= 0) opened++;
+        }
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    return opened;
+}
+#endif
+
+int perf_counters_enable(void) {
+#ifdef __linux__
+    // Disponibilité testée une fois, dans le thread principal
+    for (int c = 0; c < PERF_N_COUNTERS; c++) counter_available[c] = 1;
+    if (!intel_cpu()) {
+        for (int c = PERF_FP_SCALAR; c <= PERF_FP_512; c++) counter_available[c] = 0;
+    }
+    
+    if (open_thread_counters() == 0) {
+        // ENOENT: pas de PMU (machine virtuelle); EACCES: voir perf_event_paranoid
+        fprintf(stderr, "Warning: Hardware counters unavailable (perf_event_open: %s)\n",
+                strerror(errno));
+        thread_state = -1;
+        return 0;
+    }
+    
+    int n_available = 0;
+    for (int c = 0; c < PERF_N_COUNTERS; c++) {
+        counter_available[c] = fds[c] >= 0;
+        n_available += counter_available[c];
+    }
+    thread_state = 1;
+    counters_enabled = 1;
+    return n_available;
+#else
+    fprintf(stderr, "Warning: Hardware counters require Linux perf_event_open\n");
+    return 0;
+#endif
+}
+
+int perf_counters_enabled(void) {
+    return counters_enabled;
+}
+
+int perf_counter_available(PerfCounter counter) {
+    return counters_enabled && counter_available[counter];
+}
+
+const char* perf_counter_name(PerfCounter counter) {
+    return counter_names[counter];
+}
+
+int perf_counters_read(double values[PERF_N_COUNTERS]) {
+    for (int c = 0; c < PERF_N_COUNTERS; c++) values[c] = 0.0;
+    if (!counters_enabled) return -1;
+
+#ifdef __linux__
+    if (thread_state == 0) thread_state = open_thread_counters() > 0 ? 1 : -1;
+    if (thread_state < 0) return -1;
+    
+    for (int g = 0; g < PERF_N_GROUPS; g++) {
+        int first = g * PERF_GROUP_SIZE;
+        if (fds[first] < 0) continue;
+    
+        // Format groupe: nombre, temps activé, temps effectif, valeurs dans l'ordre d'ouverture
+        uint64_t buffer[3 + PERF_GROUP_SIZE];
+        if (read(fds[first], buffer, sizeof(buffer)) < (ssize_t)(3 * sizeof(uint64_t))) continue;
+        double scale = buffer[2] > 0 ? (double)buffer[1] / (double)buffer[2] : 0.0;
+    
+        uint64_t slot = 0;
+        for (int c = first; c < first + PERF_GROUP_SIZE && slot < buffer[0]; c++) {
+            if (fds[c] < 0) continue;
+            values[c] = (double)buffer[3 + slot++] * scale;
+        }
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+double perf_counters_flops(const double values[PERF_N_COUNTERS]) {
+    return values[PERF_FP_SCALAR] + 2.0 * values[PERF_FP_128] +
+           4.0 * values[PERF_FP_256] + 8.0 * values[PERF_FP_512];
+}
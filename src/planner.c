@@ -0,0 +1,281 @@
+#include "planner.h"
+#include "lobpcg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// LAPACK 32 bits: indices de tableaux n x n limités à 2^31 - 1
+#define PLANNER_MAX_LAPACK_ELEMENTS 2147483647.0
+
+PlanProblem plan_problem_from_grid(int N, int k) {
+    PlanProblem problem;
+    memset(&problem, 0, sizeof(problem));
+    problem.n = N * N;
+    problem.k = k;
+    problem.bandwidth = N;                          // Voisins (i ± 1, j) à distance N
+    problem.nnz_A = 5.0 * N * N - 4.0 * N;
+    problem.nnz_B = (double)N * N;
+    problem.B_diagonal = 1;
+    problem.grid_size = N;
+    return problem;
+}
+
+PlanProblem plan_problem_from_matrices(const SparseMatrixCSR* A, const SparseMatrixCSR* B, int k) {
+    PlanProblem problem;
+    memset(&problem, 0, sizeof(problem));
+    problem.n = (int)A->n_rows;
+    problem.k = k;
+    problem.bandwidth = csr_bandwidth(A);
+    problem.nnz_A = (double)A->nnz;
+    problem.nnz_B = (double)B->nnz;
+    problem.B_diagonal = csr_is_diagonal(B);
+    return problem;
+}
+
+// Valeur en ko d'une ligne "Cle: valeur kB" de /proc/meminfo
+static double meminfo_kb(const char* key) {
+    FILE* file = fopen("/proc/meminfo", "r");
+    if (!file) return 0.0;
+    char line[256];
+    double value = 0.0;
+    size_t length = strlen(key);
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, key, length) == 0 && line[length] == ':') {
+            value = atof(line + length + 1);
+            break;
+        }
+    }
+    fclose(file);
+    return value;
+}
+
+// Limite du groupe de contrôle (cgroup v2) moins l'usage courant, 0 si aucune
+static double cgroup_headroom(void) {
+    double limit = 0.0, usage = 0.0;
+    char text[64];
+    FILE* file = fopen("/sys/fs/cgroup/memory.max", "r");
+    if (!file) return 0.0;
+    if (fgets(text, sizeof(text), file) && strncmp(text, "max", 3) != 0) limit = atof(text);
+    fclose(file);
+    if (limit <= 0.0) return 0.0;
+    
+    file = fopen("/sys/fs/cgroup/memory.current", "r");
+    if (file) {
+        if (fgets(text, sizeof(text), file)) usage = atof(text);
+        fclose(file);
+    }
+    return limit > usage ? limit - usage : 1.0;
+}
+
+size_t planner_memory_budget(void) {
+    double available = 1024.0 * meminfo_kb("MemAvailable");
+#ifdef _SC_PHYS_PAGES
+    if (available <= 0.0) available = (double)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+#endif
+    double headroom = cgroup_headroom();
+    if (headroom > 0.0 && (available <= 0.0 || headroom < available)) available = headroom;
+    if (available <= 0.0) available = 4.0 * 1024 * 1024 * 1024;   // Inconnue: 4 Go
+    return (size_t)(PLANNER_BUDGET_FRACTION * available);
+}
+
+static int planner_cores(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+static double csr_memory(double nnz, int n) {
+    return nnz * (sizeof(double) + sizeof(MKL_INT)) + (n + 1.0) * sizeof(MKL_INT);
+}
+
+// Estimations mémoire (octets) et durée (secondes) de chaque stratégie
+static void estimate(const PlanProblem* pb, SolverType solver, int cores, PlanEstimate* est) {
+    double n = pb->n, k = pb->k, kd = pb->bandwidth;
+    // Un petit problème n'occupe pas plus de cœurs que n / PLANNER_DOF_PER_CORE
+    double useful = floor(n / PLANNER_DOF_PER_CORE);
+    if (cores > useful) cores = useful > 1.0 ? (int)useful : 1;
+    double d = sizeof(double);
+    double blas3 = cores * PLANNER_BLAS3_GFLOPS * 1e9;
+    double qr = cores * PLANNER_QR_GFLOPS * 1e9;
+    double rotations = PLANNER_ROTATION_GFLOPS * 1e9;
+    double bandwidth = PLANNER_MEMORY_GBS * 1e9;
+    
+    // Toujours présents: maillage, résultats; matrices assemblées sauf sans matrice
+    double common = (pb->grid_size > 0 ? 5.0 * n * d : 0.0) + n * k * d + 2.0 * k * d;
+    double matrices = csr_memory(pb->nnz_A, pb->n) + csr_memory(pb->nnz_B, pb->n);
+    double dense_elements = n * n;
+    
+    int m = lobpcg_block_size(pb->k);
+    double iterations = PLANNER_LOBPCG_ITERATIONS * sqrt(n);
+    // Par itération: Gram, combinaisons et orthogonalisation sur [X W P] (3m colonnes)
+    double rayleigh_ritz = 8.0 * n * (3.0 * m) * (3.0 * m) / blas3;
+    
+    memset(est, 0, sizeof(PlanEstimate));
+    est->applicable = 1;
+    
+    switch (solver) {
+        case SOLVER_DENSE:
+            est->memory_bytes = common + matrices + 2.0 * dense_elements * d + 67.0 * n * d;
+            // Cholesky, réduction, tridiagonalisation 8n³/3; QR et retour aux vecteurs ≈ 8n³
+            est->seconds = (8.0 / 3.0) * n * n * n / blas3 + 8.0 * n * n * n / qr;
+            if (dense_elements > PLANNER_MAX_LAPACK_ELEMENTS) {
+                est->applicable = 0;
+                est->reason = "n^2 exceeds 32-bit LAPACK indexing";
+            }
+            break;
+    
+        case SOLVER_DENSE_PARTIAL:
+            est->memory_bytes = common + matrices + 2.0 * dense_elements * d + 68.0 * n * d +
+                                10.0 * n * sizeof(MKL_INT);
+            // Bisection et itération inverse sur la tridiagonale: O(nk), négligeables
+            est->seconds = (8.0 / 3.0) * n * n * n / blas3 + 4.0 * n * n * k / blas3;
+            if (dense_elements > PLANNER_MAX_LAPACK_ELEMENTS) {
+                est->applicable = 0;
+                est->reason = "n^2 exceeds 32-bit LAPACK indexing";
+            }
+            break;
+    
+        case SOLVER_BANDED:
+            // Bande symétrique (kd+1)n, LU bande (3kd+1)n; réduction et itérations non parallèles
+            est->memory_bytes = common + matrices + (4.0 * kd + 2.0) * n * d + 10.0 * n * d +
+                                12.0 * n * sizeof(MKL_INT);
+            est->seconds = 6.0 * n * n * kd / rotations +
+                           (k * 2.0 * n * kd * (2.0 * kd + 1.0) + k * 3.0 * 6.0 * n * kd) / qr +
+                           4.0 * n * k * k / blas3;
+            if (!pb->B_diagonal) {
+                est->applicable = 0;
+                est->reason = "mass matrix is not diagonal";
+            } else if ((3.0 * kd + 1.0) * n > PLANNER_MAX_LAPACK_ELEMENTS) {
+                est->applicable = 0;
+                est->reason = "band exceeds 32-bit LAPACK indexing";
+            }
+            break;
+    
+        case SOLVER_LOBPCG:
+        case SOLVER_MATRIX_FREE: {
+            // 5 blocs (X, W, P et deux temporaires) avec leurs images par A et B, Q et BQ
+            double blocks = 15.0 * n * m * d + 2.0 * n * k * d + n * d + 4.0 * 9.0 * m * m * d;
+            double spmv_bytes;
+            if (solver == SOLVER_LOBPCG) {
+                est->memory_bytes = common + matrices + blocks;
+                spmv_bytes = matrices + 4.0 * n * m * d;
+            } else {
+                est->memory_bytes = common + blocks;
+                spmv_bytes = 3.0 * n * d + 4.0 * n * m * d;
+            }
+            est->seconds = iterations * (spmv_bytes / bandwidth + rayleigh_ritz);
+    
+            if (3 * m > pb->n) {
+                est->applicable = 0;
+                est->reason = "too few DOF for the block size";
+            } else if (solver == SOLVER_MATRIX_FREE && pb->grid_size <= 0) {
+                est->applicable = 0;
+                est->reason = "needs a generated grid";
+            } else if (solver == SOLVER_MATRIX_FREE && pb->needs_matrices) {
+                est->applicable = 0;
+                est->reason = "assembled matrices requested";
+            }
+            break;
+        }
+    
+        default:
+            est->applicable = 0;
+            est->reason = "unknown strategy";
+            break;
+    }
+}
+
+double plan_estimate_seconds(const PlanProblem* problem, SolverType solver, int cores) {
+    PlanEstimate est;
+    estimate(problem, solver, cores > 0 ? cores : 1, &est);
+    return est.seconds;
+}
+
+int plan_solve(const PlanProblem* problem, SolverType requested, size_t budget, SolvePlan* plan) {
+    memset(plan, 0, sizeof(SolvePlan));
+    plan->requested = requested;
+    plan->chosen = SOLVER_AUTO;
+    plan->n = problem->n;
+    plan->k = problem->k;
+    plan->cores = planner_cores();
+    plan->budget = budget > 0 ? budget : planner_memory_budget();
+    
+    for (int s = 0; s < SOLVER_N_TYPES; s++) {
+        estimate(problem, (SolverType)s, plan->cores, &plan->estimates[s]);
+    }
+    
+    if (requested != SOLVER_AUTO) {
+        const PlanEstimate* est = &plan->estimates[requested];
+        if (est->applicable && est->memory_bytes <= (double)plan->budget) plan->chosen = requested;
+        return plan->chosen == requested ? 0 : -1;
+    }
+    
+    // La plus rapide parmi celles qui tiennent dans le budget
+    for (int s = 0; s < SOLVER_N_TYPES; s++) {
+        const PlanEstimate* est = &plan->estimates[s];
+        if (!est->applicable || est->memory_bytes > (double)plan->budget) continue;
+        if (plan->chosen == SOLVER_AUTO || est->seconds < plan->estimates[plan->chosen].seconds) {
+            plan->chosen = (SolverType)s;
+        }
+    }
+    return plan->chosen != SOLVER_AUTO ? 0 : -1;
+}
+
+static void format_bytes(double bytes, char* text, size_t size) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int u = 0;
+    while (bytes >= 1024.0 && u < 4) {
+        bytes /= 1024.0;
+        u++;
+    }
+    snprintf(text, size, "%.1f %s", bytes, units[u]);
+}
+
+static void format_seconds(double seconds, char* text, size_t size) {
+    if (seconds < 1.0) snprintf(text, size, "%.3f s", seconds);
+    else if (seconds < 3600.0) snprintf(text, size, "%.1f s", seconds);
+    else if (seconds < 86400.0) snprintf(text, size, "%.1f h", seconds / 3600.0);
+    else snprintf(text, size, "%.1f d", seconds / 86400.0);
+}
+
+void print_solve_plan(const SolvePlan* plan) {
+    char budget[32];
+    format_bytes((double)plan->budget, budget, sizeof(budget));
+    printf("\n=== SOLVE PLAN (%d DOF, %d modes, %d cores, memory budget %s) ===\n",
+           plan->n, plan->k, plan->cores, budget);
+    printf("  %-14s %12s %12s\n", "Strategy", "Memory", "Time");
+    
+    for (int s = 0; s < SOLVER_N_TYPES; s++) {
+        const PlanEstimate* est = &plan->estimates[s];
+        char memory[32], seconds[32];
+        format_bytes(est->memory_bytes, memory, sizeof(memory));
+        format_seconds(est->seconds, seconds, sizeof(seconds));
+    
+        const char* status = "";
+        if (s == (int)plan->chosen) status = plan->requested == SOLVER_AUTO ? "<- chosen" : "<- requested";
+        else if (!est->applicable) status = est->reason;
+        else if (est->memory_bytes > (double)plan->budget) status = "over budget";
+        printf("  %-14s %12s %12s  %s\n", solver_type_name((SolverType)s), memory,
+               est->applicable ? seconds : "-", status);
+    }
+    
+    if (plan->chosen != SOLVER_AUTO) {
+        printf("Plan: %s solver\n", solver_type_name(plan->chosen));
+    } else if (plan->requested != SOLVER_AUTO) {
+        const PlanEstimate* est = &plan->estimates[plan->requested];
+        fprintf(stderr, "Error: Solver %s is not usable for this problem (%s)\n",
+                solver_type_name(plan->requested),
+                est->applicable ? "estimated memory above the budget, see --memory-budget"
+                                : est->reason);
+    } else {
+        fprintf(stderr, "Error: No solver strategy fits in the memory budget of %s "
+                "(fewer modes, a smaller grid or --memory-budget)\n", budget);
+    }
+}
@@ -0,0 +1,362 @@
+#include "image.h"
+#include "npy_io.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Deflate (RFC 1951) à codes de Huffman fixes et LZ77 par chaînes de hachage:
+// suffisant pour les cartes de couleurs (grands aplats après filtrage PNG)
+#define LZ_WINDOW 32768
+#define LZ_HASH_BITS 15
+#define LZ_MAX_CHAIN 16
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_MATCH 258
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint64_t bits;
+    int n_bits;
+} BitWriter;
+
+// Codes fixes déjà inversés (émis bit de poids faible en premier)
+typedef struct {
+    uint16_t symbol_code[288];
+    uint8_t symbol_length[288];
+    uint8_t distance_code[30];
+    uint8_t length_symbol[LZ_MAX_MATCH + 1];   // Longueur -> indice dans length_base
+    uint8_t distance_symbol[512];              // Voir distance_index()
+} HuffmanTables;
+
+static const uint16_t length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t distance_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t distance_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Bits écrits du poids faible au poids fort (ordre deflate)
+static void put_bits(BitWriter* bw, uint32_t value, int count) {
+    bw->bits |= (uint64_t)value << bw->n_bits;
+    bw->n_bits += count;
+    while (bw->n_bits >= 8) {
+        bw->data[bw->size++] = (uint8_t)bw->bits;
+        bw->bits >>= 8;
+        bw->n_bits -= 8;
+    }
+}
+
+// Les codes de Huffman sont définis bit de poids fort en premier
+static uint32_t reverse_bits(uint32_t code, int length) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    return reversed;
+}
+
+// Distances 1..256 indexées directement, au-delà par tranches de 128 (comme zlib)
+static int distance_index(int distance) {
+    return distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7);
+}
+
+static void init_huffman_tables(HuffmanTables* t) {
+    for (int symbol = 0; symbol < 288; symbol++) {
+        uint32_t code;
+        int length;
+        if (symbol < 144) { code = 0x30 + symbol; length = 8; }
+        else if (symbol < 256) { code = 0x190 + symbol - 144; length = 9; }
+        else if (symbol < 280) { code = symbol - 256; length = 7; }
+        else { code = 0xC0 + symbol - 280; length = 8; }
+        t->symbol_code[symbol] = (uint16_t)reverse_bits(code, length);
+        t->symbol_length[symbol] = (uint8_t)length;
+    }
+    for (int d = 0; d < 30; d++) {
+        t->distance_code[d] = (uint8_t)reverse_bits(d, 5);
+    }
+    for (int length = LZ_MIN_MATCH, l = 0; length <= LZ_MAX_MATCH; length++) {
+        while (l < 28 && length_base[l + 1] <= length) l++;
+        t->length_symbol[length] = (uint8_t)l;
+    }
+    for (int distance = 1, d = 0; distance <= LZ_WINDOW; distance++) {
+        while (d < 29 && distance_base[d + 1] <= distance) d++;
+        t->distance_symbol[distance_index(distance)] = (uint8_t)d;
+    }
+}
+
+static void put_symbol(BitWriter* bw, const HuffmanTables* t, int symbol) {
+    put_bits(bw, t->symbol_code[symbol], t->symbol_length[symbol]);
+}
+
+static void put_match(BitWriter* bw, const HuffmanTables* t, int length, int distance) {
+    int l = t->length_symbol[length];
+    put_symbol(bw, t, 257 + l);
+    if (length_extra[l]) put_bits(bw, length - length_base[l], length_extra[l]);
+    
+    int d = t->distance_symbol[distance_index(distance)];
+    put_bits(bw, t->distance_code[d], 5);
+    if (distance_extra[d]) put_bits(bw, distance - distance_base[d], distance_extra[d]);
+}
+
+// Longueur du préfixe commun, 8 octets à la fois
+static size_t match_length(const uint8_t* a, const uint8_t* b, size_t max_length) {
+    size_t l = 0;
+    while (l + 8 <= max_length) {
+        uint64_t x, y;
+        memcpy(&x, a + l, 8);
+        memcpy(&y, b + l, 8);
+        if (x != y) return l + (size_t)(__builtin_ctzll(x ^ y) >> 3);
+        l += 8;
+    }
+    while (l < max_length && a[l] == b[l]) l++;
+    return l;
+}
+
+static uint32_t hash3(const uint8_t* p) {
+    uint32_t v = (uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2];
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Flux deflate d'un seul bloc final; renvoie NULL en cas d'échec mémoire
+static uint8_t* deflate_fixed(const uint8_t* input, size_t length, size_t* out_size) {
+    BitWriter bw = {0};
+    bw.capacity = length + length / 8 + 64;    // 9 bits par littéral au pire
+    bw.data = (uint8_t*)malloc(bw.capacity);
+    int32_t* head = (int32_t*)malloc(((size_t)1 << LZ_HASH_BITS) * sizeof(int32_t));
+    int32_t* prev = (int32_t*)malloc(LZ_WINDOW * sizeof(int32_t));
+    if (!bw.data || !head || !prev) {
+        free(bw.data);
+        free(head);
+        free(prev);
+        return NULL;
+    }
+    memset(head, 0xFF, ((size_t)1 << LZ_HASH_BITS) * sizeof(int32_t));
+    
+    HuffmanTables tables;
+    init_huffman_tables(&tables);
+    
+    put_bits(&bw, 1, 1);    // BFINAL
+    put_bits(&bw, 1, 2);    // BTYPE = 01 (Huffman fixe)
+    
+    size_t pos = 0;
+    while (pos < length) {
+        int best_length = 0, best_distance = 0;
+        
+        if (pos + LZ_MIN_MATCH <= length) {
+            uint32_t h = hash3(input + pos);
+            int32_t candidate = head[h];
+            size_t max_length = length - pos < LZ_MAX_MATCH ? length - pos : LZ_MAX_MATCH;
+            
+            for (int chain = 0; chain < LZ_MAX_CHAIN && candidate >= 0 &&
+                 pos - (size_t)candidate <= LZ_WINDOW - 1; chain++) {
+                size_t l = match_length(input + candidate, input + pos, max_length);
+                if ((int)l > best_length) {
+                    best_length = (int)l;
+                    best_distance = (int)(pos - candidate);
+                    if (l == max_length) break;
+                }
+                int32_t next = prev[candidate & (LZ_WINDOW - 1)];
+                if (next >= candidate) break;
+                candidate = next;
+            }
+        }
+        
+        int advance = best_length >= LZ_MIN_MATCH ? best_length : 1;
+        if (best_length >= LZ_MIN_MATCH) put_match(&bw, &tables, best_length, best_distance);
+        else put_symbol(&bw, &tables, input[pos]);
+        
+        // Insertion des positions couvertes dans les chaînes
+        for (int i = 0; i < advance; i++, pos++) {
+            if (pos + LZ_MIN_MATCH <= length) {
+                uint32_t h = hash3(input + pos);
+                prev[pos & (LZ_WINDOW - 1)] = head[h];
+                head[h] = (int32_t)pos;
+            }
+        }
+    }
+    
+    put_symbol(&bw, &tables, 256);   // Fin de bloc
+    if (bw.n_bits > 0) put_bits(&bw, 0, 8 - bw.n_bits);
+    
+    free(head);
+    free(prev);
+    *out_size = bw.size;
+    return bw.data;
+}
+
+static uint32_t adler32(const uint8_t* data, size_t length) {
+    uint32_t a = 1, b = 0;
+    while (length > 0) {
+        size_t chunk = length < 5552 ? length : 5552;
+        length -= chunk;
+        while (chunk--) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+// ============ PNG ============
+
+static void store_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static int write_chunk(FILE* file, const char* type, const uint8_t* data, size_t length) {
+    uint8_t word[4];
+    store_be32(word, (uint32_t)length);
+    uint32_t crc = crc32_update(0, type, 4);
+    crc = crc32_update(crc, data, length);
+    
+    int ok = fwrite(word, 1, 4, file) == 4 && fwrite(type, 1, 4, file) == 4 &&
+             (length == 0 || fwrite(data, 1, length, file) == length);
+    store_be32(word, crc);
+    return ok && fwrite(word, 1, 4, file) == 4 ? 0 : -1;
+}
+
+static inline int paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+static int predict(int filter, int a, int b, int c) {
+    switch (filter) {
+        case 1: return a;
+        case 2: return b;
+        case 3: return (a + b) / 2;
+        case 4: return paeth(a, b, c);
+        default: return 0;
+    }
+}
+
+static inline int filter_cost(uint8_t v) {
+    return v < 128 ? v : 256 - v;
+}
+
+// Filtre de ligne choisi par la somme minimale des valeurs absolues (heuristique libpng)
+static void filter_rows(const Image* image, uint8_t* out) {
+    size_t stride = (size_t)image->width * 3;
+    
+    #pragma omp parallel for schedule(static) if (image->height > 256)
+    for (int y = 0; y < image->height; y++) {
+        const uint8_t* row = image->pixels + y * stride;
+        uint8_t* dst = out + y * (stride + 1);
+        
+        // Première ligne: seuls None et Sub ont un sens (Up = None)
+        if (y == 0) {
+            dst[0] = 1;
+            memcpy(dst + 1, row, 3);
+            for (size_t i = 3; i < stride; i++) dst[1 + i] = (uint8_t)(row[i] - row[i - 3]);
+            continue;
+        }
+        
+        // Coûts des cinq filtres en une passe (voisins a = gauche, b = haut, c = haut-gauche)
+        const uint8_t* up = row - stride;
+        long cost[5] = {0, 0, 0, 0, 0};
+        for (size_t i = 0; i < stride; i++) {
+            int a = i >= 3 ? row[i - 3] : 0;
+            int b = up[i];
+            int c = i >= 3 ? up[i - 3] : 0;
+            int x = row[i];
+            cost[0] += filter_cost((uint8_t)x);
+            cost[1] += filter_cost((uint8_t)(x - a));
+            cost[2] += filter_cost((uint8_t)(x - b));
+            cost[3] += filter_cost((uint8_t)(x - ((a + b) >> 1)));
+            cost[4] += filter_cost((uint8_t)(x - paeth(a, b, c)));
+        }
+        
+        int best = 0;
+        for (int filter = 1; filter < 5; filter++) {
+            if (cost[filter] < cost[best]) best = filter;
+        }
+        
+        dst[0] = (uint8_t)best;
+        for (size_t i = 0; i < stride; i++) {
+            int a = i >= 3 ? row[i - 3] : 0;
+            int c = i >= 3 ? up[i - 3] : 0;
+            dst[1 + i] = (uint8_t)(row[i] - predict(best, a, up[i], c));
+        }
+    }
+}
+
+int image_write_png(const Image* image, const char* filename) {
+    size_t stride = (size_t)image->width * 3;
+    size_t raw_size = (size_t)image->height * (stride + 1);
+    uint8_t* raw = (uint8_t*)malloc(raw_size);
+    if (!raw) {
+        fprintf(stderr, "Error: Failed to allocate PNG buffer\n");
+        return -1;
+    }
+    filter_rows(image, raw);
+    
+    // Flux zlib: en-tête, deflate, Adler-32
+    size_t deflate_size = 0;
+    uint8_t* compressed = deflate_fixed(raw, raw_size, &deflate_size);
+    if (!compressed) {
+        fprintf(stderr, "Error: Failed to compress PNG data\n");
+        free(raw);
+        return -1;
+    }
+    uint32_t checksum = adler32(raw, raw_size);
+    free(raw);
+    
+    uint8_t* idat = (uint8_t*)malloc(deflate_size + 6);
+    if (!idat) {
+        free(compressed);
+        return -1;
+    }
+    idat[0] = 0x78;     // CM = 8, fenêtre 32 Ko
+    idat[1] = 0x01;     // FCHECK, compression rapide
+    memcpy(idat + 2, compressed, deflate_size);
+    store_be32(idat + 2 + deflate_size, checksum);
+    free(compressed);
+    
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        free(idat);
+        return -1;
+    }
+    
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t ihdr[13];
+    store_be32(ihdr, (uint32_t)image->width);
+    store_be32(ihdr + 4, (uint32_t)image->height);
+    ihdr[8] = 8;        // Profondeur
+    ihdr[9] = 2;        // RGB
+    ihdr[10] = 0;       // Deflate
+    ihdr[11] = 0;       // Filtrage adaptatif
+    ihdr[12] = 0;       // Non entrelacé
+    
+    int ok = fwrite(signature, 1, 8, file) == 8 &&
+             write_chunk(file, "IHDR", ihdr, sizeof(ihdr)) == 0 &&
+             write_chunk(file, "IDAT", idat, deflate_size + 6) == 0 &&
+             write_chunk(file, "IEND", NULL, 0) == 0;
+    if (fclose(file) != 0) ok = 0;
+    free(idat);
+    
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to write PNG file %s\n", filename);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include "profiler.h"
+#include "perf_counters.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <mkl/mkl.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#define PROFILER_MAX_INFO 32
+
+typedef struct {
+    char name[48];
+    int parent;                 // -1: racine
+    int depth;
+    long calls;
+    double seconds;
+    double flops;               // Inclusifs comme seconds: sous-phases du même thread comprises
+    double bytes;
+    // Tas du processus entier (mallinfo2): la variation n'a de sens que si aucun autre
+    // thread n'avait de phase ouverte pendant celle-ci, sinon heap_shared et elle est omise
+    long long heap_delta;       // Variation des octets alloués (malloc) sur la phase
+    int heap_shared;
+    long long heap_peak;        // Octets alloués au plus haut, mesurés en fin de phase
+    long peak_rss_kb;           // Pic de RSS du processus en fin de phase
+    double counters[PERF_N_COUNTERS];   // Compteurs matériels cumulés (inclusifs)
+} Phase;
+
+typedef struct {
+    int phase;
+    double start;
+    double flops;               // Travail de la phase et de ses sous-phases terminées
+    double bytes;
+    long long heap_start;
+    long concurrency_start;     // concurrency_epoch à l'ouverture
+    double counters_start[PERF_N_COUNTERS];
+} Frame;
+
+static Phase phases[PROFILER_MAX_PHASES];
+static int n_phases = 0;
+static char info_keys[PROFILER_MAX_INFO][32];
+static char info_values[PROFILER_MAX_INFO][128];
+static int info_quoted[PROFILER_MAX_INFO];
+static int n_info = 0;
+static pthread_mutex_t profiler_lock = PTHREAD_MUTEX_INITIALIZER;
+static double profiler_start = 0.0;
+static int open_threads = 0;            // Threads ayant au moins une phase ouverte
+static long concurrency_epoch = 0;      // Incrémenté dès que deux threads en ont une
+
+// Pile de phases propre à chaque thread
+static __thread Frame stack[PROFILER_MAX_DEPTH];
+static __thread int stack_depth = 0;
+
+double profiler_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+// Octets alloués par malloc (tas principal et blocs mmap), tous threads confondus
+static long long heap_bytes(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return (long long)(info.uordblks + info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;
+}
+
+// Phase (parent, name), créée au besoin; appelé sous le verrou
+static int find_phase(int parent, const char* name) {
+    for (int p = 0; p < n_phases; p++) {
+        if (phases[p].parent == parent && strcmp(phases[p].name, name) == 0) return p;
+    }
+    if (n_phases >= PROFILER_MAX_PHASES) return -1;
+    
+    Phase* phase = &phases[n_phases];
+    memset(phase, 0, sizeof(Phase));
+    snprintf(phase->name, sizeof(phase->name), "%s", name);
+    phase->parent = parent;
+    phase->depth = parent >= 0 ? phases[parent].depth + 1 : 0;
+    return n_phases++;
+}
+
+void profiler_begin(const char* name) {
+    if (stack_depth >= PROFILER_MAX_DEPTH) {
+        stack_depth++;          // Trop profond: ignoré, mais équilibré par profiler_end
+        return;
+    }
+    
+    pthread_mutex_lock(&profiler_lock);
+    if (profiler_start == 0.0) profiler_start = profiler_now();
+    int parent = stack_depth > 0 ? stack[stack_depth - 1].phase : -1;
+    int phase = find_phase(parent, name);
+    if (stack_depth == 0 && ++open_threads > 1) concurrency_epoch++;
+    long epoch = concurrency_epoch;
+    pthread_mutex_unlock(&profiler_lock);
+    
+    Frame* frame = &stack[stack_depth++];
+    frame->phase = phase;
+    frame->flops = frame->bytes = 0.0;
+    frame->concurrency_start = epoch;
+    frame->heap_start = heap_bytes();
+    if (perf_counters_enabled()) perf_counters_read(frame->counters_start);
+    frame->start = profiler_now();
+}
+
+void profiler_end(void) {
+    if (stack_depth <= 0) return;
+    if (stack_depth > PROFILER_MAX_DEPTH) {
+        stack_depth--;
+        return;
+    }
+    
+    Frame* frame = &stack[--stack_depth];
+    double elapsed = profiler_now() - frame->start;
+    double counters[PERF_N_COUNTERS];
+    int counted = perf_counters_enabled() && perf_counters_read(counters) == 0;
+    long long heap = heap_bytes();
+    long rss = peak_rss_kb();
+    
+    if (stack_depth > 0) {
+        stack[stack_depth - 1].flops += frame->flops;
+        stack[stack_depth - 1].bytes += frame->bytes;
+    }
+    
+    pthread_mutex_lock(&profiler_lock);
+    int shared = open_threads > 1 || concurrency_epoch != frame->concurrency_start;
+    if (stack_depth == 0) open_threads--;
+    if (frame->phase >= 0) {
+        Phase* phase = &phases[frame->phase];
+        phase->calls++;
+        phase->seconds += elapsed;
+        phase->flops += frame->flops;
+        phase->bytes += frame->bytes;
+        if (shared) phase->heap_shared = 1;
+        else phase->heap_delta += heap - frame->heap_start;
+        if (heap > phase->heap_peak) phase->heap_peak = heap;
+        if (rss > phase->peak_rss_kb) phase->peak_rss_kb = rss;
+        for (int c = 0; counted && c < PERF_N_COUNTERS; c++) {
+            phase->counters[c] += counters[c] - frame->counters_start[c];
+        }
+    }
+    pthread_mutex_unlock(&profiler_lock);
+}
+
+// Hors de toute phase, le travail n'est attribué à rien
+void profiler_add_work(double flops, double bytes) {
+    if (stack_depth == 0) return;
+    Frame* frame = &stack[(stack_depth < PROFILER_MAX_DEPTH ? stack_depth : PROFILER_MAX_DEPTH) - 1];
+    frame->flops += flops;
+    frame->bytes += bytes;
+}
+
+static void set_info(const char* key, const char* value, int quoted) {
+    pthread_mutex_lock(&profiler_lock);
+    int slot = 0;
+    while (slot < n_info && strcmp(info_keys[slot], key) != 0) slot++;
+    if (slot < PROFILER_MAX_INFO) {
+        snprintf(info_keys[slot], sizeof(info_keys[slot]), "%s", key);
+        snprintf(info_values[slot], sizeof(info_values[slot]), "%s", value);
+        info_quoted[slot] = quoted;
+        if (slot == n_info) n_info++;
+    }
+    pthread_mutex_unlock(&profiler_lock);
+}
+
+void profiler_set_info(const char* key, const char* value) {
+    set_info(key, value, 1);
+}
+
+void profiler_set_info_int(const char* key, long value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%ld", value);
+    set_info(key, buffer, 0);
+}
+
+static int thread_count(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// Parcours en profondeur: enfants dans l'ordre de création
+static void print_phase(int p) {
+    const Phase* phase = &phases[p];
+    char label[64];
+    snprintf(label, sizeof(label), "%*s%s", 2 * phase->depth, "", phase->name);
+    printf("  %-32s %6ld %10.3f", label, phase->calls, phase->seconds);
+    if (phase->flops > 0.0 && phase->seconds > 0.0) {
+        printf(" %8.2f GFLOP/s", phase->flops / phase->seconds * 1e-9);
+    }
+    if (phase->bytes > 0.0 && phase->seconds > 0.0) {
+        printf(" %8.2f GB/s", phase->bytes / phase->seconds * 1e-9);
+    }
+    printf("\n");
+    for (int c = 0; c < n_phases; c++) {
+        if (phases[c].parent == p) print_phase(c);
+    }
+}
+
+// Métriques dérivées des compteurs matériels d'une phase
+typedef struct {
+    double ipc;
+    double llc_miss_rate;
+    double dram_bytes;          // Défauts LLC × taille de ligne
+    double hw_flops;            // Comptées par le matériel (0 si indisponible)
+    double bytes_per_flop;      // Trafic mémoire estimé / flops (matériels, sinon modélisés)
+    double vector_fraction;     // Part des instructions flottantes vectorielles
+} CounterMetrics;
+
+static CounterMetrics counter_metrics(const Phase* phase) {
+    const double* c = phase->counters;
+    CounterMetrics m;
+    memset(&m, 0, sizeof(m));
+    if (c[PERF_CYCLES] > 0.0) m.ipc = c[PERF_INSTRUCTIONS] / c[PERF_CYCLES];
+    if (c[PERF_LLC_REFERENCES] > 0.0) m.llc_miss_rate = c[PERF_LLC_MISSES] / c[PERF_LLC_REFERENCES];
+    m.dram_bytes = c[PERF_LLC_MISSES] * PERF_CACHE_LINE_BYTES;
+    m.hw_flops = perf_counters_flops(c);
+    double flops = m.hw_flops > 0.0 ? m.hw_flops : phase->flops;
+    if (flops > 0.0) m.bytes_per_flop = m.dram_bytes / flops;
+    double fp_instructions = c[PERF_FP_SCALAR] + c[PERF_FP_128] + c[PERF_FP_256] + c[PERF_FP_512];
+    if (fp_instructions > 0.0) m.vector_fraction = 1.0 - c[PERF_FP_SCALAR] / fp_instructions;
+    return m;
+}
+
+static void print_phase_counters(int p) {
+    const Phase* phase = &phases[p];
+    CounterMetrics m = counter_metrics(phase);
+    char label[64];
+    snprintf(label, sizeof(label), "%*s%s", 2 * phase->depth, "", phase->name);
+    printf("  %-32s %6.2f %9.1f%% %9.2f", label, m.ipc, 100.0 * m.llc_miss_rate,
+           phase->seconds > 0.0 ? m.dram_bytes / phase->seconds * 1e-9 : 0.0);
+    if (perf_counter_available(PERF_FP_SCALAR)) {
+        printf(" %10.2f %8.1f%%", phase->seconds > 0.0 ? m.hw_flops / phase->seconds * 1e-9 : 0.0,
+               100.0 * m.vector_fraction);
+    }
+    if (m.bytes_per_flop > 0.0) printf(" %8.3f", m.bytes_per_flop);
+    printf("\n");
+    for (int c = 0; c < n_phases; c++) {
+        if (phases[c].parent == p) print_phase_counters(c);
+    }
+}
+
+void profiler_print_summary(void) {
+    pthread_mutex_lock(&profiler_lock);
+    printf("\n=== PROFILE (wall clock, %d threads) ===\n", thread_count());
+    printf("  %-32s %6s %10s\n", "Phase", "Calls", "Seconds");
+    for (int p = 0; p < n_phases; p++) {
+        if (phases[p].parent < 0) print_phase(p);
+    }
+    printf("  Peak RSS: %.1f MB\n", peak_rss_kb() / 1024.0);
+    
+    if (perf_counters_enabled()) {
+        printf("\n=== HARDWARE COUNTERS (user space, all threads) ===\n");
+        printf("  %-32s %6s %10s %9s", "Phase", "IPC", "LLC miss", "LLC GB/s");
+        if (perf_counter_available(PERF_FP_SCALAR)) printf(" %10s %9s", "HW GFLOP/s", "Vector");
+        printf(" %8s\n", "B/flop");
+        for (int p = 0; p < n_phases; p++) {
+            if (phases[p].parent < 0) print_phase_counters(p);
+        }
+    }
+    pthread_mutex_unlock(&profiler_lock);
+}
+
+static void write_json_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+static void write_phase_json(FILE* file, int p, int indent) {
+    const Phase* phase = &phases[p];
+    double seconds = phase->seconds;
+    
+    fprintf(file, "%*s{\"name\": ", indent, "");
+    write_json_string(file, phase->name);
+    fprintf(file, ", \"calls\": %ld, \"seconds\": %.6f", phase->calls, seconds);
+    fprintf(file, ", \"flops\": %.6g, \"bytes\": %.6g", phase->flops, phase->bytes);
+    fprintf(file, ", \"gflops_per_s\": %.6g, \"gbytes_per_s\": %.6g",
+            seconds > 0.0 ? phase->flops / seconds * 1e-9 : 0.0,
+            seconds > 0.0 ? phase->bytes / seconds * 1e-9 : 0.0);
+    if (phase->heap_shared) fprintf(file, ", \"heap_delta_bytes\": null");
+    else fprintf(file, ", \"heap_delta_bytes\": %lld", phase->heap_delta);
+    fprintf(file, ", \"heap_peak_bytes\": %lld, \"peak_rss_kb\": %ld", phase->heap_peak,
+            phase->peak_rss_kb);
+    
+    if (perf_counters_enabled()) {
+        CounterMetrics m = counter_metrics(phase);
+        fprintf(file, ", \"counters\": {");
+        int first = 1;
+        for (int c = 0; c < PERF_N_COUNTERS; c++) {
+            if (!perf_counter_available((PerfCounter)c)) continue;
+            fprintf(file, "%s\"%s\": %.0f", first ? "" : ", ", perf_counter_name((PerfCounter)c),
+                    phase->counters[c]);
+            first = 0;
+        }
+        fprintf(file, ", \"ipc\": %.4f, \"llc_miss_rate\": %.4f, \"dram_bytes_est\": %.6g",
+                m.ipc, m.llc_miss_rate, m.dram_bytes);
+        fprintf(file, ", \"hw_flops\": %.6g, \"bytes_per_flop\": %.6g, \"vector_fraction\": %.4f}",
+                m.hw_flops, m.bytes_per_flop, m.vector_fraction);
+    }
+    
+    fprintf(file, ", \"children\": [");
+    int first = 1;
+    for (int c = 0; c < n_phases; c++) {
+        if (phases[c].parent != p) continue;
+        fprintf(file, first ? "\n" : ",\n");
+        write_phase_json(file, c, indent + 2);
+        first = 0;
+    }
+    if (!first) fprintf(file, "\n%*s", indent, "");
+    fprintf(file, "]}");
+}
+
+int profiler_write_json(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+        return -1;
+    }
+    
+    pthread_mutex_lock(&profiler_lock);
+    fprintf(file, "{\n  \"version\": 1,\n");
+    fprintf(file, "  \"wall_seconds\": %.6f,\n",
+            profiler_start > 0.0 ? profiler_now() - profiler_start : 0.0);
+    fprintf(file, "  \"threads\": %d,\n  \"blas_threads\": %d,\n", thread_count(),
+            mkl_get_max_threads());
+    fprintf(file, "  \"peak_rss_kb\": %ld,\n", peak_rss_kb());
+    fprintf(file, "  \"hardware_counters\": %s,\n", perf_counters_enabled() ? "true" : "false");
+    fprintf(file, "  \"info\": {");
+    for (int i = 0; i < n_info; i++) {
+        fprintf(file, "%s\n    ", i ? "," : "");
+        write_json_string(file, info_keys[i]);
+        fprintf(file, ": ");
+        if (info_quoted[i]) write_json_string(file, info_values[i]);
+        else fprintf(file, "%s", info_values[i]);
+    }
+    fprintf(file, "%s},\n", n_info ? "\n  " : "");
+    fprintf(file, "  \"phases\": [");
+    int first = 1;
+    for (int p = 0; p < n_phases; p++) {
+        if (phases[p].parent >= 0) continue;
+        fprintf(file, first ? "\n" : ",\n");
+        write_phase_json(file, p, 4);
+        first = 0;
+    }
+    fprintf(file, "%s]\n}\n", first ? "" : "\n  ");
+    pthread_mutex_unlock(&profiler_lock);
+    
+    int status = ferror(file) ? -1 : 0;
+    if (fclose(file) != 0) status = -1;
+    if (status == 0) printf("Saved performance report to %s\n", filename);
+    return status;
+}
@@ -0,0 +1,217 @@
+#ifdef __linux__
+#define _GNU_SOURCE             // sched_getaffinity(), CPU_SET
+#endif
+#include "resources.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <mkl/mkl.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Cœurs autorisés au thread appelant, dans l'ordre des identifiants
+static int current_affinity(ThreadGroup* group) {
+    group->n_cores = 0;
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE && group->n_cores < RESOURCES_MAX_CORES; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) group->cores[group->n_cores++] = cpu;
+        }
+    }
+#endif
+    return group->n_cores;
+}
+
+int resources_detect(int max_cores, ThreadGroup* all) {
+    if (current_affinity(all) == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        all->n_cores = online > 0 ? (int)online : 1;
+        if (all->n_cores > RESOURCES_MAX_CORES) all->n_cores = RESOURCES_MAX_CORES;
+        for (int c = 0; c < all->n_cores; c++) all->cores[c] = c;
+    }
+    
+    if (max_cores > RESOURCES_MAX_CORES) max_cores = RESOURCES_MAX_CORES;
+    if (max_cores > all->n_cores) {
+        // Plus de threads que de cœurs: les identifiants sont repris dans l'ordre
+        for (int c = all->n_cores; c < max_cores; c++) all->cores[c] = all->cores[c % all->n_cores];
+        all->n_cores = max_cores;
+    } else if (max_cores > 0) {
+        all->n_cores = max_cores;
+    }
+    return all->n_cores;
+}
+
+// Durée du groupe g: ses tâches s'exécutent l'une après l'autre sur cores cœurs
+static double group_seconds(int g, int cores, int n_tasks, const int* task_group,
+                            TaskCostFn cost, void* data) {
+    double seconds = 0.0;
+    for (int t = 0; t < n_tasks; t++) {
+        if (task_group[t] == g) seconds += cost(t, cores, data);
+    }
+    return seconds;
+}
+
+// Répartition sur exactement n_groups groupes (tâches triées par durée décroissante dans order)
+static double partition_into(const ThreadGroup* all, int n_tasks, TaskCostFn cost, void* data,
+                             const int* order, const double* serial, int n_groups,
+                             int* task_group, ThreadGroup* groups) {
+    double loads[RESOURCES_MAX_CORES];
+    for (int g = 0; g < n_groups; g++) {
+        loads[g] = 0.0;
+        groups[g].n_cores = 1;
+    }
+    for (int i = 0; i < n_tasks; i++) {
+        int lightest = 0;
+        for (int g = 1; g < n_groups; g++) {
+            if (loads[g] < loads[lightest]) lightest = g;
+        }
+        task_group[order[i]] = lightest;
+        loads[lightest] += serial[order[i]];
+    }
+    
+    // Cœurs restants: au groupe le plus long qui en profite, sinon au plus long
+    for (int extra = all->n_cores - n_groups; extra > 0; extra--) {
+        int longest = 0, chosen = -1;
+        double chosen_seconds = 0.0;
+        for (int g = 0; g < n_groups; g++) {
+            double seconds = group_seconds(g, groups[g].n_cores, n_tasks, task_group, cost, data);
+            double faster = group_seconds(g, groups[g].n_cores + 1, n_tasks, task_group, cost, data);
+            loads[g] = seconds;
+            if (seconds > loads[longest]) longest = g;
+            if (faster < seconds && (chosen < 0 || seconds > chosen_seconds)) {
+                chosen = g;
+                chosen_seconds = seconds;
+            }
+        }
+        groups[chosen >= 0 ? chosen : longest].n_cores++;
+    }
+    
+    // Tranches contiguës du masque, dans l'ordre des groupes
+    int next = 0;
+    double makespan = 0.0;
+    for (int g = 0; g < n_groups; g++) {
+        for (int c = 0; c < groups[g].n_cores; c++) groups[g].cores[c] = all->cores[next++];
+        double seconds = group_seconds(g, groups[g].n_cores, n_tasks, task_group, cost, data);
+        if (seconds > makespan) makespan = seconds;
+    }
+    return makespan;
+}
+
+int resources_partition(const ThreadGroup* all, int n_tasks, TaskCostFn cost, void* data,
+                        int max_groups, int* task_group, ThreadGroup* groups, double* makespan) {
+    if (n_tasks < 1 || all->n_cores < 1) return 0;
+    
+    int limit = n_tasks < all->n_cores ? n_tasks : all->n_cores;
+    if (max_groups > 0 && limit > max_groups) limit = max_groups;
+    
+    int* order = (int*)malloc(n_tasks * sizeof(int));
+    double* serial = (double*)malloc(n_tasks * sizeof(double));
+    int* candidate = (int*)malloc(n_tasks * sizeof(int));
+    ThreadGroup* trial = (ThreadGroup*)malloc(limit * sizeof(ThreadGroup));
+    if (!order || !serial || !candidate || !trial) {
+        fprintf(stderr, "Error: Memory allocation failed for task partitioning\n");
+        free(order);
+        free(serial);
+        free(candidate);
+        free(trial);
+        return 0;
+    }
+    
+    // Plus longue tâche d'abord (durée sur un cœur)
+    for (int t = 0; t < n_tasks; t++) {
+        serial[t] = cost(t, 1, data);
+        int i = t;
+        while (i > 0 && serial[order[i - 1]] < serial[t]) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = t;
+    }
+    
+    // Nombre de groupes de durée estimée minimale; à égalité, le plus grand
+    int n_groups = 0;
+    for (int count = 1; count <= limit; count++) {
+        double seconds = partition_into(all, n_tasks, cost, data, order, serial, count,
+                                        candidate, trial);
+        if (n_groups == 0 || seconds <= *makespan) {
+            n_groups = count;
+            *makespan = seconds;
+            memcpy(task_group, candidate, n_tasks * sizeof(int));
+            memcpy(groups, trial, count * sizeof(ThreadGroup));
+        }
+    }
+    
+    free(order);
+    free(serial);
+    free(candidate);
+    free(trial);
+    return n_groups;
+}
+
+#ifdef __linux__
+static int set_affinity(const ThreadGroup* group) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int c = 0; c < group->n_cores; c++) CPU_SET(group->cores[c], &mask);
+    return sched_setaffinity(0, sizeof(mask), &mask);
+}
+#endif
+
+int thread_group_enter(const ThreadGroup* group, int pin, ThreadState* previous) {
+    memset(previous, 0, sizeof(ThreadState));
+    
+    // Réglages du thread appelant uniquement: les autres groupes gardent les leurs
+    previous->mkl_threads = mkl_set_num_threads_local(group->n_cores);
+#ifdef _OPENMP
+    previous->omp_threads = omp_get_max_threads();
+    omp_set_num_threads(group->n_cores);
+#endif
+
+    if (!pin) return 0;
+#ifdef __linux__
+    // Les threads OpenMP et MKL créés ensuite par ce thread héritent du masque
+    if (current_affinity(&previous->affinity) > 0 && set_affinity(group) == 0) {
+        previous->pinned = 1;
+        return 0;
+    }
+    fprintf(stderr, "Warning: Cannot pin thread group (sched_setaffinity: %s)\n", strerror(errno));
+#endif
+    return -1;
+}
+
+void thread_group_leave(const ThreadState* previous) {
+#ifdef __linux__
+    if (previous->pinned) set_affinity(&previous->affinity);
+#endif
+#ifdef _OPENMP
+    if (previous->omp_threads > 0) omp_set_num_threads(previous->omp_threads);
+#endif
+    mkl_set_num_threads_local(previous->mkl_threads);
+}
+
+void format_core_list(const ThreadGroup* group, char* text, size_t size) {
+    size_t used = 0;
+    text[0] = '\0';
+    for (int c = 0; c < group->n_cores && used < size; c++) {
+        int last = c;
+        while (last + 1 < group->n_cores && group->cores[last + 1] == group->cores[last] + 1) last++;
+        int written;
+        if (last > c) {
+            written = snprintf(text + used, size - used, "%s%d-%d", c > 0 ? "," : "",
+                               group->cores[c], group->cores[last]);
+        } else {
+            written = snprintf(text + used, size - used, "%s%d", c > 0 ? "," : "", group->cores[c]);
+        }
+        if (written < 0) break;
+        used += (size_t)written;
+        c = last;
+    }
+}
@@ -0,0 +1,423 @@
+#include "result_cache.h"
+#include "profiler.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/stat.h>
+
+#define CACHE_MAGIC "MEMBEIG1"
+#define CACHE_VERSION 1
+#define CACHE_EXTENSION ".eig"
+#define CACHE_TEMP_INFIX ".tmp."        // <entrée>.tmp.<pid> pendant l'écriture
+
+// En-tête d'une entrée, suivi de eigenvalues[k], residuals[k] et modes[n*k] (colonne-major)
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_eigenvalues;
+    uint64_t n_dof;
+    double eps;
+    uint64_t key[2];
+} CacheEntryHeader;
+
+// ============ EMPREINTE ============
+
+typedef struct {
+    uint64_t a;
+    uint64_t b;
+    uint64_t length;
+} Hasher;
+
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static void hasher_init(Hasher* h) {
+    h->a = 0x243F6A8885A308D3ULL;
+    h->b = 0x13198A2E03707344ULL;
+    h->length = 0;
+}
+
+static void hash_word(Hasher* h, uint64_t w) {
+    h->a = rotl64((h->a ^ w) * 0x9E3779B97F4A7C15ULL, 29);
+    h->b = rotl64(h->b + w * 0xC2B2AE3D27D4EB4FULL, 31) * 0x165667B19E3779F9ULL;
+}
+
+// Deux voies 64 bits indépendantes, 8 octets par pas
+static void hash_bytes(Hasher* h, const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    h->length += length;
+    
+    while (length >= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        hash_word(h, w);
+        p += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        uint64_t w = 0;
+        memcpy(&w, p, length);
+        hash_word(h, w ^ ((uint64_t)length << 56));
+    }
+}
+
+static void hash_string(Hasher* h, const char* s) {
+    hash_bytes(h, s, strlen(s) + 1);
+}
+
+static void hash_int(Hasher* h, int64_t value) {
+    hash_bytes(h, &value, sizeof(value));
+}
+
+static ProblemKey hasher_final(Hasher* h) {
+    ProblemKey key;
+    key.h[0] = mix64(h->a ^ h->length);
+    key.h[1] = mix64(h->b ^ rotl64(h->a, 17) ^ h->length);
+    return key;
+}
+
+// Partie commune: discrétisation et partie du spectre demandée (les plus petites valeurs)
+static void hash_problem_header(Hasher* h, const char* source) {
+    hash_string(h, "membrane-eigenproblem");
+    hash_int(h, CACHE_DISCRETIZATION_VERSION);
+    hash_string(h, "spectrum=smallest");
+    hash_string(h, source);
+}
+
+ProblemKey problem_key_from_mesh(Mesh* mesh) {
+    Hasher h;
+    hasher_init(&h);
+    hash_problem_header(&h, "mesh");
+    
+    size_t n = (size_t)mesh->total_points;
+    hash_int(&h, mesh->N);
+    hash_bytes(&h, &mesh->h, sizeof(double));
+    hash_bytes(&h, mesh->x, mesh->N * sizeof(double));
+    hash_bytes(&h, mesh->y, mesh->N * sizeof(double));
+    hash_bytes(&h, mesh->p_vals, n * sizeof(double));
+    hash_bytes(&h, mesh->w_vals, n * sizeof(double));
+    hash_bytes(&h, mesh->q_vals, n * sizeof(double));
+    
+    return hasher_final(&h);
+}
+
+static void hash_matrix(Hasher* h, SparseMatrixCSR* mat) {
+    hash_int(h, mat->n_rows);
+    hash_int(h, mat->n_cols);
+    hash_int(h, mat->nnz);
+    hash_bytes(h, mat->row_index, ((size_t)mat->n_rows + 1) * sizeof(MKL_INT));
+    hash_bytes(h, mat->columns, (size_t)mat->nnz * sizeof(MKL_INT));
+    hash_bytes(h, mat->values, (size_t)mat->nnz * sizeof(double));
+}
+
+ProblemKey problem_key_from_matrices(SparseMatrixCSR* A, SparseMatrixCSR* B) {
+    Hasher h;
+    hasher_init(&h);
+    hash_problem_header(&h, "csr");
+    hash_matrix(&h, A);
+    hash_matrix(&h, B);
+    return hasher_final(&h);
+}
+
+// ============ STOCKAGE ============
+
+// Fichiers temporaires laissés par un processus interrompu avant son rename: ceux d'un
+// processus encore vivant (écriture en cours) sont conservés
+static void remove_stale_temporaries(const char* directory) {
+    DIR* dir = opendir(directory);
+    if (!dir) return;
+    
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        const char* infix = strstr(entry->d_name, CACHE_TEMP_INFIX);
+        if (!infix) continue;
+        char* end;
+        long pid = strtol(infix + strlen(CACHE_TEMP_INFIX), &end, 10);
+        if (*end != '\0' || pid <= 0) continue;
+        if (kill((pid_t)pid, 0) == 0 || errno != ESRCH) continue;
+        
+        char path[768];
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        if (unlink(path) == 0) printf("Cache: removed stale %s\n", entry->d_name);
+    }
+    closedir(dir);
+}
+
+int result_cache_init(ResultCache* cache, const char* directory, size_t max_bytes) {
+    memset(cache, 0, sizeof(ResultCache));
+    
+    if (strlen(directory) >= sizeof(cache->directory) - 64) {
+        fprintf(stderr, "Error: Cache directory path too long\n");
+        return -1;
+    }
+    strcpy(cache->directory, directory);
+    cache->max_bytes = max_bytes;
+    
+    if (mkdir(directory, 0755) != 0) {
+        struct stat st;
+        if (stat(directory, &st) != 0 || !S_ISDIR(st.st_mode)) {
+            fprintf(stderr, "Warning: Cannot use cache directory %s, cache disabled\n", directory);
+            return -1;
+        }
+    }
+    
+    remove_stale_temporaries(directory);
+    pthread_mutex_init(&cache->lock, NULL);
+    cache->enabled = 1;
+    return 0;
+}
+
+static void entry_path(ResultCache* cache, ProblemKey key, char* path, size_t size) {
+    snprintf(path, size, "%s/%016llx%016llx%s", cache->directory,
+             (unsigned long long)key.h[0], (unsigned long long)key.h[1], CACHE_EXTENSION);
+}
+
+static int read_header(FILE* file, ProblemKey key, CacheEntryHeader* header) {
+    if (fread(header, sizeof(CacheEntryHeader), 1, file) != 1) return -1;
+    if (memcmp(header->magic, CACHE_MAGIC, 8) != 0 || header->version != CACHE_VERSION) return -1;
+    if (header->key[0] != key.h[0] || header->key[1] != key.h[1]) return -1;
+    return 0;
+}
+
+EigenResults* result_cache_lookup(ResultCache* cache, ProblemKey key,
+                                  SolverConfig* config) {
+    if (!cache || !cache->enabled) return NULL;
+    
+    char path[640];
+    entry_path(cache, key, path, sizeof(path));
+    
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        cache->misses++;
+        return NULL;
+    }
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    CacheEntryHeader header;
+    int k = config->n_eigenvalues;
+    if (read_header(file, key, &header) != 0 ||
+        (int)header.n_eigenvalues < k || header.eps > config->eps) {
+        fclose(file);
+        cache->misses++;
+        return NULL;
+    }
+    
+    int n = (int)header.n_dof;
+    int stored = (int)header.n_eigenvalues;
+    EigenResults* results = create_eigen_results(n, k, config->eigenvector_file);
+    if (!results) {
+        fclose(file);
+        return NULL;
+    }
+    
+    // Les k premiers modes forment un préfixe contigu de chaque section
+    long values_offset = (long)sizeof(CacheEntryHeader);
+    long residuals_offset = values_offset + (long)stored * (long)sizeof(double);
+    long modes_offset = residuals_offset + (long)stored * (long)sizeof(double);
+    size_t mode_count = (size_t)n * k;
+    
+    int ok = fread(results->eigenvalues, sizeof(double), k, file) == (size_t)k &&
+             fseek(file, residuals_offset, SEEK_SET) == 0 &&
+             fread(results->residuals, sizeof(double), k, file) == (size_t)k &&
+             fseek(file, modes_offset, SEEK_SET) == 0 &&
+             fread(results->modes, sizeof(double), mode_count, file) == mode_count;
+    fclose(file);
+    
+    if (!ok) {
+        fprintf(stderr, "Warning: Corrupted cache entry %s, ignoring it\n", path);
+        free_eigen_results(results);
+        cache->misses++;
+        return NULL;
+    }
+    
+    // Date de modification = dernière utilisation (éviction LRU)
+    utimensat(AT_FDCWD, path, NULL, 0);
+    
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    results->computation_time = (end.tv_sec - start.tv_sec) + 1e-9 * (end.tv_nsec - start.tv_nsec);
+    results->iterations = 0;
+    cache->hits++;
+    
+    printf("Cache hit: %d of %d stored modes loaded from %s\n", k, stored, path);
+    return results;
+}
+
+int result_cache_store(ResultCache* cache, ProblemKey key, EigenResults* results,
+                       SolverConfig* config) {
+    if (!cache || !cache->enabled || !results || results->n_eigenvalues <= 0) return -1;
+    
+    char path[640];
+    entry_path(cache, key, path, sizeof(path));
+    
+    // Tolérance effectivement atteinte (un solveur itératif peut s'arrêter avant)
+    double achieved = config->eps;
+    for (int i = 0; i < results->n_eigenvalues; i++) {
+        if (results->residuals[i] > achieved) achieved = results->residuals[i];
+    }
+    
+    // Une entrée existante au moins aussi complète est conservée
+    FILE* existing = fopen(path, "rb");
+    if (existing) {
+        CacheEntryHeader old;
+        int keep = read_header(existing, key, &old) == 0 &&
+                   (int)old.n_eigenvalues >= results->n_eigenvalues &&
+                   old.eps <= achieved;
+        fclose(existing);
+        if (keep) return 0;
+    }
+    
+    // Une entrée plus grande que la limite serait évincée dès son écriture
+    size_t k = (size_t)results->n_eigenvalues;
+    size_t mode_count = (size_t)results->n_dof * k;
+    size_t entry_bytes = sizeof(CacheEntryHeader) + (2 * k + mode_count) * sizeof(double);
+    if (entry_bytes > cache->max_bytes) {
+        printf("Cache: entry of %.1f MB exceeds the cache limit (%.1f MB), not stored\n",
+               entry_bytes / 1048576.0, cache->max_bytes / 1048576.0);
+        return 0;
+    }
+    
+    CacheEntryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, 8);
+    header.version = CACHE_VERSION;
+    header.n_eigenvalues = (uint32_t)results->n_eigenvalues;
+    header.n_dof = (uint64_t)results->n_dof;
+    header.eps = achieved;
+    header.key[0] = key.h[0];
+    header.key[1] = key.h[1];
+    
+    // Ecriture dans un fichier temporaire puis rename (atomique pour les lecteurs)
+    char tmp_path[704];
+    snprintf(tmp_path, sizeof(tmp_path), "%s%s%ld", path, CACHE_TEMP_INFIX, (long)getpid());
+    FILE* file = fopen(tmp_path, "wb");
+    if (!file) {
+        fprintf(stderr, "Warning: Cannot write cache entry %s\n", tmp_path);
+        return -1;
+    }
+    
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(results->eigenvalues, sizeof(double), k, file) == k &&
+             fwrite(results->residuals, sizeof(double), k, file) == k &&
+             fwrite(results->modes, sizeof(double), mode_count, file) == mode_count;
+    if (fclose(file) != 0) ok = 0;
+    
+    if (!ok || rename(tmp_path, path) != 0) {
+        fprintf(stderr, "Warning: Failed to store cache entry %s\n", path);
+        unlink(tmp_path);
+        return -1;
+    }
+    
+    result_cache_evict(cache, path + strlen(cache->directory) + 1);
+    return 0;
+}
+
+// ============ EVICTION ============
+
+typedef struct {
+    char name[128];
+    time_t last_use;
+    off_t size;
+} CacheFileInfo;
+
+static int compare_last_use(const void* a, const void* b) {
+    const CacheFileInfo* fa = (const CacheFileInfo*)a;
+    const CacheFileInfo* fb = (const CacheFileInfo*)b;
+    if (fa->last_use != fb->last_use) return fa->last_use < fb->last_use ? -1 : 1;
+    return 0;
+}
+
+void result_cache_evict(ResultCache* cache, const char* keep) {
+    if (!cache || !cache->enabled) return;
+    
+    DIR* dir = opendir(cache->directory);
+    if (!dir) return;
+    
+    CacheFileInfo* files = NULL;
+    size_t count = 0, capacity = 0;
+    size_t total = 0;
+    struct dirent* entry;
+    
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        size_t ext_len = strlen(CACHE_EXTENSION);
+        if (len <= ext_len || len >= sizeof(files[0].name) ||
+            strcmp(entry->d_name + len - ext_len, CACHE_EXTENSION) != 0) continue;
+        
+        char path[768];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", cache->directory, entry->d_name);
+        if (stat(path, &st) != 0) continue;
+        
+        if (count == capacity) {
+            capacity = capacity ? 2 * capacity : 32;
+            CacheFileInfo* grown = (CacheFileInfo*)realloc(files, capacity * sizeof(CacheFileInfo));
+            if (!grown) break;
+            files = grown;
+        }
+        strcpy(files[count].name, entry->d_name);
+        files[count].last_use = st.st_mtime;
+        files[count].size = st.st_size;
+        total += (size_t)st.st_size;
+        count++;
+    }
+    closedir(dir);
+    
+    if (total > cache->max_bytes) {
+        qsort(files, count, sizeof(CacheFileInfo), compare_last_use);
+        for (size_t i = 0; i < count && total > cache->max_bytes; i++) {
+            if (keep && strcmp(files[i].name, keep) == 0) continue;
+            char path[768];
+            snprintf(path, sizeof(path), "%s/%s", cache->directory, files[i].name);
+            if (unlink(path) == 0) {
+                total -= (size_t)files[i].size;
+                printf("Cache: evicted %s\n", files[i].name);
+            }
+        }
+    }
+    
+    free(files);
+}
+
+EigenResults* solve_eigenproblem_cached(ResultCache* cache, ProblemKey key,
+                                        SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                        SolverConfig* config) {
+    int locked = cache && cache->enabled;
+    profiler_begin("cache_lookup");
+    if (locked) pthread_mutex_lock(&cache->lock);
+    EigenResults* results = result_cache_lookup(cache, key, config);
+    if (locked) pthread_mutex_unlock(&cache->lock);
+    profiler_end();
+    if (results) {
+        stream_eigenpairs(config, results, 0, 0.0);
+        return results;
+    }
+    
+    results = solve_eigenproblem(A, B, config);
+    if (results) {
+        profiler_begin("cache_store");
+        if (locked) pthread_mutex_lock(&cache->lock);
+        result_cache_store(cache, key, results, config);
+        if (locked) pthread_mutex_unlock(&cache->lock);
+        profiler_end();
+    }
+    
+    return results;
+}
@@ -0,0 +1,170 @@
+#include "sensitivity.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+void free_eigen_sensitivities(EigenSensitivities* sens) {
+    if (!sens) return;
+    mkl_free(sens->dp);
+    mkl_free(sens->dw);
+    mkl_free(sens->dq);
+    free(sens->obstacle);
+    free(sens->cluster);
+    free(sens);
+}
+
+// Groupes de valeurs propres consécutives à moins de SENSITIVITY_CLUSTER_GAP (relatif)
+static int find_clusters(const double* eigenvalues, int k, int* cluster) {
+    for (int v = 0; v < k; v++) {
+        int joined = v > 0 && fabs(eigenvalues[v] - eigenvalues[v - 1]) <=
+                     SENSITIVITY_CLUSTER_GAP * fmax(fabs(eigenvalues[v]), fabs(eigenvalues[v - 1]));
+        cluster[v] = joined ? cluster[v - 1] : v;
+    }
+    int clustered = 0;
+    for (int v = 0; v < k; v++) {
+        if (cluster[v] != v || (v + 1 < k && cluster[v + 1] == v)) clustered++;
+    }
+    return clustered;
+}
+
+// Moyenne des colonnes [first, first + size) de field (n x k), recopiée dans chacune
+static void average_cluster(double* field, size_t n, int first, int size) {
+    #pragma omp parallel for schedule(static)
+    for (size_t idx = 0; idx < n; idx++) {
+        double sum = 0.0;
+        for (int v = first; v < first + size; v++) sum += field[(size_t)v * n + idx];
+        for (int v = first; v < first + size; v++) field[(size_t)v * n + idx] = sum / size;
+    }
+}
+
+// Dérivées de q = S exp(-W r²) aux points: colonnes centre x, centre y, intensité, largeur
+static void obstacle_jacobian(const Mesh* mesh, const MembraneParams* params, double* J) {
+    int N = mesh->N;
+    size_t n = (size_t)mesh->total_points;
+    double width = params->obstacle_width;
+    
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            size_t idx = (size_t)i * N + j;
+            double dx = mesh->x[i] - params->obstacle_center_x;
+            double dy = mesh->y[j] - params->obstacle_center_y;
+            double r2 = dx * dx + dy * dy;
+            double shape = exp(-width * r2);
+            double q = params->obstacle_strength * shape;
+            J[idx] = 2.0 * width * dx * q;
+            J[n + idx] = 2.0 * width * dy * q;
+            J[2 * n + idx] = shape;
+            J[3 * n + idx] = -r2 * q;
+        }
+    }
+}
+
+EigenSensitivities* compute_eigen_sensitivities(const Mesh* mesh, const MembraneParams* params,
+                                                const EigenResults* modes) {
+    int N = mesh->N;
+    int n = mesh->total_points;
+    int k = modes->n_eigenvalues;
+    if (modes->n_dof != n) {
+        fprintf(stderr, "Error: Modes (%d DOF) do not match the mesh (%d points)\n",
+                modes->n_dof, n);
+        return NULL;
+    }
+    
+    EigenSensitivities* sens = (EigenSensitivities*)calloc(1, sizeof(EigenSensitivities));
+    double* mass = (double*)malloc((size_t)k * sizeof(double));
+    if (!sens || !mass) {
+        free(sens);
+        free(mass);
+        return NULL;
+    }
+    sens->n_modes = k;
+    sens->n_points = n;
+    sens->dp = (double*)mkl_malloc((size_t)n * k * sizeof(double), 64);
+    sens->dw = (double*)mkl_malloc((size_t)n * k * sizeof(double), 64);
+    sens->dq = (double*)mkl_malloc((size_t)n * k * sizeof(double), 64);
+    sens->obstacle = (double*)calloc((size_t)k * SENSITIVITY_N_OBSTACLE, sizeof(double));
+    sens->cluster = (int*)malloc((size_t)k * sizeof(int));
+    if (!sens->dp || !sens->dw || !sens->dq || !sens->obstacle || !sens->cluster) {
+        fprintf(stderr, "Error: Memory allocation failed for the sensitivities\n");
+        free_eigen_sensitivities(sens);
+        free(mass);
+        return NULL;
+    }
+    
+    profiler_begin("sensitivities");
+    
+    // Masses modales φᵀBφ (les modes sont normés en norme 2, pas en norme B)
+    for (int v = 0; v < k; v++) {
+        const double* phi = modes->modes + (size_t)v * n;
+        double m = 0.0;
+        #pragma omp parallel for reduction(+:m) schedule(static)
+        for (int idx = 0; idx < n; idx++) m += mesh->w_vals[idx] * phi[idx] * phi[idx];
+        mass[v] = m;
+    }
+    
+    // Un passage sur (mode, ligne): φ et ses 4 voisins suffisent, les coefficients p
+    // n'interviennent pas (c linéaire en p: ∂c/∂p = 1/2h² à l'intérieur, 1/h² au bord)
+    double inv_h2 = 1.0 / (mesh->h * mesh->h);
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int v = 0; v < k; v++) {
+        for (int i = 0; i < N; i++) {
+            const double* phi = modes->modes + (size_t)v * n;
+            double scale = 1.0 / mass[v];
+            double lambda = modes->eigenvalues[v];
+            size_t row = (size_t)v * n + (size_t)i * N;
+            const double* f = phi + (size_t)i * N;
+    
+            #pragma omp simd
+            for (int j = 0; j < N; j++) {
+                double fc = f[j];
+                double f2 = fc * fc;
+                double dr = i < N - 1 ? fc - f[j + N] : 0.0;
+                double dl = i > 0 ? fc - f[j - N] : 0.0;
+                double du = j < N - 1 ? fc - f[j + 1] : 0.0;
+                double dd = j > 0 ? fc - f[j - 1] : 0.0;
+                double edges = (i < N - 1 ? 0.5 * dr * dr : f2) + (i > 0 ? 0.5 * dl * dl : f2) +
+                               (j < N - 1 ? 0.5 * du * du : f2) + (j > 0 ? 0.5 * dd * dd : f2);
+                sens->dq[row + j] = f2 * scale;
+                sens->dw[row + j] = -lambda * f2 * scale;
+                sens->dp[row + j] = edges * inv_h2 * scale;
+            }
+        }
+    }
+    profiler_add_work(24.0 * n * k, 4.0 * n * k * sizeof(double));
+    
+    // Groupes multiples: trace de la dérivée projetée sur le sous-espace (modes B-orthogonaux),
+    // les gradients de l'obstacle suivent (linéaires en dq)
+    sens->n_clustered = find_clusters(modes->eigenvalues, k, sens->cluster);
+    for (int first = 0; first < k;) {
+        int size = 1;
+        while (first + size < k && sens->cluster[first + size] == first) size++;
+        if (size > 1) {
+            average_cluster(sens->dp, (size_t)n, first, size);
+            average_cluster(sens->dw, (size_t)n, first, size);
+            average_cluster(sens->dq, (size_t)n, first, size);
+        }
+        first += size;
+    }
+    
+    // Paramètres scalaires de l'obstacle: dλ_i/dθ = Σ_k dλ_i/dq_k ∂q_k/∂θ (k x 4 = dqᵀ J)
+    sens->has_obstacle = !params->potential_expr && params->potential == default_potential;
+    if (sens->has_obstacle) {
+        double* J = (double*)mkl_malloc((size_t)n * SENSITIVITY_N_OBSTACLE * sizeof(double), 64);
+        if (J) {
+            obstacle_jacobian(mesh, params, J);
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, SENSITIVITY_N_OBSTACLE, k, n,
+                        1.0, J, n, sens->dq, n, 0.0, sens->obstacle, SENSITIVITY_N_OBSTACLE);
+            mkl_free(J);
+        } else {
+            fprintf(stderr, "Warning: No memory for the obstacle gradients\n");
+            sens->has_obstacle = 0;
+        }
+    }
+    profiler_end();
+    
+    free(mass);
+    return sens;
+}
@@ -0,0 +1,807 @@
+#include "server.h"
+#include "job.h"
+#include "membrane_context.h"
+#include "planner.h"
+#include "profiler.h"
+#include "resources.h"
+#include "npy_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+typedef enum {
+    REPLY_TEXT,        // Valeurs propres seulement
+    REPLY_BINARY,      // Puis les modes en float64 (n x k, colonne-major)
+    REPLY_PATH         // Modes écrits dans un fichier .npy (k x n)
+} ReplyMode;
+
+typedef struct Server Server;
+
+typedef struct {
+    Server* server;
+    FILE* input;
+    int output_fd;
+    int is_socket;
+    pthread_t thread;
+    pthread_mutex_t write_lock;
+    int pending;               // Jobs soumis sans réponse (verrou du serveur)
+    int finished;
+} Client;
+
+typedef struct {
+    char id[64];
+    JobSpec spec;
+    SolverType solver;
+    double tolerance;
+    int max_iterations;
+    ReplyMode reply;
+    char output[512];
+    Client* client;
+    double submitted;
+} ServerJob;
+
+// File d'un groupe: le propriétaire prend en tête, les voleurs en queue
+typedef struct {
+    ServerJob* jobs[SERVER_QUEUE_DEPTH];
+    int head;
+    int count;
+} JobQueue;
+
+typedef enum { OPERATOR_EMPTY, OPERATOR_BUILDING, OPERATOR_READY } OperatorState;
+
+// Maillage et matrices d'un problème (N, p, w, q), partagés entre les groupes
+typedef struct {
+    OperatorState state;
+    JobSpec spec;
+    Mesh* mesh;
+    SparseMatrixCSR* A;
+    SparseMatrixCSR* B;
+    int refs;
+    long last_used;
+    int uncached;              // Hors cache (cache plein ou désactivé): libéré après usage
+} OperatorEntry;
+
+typedef struct {
+    Server* server;
+    int index;
+    ThreadGroup group;
+    pthread_t thread;
+    int started;
+    JobQueue queue;
+    long stolen;
+} Worker;
+
+struct Server {
+    ServerOptions options;
+    Worker workers[SERVER_MAX_WORKERS];
+    int n_workers;
+    int n_cores;
+    
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;   // job en file ou arrêt
+    pthread_cond_t client_idle;      // un client n'a plus de job en cours
+    pthread_cond_t operator_ready;   // fin d'un assemblage
+    int shutdown;
+    
+    OperatorEntry* operators;
+    int n_operators;
+    long clock;
+    long operator_hits;
+    long operator_misses;
+    long jobs_done;
+    long jobs_failed;
+    
+    int listen_fd;
+    Client* clients[SERVER_MAX_CLIENTS];
+    int n_clients;
+};
+
+void server_options_init(ServerOptions* options) {
+    memset(options, 0, sizeof(ServerOptions));
+    options->pin = 1;
+    options->operator_cache = 8;
+}
+
+// ============ REPONSES ============
+
+static int write_all(int fd, const void* data, size_t bytes) {
+    const char* p = (const char*)data;
+    while (bytes > 0) {
+        ssize_t written = write(fd, p, bytes);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += written;
+        bytes -= (size_t)written;
+    }
+    return 0;
+}
+
+// Une réponse complète (en-tête, ligne des valeurs, charge binaire) d'un seul tenant
+static void send_reply(Client* client, const char* header, const char* values,
+                       const void* payload, size_t bytes) {
+    pthread_mutex_lock(&client->write_lock);
+    int status = write_all(client->output_fd, header, strlen(header));
+    if (status == 0 && values) status = write_all(client->output_fd, values, strlen(values));
+    if (status == 0 && payload) status = write_all(client->output_fd, payload, bytes);
+    pthread_mutex_unlock(&client->write_lock);
+    if (status != 0) fprintf(stderr, "Warning: Client disconnected before its reply\n");
+}
+
+static void send_error(Client* client, const char* id, const char* message) {
+    char line[768];
+    snprintf(line, sizeof(line), "ERR id=%s %s\n", id[0] ? id : "-", message);
+    send_reply(client, line, NULL, NULL, 0);
+}
+
+// ============ OPERATEURS ASSEMBLES ============
+
+static int same_problem(const JobSpec* a, const JobSpec* b) {
+    return a->N == b->N && strcmp(a->tension, b->tension) == 0 &&
+           strcmp(a->density, b->density) == 0 && strcmp(a->potential, b->potential) == 0 &&
+           memcmp(a->obstacle, b->obstacle, sizeof(a->obstacle)) == 0;
+}
+
+static void clear_operator(OperatorEntry* entry) {
+    free_sparse_matrix(entry->A);
+    free_sparse_matrix(entry->B);
+    free_mesh(entry->mesh);
+    entry->A = entry->B = NULL;
+    entry->mesh = NULL;
+    entry->state = OPERATOR_EMPTY;
+}
+
+static int build_operator(OperatorEntry* entry) {
+    MembraneParams* params = create_default_params();
+    if (!params || job_spec_apply(&entry->spec, params) != 0) {
+        free_membrane_params(params);
+        return -1;
+    }
+    profiler_begin("server_assembly");
+    entry->mesh = create_mesh(entry->spec.N, params);
+    if (entry->mesh) {
+        entry->A = build_stiffness_matrix(entry->mesh);
+        entry->B = build_mass_matrix(entry->mesh);
+    }
+    profiler_end();
+    free_membrane_params(params);
+    return entry->mesh && entry->A && entry->B ? 0 : -1;
+}
+
+// Opérateur du problème: en cache, en cours d'assemblage par un autre groupe (attente) ou
+// assemblé ici. *reused: 1 si l'assemblage a été évité
+static OperatorEntry* acquire_operator(Server* server, const JobSpec* spec, int* reused) {
+    pthread_mutex_lock(&server->lock);
+    OperatorEntry* entry = NULL;
+    for (;;) {
+        entry = NULL;
+        for (int e = 0; e < server->n_operators; e++) {
+            OperatorEntry* candidate = &server->operators[e];
+            if (candidate->state != OPERATOR_EMPTY && same_problem(&candidate->spec, spec)) {
+                entry = candidate;
+                break;
+            }
+        }
+        if (!entry || entry->state == OPERATOR_READY) break;
+        pthread_cond_wait(&server->operator_ready, &server->lock);
+    }
+    
+    if (entry) {
+        entry->refs++;
+        entry->last_used = ++server->clock;
+        server->operator_hits++;
+        pthread_mutex_unlock(&server->lock);
+        *reused = 1;
+        return entry;
+    }
+    
+    // Emplacement libre, sinon le moins récemment utilisé qui n'est pas en service
+    for (int e = 0; e < server->n_operators; e++) {
+        OperatorEntry* candidate = &server->operators[e];
+        if (candidate->state == OPERATOR_EMPTY) {
+            entry = candidate;
+            break;
+        }
+        if (candidate->state == OPERATOR_READY && candidate->refs == 0 &&
+            (!entry || candidate->last_used < entry->last_used)) {
+            entry = candidate;
+        }
+    }
+    if (entry) {
+        clear_operator(entry);
+        entry->state = OPERATOR_BUILDING;
+    } else {
+        entry = (OperatorEntry*)calloc(1, sizeof(OperatorEntry));
+        if (!entry) {
+            pthread_mutex_unlock(&server->lock);
+            return NULL;
+        }
+        entry->uncached = 1;
+    }
+    entry->spec = *spec;
+    entry->refs = 1;
+    entry->last_used = ++server->clock;
+    server->operator_misses++;
+    pthread_mutex_unlock(&server->lock);
+    
+    *reused = 0;
+    int status = build_operator(entry);
+    
+    pthread_mutex_lock(&server->lock);
+    if (status != 0) {
+        clear_operator(entry);
+        entry->refs = 0;
+        if (entry->uncached) free(entry);
+        entry = NULL;
+    } else {
+        entry->state = OPERATOR_READY;
+    }
+    pthread_cond_broadcast(&server->operator_ready);
+    pthread_mutex_unlock(&server->lock);
+    return entry;
+}
+
+static void release_operator(Server* server, OperatorEntry* entry) {
+    pthread_mutex_lock(&server->lock);
+    entry->refs--;
+    int discard = entry->uncached;
+    pthread_mutex_unlock(&server->lock);
+    if (discard) {
+        clear_operator(entry);
+        free(entry);
+    }
+}
+
+// ============ FILES ET GROUPES ============
+
+static ServerJob* queue_pop_head(JobQueue* queue) {
+    if (queue->count == 0) return NULL;
+    ServerJob* job = queue->jobs[queue->head];
+    queue->head = (queue->head + 1) % SERVER_QUEUE_DEPTH;
+    queue->count--;
+    return job;
+}
+
+static ServerJob* queue_pop_tail(JobQueue* queue) {
+    if (queue->count == 0) return NULL;
+    queue->count--;
+    return queue->jobs[(queue->head + queue->count) % SERVER_QUEUE_DEPTH];
+}
+
+// Verrou du serveur tenu. Sa propre file d'abord, sinon vol dans la file la plus longue
+static ServerJob* next_job(Worker* worker) {
+    Server* server = worker->server;
+    ServerJob* job = queue_pop_head(&worker->queue);
+    if (job) return job;
+    
+    Worker* victim = NULL;
+    for (int w = 0; w < server->n_workers; w++) {
+        Worker* other = &server->workers[w];
+        if (other != worker && other->queue.count > 0 &&
+            (!victim || other->queue.count > victim->queue.count)) {
+            victim = other;
+        }
+    }
+    if (!victim) return NULL;
+    worker->stolen++;
+    return queue_pop_tail(&victim->queue);
+}
+
+// Les jobs d'une même taille vont au même groupe (arène déjà à la bonne taille); le vol
+// rééquilibre quand ce groupe est occupé
+static int submit_job(Server* server, ServerJob* job) {
+    pthread_mutex_lock(&server->lock);
+    Worker* target = &server->workers[job->spec.N % server->n_workers];
+    if (target->queue.count == SERVER_QUEUE_DEPTH) {
+        for (int w = 0; w < server->n_workers; w++) {
+            if (server->workers[w].queue.count < target->queue.count) target = &server->workers[w];
+        }
+    }
+    if (server->shutdown || target->queue.count == SERVER_QUEUE_DEPTH) {
+        pthread_mutex_unlock(&server->lock);
+        return -1;
+    }
+    JobQueue* queue = &target->queue;
+    queue->jobs[(queue->head + queue->count) % SERVER_QUEUE_DEPTH] = job;
+    queue->count++;
+    job->client->pending++;
+    pthread_cond_broadcast(&server->work_available);
+    pthread_mutex_unlock(&server->lock);
+    return 0;
+}
+
+static void format_values(const EigenResults* results, char* text, size_t size) {
+    size_t used = 0;
+    text[0] = '\0';
+    for (int i = 0; i < results->n_eigenvalues && used + 32 < size; i++) {
+        used += (size_t)snprintf(text + used, size - used, "%s%.17g", i > 0 ? " " : "",
+                                 results->eigenvalues[i]);
+    }
+    snprintf(text + used, size - used, "\n");
+}
+
+static int run_job(Worker* worker, MembraneContext* context, ServerJob* job) {
+    Server* server = worker->server;
+    Client* client = job->client;
+    int N = job->spec.N;
+    int k = job->spec.n_eigenvalues;
+    
+    MembraneSolveRequest request;
+    membrane_request_init(&request, N, k);
+    request.solver = job->solver;
+    request.eps = job->tolerance;
+    request.max_iterations = job->max_iterations;
+    request.memory_budget = server->options.memory_budget;
+    
+    // Solveur fixé avant la résolution pour être annoncé dans la réponse
+    if (request.solver == SOLVER_AUTO) {
+        PlanProblem problem = plan_problem_from_grid(N, k);
+        SolvePlan plan;
+        if (plan_solve(&problem, SOLVER_AUTO, request.memory_budget, &plan) != 0) {
+            send_error(client, job->id, "no solver fits in the memory budget");
+            return -1;
+        }
+        request.solver = plan.chosen;
+    }
+    
+    int reused = 0;
+    OperatorEntry* entry = acquire_operator(server, &job->spec, &reused);
+    if (!entry) {
+        send_error(client, job->id, "failed to build the operator");
+        return -1;
+    }
+    
+    double start = profiler_now();
+    const EigenResults* results = membrane_solve_operator(context, entry->mesh, entry->A,
+                                                          entry->B, &request);
+    double solve_seconds = profiler_now() - start;
+    release_operator(server, entry);
+    if (!results) {
+        send_error(client, job->id, "solve failed");
+        return -1;
+    }
+    
+    size_t bytes = (size_t)results->n_dof * results->n_eigenvalues * sizeof(double);
+    char extra[600] = "";
+    if (job->reply == REPLY_BINARY) {
+        snprintf(extra, sizeof(extra), " bytes=%zu", bytes);
+    } else if (job->reply == REPLY_PATH) {
+        size_t shape[2] = {(size_t)results->n_eigenvalues, (size_t)results->n_dof};
+        if (npy_save(job->output, NPY_FLOAT64, 2, shape, results->modes) != 0) {
+            send_error(client, job->id, "cannot write the modes file");
+            return -1;
+        }
+        snprintf(extra, sizeof(extra), " path=%s", job->output);
+    }
+    
+    char header[1024];
+    snprintf(header, sizeof(header),
+             "OK id=%s N=%d k=%d n=%d solver=%s operator=%s worker=%d iterations=%d "
+             "solve=%.6f latency=%.6f%s\n",
+             job->id, N, results->n_eigenvalues, results->n_dof, solver_type_name(request.solver),
+             reused ? "cached" : "built", worker->index, results->iterations, solve_seconds,
+             profiler_now() - job->submitted, extra);
+    char values[4096];
+    format_values(results, values, sizeof(values));
+    send_reply(client, header, values, job->reply == REPLY_BINARY ? results->modes : NULL, bytes);
+    return 0;
+}
+
+static void* worker_thread(void* arg) {
+    Worker* worker = (Worker*)arg;
+    Server* server = worker->server;
+    
+    // Threads MKL/OpenMP et arène du groupe: créés une fois, chauds pour tous les jobs
+    ThreadState previous;
+    thread_group_enter(&worker->group, server->options.pin, &previous);
+    MembraneContext* context = membrane_context_create(0);
+    
+    pthread_mutex_lock(&server->lock);
+    for (;;) {
+        ServerJob* job = next_job(worker);
+        if (!job) {
+            if (server->shutdown) break;
+            pthread_cond_wait(&server->work_available, &server->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&server->lock);
+    
+        int status = -1;
+        if (context) status = run_job(worker, context, job);
+        else send_error(job->client, job->id, "no solver context");
+    
+        pthread_mutex_lock(&server->lock);
+        if (status == 0) server->jobs_done++;
+        else server->jobs_failed++;
+        if (--job->client->pending == 0) pthread_cond_broadcast(&server->client_idle);
+        free(job);
+    }
+    pthread_mutex_unlock(&server->lock);
+    
+    membrane_context_destroy(context);
+    thread_group_leave(&previous);
+    return NULL;
+}
+
+// Cœurs répartis en tranches contiguës; plus de groupes que de cœurs: un cœur partagé chacun
+static void assign_groups(Server* server, const ThreadGroup* all) {
+    int n = all->n_cores;
+    int W = server->n_workers;
+    for (int w = 0; w < W; w++) {
+        ThreadGroup* group = &server->workers[w].group;
+        if (W > n) {
+            group->n_cores = 1;
+            group->cores[0] = all->cores[w % n];
+            continue;
+        }
+        int first = (int)((long)w * n / W);
+        int last = (int)((long)(w + 1) * n / W);
+        group->n_cores = last - first;
+        for (int c = first; c < last; c++) group->cores[c - first] = all->cores[c];
+    }
+}
+
+// ============ CLIENTS ============
+
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+static void reset_job(ServerJob* job) {
+    memset(job, 0, sizeof(ServerJob));
+    job_spec_init(&job->spec);
+    job->solver = SOLVER_AUTO;
+    job->reply = REPLY_TEXT;
+}
+
+// Clés propres au serveur; 1 si la clé n'en est pas une
+static int set_server_key(ServerJob* job, const char* key, const char* value) {
+    if (strcmp(key, "id") == 0) {
+        snprintf(job->id, sizeof(job->id), "%s", value);
+    } else if (strcmp(key, "solver") == 0) {
+        return parse_solver_type(value, &job->solver) != 0 ? -1 : 0;
+    } else if (strcmp(key, "tol") == 0) {
+        job->tolerance = atof(value);
+    } else if (strcmp(key, "max_iter") == 0) {
+        job->max_iterations = atoi(value);
+    } else if (strcmp(key, "output") == 0) {
+        snprintf(job->output, sizeof(job->output), "%s", value);
+    } else if (strcmp(key, "reply") == 0) {
+        if (strcmp(value, "text") == 0) job->reply = REPLY_TEXT;
+        else if (strcmp(value, "binary") == 0) job->reply = REPLY_BINARY;
+        else if (strcmp(value, "path") == 0) job->reply = REPLY_PATH;
+        else return -1;
+    } else {
+        return 1;
+    }
+    return 0;
+}
+
+static int parse_job_line(ServerJob* job, char* line) {
+    char* equal = strchr(line, '=');
+    if (!equal) return -1;
+    *equal = '\0';
+    char* key = trim(line);
+    char* value = trim(equal + 1);
+    int status = set_server_key(job, key, value);
+    if (status <= 0) return status;
+    return job_spec_set(&job->spec, key, value);
+}
+
+// Refus au dépôt plutôt qu'au moment de la résolution
+static const char* validate_job(const ServerJob* job) {
+    const JobSpec* spec = &job->spec;
+    if (spec->N < 2) return "grid size N must be at least 2";
+    if (spec->n_eigenvalues < 1 || spec->n_eigenvalues > spec->N * spec->N) {
+        return "number of eigenvalues out of range";
+    }
+    if (job->reply == REPLY_PATH && !job->output[0]) return "reply = path requires output = FILE";
+    
+    MembraneParams* params = create_default_params();
+    int status = params ? job_spec_apply(spec, params) : -1;
+    free_membrane_params(params);
+    return status != 0 ? "invalid coefficient expression" : NULL;
+}
+
+static void send_stats(Client* client) {
+    Server* server = client->server;
+    char line[512];
+    pthread_mutex_lock(&server->lock);
+    int queued = 0, cached = 0;
+    long stolen = 0;
+    for (int w = 0; w < server->n_workers; w++) {
+        queued += server->workers[w].queue.count;
+        stolen += server->workers[w].stolen;
+    }
+    for (int e = 0; e < server->n_operators; e++) {
+        if (server->operators[e].state == OPERATOR_READY) cached++;
+    }
+    snprintf(line, sizeof(line),
+             "STATS workers=%d cores=%d jobs=%ld failed=%ld queued=%d stolen=%ld "
+             "operators=%d hits=%ld misses=%ld\n",
+             server->n_workers, server->n_cores, server->jobs_done, server->jobs_failed, queued,
+             stolen, cached, server->operator_hits, server->operator_misses);
+    pthread_mutex_unlock(&server->lock);
+    send_reply(client, line, NULL, NULL, 0);
+}
+
+static void request_shutdown(Server* server) {
+    pthread_mutex_lock(&server->lock);
+    server->shutdown = 1;
+    pthread_cond_broadcast(&server->work_available);
+    pthread_mutex_unlock(&server->lock);
+    if (server->listen_fd >= 0) shutdown(server->listen_fd, SHUT_RDWR);   // Débloque accept()
+}
+
+// Lignes "cle = valeur" jusqu'à "solve"; les jobs d'un client s'exécutent en parallèle et
+// leurs réponses (identifiées par id) arrivent dans l'ordre de fin
+static void* client_thread(void* arg) {
+    Client* client = (Client*)arg;
+    Server* server = client->server;
+    char line[JOB_EXPR_MAX + 64];
+    char error[JOB_EXPR_MAX + 96] = "";
+    long sequence = 0;
+    
+    ServerJob job;
+    reset_job(&job);
+    while (fgets(line, sizeof(line), client->input)) {
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        char* content = trim(line);
+        if (*content == '\0') continue;
+    
+        if (strcmp(content, "stats") == 0) {
+            send_stats(client);
+            continue;
+        }
+        if (strcmp(content, "shutdown") == 0) {
+            request_shutdown(server);
+            break;
+        }
+        if (strcmp(content, "solve") != 0) {
+            // Première ligne invalide retenue, signalée au "solve"
+            if (!error[0] && parse_job_line(&job, content) != 0) {
+                snprintf(error, sizeof(error), "invalid line '%s'", content);
+            }
+            continue;
+        }
+    
+        sequence++;
+        if (!job.id[0]) snprintf(job.id, sizeof(job.id), "%ld", sequence);
+        const char* invalid = error[0] ? error : validate_job(&job);
+        ServerJob* queued = invalid ? NULL : (ServerJob*)malloc(sizeof(ServerJob));
+        if (queued) {
+            *queued = job;
+            queued->client = client;
+            queued->submitted = profiler_now();
+            if (submit_job(server, queued) != 0) {
+                free(queued);
+                invalid = "server busy or shutting down";
+            }
+        } else if (!invalid) {
+            invalid = "out of memory";
+        }
+        if (invalid) {
+            send_error(client, job.id, invalid);
+            pthread_mutex_lock(&server->lock);
+            server->jobs_failed++;
+            pthread_mutex_unlock(&server->lock);
+        }
+        reset_job(&job);
+        error[0] = '\0';
+    }
+    
+    // Réponses en attente envoyées avant de fermer
+    pthread_mutex_lock(&server->lock);
+    while (client->pending > 0) pthread_cond_wait(&server->client_idle, &server->lock);
+    client->finished = 1;
+    pthread_mutex_unlock(&server->lock);
+    return NULL;
+}
+
+static void close_client(Client* client) {
+    fclose(client->input);
+    if (client->is_socket) close(client->output_fd);
+    pthread_mutex_destroy(&client->write_lock);
+    free(client);
+}
+
+static Client* create_client(Server* server, int input_fd, int output_fd, int is_socket) {
+    Client* client = (Client*)calloc(1, sizeof(Client));
+    if (!client) return NULL;
+    client->input = fdopen(input_fd, "r");
+    if (!client->input) {
+        free(client);
+        return NULL;
+    }
+    client->server = server;
+    client->output_fd = output_fd;
+    client->is_socket = is_socket;
+    pthread_mutex_init(&client->write_lock, NULL);
+    return client;
+}
+
+// Clients terminés: threads rejoints, descripteurs fermés
+static void reap_clients(Server* server, int all) {
+    int kept = 0;
+    for (int c = 0; c < server->n_clients; c++) {
+        Client* client = server->clients[c];
+        pthread_mutex_lock(&server->lock);
+        int finished = client->finished;
+        pthread_mutex_unlock(&server->lock);
+        if (!finished && all) {
+            shutdown(client->output_fd, SHUT_RD);    // Débloque la lecture en cours
+            finished = 1;
+        }
+        if (finished) {
+            pthread_join(client->thread, NULL);
+            close_client(client);
+        } else {
+            server->clients[kept++] = client;
+        }
+    }
+    server->n_clients = kept;
+}
+
+static int open_socket(const char* path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Error: Socket path too long: %s\n", path);
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create socket: %s\n", strerror(errno));
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        fprintf(stderr, "Error: Cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void serve_socket(Server* server) {
+    while (!server->shutdown) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;                                   // Arrêt (socket fermée) ou erreur
+        }
+        reap_clients(server, 0);
+        // Descripteur à part pour les réponses: fclose de l'entrée et close de la sortie
+        // ferment chacun le leur (un numéro fermé deux fois peut déjà servir à un autre thread)
+        int output_fd = server->n_clients < SERVER_MAX_CLIENTS ? dup(fd) : -1;
+        Client* client = output_fd >= 0 ? create_client(server, fd, output_fd, 1) : NULL;
+        if (!client) {
+            const char* busy = "ERR id=- too many clients\n";
+            write_all(fd, busy, strlen(busy));
+            if (output_fd >= 0) close(output_fd);
+            close(fd);
+            continue;
+        }
+        if (pthread_create(&client->thread, NULL, client_thread, client) != 0) {
+            close_client(client);
+            continue;
+        }
+        server->clients[server->n_clients++] = client;
+    }
+    reap_clients(server, 1);
+}
+
+// ============ SERVEUR ============
+
+int run_server(const ServerOptions* options) {
+    Server* server = (Server*)calloc(1, sizeof(Server));
+    if (!server) {
+        fprintf(stderr, "Error: Failed to allocate server\n");
+        return -1;
+    }
+    server->options = *options;
+    server->listen_fd = -1;
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_cond_init(&server->work_available, NULL);
+    pthread_cond_init(&server->client_idle, NULL);
+    pthread_cond_init(&server->operator_ready, NULL);
+    
+    // Un client parti ne doit pas arrêter le serveur
+    signal(SIGPIPE, SIG_IGN);
+    
+    int use_stdin = !options->socket_path || strcmp(options->socket_path, "-") == 0;
+    int reply_fd = STDOUT_FILENO;
+    if (use_stdin) {
+        // Réponses sur la sortie standard d'origine, journal des solveurs sur stderr (ce qui
+        // attend encore dans le tampon de stdout compris: READY reste la première ligne)
+        reply_fd = dup(STDOUT_FILENO);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        fflush(stdout);
+    } else {
+        server->listen_fd = open_socket(options->socket_path);
+        if (server->listen_fd < 0) {
+            free(server);
+            return -1;
+        }
+    }
+    
+    ThreadGroup all;
+    server->n_cores = resources_detect(options->threads, &all);
+    server->n_workers = options->workers > 0 ? options->workers : (all.n_cores + 1) / 2;
+    if (server->n_workers > SERVER_MAX_WORKERS) server->n_workers = SERVER_MAX_WORKERS;
+    assign_groups(server, &all);
+    
+    if (options->operator_cache > 0) {
+        server->operators = (OperatorEntry*)calloc(options->operator_cache, sizeof(OperatorEntry));
+        if (server->operators) server->n_operators = options->operator_cache;
+    }
+    
+    int started = 0;
+    for (int w = 0; w < server->n_workers; w++) {
+        Worker* worker = &server->workers[w];
+        worker->server = server;
+        worker->index = w;
+        worker->started = pthread_create(&worker->thread, NULL, worker_thread, worker) == 0;
+        started += worker->started;
+    }
+    int status = 0;
+    if (started == 0) {
+        fprintf(stderr, "Error: Failed to start server workers\n");
+        status = -1;
+    } else if (use_stdin) {
+        char ready[128];
+        snprintf(ready, sizeof(ready), "READY workers=%d cores=%d\n", started, server->n_cores);
+        write_all(reply_fd, ready, strlen(ready));
+        Client* client = create_client(server, STDIN_FILENO, reply_fd, 0);
+        if (client) {
+            client_thread(client);
+            close_client(client);
+        }
+        request_shutdown(server);
+    } else {
+        printf("Serving on %s (%d worker groups, %d cores)\n", options->socket_path, started,
+               server->n_cores);
+        for (int w = 0; w < server->n_workers; w++) {
+            char cores[64];
+            format_core_list(&server->workers[w].group, cores, sizeof(cores));
+            printf("  Worker %d: cores %s\n", w, cores);
+        }
+        fflush(stdout);
+        serve_socket(server);
+    }
+    
+    // Files vidées par les groupes avant leur arrêt
+    request_shutdown(server);
+    for (int w = 0; w < server->n_workers; w++) {
+        if (server->workers[w].started) pthread_join(server->workers[w].thread, NULL);
+    }
+    
+    if (server->listen_fd >= 0) {
+        close(server->listen_fd);
+        unlink(options->socket_path);
+    }
+    if (use_stdin) close(reply_fd);
+    for (int e = 0; e < server->n_operators; e++) clear_operator(&server->operators[e]);
+    free(server->operators);
+    pthread_mutex_destroy(&server->lock);
+    pthread_cond_destroy(&server->work_available);
+    pthread_cond_destroy(&server->client_idle);
+    pthread_cond_destroy(&server->operator_ready);
+    free(server);
+    return status;
+}
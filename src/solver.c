@@ -1,9 +1,21 @@
 #include "solver.h"
+#include "npy_io.h"
+#include "lobpcg.h"
+#include "profiler.h"
+#include "planner.h"
+#include "symmetry.h"
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Définitions pour PI si non défini
 #ifndef PI
@@ -16,99 +28,212 @@ SolverConfig* create_solver_config(int n_eigenvalues) {
         fprintf(stderr, "Error: Failed to allocate solver config\n");
         return NULL;
     }
-    
+    solver_config_init(config, n_eigenvalues);
+    return config;
+}
+
+void solver_config_init(SolverConfig* config, int n_eigenvalues) {
     config->n_eigenvalues = n_eigenvalues;
     config->eps = 1e-10;
-    config->mkl_threads = 4;
-    
-    return config;
+    config->mkl_threads = 0;
+    config->eigenvector_file = NULL;
+    config->solver = SOLVER_DENSE;
+    config->max_iterations = 1000;
+    config->checkpoint_file = NULL;
+    config->checkpoint_interval = 50;
+    config->restart = 0;
+    config->on_eigenpair = NULL;
+    config->on_eigenpair_data = NULL;
+    config->mesh = NULL;
+    config->memory_budget = 0;
+    config->workspace = NULL;
+    config->symmetry = 1;
 }
 
 void free_solver_config(SolverConfig* config) {
     if (config) free(config);
 }
 
-EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B, 
-                                 SolverConfig* config) {
-    printf("\n=== SOLVING EIGENPROBLEM (DSYGV DENSE SOLVER) ===\n");
+static const char* solver_names[SOLVER_N_TYPES + 1] = {
+    "dense", "dense-partial", "banded", "lobpcg", "matrix-free", "auto"
+};
+
+int parse_solver_type(const char* name, SolverType* type) {
+    for (int t = 0; t <= SOLVER_N_TYPES; t++) {
+        if (strcmp(name, solver_names[t]) == 0) {
+            *type = (SolverType)t;
+            return 0;
+        }
+    }
+    fprintf(stderr, "Error: Unknown solver '%s' (expected dense, dense-partial, banded, "
+            "lobpcg, matrix-free or auto)\n", name);
+    return -1;
+}
+
+const char* solver_type_name(SolverType type) {
+    return type >= 0 && type <= SOLVER_N_TYPES ? solver_names[type] : "unknown";
+}
+
+int csr_bandwidth(const SparseMatrixCSR* mat) {
+    MKL_INT bandwidth = 0;
+    for (MKL_INT i = 0; i < mat->n_rows; i++) {
+        for (MKL_INT p = mat->row_index[i]; p < mat->row_index[i + 1]; p++) {
+            MKL_INT distance = mat->columns[p] > i ? mat->columns[p] - i : i - mat->columns[p];
+            if (distance > bandwidth) bandwidth = distance;
+        }
+    }
+    return (int)bandwidth;
+}
+
+int csr_is_diagonal(const SparseMatrixCSR* mat) {
+    for (MKL_INT i = 0; i < mat->n_rows; i++) {
+        for (MKL_INT p = mat->row_index[i]; p < mat->row_index[i + 1]; p++) {
+            if (mat->columns[p] != i && mat->values[p] != 0.0) return 0;
+        }
+    }
+    return 1;
+}
+
+// Projette un fichier .npy (float64, fortran_order, n x k) et renvoie le début des données
+static double* map_eigenvector_file(EigenResults* results, const char* filename,
+                                    int n, int k) {
+    char header[256];
+    size_t shape[2] = {(size_t)n, (size_t)k};
+    size_t header_len = npy_build_header(header, sizeof(header), NPY_FLOAT64, 1, 2, shape);
+    size_t total = header_len + (size_t)n * k * sizeof(double);
+    
+    int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open eigenvector file %s\n", filename);
+        return NULL;
+    }
     
-    clock_t start = clock();
-    int n = (int)A->n_rows;
-    int k = config->n_eigenvalues;
+    if (header_len == 0 || ftruncate(fd, (off_t)total) != 0 ||
+        pwrite(fd, header, header_len, 0) != (ssize_t)header_len) {
+        fprintf(stderr, "Error: Cannot size eigenvector file %s\n", filename);
+        close(fd);
+        return NULL;
+    }
     
-    if (k > n) {
-        printf("Warning: Requested %d eigenvalues but only %d DOF. Using %d instead.\n", 
-               k, n, n);
-        k = n;
+    void* mapping = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map eigenvector file %s\n", filename);
+        return NULL;
     }
     
-    printf("Problem size: %d x %d\n", n, n);
-    printf("Requested eigenvalues: %d\n", k);
+    results->mapping = mapping;
+    results->mapped_bytes = total;
     
-    // Allouer résultats
-    EigenResults* results = (EigenResults*)malloc(sizeof(EigenResults));
+    // En-tête de 64*m octets: les données restent alignées sur 64 octets
+    return (double*)((char*)mapping + header_len);
+}
+
+EigenResults* create_eigen_results(int n, int k, const char* backing_file) {
+    return create_eigen_results_in(n, k, backing_file, NULL);
+}
+
+EigenResults* create_eigen_results_in(int n, int k, const char* backing_file, Arena* arena) {
+    EigenResults* results = (EigenResults*)arena_calloc(arena, 1, sizeof(EigenResults));
     if (!results) {
         fprintf(stderr, "Error: Failed to allocate eigen results\n");
         return NULL;
     }
     
     results->n_eigenvalues = k;
-    results->eigenvalues = (double*)malloc(k * sizeof(double));
-    results->residuals = (double*)malloc(k * sizeof(double));
-    results->eigenvectors = (double**)malloc(k * sizeof(double*));
+    results->n_dof = n;
+    results->arena = arena;
+    results->eigenvalues = (double*)arena_alloc(arena, k * sizeof(double));
+    results->residuals = (double*)arena_calloc(arena, k, sizeof(double));
+    results->eigenvectors = (double**)arena_alloc(arena, k * sizeof(double*));
+    
+    if (backing_file) {
+        results->modes = map_eigenvector_file(results, backing_file, n, k);
+    } else {
+        results->modes = (double*)arena_alloc(arena, (size_t)n * k * sizeof(double));
+    }
     
-    if (!results->eigenvalues || !results->residuals || !results->eigenvectors) {
+    if (!results->eigenvalues || !results->residuals || !results->eigenvectors ||
+        !results->modes) {
         fprintf(stderr, "Error: Failed to allocate eigen results arrays\n");
         free_eigen_results(results);
         return NULL;
     }
     
     for (int i = 0; i < k; i++) {
-        results->eigenvectors[i] = (double*)malloc(n * sizeof(double));
-        if (!results->eigenvectors[i]) {
-            fprintf(stderr, "Error: Failed to allocate eigenvector %d\n", i);
-            free_eigen_results(results);
-            return NULL;
-        }
-        results->residuals[i] = 0.0;  // DSYGV ne calcule pas de résidu
+        results->eigenvectors[i] = results->modes + (size_t)i * n;
     }
     
-    // ===== CONVERSION CSR -> DENSE (symétrique) =====
+    return results;
+}
+
+// Conversion CSR -> dense (symétrique, colonne-major) de la paire (A, B)
+static int densify_pair(const SparseMatrixCSR* A, const SparseMatrixCSR* B, int n,
+                        Arena* workspace, double** A_out, double** B_out) {
     printf("Converting CSR matrices to dense format...\n");
+    profiler_begin("densify");
     
-    double* A_dense = (double*)calloc(n * n, sizeof(double));
-    double* B_dense = (double*)calloc(n * n, sizeof(double));
+    double* A_dense = (double*)arena_calloc(workspace, (size_t)n * n, sizeof(double));
+    double* B_dense = (double*)arena_calloc(workspace, (size_t)n * n, sizeof(double));
     
     if (!A_dense || !B_dense) {
         fprintf(stderr, "Error: Failed to allocate dense matrices\n");
-        free(A_dense);
-        free(B_dense);
-        free_eigen_results(results);
-        return NULL;
+        arena_free(workspace, A_dense);
+        arena_free(workspace, B_dense);
+        profiler_end();
+        return -1;
     }
     
-    // Convertir A (CSR -> dense, symétrique)
-    for (int i = 0; i < n; i++) {
-        for (MKL_INT j = A->row_index[i]; j < A->row_index[i+1]; j++) {
-            int col = (int)A->columns[j];
-            A_dense[i * n + col] = A->values[j];
-            // Pour symétrie, copier aussi l'élément symétrique
-            if (col != i) {
-                A_dense[col * n + i] = A->values[j];
+    // Pour symétrie, copier aussi l'élément symétrique
+    const SparseMatrixCSR* pair[2] = {A, B};
+    double* dense[2] = {A_dense, B_dense};
+    for (int m = 0; m < 2; m++) {
+        for (int i = 0; i < n; i++) {
+            for (MKL_INT j = pair[m]->row_index[i]; j < pair[m]->row_index[i+1]; j++) {
+                int col = (int)pair[m]->columns[j];
+                dense[m][(size_t)i * n + col] = pair[m]->values[j];
+                if (col != i) {
+                    dense[m][(size_t)col * n + i] = pair[m]->values[j];
+                }
             }
         }
     }
     
-    // Convertir B (diagonale -> dense, symétrique)
-    // NOTE: B est diagonal, mais on le convertit en dense pour DSYGV
-    for (int i = 0; i < n; i++) {
-        for (MKL_INT j = B->row_index[i]; j < B->row_index[i+1]; j++) {
-            int col = (int)B->columns[j];
-            B_dense[i * n + col] = B->values[j];
-            if (col != i) {
-                B_dense[col * n + i] = B->values[j];
-            }
-        }
+    profiler_add_work(0.0, 2.0 * n * (double)n * sizeof(double));
+    profiler_end();
+    
+    *A_out = A_dense;
+    *B_out = B_dense;
+    return 0;
+}
+
+static EigenResults* solve_dense(SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                 SolverConfig* config) {
+    printf("\n=== SOLVING EIGENPROBLEM (DSYGV DENSE SOLVER) ===\n");
+    
+    double start = profiler_now();
+    Arena* workspace = config->workspace;
+    int n = (int)A->n_rows;
+    int k = config->n_eigenvalues;
+    
+    if (k > n) {
+        printf("Warning: Requested %d eigenvalues but only %d DOF. Using %d instead.\n", 
+               k, n, n);
+        k = n;
+    }
+    
+    printf("Problem size: %d x %d\n", n, n);
+    printf("Requested eigenvalues: %d\n", k);
+    
+    // Allouer résultats (résidus à zéro: DSYGV ne calcule pas de résidu)
+    EigenResults* results = create_eigen_results_in(n, k, config->eigenvector_file, workspace);
+    if (!results) return NULL;
+    
+    double* A_dense = NULL;
+    double* B_dense = NULL;
+    if (densify_pair(A, B, n, workspace, &A_dense, &B_dense) != 0) {
+        free_eigen_results(results);
+        return NULL;
     }
     
     // ===== RÉSOLUTION AVEC DSYGV =====
@@ -122,11 +247,11 @@ EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B,
     MKL_INT info;
     
     // Tableau complet des valeurs propres (n éléments)
-    double* all_eigenvalues = (double*)malloc(n * sizeof(double));
+    double* all_eigenvalues = (double*)arena_alloc(workspace, n * sizeof(double));
     if (!all_eigenvalues) {
         fprintf(stderr, "Error: Failed to allocate eigenvalues array\n");
-        free(A_dense);
-        free(B_dense);
+        arena_free(workspace, A_dense);
+        arena_free(workspace, B_dense);
         free_eigen_results(results);
         return NULL;
     }
@@ -146,19 +271,24 @@ EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B,
         lwork = (MKL_INT)work_query;
     }
     
-    double* work = (double*)malloc(lwork * sizeof(double));
+    double* work = (double*)arena_alloc(workspace, lwork * sizeof(double));
     if (!work) {
         fprintf(stderr, "Error: Failed to allocate workspace\n");
-        free(A_dense);
-        free(B_dense);
-        free(all_eigenvalues);
+        arena_free(workspace, A_dense);
+        arena_free(workspace, B_dense);
+        arena_free(workspace, all_eigenvalues);
         free_eigen_results(results);
         return NULL;
     }
     
     // Résoudre le problème complet
+    // Coût estimé: Cholesky n³/3, réduction n³, tridiagonalisation 4n³/3,
+    // QR implicite avec vecteurs ~6n³, retour aux vecteurs 4n³/3 + n³ (≈ 11n³)
+    profiler_begin("dsygv");
     dsygv(&itype, &jobz, &uplo, &n, A_dense, &lda, B_dense, &ldb,
           all_eigenvalues, work, &lwork, &info);
+    profiler_add_work(11.0 * n * (double)n * n, 2.0 * n * (double)n * sizeof(double));
+    profiler_end();
     
     printf("DSYGV completed with info = %ld\n", (long)info);
     
@@ -168,24 +298,17 @@ EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B,
     } else {
         // DSYGV trie les valeurs propres dans l'ordre croissant
         // On prend les k plus petites (les premiers modes)
+        memcpy(results->eigenvalues, all_eigenvalues, k * sizeof(double));
+        
+        // Les vecteurs propres sont les k premières colonnes (colonne-major)
+        // de A_dense: un seul bloc contigu n x k
+        memcpy(results->modes, A_dense, (size_t)n * k * sizeof(double));
+        
+        // Normaliser les vecteurs propres (optionnel mais utile)
         for (int i = 0; i < k; i++) {
-            results->eigenvalues[i] = all_eigenvalues[i];
-            
-            // Les vecteurs propres sont stockés dans les colonnes de A_dense
-            for (int j = 0; j < n; j++) {
-                results->eigenvectors[i][j] = A_dense[j * n + i];
-            }
-            
-            // Normaliser le vecteur propre (optionnel mais utile)
-            double norm = 0.0;
-            for (int j = 0; j < n; j++) {
-                norm += results->eigenvectors[i][j] * results->eigenvectors[i][j];
-            }
-            norm = sqrt(norm);
+            double norm = cblas_dnrm2(n, results->eigenvectors[i], 1);
             if (norm > 1e-12) {
-                for (int j = 0; j < n; j++) {
-                    results->eigenvectors[i][j] /= norm;
-                }
+                cblas_dscal(n, 1.0 / norm, results->eigenvectors[i], 1);
             }
         }
         
@@ -193,13 +316,12 @@ EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B,
     }
     
     // ===== NETTOYAGE =====
-    free(A_dense);
-    free(B_dense);
-    free(all_eigenvalues);
-    free(work);
+    arena_free(workspace, A_dense);
+    arena_free(workspace, B_dense);
+    arena_free(workspace, all_eigenvalues);
+    arena_free(workspace, work);
     
-    clock_t end = clock();
-    results->computation_time = ((double)(end - start)) / CLOCKS_PER_SEC;
+    results->computation_time = profiler_now() - start;
     results->iterations = 1;  // DSYGV est direct
     
     printf("Computation time: %.3f seconds\n", results->computation_time);
@@ -207,31 +329,433 @@ EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B,
     return results;
 }
 
-void free_eigen_results(EigenResults* results) {
-    if (!results) return;
+// Normalisation 2 des colonnes (comme DSYGV, dont les vecteurs sont B-normés)
+static void normalize_modes(EigenResults* results, int n) {
+    for (int i = 0; i < results->n_eigenvalues; i++) {
+        double norm = cblas_dnrm2(n, results->eigenvectors[i], 1);
+        if (norm > 1e-12) {
+            cblas_dscal(n, 1.0 / norm, results->eigenvectors[i], 1);
+        }
+    }
+}
+
+static EigenResults* solve_dense_partial(SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                         SolverConfig* config) {
+    printf("\n=== SOLVING EIGENPROBLEM (DSYGVX PARTIAL DENSE SOLVER) ===\n");
+    
+    double start = profiler_now();
+    Arena* workspace = config->workspace;
+    int n = (int)A->n_rows;
+    int k = config->n_eigenvalues < n ? config->n_eigenvalues : n;
+    printf("Problem size: %d x %d, eigenpairs 1..%d\n", n, n, k);
     
-    if (results->eigenvalues) {
-        free(results->eigenvalues);
-        results->eigenvalues = NULL;
+    EigenResults* results = create_eigen_results_in(n, k, config->eigenvector_file, workspace);
+    if (!results) return NULL;
+    
+    double* A_dense = NULL;
+    double* B_dense = NULL;
+    if (densify_pair(A, B, n, workspace, &A_dense, &B_dense) != 0) {
+        free_eigen_results(results);
+        return NULL;
     }
     
-    if (results->residuals) {
-        free(results->residuals);
-        results->residuals = NULL;
+    char jobz = 'V', range = 'I', uplo = 'U';
+    MKL_INT itype = 1, il = 1, iu = k, lda = n, m = 0, info = 0;
+    double vl = 0.0, vu = 0.0;
+    double abstol = 2.0 * dlamch("S");   // Précision maximale de la bisection
+    
+    double* values = (double*)arena_alloc(workspace, n * sizeof(double));
+    MKL_INT* iwork = (MKL_INT*)arena_alloc(workspace, 5 * (size_t)n * sizeof(MKL_INT));
+    MKL_INT* ifail = (MKL_INT*)arena_alloc(workspace, n * sizeof(MKL_INT));
+    MKL_INT lwork = -1;
+    double work_query = 0.0;
+    double* work = NULL;
+    if (values && iwork && ifail) {
+        dsygvx(&itype, &jobz, &range, &uplo, &n, A_dense, &lda, B_dense, &lda, &vl, &vu,
+               &il, &iu, &abstol, &m, values, results->modes, &lda, &work_query, &lwork,
+               iwork, ifail, &info);
+        lwork = info == 0 && work_query > 8.0 * n ? (MKL_INT)work_query : 8 * n;
+        work = (double*)arena_alloc(workspace, lwork * sizeof(double));
+    }
+    if (!values || !iwork || !ifail || !work) {
+        fprintf(stderr, "Error: Failed to allocate DSYGVX workspace\n");
+        arena_free(workspace, values);
+        arena_free(workspace, iwork);
+        arena_free(workspace, ifail);
+        arena_free(workspace, A_dense);
+        arena_free(workspace, B_dense);
+        free_eigen_results(results);
+        return NULL;
+    }
+    
+    // Cholesky n³/3, réduction n³, tridiagonalisation 4n³/3, retour aux vecteurs 4n²k
+    profiler_begin("dsygvx");
+    dsygvx(&itype, &jobz, &range, &uplo, &n, A_dense, &lda, B_dense, &lda, &vl, &vu,
+           &il, &iu, &abstol, &m, values, results->modes, &lda, work, &lwork,
+           iwork, ifail, &info);
+    profiler_add_work((8.0 / 3.0) * n * (double)n * n + 4.0 * n * (double)n * k,
+                      2.0 * n * (double)n * sizeof(double));
+    profiler_end();
+    
+    if (info < 0 || m < k) {
+        printf("Warning: DSYGVX failed with error code %ld (%ld pairs)\n", (long)info, (long)m);
+        results->n_eigenvalues = 0;
+    } else {
+        if (info > 0) printf("Warning: DSYGVX: %ld eigenvectors did not converge\n", (long)info);
+        memcpy(results->eigenvalues, values, k * sizeof(double));
+        normalize_modes(results, n);
+        printf("\nSuccessfully computed %d eigenvalues:\n", k);
     }
     
-    if (results->eigenvectors) {
-        for (int i = 0; i < results->n_eigenvalues; i++) {
-            if (results->eigenvectors[i]) {
-                free(results->eigenvectors[i]);
-                results->eigenvectors[i] = NULL;
+    arena_free(workspace, values);
+    arena_free(workspace, iwork);
+    arena_free(workspace, ifail);
+    arena_free(workspace, work);
+    arena_free(workspace, A_dense);
+    arena_free(workspace, B_dense);
+    
+    results->computation_time = profiler_now() - start;
+    results->iterations = 1;
+    printf("Computation time: %.3f seconds\n", results->computation_time);
+    return results;
+}
+
+// ============ SOLVEUR BANDE ============
+
+// Itérations inverses par paire: 2 suffisent en général, le résidu décide
+#define BANDED_MAX_INVERSE_ITERATIONS 6
+#define BANDED_RESIDUAL_TOL 1e-10
+
+// y = C x avec C = D^(-1/2) A D^(-1/2), d = diag(B)^(-1/2)
+static void scaled_apply(const SparseMatrixCSR* A, const double* d, const double* x, double* y) {
+    #pragma omp parallel for schedule(static)
+    for (MKL_INT i = 0; i < A->n_rows; i++) {
+        double sum = 0.0;
+        for (MKL_INT p = A->row_index[i]; p < A->row_index[i + 1]; p++) {
+            sum += A->values[p] * d[A->columns[p]] * x[A->columns[p]];
+        }
+        y[i] = d[i] * sum;
+    }
+}
+
+// Stockage bande général de C - sigma I pour DGBTRF (kl = ku = kd, ldab = 3kd + 1)
+static void fill_shifted_band(const SparseMatrixCSR* A, const double* d, int kd, double sigma,
+                              double* band) {
+    int n = (int)A->n_rows;
+    int ldab = 3 * kd + 1;
+    memset(band, 0, (size_t)ldab * n * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        for (MKL_INT p = A->row_index[i]; p < A->row_index[i + 1]; p++) {
+            int j = (int)A->columns[p];
+            band[(size_t)j * ldab + 2 * kd + i - j] += A->values[p] * d[i] * d[j];
+        }
+        band[(size_t)i * ldab + 2 * kd] -= sigma;
+    }
+}
+
+// B diagonale: problème standard C y = lambda y, x = D^(-1/2) y.
+// Valeurs propres par DSBEVX sur la bande (O(n kd) octets, sans matrice n x n),
+// vecteurs par itération inverse sur la factorisation LU bande de C - lambda I
+static EigenResults* solve_banded(SparseMatrixCSR* A, SparseMatrixCSR* B, SolverConfig* config) {
+    printf("\n=== SOLVING EIGENPROBLEM (DSBEVX BANDED SOLVER) ===\n");
+    
+    double start = profiler_now();
+    Arena* workspace = config->workspace;
+    int n = (int)A->n_rows;
+    int k = config->n_eigenvalues < n ? config->n_eigenvalues : n;
+    int kd = csr_bandwidth(A);
+    printf("Problem size: %d, half bandwidth: %d, eigenpairs 1..%d\n", n, kd, k);
+    
+    EigenResults* results = create_eigen_results_in(n, k, config->eigenvector_file, workspace);
+    if (!results) return NULL;
+    
+    int ldab = kd + 1;
+    int ldlu = 3 * kd + 1;
+    double* d = (double*)arena_alloc(workspace, n * sizeof(double));
+    double* sym_band = (double*)arena_calloc(workspace, (size_t)ldab * n, sizeof(double));
+    double* lu_band = (double*)arena_alloc(workspace, (size_t)ldlu * n * sizeof(double));
+    double* values = (double*)arena_alloc(workspace, n * sizeof(double));
+    double* work = (double*)arena_alloc(workspace, 7 * (size_t)n * sizeof(double));
+    double* cy = (double*)arena_alloc(workspace, n * sizeof(double));
+    MKL_INT* iwork = (MKL_INT*)arena_alloc(workspace, 5 * (size_t)n * sizeof(MKL_INT));
+    MKL_INT* ifail = (MKL_INT*)arena_alloc(workspace, n * sizeof(MKL_INT));
+    MKL_INT* ipiv = (MKL_INT*)arena_alloc(workspace, n * sizeof(MKL_INT));
+    
+    int status = 0;
+    if (!d || !sym_band || !lu_band || !values || !work || !cy || !iwork || !ifail ||
+        !ipiv) {
+        fprintf(stderr, "Error: Failed to allocate banded solver workspace\n");
+        status = -1;
+    }
+    
+    for (int i = 0; status == 0 && i < n; i++) {
+        double b_ii = 0.0;
+        for (MKL_INT p = B->row_index[i]; p < B->row_index[i + 1]; p++) {
+            if (B->columns[p] == i) b_ii = B->values[p];
+        }
+        if (b_ii <= 0.0) {
+            fprintf(stderr, "Error: Mass matrix is not positive at row %d\n", i);
+            status = -1;
+        } else {
+            d[i] = 1.0 / sqrt(b_ii);
+        }
+    }
+    
+    // ===== VALEURS PROPRES: tridiagonalisation de la bande + bisection =====
+    MKL_INT m = 0, info = 0;
+    if (status == 0) {
+        // Triangle supérieur: sym_band[kd + i - j + j*ldab] = C(i, j), i <= j
+        for (int i = 0; i < n; i++) {
+            for (MKL_INT p = A->row_index[i]; p < A->row_index[i + 1]; p++) {
+                int j = (int)A->columns[p];
+                if (j >= i) sym_band[(size_t)j * ldab + kd + i - j] += A->values[p] * d[i] * d[j];
+            }
+        }
+        
+        char jobz = 'N', range = 'I', uplo = 'U';
+        MKL_INT n_mkl = n, kd_mkl = kd, ldab_mkl = ldab, il = 1, iu = k, ldq = 1;
+        double vl = 0.0, vu = 0.0, dummy = 0.0;
+        double abstol = 2.0 * dlamch("S");
+        profiler_begin("dsbevx");
+        dsbevx(&jobz, &range, &uplo, &n_mkl, &kd_mkl, sym_band, &ldab_mkl, &dummy, &ldq,
+               &vl, &vu, &il, &iu, &abstol, &m, values, &dummy, &ldq, work, iwork, ifail, &info);
+        profiler_add_work(6.0 * n * (double)n * kd, (double)ldab * n * sizeof(double));
+        profiler_end();
+        if (info != 0 || m < k) {
+            printf("Warning: DSBEVX failed with error code %ld (%ld values)\n", (long)info, (long)m);
+            status = -1;
+        }
+    }
+    
+    // ===== VECTEURS PROPRES: itération inverse, orthogonalisés contre les précédents =====
+    double max_residual = 0.0;
+    double factored_shift = NAN;
+    int total_iterations = 0;
+    int iteration_phase = status == 0;
+    if (iteration_phase) profiler_begin("inverse_iteration");
+    for (int e = 0; status == 0 && e < k; e++) {
+        double lambda = values[e];
+        double scale = fabs(lambda) > 1.0 ? fabs(lambda) : 1.0;
+        
+        // Une factorisation par groupe de valeurs confondues (modes dégénérés)
+        if (!(fabs(lambda - factored_shift) <= 1e-10 * scale)) {
+            double sigma = lambda + 1e-13 * scale;
+            MKL_INT n_mkl = n, kl = kd, ldlu_mkl = ldlu;
+            fill_shifted_band(A, d, kd, sigma, lu_band);
+            dgbtrf(&n_mkl, &n_mkl, &kl, &kl, lu_band, &ldlu_mkl, ipiv, &info);
+            profiler_add_work(2.0 * n * (double)kd * (2.0 * kd + 1.0),
+                              (double)ldlu * n * sizeof(double));
+            if (info < 0) {
+                fprintf(stderr, "Error: DGBTRF failed with error code %ld\n", (long)info);
+                status = -1;
+                break;
+            }
+            factored_shift = lambda;
+        }
+        
+        // Départ pseudo-aléatoire déterministe
+        double* x = results->eigenvectors[e];
+        uint64_t seed = 0x9E3779B97F4A7C15ULL * (uint64_t)(e + 1);
+        for (int i = 0; i < n; i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            x[i] = (double)(seed >> 11) / 9007199254740992.0 - 0.5;
+        }
+        
+        double residual = INFINITY;
+        for (int it = 0; it < BANDED_MAX_INVERSE_ITERATIONS && residual > BANDED_RESIDUAL_TOL; it++) {
+            char trans = 'N';
+            MKL_INT n_mkl = n, kl = kd, nrhs = 1, ldlu_mkl = ldlu;
+            dgbtrs(&trans, &n_mkl, &kl, &kl, &nrhs, lu_band, &ldlu_mkl, ipiv, x, &n_mkl, &info);
+            
+            // Modes déjà calculés retirés (Gram-Schmidt modifié), puis normalisation
+            for (int pass = 0; pass < 2; pass++) {
+                for (int j = 0; j < e; j++) {
+                    double dot = cblas_ddot(n, results->eigenvectors[j], 1, x, 1);
+                    cblas_daxpy(n, -dot, results->eigenvectors[j], 1, x, 1);
+                }
+            }
+            double norm = cblas_dnrm2(n, x, 1);
+            if (!(norm > 0.0)) {
+                status = -1;
+                break;
             }
+            cblas_dscal(n, 1.0 / norm, x, 1);
+            
+            scaled_apply(A, d, x, cy);
+            cblas_daxpy(n, -lambda, x, 1, cy, 1);
+            residual = cblas_dnrm2(n, cy, 1) / scale;
+            total_iterations++;
+        }
+        profiler_add_work(4.0 * n * (double)kd * BANDED_MAX_INVERSE_ITERATIONS, 0.0);
+        results->eigenvalues[e] = lambda;
+        results->residuals[e] = residual;
+        if (residual > max_residual) max_residual = residual;
+    }
+    if (iteration_phase) profiler_end();
+    
+    if (status == 0) {
+        // Retour au problème généralisé: x = D^(-1/2) y
+        for (int e = 0; e < k; e++) {
+            double* x = results->eigenvectors[e];
+            for (int i = 0; i < n; i++) x[i] *= d[i];
+        }
+        normalize_modes(results, n);
+        printf("\nSuccessfully computed %d eigenvalues (max relative residual %.2e)\n",
+               k, max_residual);
+    } else {
+        results->n_eigenvalues = 0;
+    }
+    
+    arena_free(workspace, d);
+    arena_free(workspace, sym_band);
+    arena_free(workspace, lu_band);
+    arena_free(workspace, values);
+    arena_free(workspace, work);
+    arena_free(workspace, cy);
+    arena_free(workspace, iwork);
+    arena_free(workspace, ifail);
+    arena_free(workspace, ipiv);
+    
+    results->computation_time = profiler_now() - start;
+    results->iterations = total_iterations;
+    printf("Computation time: %.3f seconds\n", results->computation_time);
+    return results;
+}
+
+static EigenResults* dispatch_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B,
+                                           SolverConfig* config) {
+    SolverType solver = config->solver;
+    
+    // Coefficients invariants par symétrie: classes indépendantes (sans maillage, donc sans
+    // nouvelle réduction). L'état d'un checkpoint porte sur la grille complète
+    if (config->symmetry && config->mesh && !config->checkpoint_file) {
+        int symmetries = detect_mesh_symmetries(config->mesh, SYMMETRY_TOLERANCE);
+        if (symmetries) {
+            profiler_begin("symmetric_solve");
+            EigenResults* results = solve_symmetric_eigenproblem(symmetries, config);
+            profiler_end();
+            return results;
+        }
+    }
+    
+    if (solver == SOLVER_MATRIX_FREE) {
+        if (!config->mesh) {
+            fprintf(stderr, "Error: The matrix-free solver needs the problem mesh\n");
+            return NULL;
+        }
+        int n = config->mesh->total_points;
+        int k = config->n_eigenvalues < n ? config->n_eigenvalues : n;
+        if (3 * lobpcg_block_size(k) <= n) {
+            profiler_begin("matrix_free");
+            EigenResults* results = solve_lobpcg_matrix_free(config->mesh, config);
+            profiler_end();
+            return results;
+        }
+        if (!A || !B) {
+            fprintf(stderr, "Error: %d DOF is too small for the matrix-free solver\n", n);
+            return NULL;
+        }
+        printf("Warning: %d DOF is too small for LOBPCG with %d modes, using the dense solver\n",
+               n, k);
+        solver = SOLVER_DENSE;
+    }
+    
+    if (!A || !B) {
+        fprintf(stderr, "Error: Solver %s needs assembled matrices\n", solver_type_name(solver));
+        return NULL;
+    }
+    int n = (int)A->n_rows;
+    int k = config->n_eigenvalues < n ? config->n_eigenvalues : n;
+    
+    // Sans choix explicite: plan sur la taille, la bande et la mémoire disponible
+    if (solver == SOLVER_AUTO) {
+        PlanProblem problem = plan_problem_from_matrices(A, B, k);
+        SolvePlan plan;
+        int status = plan_solve(&problem, SOLVER_AUTO, config->memory_budget, &plan);
+        print_solve_plan(&plan);
+        if (status != 0) return NULL;
+        solver = plan.chosen;
+    }
+    
+    if (solver == SOLVER_LOBPCG) {
+        if (3 * lobpcg_block_size(k) <= n) {
+            profiler_begin("lobpcg");
+            EigenResults* results = solve_lobpcg(A, B, config);
+            profiler_end();
+            return results;
         }
-        free(results->eigenvectors);
-        results->eigenvectors = NULL;
+        printf("Warning: %d DOF is too small for LOBPCG with %d modes, using the dense solver\n",
+               n, k);
+        solver = SOLVER_DENSE;
+    }
+    
+    if (solver == SOLVER_BANDED && !csr_is_diagonal(B)) {
+        printf("Warning: The banded solver needs a diagonal mass matrix, using dense-partial\n");
+        solver = SOLVER_DENSE_PARTIAL;
+    }
+    
+    EigenResults* results;
+    profiler_begin(solver_type_name(solver));
+    if (solver == SOLVER_BANDED) {
+        results = solve_banded(A, B, config);
+    } else if (solver == SOLVER_DENSE_PARTIAL) {
+        results = solve_dense_partial(A, B, config);
+    } else {
+        results = solve_dense(A, B, config);
+    }
+    profiler_end();
+    if (results) stream_eigenpairs(config, results, 0, results->computation_time);
+    return results;
+}
+
+EigenResults* solve_eigenproblem(SparseMatrixCSR* A, SparseMatrixCSR* B, 
+                                 SolverConfig* config) {
+    if (config->mkl_threads <= 0) return dispatch_eigenproblem(A, B, config);
+    
+    // Réglage propre au thread appelant, rétabli après la résolution
+    int previous_mkl = mkl_set_num_threads_local(config->mkl_threads);
+#ifdef _OPENMP
+    int previous_omp = omp_get_max_threads();
+    omp_set_num_threads(config->mkl_threads);
+#endif
+    EigenResults* results = dispatch_eigenproblem(A, B, config);
+#ifdef _OPENMP
+    omp_set_num_threads(previous_omp);
+#endif
+    mkl_set_num_threads_local(previous_mkl);
+    return results;
+}
+
+void stream_eigenpairs(const SolverConfig* config, const EigenResults* results,
+                       int first, double elapsed) {
+    if (!config->on_eigenpair) return;
+    for (int i = first; i < results->n_eigenvalues; i++) {
+        Eigenpair pair = {i, results->n_dof, results->eigenvalues[i], results->residuals[i],
+                          results->eigenvectors[i], elapsed};
+        config->on_eigenpair(&pair, config->on_eigenpair_data);
+    }
+}
+
+void free_eigen_results(EigenResults* results) {
+    if (!results) return;
+    
+    // Sans effet dans une arène, sauf pour une projection de fichier
+    Arena* arena = results->arena;
+    arena_free(arena, results->eigenvalues);
+    arena_free(arena, results->residuals);
+    arena_free(arena, results->eigenvectors);
+    if (results->mapping) {
+        munmap(results->mapping, results->mapped_bytes);
+    } else {
+        arena_free(arena, results->modes);
     }
+    results->eigenvalues = NULL;
+    results->residuals = NULL;
+    results->eigenvectors = NULL;
+    results->mapping = NULL;
+    results->modes = NULL;
     
-    free(results);
+    arena_free(arena, results);
 }
 
 void print_eigenvalues(EigenResults* results, int n_to_print) {
@@ -0,0 +1,162 @@
+#include "sparsity.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+SparsityPattern* compute_sparsity_pattern(const SparseMatrixCSR* mat, int resolution) {
+    SparsityPattern* pattern = (SparsityPattern*)calloc(1, sizeof(SparsityPattern));
+    if (!pattern) {
+        fprintf(stderr, "Error: Failed to allocate sparsity pattern\n");
+        return NULL;
+    }
+    
+    MKL_INT n_rows = mat->n_rows;
+    MKL_INT n_cols = mat->n_cols;
+    int R = (int)(n_rows < resolution ? n_rows : resolution);
+    int C = (int)(n_cols < resolution ? n_cols : resolution);
+    if (R < 1) R = 1;
+    if (C < 1) C = 1;
+    
+    pattern->image_rows = R;
+    pattern->image_cols = C;
+    pattern->n_rows = n_rows;
+    pattern->n_cols = n_cols;
+    pattern->nnz = mat->nnz;
+    pattern->counts = (uint32_t*)calloc((size_t)R * C, sizeof(uint32_t));
+    if (!pattern->counts) {
+        fprintf(stderr, "Error: Failed to allocate %d x %d density image\n", R, C);
+        free(pattern);
+        return NULL;
+    }
+    
+    MKL_INT lower = 0, upper = 0, min_nnz = n_cols, max_nnz = 0;
+    MKL_INT empty = 0, missing = 0;
+    long long profile = 0;
+    uint32_t max_count = 0;
+    
+    #pragma omp parallel
+    {
+        long long histogram[SPARSITY_HISTOGRAM_BINS] = {0};
+        
+        // Chaque ligne de l'image couvre un bloc contigu de lignes de la matrice:
+        // les threads écrivent dans des lignes d'image disjointes, sans atomiques
+        #pragma omp for schedule(dynamic, 4) reduction(max:lower, upper, max_nnz, max_count) \
+                        reduction(min:min_nnz) reduction(+:empty, missing, profile)
+        for (int r = 0; r < R; r++) {
+            MKL_INT first = (MKL_INT)((long long)r * n_rows / R);
+            MKL_INT last = (MKL_INT)((long long)(r + 1) * n_rows / R);
+            uint32_t* image_row = pattern->counts + (size_t)r * C;
+            
+            for (MKL_INT i = first; i < last; i++) {
+                MKL_INT start = mat->row_index[i];
+                MKL_INT end = mat->row_index[i + 1];
+                MKL_INT row_nnz = end - start;
+                MKL_INT min_col = i;
+                int has_diagonal = 0;
+                
+                for (MKL_INT p = start; p < end; p++) {
+                    MKL_INT j = mat->columns[p];
+                    image_row[(long long)j * C / n_cols]++;
+                    if (i - j > lower) lower = i - j;
+                    if (j - i > upper) upper = j - i;
+                    if (j < min_col) min_col = j;
+                    if (j == i) has_diagonal = 1;
+                }
+                
+                profile += i - min_col;
+                if (row_nnz == 0) empty++;
+                if (!has_diagonal && i < n_cols) missing++;
+                if (row_nnz < min_nnz) min_nnz = row_nnz;
+                if (row_nnz > max_nnz) max_nnz = row_nnz;
+                histogram[row_nnz < SPARSITY_HISTOGRAM_BINS - 1 ? row_nnz
+                                                               : SPARSITY_HISTOGRAM_BINS - 1]++;
+            }
+            
+            for (int c = 0; c < C; c++) {
+                if (image_row[c] > max_count) max_count = image_row[c];
+            }
+        }
+        
+        #pragma omp critical
+        for (int b = 0; b < SPARSITY_HISTOGRAM_BINS; b++) {
+            pattern->row_histogram[b] += histogram[b];
+        }
+    }
+    
+    pattern->lower_bandwidth = lower;
+    pattern->upper_bandwidth = upper;
+    pattern->profile = profile;
+    pattern->min_row_nnz = n_rows > 0 ? min_nnz : 0;
+    pattern->max_row_nnz = max_nnz;
+    pattern->empty_rows = empty;
+    pattern->missing_diagonal = missing;
+    pattern->max_count = max_count;
+    
+    return pattern;
+}
+
+void free_sparsity_pattern(SparsityPattern* pattern) {
+    if (!pattern) return;
+    free(pattern->counts);
+    free(pattern);
+}
+
+void print_sparsity_stats(const SparsityPattern* pattern) {
+    double density = (double)pattern->nnz / ((double)pattern->n_rows * pattern->n_cols);
+    
+    printf("Matrix structure: %ld x %ld, nnz = %ld (%.4f%% dense)\n",
+           (long)pattern->n_rows, (long)pattern->n_cols, (long)pattern->nnz, 100.0 * density);
+    printf("  Bandwidth: lower %ld, upper %ld\n",
+           (long)pattern->lower_bandwidth, (long)pattern->upper_bandwidth);
+    printf("  Profile (envelope): %lld\n", pattern->profile);
+    printf("  Nonzeros per row: min %ld, mean %.2f, max %ld\n",
+           (long)pattern->min_row_nnz, (double)pattern->nnz / pattern->n_rows,
+           (long)pattern->max_row_nnz);
+    if (pattern->empty_rows > 0 || pattern->missing_diagonal > 0) {
+        printf("  Empty rows: %ld, rows without diagonal: %ld\n",
+               (long)pattern->empty_rows, (long)pattern->missing_diagonal);
+    }
+}
+
+int save_sparsity_stats(const SparsityPattern* pattern, const char* stats_file,
+                        const char* histogram_file) {
+    FILE* file = fopen(stats_file, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", stats_file);
+        return -1;
+    }
+    
+    fprintf(file, "statistic,value\n");
+    fprintf(file, "n_rows,%ld\n", (long)pattern->n_rows);
+    fprintf(file, "n_cols,%ld\n", (long)pattern->n_cols);
+    fprintf(file, "nnz,%ld\n", (long)pattern->nnz);
+    fprintf(file, "lower_bandwidth,%ld\n", (long)pattern->lower_bandwidth);
+    fprintf(file, "upper_bandwidth,%ld\n", (long)pattern->upper_bandwidth);
+    fprintf(file, "profile,%lld\n", pattern->profile);
+    fprintf(file, "min_row_nnz,%ld\n", (long)pattern->min_row_nnz);
+    fprintf(file, "mean_row_nnz,%.6f\n", (double)pattern->nnz / pattern->n_rows);
+    fprintf(file, "max_row_nnz,%ld\n", (long)pattern->max_row_nnz);
+    fprintf(file, "empty_rows,%ld\n", (long)pattern->empty_rows);
+    fprintf(file, "missing_diagonal,%ld\n", (long)pattern->missing_diagonal);
+    fprintf(file, "image_rows,%d\n", pattern->image_rows);
+    fprintf(file, "image_cols,%d\n", pattern->image_cols);
+    fprintf(file, "max_bin_count,%u\n", pattern->max_count);
+    fclose(file);
+    
+    file = fopen(histogram_file, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file %s for writing\n", histogram_file);
+        return -1;
+    }
+    
+    // Dernière classe: lignes d'au moins SPARSITY_HISTOGRAM_BINS - 1 non-nuls
+    fprintf(file, "nnz_per_row,rows\n");
+    for (int b = 0; b < SPARSITY_HISTOGRAM_BINS; b++) {
+        if (pattern->row_histogram[b] == 0) continue;
+        fprintf(file, "%s%d,%lld\n", b == SPARSITY_HISTOGRAM_BINS - 1 ? ">=" : "", b,
+                pattern->row_histogram[b]);
+    }
+    fclose(file);
+    
+    return 0;
+}
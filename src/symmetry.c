@@ -0,0 +1,556 @@
+#include "symmetry.h"
+#include "lobpcg.h"
+#include "planner.h"
+#include "profiler.h"
+#include "resources.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Paires demandées à une classe: part du spectre proportionnelle à sa taille, avec marge
+#define SYMMETRY_MARGIN 1.5
+#define SYMMETRY_EXTRA 2
+#define SYMMETRY_UNVISITED -2
+
+// Eléments du groupe du carré codés comme les SYMMETRY_*: bit 4 transposition, puis
+// bit 1 réflexion en x, bit 2 réflexion en y. Caractère d'une classe:
+// χ(g) = (g & 1 ? parité x : 1)(g & 2 ? parité y : 1)(g & 4 ? parité diagonale : 1)
+typedef struct {
+    int elements;           // Sous-groupe: bit g pour l'élément g
+    int parity[3];          // x, y, diagonale (±1)
+    int mirror;             // La classe transposée a le même spectre (classe +- de D4)
+    char name[16];
+    int n;                  // Dimension de la classe
+    int* basis;             // Point -> vecteur de base (-1: composante nulle)
+    double* coef;           // Composante ±1/√|orbite| du point dans son vecteur de base
+    int* reps;              // Représentant (premier point de l'orbite) de chaque vecteur
+    SparseMatrixCSR* A;
+    SparseMatrixCSR* B;
+    SolverType solver;
+    int k;
+    EigenResults* results;
+} SymmetryClass;
+
+typedef struct {
+    SymmetryClass* classes;
+    const int* tasks;       // Classe de chaque tâche du tour
+    const int* task_group;
+    int n_tasks;
+    int group;
+    const ThreadGroup* threads;
+    const SolverConfig* reference;
+    pthread_t thread;
+    int started;
+} ClassLane;
+
+typedef struct {
+    double value;
+    int cls;
+    int index;
+    int transposed;
+} Candidate;
+
+static int map_point(int N, int g, int p) {
+    int i = p / N, j = p % N;
+    if (g & SYMMETRY_DIAGONAL) {
+        int swap = i;
+        i = j;
+        j = swap;
+    }
+    if (g & SYMMETRY_X) i = N - 1 - i;
+    if (g & SYMMETRY_Y) j = N - 1 - j;
+    return i * N + j;
+}
+
+static double max_asymmetry(const double* f, int N, int g, double* scale) {
+    int n = N * N;
+    double diff = 0.0, peak = 0.0;
+    #pragma omp parallel for reduction(max:diff, peak) schedule(static)
+    for (int p = 0; p < n; p++) {
+        double d = fabs(f[p] - f[map_point(N, g, p)]);
+        if (d > diff) diff = d;
+        if (fabs(f[p]) > peak) peak = fabs(f[p]);
+    }
+    *scale = peak;
+    return diff;
+}
+
+int detect_mesh_symmetries(const Mesh* mesh, double tolerance) {
+    const double* coefficients[3] = {mesh->p_vals, mesh->w_vals, mesh->q_vals};
+    int symmetries = 0;
+    for (int g = SYMMETRY_X; g <= SYMMETRY_DIAGONAL; g <<= 1) {
+        int invariant = 1;
+        for (int c = 0; c < 3 && invariant; c++) {
+            double scale;
+            double diff = max_asymmetry(coefficients[c], mesh->N, g, &scale);
+            invariant = diff <= tolerance * scale;
+        }
+        if (invariant) symmetries |= g;
+    }
+    return symmetries;
+}
+
+void format_symmetries(int symmetries, char* text, size_t size) {
+    snprintf(text, size, "%s%s%s%s", symmetries & SYMMETRY_X ? "x" : "",
+             (symmetries & SYMMETRY_X) && (symmetries & SYMMETRY_Y) ? ", " : "",
+             symmetries & SYMMETRY_Y ? "y" : "",
+             !(symmetries & SYMMETRY_DIAGONAL) ? "" :
+             (symmetries & (SYMMETRY_X | SYMMETRY_Y)) ? ", diagonal" : "diagonal");
+}
+
+// ============ CLASSES ============
+
+static void add_class(SymmetryClass* classes, int* n_classes, int elements, int px, int py,
+                      int pd, int mirror) {
+    SymmetryClass* c = &classes[(*n_classes)++];
+    memset(c, 0, sizeof(SymmetryClass));
+    c->elements = elements;
+    c->parity[0] = px;
+    c->parity[1] = py;
+    c->parity[2] = pd;
+    c->mirror = mirror;
+    int used = 0;
+    if (elements & (1 << SYMMETRY_X)) used += sprintf(c->name + used, "x%c", px > 0 ? '+' : '-');
+    if (elements & (1 << SYMMETRY_Y)) used += sprintf(c->name + used, "y%c", py > 0 ? '+' : '-');
+    if (elements & (1 << SYMMETRY_DIAGONAL)) sprintf(c->name + used, "d%c", pd > 0 ? '+' : '-');
+}
+
+// Sous-groupe retenu: D4 si les trois réflexions tiennent, sinon le plus grand disponible
+static int define_classes(int symmetries, SymmetryClass* classes) {
+    int n = 0;
+    int xy = SYMMETRY_X | SYMMETRY_Y;
+    if ((symmetries & xy) == xy && (symmetries & SYMMETRY_DIAGONAL)) {
+        for (int parity = 1; parity >= -1; parity -= 2) {
+            add_class(classes, &n, 0xFF, parity, parity, 1, 0);
+            add_class(classes, &n, 0xFF, parity, parity, -1, 0);
+        }
+        add_class(classes, &n, 0x0F, 1, -1, 1, 1);
+    } else if ((symmetries & xy) == xy) {
+        for (int px = 1; px >= -1; px -= 2) {
+            for (int py = 1; py >= -1; py -= 2) add_class(classes, &n, 0x0F, px, py, 1, 0);
+        }
+    } else if (symmetries & SYMMETRY_X) {
+        add_class(classes, &n, 0x03, 1, 1, 1, 0);
+        add_class(classes, &n, 0x03, -1, 1, 1, 0);
+    } else if (symmetries & SYMMETRY_Y) {
+        add_class(classes, &n, 0x05, 1, 1, 1, 0);
+        add_class(classes, &n, 0x05, 1, -1, 1, 0);
+    } else if (symmetries & SYMMETRY_DIAGONAL) {
+        add_class(classes, &n, 0x11, 1, 1, 1, 0);
+        add_class(classes, &n, 0x11, 1, 1, -1, 0);
+    }
+    return n;
+}
+
+static int character(const SymmetryClass* c, int g) {
+    int chi = 1;
+    if (g & SYMMETRY_X) chi *= c->parity[0];
+    if (g & SYMMETRY_Y) chi *= c->parity[1];
+    if (g & SYMMETRY_DIAGONAL) chi *= c->parity[2];
+    return chi;
+}
+
+// Tableaux de la base, pris dans l'arène avant le remplissage parallèle (arène non partagée)
+static int allocate_class_basis(int n, SymmetryClass* c, Arena* arena) {
+    c->basis = (int*)arena_alloc(arena, (size_t)n * sizeof(int));
+    c->coef = (double*)arena_calloc(arena, n, sizeof(double));
+    c->reps = (int*)arena_alloc(arena, (size_t)n * sizeof(int));
+    return c->basis && c->coef && c->reps ? 0 : -1;
+}
+
+// Base orthonormée de la classe: projection Σ_g χ(g) e_g(r) de chaque orbite, normalisée
+// (nulle si χ n'est pas trivial sur le stabilisateur de r)
+static void build_class_basis(const Mesh* mesh, SymmetryClass* c) {
+    int N = mesh->N;
+    int n = mesh->total_points;
+    for (int p = 0; p < n; p++) c->basis[p] = SYMMETRY_UNVISITED;
+    
+    c->n = 0;
+    for (int p = 0; p < n; p++) {
+        if (c->basis[p] != SYMMETRY_UNVISITED) continue;
+        int points[8], sums[8], m = 0;
+        for (int g = 0; g < 8; g++) {
+            if (!(c->elements & (1 << g))) continue;
+            int q = map_point(N, g, p);
+            int slot = 0;
+            while (slot < m && points[slot] != q) slot++;
+            if (slot == m) {
+                points[m] = q;
+                sums[m++] = 0;
+            }
+            sums[slot] += character(c, g);
+        }
+        if (sums[0] == 0) {
+            for (int s = 0; s < m; s++) c->basis[points[s]] = -1;
+            continue;
+        }
+        int b = c->n++;
+        c->reps[b] = p;
+        double norm = 1.0 / sqrt((double)m);
+        for (int s = 0; s < m; s++) {
+            c->basis[points[s]] = b;
+            c->coef[points[s]] = sums[s] > 0 ? norm : -norm;
+        }
+    }
+}
+
+// Opérateurs réduits VᵀAV et VᵀBV: la ligne du vecteur a se lit sur la ligne de son
+// représentant r, (VᵀAV)_ab = Σ_m A_rm coef(m) / coef(r) sur les voisins m de la base b
+static void assemble_class(const Mesh* mesh, SymmetryClass* c) {
+    int N = mesh->N;
+    MKL_INT nnz = 0;
+    for (int a = 0; a < c->n; a++) {
+        int r = c->reps[a];
+        MKL_INT columns[STIFFNESS_ROW_MAX];
+        double values[STIFFNESS_ROW_MAX];
+        int count = stiffness_row(mesh, r / N, r % N, columns, values);
+    
+        MKL_INT row_columns[STIFFNESS_ROW_MAX];
+        double row_values[STIFFNESS_ROW_MAX];
+        int m = 0;
+        for (int e = 0; e < count; e++) {
+            int b = c->basis[columns[e]];
+            if (b < 0) continue;
+            double value = values[e] * c->coef[columns[e]] / c->coef[r];
+            int slot = 0;
+            while (slot < m && row_columns[slot] != b) slot++;
+            if (slot == m) {
+                // Insertion triée par colonne
+                while (slot > 0 && row_columns[slot - 1] > b) {
+                    row_columns[slot] = row_columns[slot - 1];
+                    row_values[slot] = row_values[slot - 1];
+                    slot--;
+                }
+                row_columns[slot] = b;
+                row_values[slot] = value;
+                m++;
+            } else {
+                row_values[slot] += value;
+            }
+        }
+        c->A->row_index[a] = nnz;
+        memcpy(c->A->columns + nnz, row_columns, m * sizeof(MKL_INT));
+        memcpy(c->A->values + nnz, row_values, m * sizeof(double));
+        nnz += m;
+    
+        c->B->row_index[a] = a;
+        c->B->columns[a] = a;
+        c->B->values[a] = mesh->w_vals[r];
+    }
+    c->A->row_index[c->n] = nnz;
+    c->A->nnz = nnz;
+    c->B->row_index[c->n] = c->n;
+    c->B->nnz = c->n;
+}
+
+// Sans effet dans une arène: tout est rendu avec elle
+static void free_class(SymmetryClass* c, Arena* arena) {
+    arena_free(arena, c->basis);
+    arena_free(arena, c->coef);
+    arena_free(arena, c->reps);
+    free_sparse_matrix(c->A);
+    free_sparse_matrix(c->B);
+    free_eigen_results(c->results);
+}
+
+// ============ RESOLUTION DES CLASSES ============
+
+static void solve_class(SymmetryClass* c, const SolverConfig* reference, int cores) {
+    SolverConfig config = *reference;
+    config.n_eigenvalues = c->k;
+    config.solver = c->solver;
+    config.mkl_threads = cores;
+    config.mesh = NULL;
+    config.symmetry = 0;
+    config.eigenvector_file = NULL;
+    config.on_eigenpair = NULL;
+    config.on_eigenpair_data = NULL;
+    config.checkpoint_file = NULL;
+    config.restart = 0;
+    free_eigen_results(c->results);
+    c->results = NULL;
+    
+    Arena* arena = reference->workspace;
+    if (!arena) {
+        c->results = solve_eigenproblem(c->A, c->B, &config);
+        return;
+    }
+    
+    // Paires gardées sous la marque; l'espace de travail du solveur est rendu après la copie,
+    // la classe suivante le réutilise
+    EigenResults* kept = create_eigen_results_in(c->n, c->k, NULL, arena);
+    if (!kept) return;
+    ArenaMark mark = arena_mark(arena);
+    EigenResults* solved = solve_eigenproblem(c->A, c->B, &config);
+    if (solved && solved->n_eigenvalues >= c->k) {
+        memcpy(kept->eigenvalues, solved->eigenvalues, c->k * sizeof(double));
+        memcpy(kept->residuals, solved->residuals, c->k * sizeof(double));
+        for (int i = 0; i < c->k; i++) {
+            memcpy(kept->eigenvectors[i], solved->eigenvectors[i], c->n * sizeof(double));
+        }
+        kept->iterations = solved->iterations;
+        kept->computation_time = solved->computation_time;
+        c->results = kept;
+    }
+    free_eigen_results(solved);
+    arena_rewind(arena, mark);
+}
+
+static void run_class_lane(ClassLane* lane) {
+    ThreadState previous;
+    thread_group_enter(lane->threads, 0, &previous);
+    for (int t = 0; t < lane->n_tasks; t++) {
+        if (lane->task_group[t] == lane->group) {
+            solve_class(&lane->classes[lane->tasks[t]], lane->reference, lane->threads->n_cores);
+        }
+    }
+    thread_group_leave(&previous);
+}
+
+static void* class_lane_thread(void* arg) {
+    run_class_lane((ClassLane*)arg);
+    return NULL;
+}
+
+typedef struct {
+    const SymmetryClass* classes;
+    const int* tasks;
+} ClassCostData;
+
+static double class_cost(int task, int cores, void* data) {
+    const ClassCostData* cost = (const ClassCostData*)data;
+    const SymmetryClass* c = &cost->classes[cost->tasks[task]];
+    PlanProblem problem = plan_problem_from_matrices(c->A, c->B, c->k);
+    return plan_estimate_seconds(&problem, c->solver, cores);
+}
+
+// Un tour: classes de tasks résolues en parallèle, chaque groupe de threads les siennes
+static int solve_round(SymmetryClass* classes, const int* tasks, int n_tasks,
+                       const SolverConfig* config) {
+    double memory = 0.0;
+    for (int t = 0; t < n_tasks; t++) {
+        SymmetryClass* c = &classes[tasks[t]];
+        SolverType requested = config->solver == SOLVER_MATRIX_FREE ? SOLVER_LOBPCG : config->solver;
+        // LOBPCG stagne quand 3m approche la taille de la classe: petites classes au planificateur
+        if (requested == SOLVER_LOBPCG && 6 * lobpcg_block_size(c->k) > c->n) requested = SOLVER_AUTO;
+        PlanProblem problem = plan_problem_from_matrices(c->A, c->B, c->k);
+        SolvePlan plan;
+        if (plan_solve(&problem, requested, config->memory_budget, &plan) != 0 &&
+            plan_solve(&problem, SOLVER_AUTO, config->memory_budget, &plan) != 0) {
+            fprintf(stderr, "Error: No solver fits symmetry class %s\n", c->name);
+            return -1;
+        }
+        c->solver = plan.chosen;
+        memory += plan.estimates[plan.chosen].memory_bytes;
+    }
+    
+    // Classes simultanées au-delà du budget mémoire, ou dans l'arène de l'appelant (qui ne se
+    // partage pas entre threads): un seul groupe, classes en file
+    size_t budget = config->memory_budget ? config->memory_budget : planner_memory_budget();
+    int max_groups = memory <= (double)budget && !config->workspace ? 0 : 1;
+    int cores = config->mkl_threads;
+#ifdef _OPENMP
+    if (cores <= 0) cores = omp_get_max_threads();
+#endif
+    ThreadGroup all;
+    resources_detect(cores, &all);
+    
+    ThreadGroup groups[SYMMETRY_MAX_CLASSES];
+    int task_group[SYMMETRY_MAX_CLASSES];
+    double makespan;
+    ClassCostData cost = {classes, tasks};
+    int n_groups = resources_partition(&all, n_tasks, class_cost, &cost, max_groups, task_group,
+                                       groups, &makespan);
+    if (n_groups == 0) {
+        n_groups = 1;
+        groups[0] = all;
+        for (int t = 0; t < n_tasks; t++) task_group[t] = 0;
+    }
+    
+    ClassLane lanes[SYMMETRY_MAX_CLASSES];
+    memset(lanes, 0, sizeof(lanes));
+    for (int g = 0; g < n_groups; g++) {
+        lanes[g].classes = classes;
+        lanes[g].tasks = tasks;
+        lanes[g].task_group = task_group;
+        lanes[g].n_tasks = n_tasks;
+        lanes[g].group = g;
+        lanes[g].threads = &groups[g];
+        lanes[g].reference = config;
+        if (g > 0) {
+            lanes[g].started = pthread_create(&lanes[g].thread, NULL, class_lane_thread,
+                                              &lanes[g]) == 0;
+        }
+    }
+    run_class_lane(&lanes[0]);
+    for (int g = 1; g < n_groups; g++) {
+        if (lanes[g].started) pthread_join(lanes[g].thread, NULL);
+        else run_class_lane(&lanes[g]);   // Thread refusé: dans le thread appelant
+    }
+    
+    for (int t = 0; t < n_tasks; t++) {
+        SymmetryClass* c = &classes[tasks[t]];
+        if (!c->results || c->results->n_eigenvalues < c->k) {
+            fprintf(stderr, "Error: Solve of symmetry class %s failed\n", c->name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int compare_candidates(const void* a, const void* b) {
+    const Candidate* x = (const Candidate*)a;
+    const Candidate* y = (const Candidate*)b;
+    if (x->value != y->value) return x->value < y->value ? -1 : 1;
+    if (x->cls != y->cls) return x->cls - y->cls;
+    if (x->index != y->index) return x->index - y->index;
+    return x->transposed - y->transposed;
+}
+
+// Paires de toutes les classes triées (la classe miroir compte deux fois)
+static int gather_candidates(const SymmetryClass* classes, int n_classes, Candidate* candidates) {
+    int count = 0;
+    for (int c = 0; c < n_classes; c++) {
+        const EigenResults* results = classes[c].results;
+        if (!results) continue;
+        for (int i = 0; i < results->n_eigenvalues; i++) {
+            for (int t = 0; t <= classes[c].mirror; t++) {
+                candidates[count++] = (Candidate){results->eigenvalues[i], c, i, t};
+            }
+        }
+    }
+    qsort(candidates, count, sizeof(Candidate), compare_candidates);
+    return count;
+}
+
+EigenResults* solve_symmetric_eigenproblem(int symmetries, SolverConfig* config) {
+    const Mesh* mesh = config->mesh;
+    int N = mesh->N;
+    int n = mesh->total_points;
+    int k = config->n_eigenvalues < n ? config->n_eigenvalues : n;
+    double start = profiler_now();
+    
+    SymmetryClass classes[SYMMETRY_MAX_CLASSES];
+    int n_classes = define_classes(symmetries, classes);
+    char names[64];
+    format_symmetries(symmetries, names, sizeof(names));
+    
+    // Bases et opérateurs réduits dans l'arène de l'appelant: allocations dans ce thread,
+    // remplissage parallèle
+    Arena* arena = config->workspace;
+    profiler_begin("symmetry_reduction");
+    int failed = 0;
+    for (int c = 0; c < n_classes; c++) {
+        if (allocate_class_basis(n, &classes[c], arena) != 0) failed = 1;
+    }
+    if (!failed) {
+        #pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < n_classes; c++) build_class_basis(mesh, &classes[c]);
+    
+        for (int c = 0; c < n_classes && !failed; c++) {
+            SymmetryClass* cls = &classes[c];
+            if (cls->n == 0) continue;
+            cls->A = create_sparse_matrix_in(cls->n, (MKL_INT)cls->n * STIFFNESS_ROW_MAX, arena);
+            cls->B = create_sparse_matrix_in(cls->n, cls->n, arena);
+            if (!cls->A || !cls->B) failed = 1;
+        }
+    }
+    if (!failed) {
+        #pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < n_classes; c++) {
+            if (classes[c].n > 0) assemble_class(mesh, &classes[c]);
+        }
+    }
+    profiler_end();
+    
+    EigenResults* results = NULL;
+    Candidate* candidates = (Candidate*)arena_alloc(arena, 2 * (size_t)n * sizeof(Candidate));
+    if (failed || !candidates) {
+        fprintf(stderr, "Error: Memory allocation failed for the symmetry classes\n");
+        goto cleanup;
+    }
+    
+    printf("\n=== SYMMETRY REDUCTION (%s) ===\n", names);
+    for (int c = 0; c < n_classes; c++) {
+        SymmetryClass* cls = &classes[c];
+        double share = (double)cls->n / n;
+        int guess = (int)ceil(SYMMETRY_MARGIN * k * share) + SYMMETRY_EXTRA;
+        cls->k = guess < cls->n ? guess : cls->n;
+        printf("  class %-7s %8d DOF%s\n", cls->name, cls->n,
+               cls->mirror ? " (also gives its x <-> y mirror)" : "");
+    }
+    
+    // Tours: une classe dont la plus grande valeur calculée reste sous la k-ième peut en
+    // cacher d'autres plus bas; elle est résolue à nouveau avec deux fois plus de paires
+    int tasks[SYMMETRY_MAX_CLASSES];
+    int n_tasks = 0;
+    for (int c = 0; c < n_classes; c++) {
+        if (classes[c].k > 0) tasks[n_tasks++] = c;
+    }
+    int rounds = 0;
+    int count = 0;
+    while (n_tasks > 0) {
+        rounds++;
+        if (solve_round(classes, tasks, n_tasks, config) != 0) goto cleanup;
+        count = gather_candidates(classes, n_classes, candidates);
+        double kth = count >= k ? candidates[k - 1].value : INFINITY;
+        n_tasks = 0;
+        for (int c = 0; c < n_classes; c++) {
+            SymmetryClass* cls = &classes[c];
+            if (cls->k == 0 || cls->k == cls->n) continue;
+            if (cls->results->eigenvalues[cls->k - 1] < kth) {
+                cls->k = 2 * cls->k < cls->n ? 2 * cls->k : cls->n;
+                tasks[n_tasks++] = c;
+            }
+        }
+    }
+    
+    // Modes sur la grille complète: x(p) = coef(p) y(base(p)), transposés pour le miroir
+    results = create_eigen_results_in(n, k, config->eigenvector_file, config->workspace);
+    if (!results) goto cleanup;
+    int iterations = 0;
+    for (int m = 0; m < k; m++) {
+        const Candidate* cand = &candidates[m];
+        const EigenResults* part = classes[cand->cls].results;
+        results->eigenvalues[m] = cand->value;
+        results->residuals[m] = part->residuals[cand->index];
+    }
+    for (int c = 0; c < n_classes; c++) {
+        if (classes[c].results && classes[c].results->iterations > iterations) {
+            iterations = classes[c].results->iterations;
+        }
+    }
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int m = 0; m < k; m++) {
+        for (int i = 0; i < N; i++) {
+            const Candidate* cand = &candidates[m];
+            const SymmetryClass* cls = &classes[cand->cls];
+            const double* y = cls->results->eigenvectors[cand->index];
+            double* x = results->eigenvectors[m];
+            for (int j = 0; j < N; j++) {
+                int p = i * N + j;
+                int b = cls->basis[p];
+                double value = b >= 0 ? cls->coef[p] * y[b] : 0.0;
+                if (cand->transposed) x[j * N + i] = value;
+                else x[p] = value;
+            }
+        }
+    }
+    profiler_add_work(0.0, (double)k * n * (2 * sizeof(double) + sizeof(int)));
+    
+    results->iterations = iterations;
+    results->computation_time = profiler_now() - start;
+    printf("\nSymmetry classes: %d rounds, %d pairs merged in %.3f seconds\n", rounds, k,
+           results->computation_time);
+    stream_eigenpairs(config, results, 0, results->computation_time);
+
+cleanup:
+    for (int c = 0; c < n_classes; c++) free_class(&classes[c], arena);
+    arena_free(arena, candidates);
+    return results;
+}
@@ -1,14 +1,446 @@
 #include "visualization.h"
+#include "image.h"
+#include "sparsity.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/stat.h>
 
 // Définitions pour PI si non défini
 #ifndef PI
 #define PI 3.14159265358979323846
 #endif
 
+// Mise en page des images natives
+#define PLOT_MARGIN_LEFT 48
+#define PLOT_MARGIN_TOP 28
+#define PLOT_MARGIN_BOTTOM 32
+#define MODE_IMAGE_SIZE 400
+#define MODE_CONTOUR_LEVELS 8
+#define SPARSITY_IMAGE_SIZE 600
+#define CONVERGENCE_PANEL_WIDTH 260
+#define CONVERGENCE_PANEL_HEIGHT 220
+#define ANIMATION_BATCH 32          // Images synthétisées par produit matriciel
+
+static PlotBackend plot_backend = PLOT_NATIVE;
+static AnimationOptions animation_options = {ANIMATION_GIF, 120, 320, 25};
+
+static const Color axis_color = {40, 40, 40};
+static const Color series_color = {31, 119, 180};
+static const Color grid_color = {225, 225, 225};
+
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+int parse_plot_backend(const char* name, PlotBackend* backend) {
+    if (strcmp(name, "native") == 0) {
+        *backend = PLOT_NATIVE;
+    } else if (strcmp(name, "python") == 0) {
+        *backend = PLOT_PYTHON;
+    } else {
+        fprintf(stderr, "Error: Unknown plot backend '%s' (expected native or python)\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+void set_plot_backend(PlotBackend backend) {
+    plot_backend = backend;
+}
+
+int parse_sparsity_mode(const char* name, SparsityPlotMode* mode) {
+    if (strcmp(name, "density") == 0) {
+        *mode = SPARSITY_DENSITY;
+    } else if (strcmp(name, "full") == 0) {
+        *mode = SPARSITY_FULL;
+    } else {
+        fprintf(stderr, "Error: Unknown sparsity mode '%s' (expected density or full)\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+int parse_animation_format(const char* name, AnimationFormat* format) {
+    if (strcmp(name, "gif") == 0) {
+        *format = ANIMATION_GIF;
+    } else if (strcmp(name, "raw") == 0) {
+        *format = ANIMATION_RAW;
+    } else if (strcmp(name, "none") == 0) {
+        *format = ANIMATION_NONE;
+    } else {
+        fprintf(stderr, "Error: Unknown animation format '%s' (expected gif, raw or none)\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+void set_animation_options(const AnimationOptions* options) {
+    animation_options = *options;
+}
+
+// ============ RENDU NATIF ============
+
+// Valeur du mode au point (u, v) du domaine, interpolation bilinéaire;
+// les noeuds virtuels du bord (Dirichlet) valent 0
+static double sample_mode(const double* mode, int N, double u, double v) {
+    double gx = u * (N + 1) - 1.0;
+    double gy = v * (N + 1) - 1.0;
+    int i0 = (int)floor(gx), j0 = (int)floor(gy);
+    double fx = gx - i0, fy = gy - j0;
+    
+    double corner[2][2];
+    for (int di = 0; di < 2; di++) {
+        for (int dj = 0; dj < 2; dj++) {
+            int i = i0 + di, j = j0 + dj;
+            corner[di][dj] = (i >= 0 && i < N && j >= 0 && j < N) ? mode[i * N + j] : 0.0;
+        }
+    }
+    
+    return (1 - fx) * ((1 - fy) * corner[0][0] + fy * corner[0][1]) +
+           fx * ((1 - fy) * corner[1][0] + fy * corner[1][1]);
+}
+
+static void format_value(char* buffer, size_t size, double value) {
+    snprintf(buffer, size, "%.3g", value);
+}
+
+// Carte de couleurs du mode, lignes de niveau (ligne nodale en noir) et barre de couleurs
+static int render_mode_png(Mesh* mesh, const double* mode, int mode_index,
+                           double eigenvalue, const char* filename) {
+    int S = MODE_IMAGE_SIZE;
+    int x0 = PLOT_MARGIN_LEFT, y0 = PLOT_MARGIN_TOP;
+    int bar_x = x0 + S + 16, bar_width = 16;
+    Image* image = image_create(bar_x + bar_width + 64, y0 + S + PLOT_MARGIN_BOTTOM, COLOR_WHITE);
+    float* field = (float*)malloc((size_t)S * S * sizeof(float));
+    if (!image || !field) {
+        free_image(image);
+        free(field);
+        return -1;
+    }
+    
+    int N = mesh->N;
+    double vmax = 0.0;
+    for (int i = 0; i < N * N; i++) {
+        if (fabs(mode[i]) > vmax) vmax = fabs(mode[i]);
+    }
+    if (vmax == 0.0) vmax = 1.0;
+    
+    // Champ normalisé dans [-1, 1], y vers le haut
+    for (int py = 0; py < S; py++) {
+        double v = 1.0 - (py + 0.5) / S;
+        for (int px = 0; px < S; px++) {
+            double u = (px + 0.5) / S;
+            field[(size_t)py * S + px] = (float)(sample_mode(mode, N, u, v) / vmax);
+        }
+    }
+    
+    for (int py = 0; py < S; py++) {
+        for (int px = 0; px < S; px++) {
+            float value = field[(size_t)py * S + px];
+            Color color = colormap_color(COLORMAP_RDBU, 0.5 + 0.5 * value);
+            
+            // Changement de niveau avec le voisin de droite ou du dessous
+            int level = (int)floor(value * MODE_CONTOUR_LEVELS);
+            for (int n = 0; n < 2; n++) {
+                int qx = px + (n == 0), qy = py + (n == 1);
+                if (qx >= S || qy >= S) continue;
+                float other = field[(size_t)qy * S + qx];
+                if ((value < 0) != (other < 0)) {
+                    color = COLOR_BLACK;
+                    break;
+                }
+                if ((int)floor(other * MODE_CONTOUR_LEVELS) != level) {
+                    color.r = (uint8_t)(color.r * 0.55);
+                    color.g = (uint8_t)(color.g * 0.55);
+                    color.b = (uint8_t)(color.b * 0.55);
+                }
+            }
+            image_set_pixel(image, x0 + px, y0 + py, color);
+        }
+    }
+    image_draw_rect(image, x0 - 1, y0 - 1, S + 2, S + 2, axis_color);
+    
+    // Barre de couleurs
+    for (int py = 0; py < S; py++) {
+        Color color = colormap_color(COLORMAP_RDBU, 1.0 - (py + 0.5) / S);
+        image_fill_rect(image, bar_x, y0 + py, bar_width, 1, color);
+    }
+    image_draw_rect(image, bar_x - 1, y0 - 1, bar_width + 2, S + 2, axis_color);
+    
+    char label[64];
+    format_value(label, sizeof(label), vmax);
+    image_draw_text(image, bar_x + bar_width + 4, y0, label, axis_color);
+    image_draw_text(image, bar_x + bar_width + 4, y0 + S / 2 - 3, "0", axis_color);
+    format_value(label, sizeof(label), -vmax);
+    image_draw_text(image, bar_x + bar_width + 4, y0 + S - 7, label, axis_color);
+    
+    // Axes et titre
+    image_draw_text(image, x0 - 3, y0 + S + 6, "0", axis_color);
+    image_draw_text(image, x0 + S / 2 - 8, y0 + S + 6, "0.5", axis_color);
+    image_draw_text(image, x0 + S - 3, y0 + S + 6, "1", axis_color);
+    image_draw_text(image, x0 + S / 2 - 3, y0 + S + 18, "X", axis_color);
+    image_draw_text(image, x0 - 12, y0 + S - 7, "0", axis_color);
+    image_draw_text(image, x0 - 24, y0 + S / 2 - 3, "0.5", axis_color);
+    image_draw_text(image, x0 - 12, y0, "1", axis_color);
+    image_draw_text(image, x0 - 40, y0 + S / 2 - 3, "Y", axis_color);
+    
+    snprintf(label, sizeof(label), "MODE %d   LAMBDA = %.6g   F = %.4g HZ",
+             mode_index + 1, eigenvalue, sqrt(fabs(eigenvalue)) / (2 * PI));
+    image_draw_text(image, x0, 10, label, axis_color);
+    
+    int status = image_write_png(image, filename);
+    free(field);
+    free_image(image);
+    return status;
+}
+
+// Rendu des n_modes premiers modes en parallèle (un mode par thread)
+static int render_modes_native(Mesh* mesh, EigenResults* results, int n_modes,
+                               const char* output_dir) {
+    double start = wall_time();
+    int n_written = 0;
+    
+    #pragma omp parallel for schedule(dynamic) reduction(+:n_written)
+    for (int m = 0; m < n_modes; m++) {
+        char filename[512];
+        snprintf(filename, sizeof(filename), "%s/mode_%02d.png", output_dir, m + 1);
+        if (render_mode_png(mesh, results->eigenvectors[m], m,
+                            results->eigenvalues[m], filename) == 0) {
+            n_written++;
+        }
+    }
+    
+    printf("Rendered %d mode images to %s/ in %.1f ms\n", n_written, output_dir,
+           1000.0 * (wall_time() - start));
+    return n_written == n_modes ? 0 : -1;
+}
+
+// Axes d'un panneau: cadre, graduations et étiquettes aux extrémités
+static double axis_position(double value, double lo, double hi, int log_scale) {
+    if (log_scale) {
+        value = log(value);
+        lo = log(lo);
+        hi = log(hi);
+    }
+    return hi > lo ? (value - lo) / (hi - lo) : 0.5;
+}
+
+static void draw_line_panel(Image* image, int x0, int y0, int width, int height,
+                            const double* x, const double* y, int n, int log_scale,
+                            const char* title) {
+    double x_lo = x[0], x_hi = x[0], y_lo = y[0], y_hi = y[0];
+    for (int i = 1; i < n; i++) {
+        if (x[i] < x_lo) x_lo = x[i];
+        if (x[i] > x_hi) x_hi = x[i];
+        if (y[i] < y_lo) y_lo = y[i];
+        if (y[i] > y_hi) y_hi = y[i];
+    }
+    // Marge relative pour ne pas coller les points au cadre
+    if (log_scale && x_lo > 0 && y_lo > 0) {
+        x_lo /= 1.1; x_hi *= 1.1;
+        double span = y_hi / y_lo > 1.0001 ? pow(y_hi / y_lo, 0.08) : 1.01;
+        y_lo /= span; y_hi *= span;
+    } else {
+        log_scale = 0;
+        double dx = (x_hi - x_lo) * 0.08 + 1e-12, dy = (y_hi - y_lo) * 0.08 + 1e-12 * fabs(y_hi);
+        x_lo -= dx; x_hi += dx;
+        y_lo -= dy; y_hi += dy;
+    }
+    
+    for (int g = 1; g < 4; g++) {
+        image_draw_line(image, x0, y0 + g * height / 4, x0 + width - 1, y0 + g * height / 4, grid_color);
+    }
+    image_draw_rect(image, x0, y0, width, height, axis_color);
+    image_draw_text(image, x0 + (width - image_text_width(title)) / 2, y0 - 12, title, axis_color);
+    
+    char label[32];
+    int prev_x = -1;
+    int px[n > 0 ? n : 1], py[n > 0 ? n : 1];
+    for (int i = 0; i < n; i++) {
+        px[i] = x0 + (int)lround(axis_position(x[i], x_lo, x_hi, log_scale) * (width - 1));
+        py[i] = y0 + height - 1 - (int)lround(axis_position(y[i], y_lo, y_hi, log_scale) * (height - 1));
+        
+        snprintf(label, sizeof(label), "%g", x[i]);
+        int lx = px[i] - image_text_width(label) / 2;
+        if (lx > prev_x) {
+            image_draw_line(image, px[i], y0 + height - 1, px[i], y0 + height + 2, axis_color);
+            image_draw_text(image, lx, y0 + height + 5, label, axis_color);
+            prev_x = lx + image_text_width(label) + 4;
+        }
+    }
+    
+    for (int t = 0; t < 3; t++) {
+        double fraction = t / 2.0;
+        double value = log_scale ? exp(log(y_lo) + fraction * (log(y_hi) - log(y_lo)))
+                                 : y_lo + fraction * (y_hi - y_lo);
+        int ty = y0 + height - 1 - (int)lround(fraction * (height - 1));
+        snprintf(label, sizeof(label), "%.5g", value);
+        image_draw_line(image, x0 - 3, ty, x0, ty, axis_color);
+        image_draw_text(image, x0 - 5 - image_text_width(label), ty - 3, label, axis_color);
+    }
+    
+    for (int i = 0; i < n; i++) {
+        if (i > 0) image_draw_line(image, px[i - 1], py[i - 1], px[i], py[i], series_color);
+        image_fill_rect(image, px[i] - 2, py[i] - 2, 5, 5, series_color);
+    }
+}
+
+static int render_convergence_png(int* grid_sizes, double** eigenvalues, int n_sizes,
+                                  int n_eigenvalues, const char* filename) {
+    int panel_stride = CONVERGENCE_PANEL_WIDTH + 90;
+    Image* image = image_create(n_eigenvalues * panel_stride + 20,
+                                CONVERGENCE_PANEL_HEIGHT + PLOT_MARGIN_TOP + PLOT_MARGIN_BOTTOM + 12,
+                                COLOR_WHITE);
+    double* x = (double*)malloc(n_sizes * sizeof(double));
+    double* y = (double*)malloc(n_sizes * sizeof(double));
+    if (!image || !x || !y) {
+        free_image(image);
+        free(x);
+        free(y);
+        return -1;
+    }
+    
+    for (int m = 0; m < n_eigenvalues; m++) {
+        int n = 0;
+        for (int s = 0; s < n_sizes; s++) {
+            if (!eigenvalues[s]) continue;
+            x[n] = grid_sizes[s];
+            y[n] = eigenvalues[s][m];
+            n++;
+        }
+        if (n == 0) continue;
+        
+        char title[32];
+        snprintf(title, sizeof(title), "MODE %d EIGENVALUE", m + 1);
+        draw_line_panel(image, m * panel_stride + 80, PLOT_MARGIN_TOP + 8,
+                        CONVERGENCE_PANEL_WIDTH, CONVERGENCE_PANEL_HEIGHT, x, y, n, 1, title);
+        image_draw_text(image, m * panel_stride + 80 + CONVERGENCE_PANEL_WIDTH / 2 - 33,
+                        PLOT_MARGIN_TOP + CONVERGENCE_PANEL_HEIGHT + 28, "GRID SIZE N", axis_color);
+    }
+    
+    int status = image_write_png(image, filename);
+    free(x);
+    free(y);
+    free_image(image);
+    return status;
+}
+
+// Image de densité: chaque pixel cumule les cases qu'il couvre, échelle logarithmique
+static int render_sparsity_png(const SparsityPattern* pattern, const char* filename) {
+    int R = pattern->image_rows, C = pattern->image_cols;
+    int S = R > C ? R : C;
+    if (S > SPARSITY_IMAGE_SIZE) S = SPARSITY_IMAGE_SIZE;
+    int x0 = PLOT_MARGIN_LEFT, y0 = PLOT_MARGIN_TOP + 26;
+    int bar_x = x0 + S + 16;
+    Image* image = image_create(bar_x + 56, y0 + S + PLOT_MARGIN_BOTTOM, COLOR_WHITE);
+    if (!image) return -1;
+    
+    uint64_t* pixels = (uint64_t*)calloc((size_t)S * S, sizeof(uint64_t));
+    if (!pixels) {
+        free_image(image);
+        return -1;
+    }
+    
+    // Lignes de pixels disjointes par thread
+    #pragma omp parallel for schedule(static)
+    for (int py = 0; py < S; py++) {
+        int r_first = (int)((long long)py * R / S);
+        int r_last = (int)((long long)(py + 1) * R / S);
+        if (r_last == r_first) r_last = r_first + 1;
+        for (int r = r_first; r < r_last && r < R; r++) {
+            const uint32_t* row = pattern->counts + (size_t)r * C;
+            for (int c = 0; c < C; c++) {
+                if (row[c]) pixels[(size_t)py * S + (long long)c * S / C] += row[c];
+            }
+        }
+    }
+    
+    uint64_t max_pixel = 0;
+    for (size_t k = 0; k < (size_t)S * S; k++) {
+        if (pixels[k] > max_pixel) max_pixel = pixels[k];
+    }
+    double log_max = log1p((double)max_pixel);
+    
+    #pragma omp parallel for schedule(static)
+    for (int py = 0; py < S; py++) {
+        for (int px = 0; px < S; px++) {
+            uint64_t count = pixels[(size_t)py * S + px];
+            if (count == 0) continue;
+            double t = log_max > log(2.0) ? log1p((double)count) / log_max : 1.0;
+            image_set_pixel(image, x0 + px, y0 + py, colormap_color(COLORMAP_VIRIDIS, 1.0 - t));
+        }
+    }
+    free(pixels);
+    image_draw_rect(image, x0 - 1, y0 - 1, S + 2, S + 2, axis_color);
+    
+    // Barre de couleurs: nombre de non-nuls par pixel
+    for (int k = 0; k < S; k++) {
+        double t = 1.0 - (double)k / (S > 1 ? S - 1 : 1);
+        image_fill_rect(image, bar_x, y0 + k, 12, 1, colormap_color(COLORMAP_VIRIDIS, 1.0 - t));
+    }
+    image_draw_rect(image, bar_x - 1, y0 - 1, 14, S + 2, axis_color);
+    
+    char label[160];
+    snprintf(label, sizeof(label), "%llu", (unsigned long long)max_pixel);
+    image_draw_text(image, bar_x + 16, y0, label, axis_color);
+    image_draw_text(image, bar_x + 16, y0 + S - FONT_HEIGHT, "1", axis_color);
+    
+    double density = (double)pattern->nnz / ((double)pattern->n_rows * pattern->n_cols);
+    snprintf(label, sizeof(label), "MATRIX DENSITY   %ld X %ld   NNZ = %ld   SPARSITY = %.2f%%",
+             (long)pattern->n_rows, (long)pattern->n_cols, (long)pattern->nnz, (1.0 - density) * 100.0);
+    image_draw_text(image, x0, 8, label, axis_color);
+    snprintf(label, sizeof(label), "BANDWIDTH %ld/%ld   PROFILE %lld   NNZ/ROW %ld-%ld MEAN %.2f",
+             (long)pattern->lower_bandwidth, (long)pattern->upper_bandwidth, pattern->profile,
+             (long)pattern->min_row_nnz, (long)pattern->max_row_nnz,
+             (double)pattern->nnz / pattern->n_rows);
+    image_draw_text(image, x0, 20, label, axis_color);
+    
+    snprintf(label, sizeof(label), "%ld", (long)pattern->n_cols);
+    image_draw_text(image, x0 - 3, y0 + S + 6, "0", axis_color);
+    image_draw_text(image, x0 + S - image_text_width(label), y0 + S + 6, label, axis_color);
+    image_draw_text(image, x0 + S / 2 - 18, y0 + S + 18, "COLUMN", axis_color);
+    image_draw_text(image, x0 - 12, y0, "0", axis_color);
+    image_draw_text(image, x0 - 42, y0 + S / 2 - 3, "ROW", axis_color);
+    
+    int status = image_write_png(image, filename);
+    free_image(image);
+    return status;
+}
+
+// Image de densité brute (image_rows x image_cols)
+static int save_density_image(const SparsityPattern* pattern, OutputFormat format) {
+    if (format == OUTPUT_NPY) {
+        size_t shape[2] = {(size_t)pattern->image_rows, (size_t)pattern->image_cols};
+        if (npy_save("data/matrix_density.npy", NPY_UINT32, 2, shape, pattern->counts) != 0) return -1;
+        printf("Saved %d x %d density image to data/matrix_density.npy\n",
+               pattern->image_rows, pattern->image_cols);
+        return 0;
+    }
+    
+    FILE* file = fopen("data/matrix_density.csv", "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot create matrix density file\n");
+        return -1;
+    }
+    for (int r = 0; r < pattern->image_rows; r++) {
+        const uint32_t* row = pattern->counts + (size_t)r * pattern->image_cols;
+        for (int c = 0; c < pattern->image_cols; c++) {
+            fprintf(file, c ? ",%u" : "%u", row[c]);
+        }
+        fputc('\n', file);
+    }
+    fclose(file);
+    printf("Saved %d x %d density image to data/matrix_density.csv\n",
+           pattern->image_rows, pattern->image_cols);
+    return 0;
+}
+
 void save_mode_to_csv(Mesh* mesh, double* mode, int mode_index, 
                      const char* filename) {
     FILE* file = fopen(filename, "w");
@@ -30,14 +462,46 @@ void save_mode_to_csv(Mesh* mesh, double* mode, int mode_index,
     printf("Saved mode %d data to %s\n", mode_index + 1, filename);
 }
 
-void generate_python_script(const char* plot_type) {
+void save_mode_to_npy(Mesh* mesh, double* mode, int mode_index,
+                      const char* filename) {
+    size_t shape[2] = {(size_t)mesh->N, (size_t)mesh->N};
+    
+    if (npy_save(filename, NPY_FLOAT64, 2, shape, mode) == 0) {
+        printf("Saved mode %d data to %s\n", mode_index + 1, filename);
+    }
+}
+
+// Répertoire créé sans passer par un shell; déjà présent, il est gardé tel quel
+int ensure_directory(const char* path) {
+    char prefix[1024];
+    if (path[0] == '\0' || strlen(path) >= sizeof(prefix)) {
+        fprintf(stderr, "Error: Invalid directory path '%s'\n", path);
+        return -1;
+    }
+    strcpy(prefix, path);
+    
+    // Parents d'abord (mkdir -p), chaque composant au plus une fois
+    for (char* slash = strchr(prefix + 1, '/'); ; slash = strchr(slash + 1, '/')) {
+        if (slash) *slash = '\0';
+        if (prefix[0] != '\0' && mkdir(prefix, 0755) != 0 && errno != EEXIST) {
+            fprintf(stderr, "Error: Cannot create directory %s: %s\n", prefix, strerror(errno));
+            return -1;
+        }
+        if (!slash) break;
+        *slash = '/';
+    }
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        fprintf(stderr, "Error: %s is not a directory\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+void generate_python_script(const char* plot_type, int n_modes) {
     char script_filename[256];
     sprintf(script_filename, "scripts/plot_%s.py", plot_type);
-    
-    // Créer le répertoire scripts s'il n'existe pas
-    char mkdir_cmd[256];
-    sprintf(mkdir_cmd, "mkdir -p scripts");
-    int ret = system(mkdir_cmd); (void)ret;
+    if (ensure_directory("scripts") != 0) return;
     
     FILE* script = fopen(script_filename, "w");
     if (!script) {
@@ -52,9 +516,15 @@ void generate_python_script(const char* plot_type) {
         fprintf(script, "import os\n");
         fprintf(script, "from mpl_toolkits.mplot3d import Axes3D\n\n");
         
-        fprintf(script, "# Read data\n");
+        fprintf(script, "# Read data (.npy: grille N x N, coordonnees (i+1)/(N+1))\n");
         fprintf(script, "def read_mode_data(filename):\n");
         fprintf(script, "    try:\n");
+        fprintf(script, "        if filename.endswith('.npy'):\n");
+        fprintf(script, "            Z = np.load(filename)\n");
+        fprintf(script, "            n = Z.shape[0]\n");
+        fprintf(script, "            c = (np.arange(n) + 1.0) / (n + 1.0)\n");
+        fprintf(script, "            X, Y = np.meshgrid(c, c, indexing='ij')\n");
+        fprintf(script, "            return np.column_stack((X.ravel(), Y.ravel(), Z.ravel()))\n");
         fprintf(script, "        data = np.loadtxt(filename, delimiter=',')\n");
         fprintf(script, "        return data\n");
         fprintf(script, "    except Exception as e:\n");
@@ -102,9 +572,11 @@ void generate_python_script(const char* plot_type) {
         fprintf(script, "    # Créer le répertoire data s'il n'existe pas\n");
         fprintf(script, "    os.makedirs('data', exist_ok=True)\n");
         fprintf(script, "    \n");
-        fprintf(script, "    # Par défaut, on génère les 5 premiers modes\n");
-        fprintf(script, "    for i in range(1, 6):\n");
-        fprintf(script, "        filename = f'data/mode_{i:02d}.csv'\n");
+        fprintf(script, "    # Modes sauvegardés par le solveur\n");
+        fprintf(script, "    for i in range(1, %d):\n", n_modes + 1);
+        fprintf(script, "        filename = f'data/mode_{i:02d}.npy'\n");
+        fprintf(script, "        if not os.path.exists(filename):\n");
+        fprintf(script, "            filename = f'data/mode_{i:02d}.csv'\n");
         fprintf(script, "        if os.path.exists(filename):\n");
         fprintf(script, "            data = read_mode_data(filename)\n");
         fprintf(script, "            plot_mode(data, i)\n");
@@ -117,34 +589,33 @@ void generate_python_script(const char* plot_type) {
     printf("Generated Python script: %s\n", script_filename);
 }
 
-void generate_plots(Mesh* mesh, EigenResults* results, const char* output_dir) {
+void generate_plots(Mesh* mesh, EigenResults* results, int n_modes, const char* output_dir) {
     printf("Generating plots in directory: %s\n", output_dir);
+    if (ensure_directory(output_dir) != 0) return;
+    if (n_modes > results->n_eigenvalues) n_modes = results->n_eigenvalues;
     
-    // Créer les répertoires nécessaires
-    char command[512];
-    sprintf(command, "mkdir -p %s", output_dir);
-    int ret = system(command); (void)ret;
-    int ret7 = ret = system("mkdir -p scripts"); (void)ret; (void)ret7;;
-    int ret8 = ret = system("mkdir -p data"); (void)ret; (void)ret8;;
-    
-    // Générer le script Python pour les plots
-    generate_python_script("modes");
-    
-    // Vérifier que le script a été créé
-    FILE* test_script = fopen("scripts/plot_modes.py", "r");
-    if (!test_script) {
-        fprintf(stderr, "Error: Python script not created\n");
-        return;
-    }
-    fclose(test_script);
-    
-    // Exécuter le script Python
-    printf("Executing Python script...\n");
-    int ret2 = system("python3 scripts/plot_modes.py"); (void)ret2;
-    if (ret != 0) {
-        fprintf(stderr, "Warning: Python script execution returned code %d\n", ret);
+    if (plot_backend == PLOT_NATIVE) {
+        render_modes_native(mesh, results, n_modes, output_dir);
     } else {
-        printf("Python script executed successfully\n");
+        // Générer le script Python pour les plots (il crée data/ et plots/ lui-même)
+        generate_python_script("modes", n_modes);
+        
+        // Vérifier que le script a été créé
+        FILE* test_script = fopen("scripts/plot_modes.py", "r");
+        if (!test_script) {
+            fprintf(stderr, "Error: Python script not created\n");
+            return;
+        }
+        fclose(test_script);
+        
+        // Exécuter le script Python
+        printf("Executing Python script...\n");
+        int ret2 = system("python3 scripts/plot_modes.py");
+        if (ret2 != 0) {
+            fprintf(stderr, "Warning: Python script execution returned code %d\n", ret2);
+        } else {
+            printf("Python script executed successfully\n");
+        }
     }
     
     // Sauvegarder les valeurs propres
@@ -171,8 +642,7 @@ void plot_convergence(int* grid_sizes, double** eigenvalues,
                      const char* filename) {
     printf("Generating convergence plot...\n");
     
-    // Créer le répertoire data s'il n'existe pas
-    int ret = system("mkdir -p data"); (void)ret;
+    if (ensure_directory("data") != 0) return;
     
     FILE* conv_file = fopen("data/convergence_data.csv", "w");
     if (!conv_file) {
@@ -197,10 +667,15 @@ void plot_convergence(int* grid_sizes, double** eigenvalues,
     fclose(conv_file);
     printf("Saved convergence data to data/convergence_data.csv\n");
     
-    // Créer le répertoire scripts s'il n'existe pas
-    int ret10 = ret = system("mkdir -p scripts"); (void)ret; (void)ret10;;
+    if (plot_backend == PLOT_NATIVE) {
+        if (render_convergence_png(grid_sizes, eigenvalues, n_sizes, n_eigenvalues, filename) == 0) {
+            printf("Convergence plot saved to %s\n", filename);
+        }
+        return;
+    }
     
     // Générer un script Python pour le plot de convergence
+    if (ensure_directory("scripts") != 0) return;
     FILE* script = fopen("scripts/plot_convergence.py", "w");
     if (!script) {
         fprintf(stderr, "Error: Cannot create convergence plot script\n");
@@ -246,41 +721,80 @@ void plot_convergence(int* grid_sizes, double** eigenvalues,
     
     // Exécuter le script
     printf("Executing convergence plot script...\n");
-    int ret3 = system("python3 scripts/plot_convergence.py"); (void)ret3;
-    if (ret != 0) {
-        fprintf(stderr, "Warning: Convergence plot script returned code %d\n", ret);
+    int ret3 = system("python3 scripts/plot_convergence.py");
+    if (ret3 != 0) {
+        fprintf(stderr, "Warning: Convergence plot script returned code %d\n", ret3);
     }
 }
 
-void plot_matrix_sparsity(SparseMatrixCSR* mat, const char* filename) {
+void plot_matrix_sparsity(SparseMatrixCSR* mat, const char* filename,
+                          OutputFormat pattern_format, SparsityPlotMode mode) {
     printf("Generating matrix sparsity plot...\n");
     
-    // Créer le répertoire data s'il n'existe pas
-    int ret = system("mkdir -p data"); (void)ret;
+    if (ensure_directory("data") != 0) return;
     
-    FILE* data_file = fopen("data/matrix_pattern.csv", "w");
-    if (!data_file) {
-        fprintf(stderr, "Error: Cannot create matrix pattern file\n");
-        return;
+    // Une passe sur la structure CSR: image de densité et statistiques
+    double start = wall_time();
+    SparsityPattern* pattern = compute_sparsity_pattern(mat, SPARSITY_DEFAULT_RESOLUTION);
+    if (!pattern) return;
+    printf("Density image %d x %d computed in %.1f ms\n", pattern->image_rows,
+           pattern->image_cols, 1000.0 * (wall_time() - start));
+    print_sparsity_stats(pattern);
+    if (save_sparsity_stats(pattern, "data/matrix_stats.csv", "data/matrix_row_nnz.csv") == 0) {
+        printf("Saved matrix statistics to data/matrix_stats.csv and data/matrix_row_nnz.csv\n");
     }
+    save_density_image(pattern, pattern_format);
     
-    fprintf(data_file, "row,col\n");
-    for (MKL_INT i = 0; i < mat->n_rows; i++) {
-        for (MKL_INT j = mat->row_index[i]; j < mat->row_index[i + 1]; j++) {
-            fprintf(data_file, "%d,%d\n", (int)i, (int)(int)mat->columns[j]);
+    if (mode == SPARSITY_FULL && pattern_format == OUTPUT_NPY) {
+        // Structure CSR brute: deux blocs contigus au lieu d'une ligne par non-nul
+        NpzWriter* npz = npz_open("data/matrix_pattern.npz");
+        if (!npz) {
+            fprintf(stderr, "Error: Cannot create matrix pattern file\n");
+            free_sparsity_pattern(pattern);
+            return;
+        }
+        size_t rows[1] = {(size_t)mat->n_rows + 1};
+        size_t nnz[1] = {(size_t)mat->nnz};
+        npz_add_array(npz, "indptr", NPY_MKL_INT, 1, rows, mat->row_index);
+        npz_add_array(npz, "indices", NPY_MKL_INT, 1, nnz, mat->columns);
+        if (npz_close(npz) != 0) {
+            free_sparsity_pattern(pattern);
+            return;
+        }
+        printf("Saved matrix pattern to data/matrix_pattern.npz\n");
+    } else if (mode == SPARSITY_FULL) {
+        FILE* data_file = fopen("data/matrix_pattern.csv", "w");
+        if (!data_file) {
+            fprintf(stderr, "Error: Cannot create matrix pattern file\n");
+            free_sparsity_pattern(pattern);
+            return;
+        }
+        
+        fprintf(data_file, "row,col\n");
+        for (MKL_INT i = 0; i < mat->n_rows; i++) {
+            for (MKL_INT j = mat->row_index[i]; j < mat->row_index[i + 1]; j++) {
+                fprintf(data_file, "%d,%d\n", (int)i, (int)(int)mat->columns[j]);
+            }
         }
+        
+        fclose(data_file);
+        printf("Saved matrix pattern to data/matrix_pattern.csv\n");
     }
     
-    fclose(data_file);
-    printf("Saved matrix pattern to data/matrix_pattern.csv\n");
-    
-    // Créer le répertoire scripts s'il n'existe pas
-    int ret12 = ret = system("mkdir -p scripts"); (void)ret; (void)ret12;;
+    if (plot_backend == PLOT_NATIVE) {
+        start = wall_time();
+        if (render_sparsity_png(pattern, filename) == 0) {
+            printf("Sparsity plot saved to %s (%.1f ms)\n", filename, 1000.0 * (wall_time() - start));
+        }
+        free_sparsity_pattern(pattern);
+        return;
+    }
     
     // Script Python pour visualiser la structure
-    FILE* script = fopen("scripts/plot_sparsity.py", "w");
+    FILE* script = ensure_directory("scripts") == 0 ? fopen("scripts/plot_sparsity.py", "w") : NULL;
     if (!script) {
         fprintf(stderr, "Error: Cannot create sparsity plot script\n");
+        free_sparsity_pattern(pattern);
         return;
     }
     
@@ -291,32 +805,57 @@ void plot_matrix_sparsity(SparseMatrixCSR* mat, const char* filename) {
     fprintf(script, "print('Generating matrix sparsity plot...')\n");
     fprintf(script, "\n");
     fprintf(script, "try:\n");
-    fprintf(script, "    data = np.loadtxt('data/matrix_pattern.csv', delimiter=',', skiprows=1)\n");
-    fprintf(script, "    rows = data[:, 0].astype(int)\n");
-    fprintf(script, "    cols = data[:, 1].astype(int)\n");
+    if (mode == SPARSITY_DENSITY) {
+        if (pattern_format == OUTPUT_NPY) {
+            fprintf(script, "    density = np.load('data/matrix_density.npy')\n");
+        } else {
+            fprintf(script, "    density = np.loadtxt('data/matrix_density.csv', delimiter=',', ndmin=2)\n");
+        }
+    } else if (pattern_format == OUTPUT_NPY) {
+        fprintf(script, "    pattern = np.load('data/matrix_pattern.npz')\n");
+        fprintf(script, "    indptr = pattern['indptr']\n");
+        fprintf(script, "    cols = pattern['indices'].astype(int)\n");
+        fprintf(script, "    rows = np.repeat(np.arange(len(indptr) - 1), np.diff(indptr))\n");
+    } else {
+        fprintf(script, "    data = np.loadtxt('data/matrix_pattern.csv', delimiter=',', skiprows=1)\n");
+        fprintf(script, "    rows = data[:, 0].astype(int)\n");
+        fprintf(script, "    cols = data[:, 1].astype(int)\n");
+    }
     fprintf(script, "    \n");
     fprintf(script, "    # Créer le répertoire plots s'il n'existe pas\n");
     fprintf(script, "    os.makedirs('plots', exist_ok=True)\n");
     fprintf(script, "    \n");
     fprintf(script, "    plt.figure(figsize=(10, 10))\n");
     fprintf(script, "    \n");
-    fprintf(script, "    # Tracer les points non nuls\n");
-    fprintf(script, "    plt.scatter(cols, rows, s=0.5, c='blue', alpha=0.6, marker='s')\n");
+    if (mode == SPARSITY_DENSITY) {
+        fprintf(script, "    # Nombre de non-nuls par case, échelle logarithmique\n");
+        fprintf(script, "    from matplotlib.colors import LogNorm\n");
+        fprintf(script, "    masked = np.ma.masked_equal(density, 0)\n");
+        fprintf(script, "    plt.imshow(masked, cmap='viridis_r', norm=LogNorm(vmin=1, vmax=max(1, density.max())),\n");
+        fprintf(script, "               extent=[0, %ld, %ld, 0], interpolation='nearest')\n",
+                (long)mat->n_cols, (long)mat->n_rows);
+        fprintf(script, "    plt.colorbar(label='Non-zeros per bin', shrink=0.8)\n");
+    } else {
+        fprintf(script, "    # Tracer les points non nuls\n");
+        fprintf(script, "    plt.scatter(cols, rows, s=0.5, c='blue', alpha=0.6, marker='s')\n");
+        fprintf(script, "    plt.gca().invert_yaxis()\n");
+        fprintf(script, "    plt.axis('equal')\n");
+    }
     fprintf(script, "    \n");
     fprintf(script, "    plt.title('Matrix Sparsity Pattern', fontsize=14)\n");
     fprintf(script, "    plt.xlabel('Column Index', fontsize=12)\n");
     fprintf(script, "    plt.ylabel('Row Index', fontsize=12)\n");
-    fprintf(script, "    plt.gca().invert_yaxis()\n");
     fprintf(script, "    plt.grid(True, alpha=0.2)\n");
-    fprintf(script, "    plt.axis('equal')\n");
     fprintf(script, "    \n");
     fprintf(script, "    # Ajouter des informations sur la matrice\n");
     fprintf(script, "    n_rows = %d\n", (int)(int)mat->n_rows);
     fprintf(script, "    n_cols = %d\n", (int)(int)mat->n_cols);
-    fprintf(script, "    nnz = len(rows)\n");
+    fprintf(script, "    nnz = %ld\n", (long)mat->nnz);
     fprintf(script, "    sparsity = (1.0 - nnz/(n_rows*n_cols)) * 100\n");
     fprintf(script, "    \n");
     fprintf(script, "    info_text = f'Dimensions: {n_rows} x {n_cols}\\nNon-zeros: {nnz}\\nSparsity: {sparsity:.2f}%%'\n");
+    fprintf(script, "    info_text += '\\nBandwidth: %ld/%ld\\nProfile: %lld'\n",
+            (long)pattern->lower_bandwidth, (long)pattern->upper_bandwidth, pattern->profile);
     fprintf(script, "    plt.figtext(0.02, 0.98, info_text, fontsize=10,\n");
     fprintf(script, "                verticalalignment='top',\n");
     fprintf(script, "                bbox=dict(boxstyle='round', facecolor='wheat', alpha=0.8))\n");
@@ -330,17 +869,200 @@ void plot_matrix_sparsity(SparseMatrixCSR* mat, const char* filename) {
     fprintf(script, "    print(f'Error generating sparsity plot: {e}')\n");
     
     fclose(script);
+    free_sparsity_pattern(pattern);
     
     // Exécuter le script
     printf("Executing sparsity plot script...\n");
-    int ret4 = system("python3 scripts/plot_sparsity.py"); (void)ret4;
-    if (ret != 0) {
-        fprintf(stderr, "Warning: Sparsity plot script returned code %d\n", ret);
+    int ret4 = system("python3 scripts/plot_sparsity.py");
+    if (ret4 != 0) {
+        fprintf(stderr, "Warning: Sparsity plot script returned code %d\n", ret4);
     }
 }
 
+// Interpolation bilinéaire précalculée: 4 noeuds et poids par pixel (y vers le haut),
+// les noeuds du bord (Dirichlet) ont un poids nul
+typedef struct {
+    int32_t node[4];
+    float weight[4];
+} PixelStencil;
+
+static PixelStencil* build_pixel_stencils(int N, int S) {
+    PixelStencil* stencils = (PixelStencil*)malloc((size_t)S * S * sizeof(PixelStencil));
+    if (!stencils) return NULL;
+    
+    for (int py = 0; py < S; py++) {
+        double gy = (1.0 - (py + 0.5) / S) * (N + 1) - 1.0;
+        int j0 = (int)floor(gy);
+        double fy = gy - j0;
+        for (int px = 0; px < S; px++) {
+            double gx = (px + 0.5) / S * (N + 1) - 1.0;
+            int i0 = (int)floor(gx);
+            double fx = gx - i0;
+            PixelStencil* st = &stencils[(size_t)py * S + px];
+            for (int c = 0; c < 4; c++) {
+                int di = c >> 1, dj = c & 1;
+                int i = i0 + di, j = j0 + dj;
+                int inside = i >= 0 && i < N && j >= 0 && j < N;
+                st->node[c] = inside ? i * N + j : 0;
+                st->weight[c] = inside ? (float)((di ? fx : 1 - fx) * (dj ? fy : 1 - fy)) : 0.0f;
+            }
+        }
+    }
+    return stencils;
+}
+
 void create_animation(Mesh* mesh, EigenResults* results, 
                      int n_modes, const char* output_dir) {
-    printf("Animation generation not yet implemented\n");
-    // TODO: Implémenter la génération d'animation
+    AnimationOptions opts = animation_options;
+    if (opts.format == ANIMATION_NONE || opts.n_frames <= 0) return;
+    if (!mesh || !results || results->n_dof != mesh->N * mesh->N) {
+        printf("Skipping animation (no grid for these modes)\n");
+        return;
+    }
+    
+    double start = wall_time();
+    int N = mesh->N;
+    int n = results->n_dof;
+    int k = n_modes < results->n_eigenvalues ? n_modes : results->n_eigenvalues;
+    int S = opts.image_size;
+    int F = opts.n_frames;
+    if (k <= 0) return;
+    
+    printf("Generating animation (%d modes, %d frames, %dx%d)...\n", k, F, S, S);
+    
+    double* amplitude = (double*)malloc(k * sizeof(double));
+    double* omega = (double*)malloc(k * sizeof(double));
+    double* coeffs = (double*)malloc((size_t)k * ANIMATION_BATCH * sizeof(double));
+    double* frames = (double*)mkl_malloc((size_t)n * ANIMATION_BATCH * sizeof(double), 64);
+    uint8_t* indices = (uint8_t*)malloc((size_t)S * S * ANIMATION_BATCH);
+    uint8_t** encoded = (uint8_t**)calloc(ANIMATION_BATCH, sizeof(uint8_t*));
+    size_t* encoded_size = (size_t*)calloc(ANIMATION_BATCH, sizeof(size_t));
+    PixelStencil* stencils = build_pixel_stencils(N, S);
+    Color palette[256];
+    GifWriter* gif = NULL;
+    FILE* raw = NULL;
+    int n_written = 0;
+    double synthesis_time = 0.0, raster_time = 0.0;
+    
+    if (!amplitude || !omega || !coeffs || !frames || !indices || !encoded || !encoded_size ||
+        !stencils) {
+        fprintf(stderr, "Error: Failed to allocate animation buffers\n");
+        goto cleanup;
+    }
+    
+    // Chaque mode culmine à 1; une période du mode fondamental
+    for (int i = 0; i < k; i++) {
+        const double* mode = results->eigenvectors[i];
+        double peak = 0.0;
+        for (int p = 0; p < n; p++) {
+            if (fabs(mode[p]) > peak) peak = fabs(mode[p]);
+        }
+        amplitude[i] = peak > 0.0 ? 1.0 / peak : 0.0;
+        omega[i] = sqrt(fabs(results->eigenvalues[i]));
+    }
+    double period = omega[0] > 0.0 ? 2 * PI / omega[0] : 1.0;
+    
+    // Echelle des couleurs: amplitude à t = 0, où tous les modes sont en phase
+    cblas_dgemv(CblasColMajor, CblasNoTrans, n, k, 1.0, results->modes, n,
+                amplitude, 1, 0.0, frames, 1);
+    double vmax = 0.0;
+    for (int p = 0; p < n; p++) {
+        if (fabs(frames[p]) > vmax) vmax = fabs(frames[p]);
+    }
+    if (vmax == 0.0) vmax = 1.0;
+    
+    for (int c = 0; c < 256; c++) palette[c] = colormap_color(COLORMAP_RDBU, c / 255.0);
+    
+    char filename[512];
+    if (opts.format == ANIMATION_GIF) {
+        snprintf(filename, sizeof(filename), "%s/animation.gif", output_dir);
+        gif = gif_open(filename, S, S, palette, (100 + opts.fps / 2) / opts.fps);
+        if (!gif) goto cleanup;
+    } else {
+        snprintf(filename, sizeof(filename), "%s/animation.rgb", output_dir);
+        raw = fopen(filename, "wb");
+        if (!raw) {
+            fprintf(stderr, "Error: Cannot open file %s for writing\n", filename);
+            goto cleanup;
+        }
+    }
+    
+    for (int first = 0; first < F; first += ANIMATION_BATCH) {
+        int batch = F - first < ANIMATION_BATCH ? F - first : ANIMATION_BATCH;
+        double t0 = wall_time();
+        
+        // U (n x batch) = Phi (n x k) * C (k x batch), C[i, f] = a_i cos(omega_i t_f)
+        for (int f = 0; f < batch; f++) {
+            double t = period * (first + f) / F;
+            for (int i = 0; i < k; i++) {
+                coeffs[(size_t)f * k + i] = amplitude[i] * cos(omega[i] * t);
+            }
+        }
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, batch, k,
+                    1.0 / vmax, results->modes, n, coeffs, k, 0.0, frames, n);
+        double t1 = wall_time();
+        synthesis_time += t1 - t0;
+        
+        // Rasterisation et compression indépendantes par image
+        #pragma omp parallel for schedule(dynamic)
+        for (int f = 0; f < batch; f++) {
+            const double* u = frames + (size_t)f * n;
+            uint8_t* frame = indices + (size_t)f * S * S;
+            for (size_t p = 0; p < (size_t)S * S; p++) {
+                const PixelStencil* st = &stencils[p];
+                double value = st->weight[0] * u[st->node[0]] + st->weight[1] * u[st->node[1]] +
+                               st->weight[2] * u[st->node[2]] + st->weight[3] * u[st->node[3]];
+                double level = 127.5 + 127.5 * value;
+                frame[p] = (uint8_t)(level < 0.0 ? 0 : level > 255.0 ? 255 : level);
+            }
+            if (gif) encoded[f] = gif_encode_frame(frame, S, S, &encoded_size[f]);
+        }
+        raster_time += wall_time() - t1;
+        
+        // Ecriture dans l'ordre
+        for (int f = 0; f < batch; f++) {
+            if (gif) {
+                if (encoded[f] && gif_add_encoded_frame(gif, encoded[f], encoded_size[f]) == 0) {
+                    n_written++;
+                }
+                free(encoded[f]);
+                encoded[f] = NULL;
+            } else {
+                const uint8_t* frame = indices + (size_t)f * S * S;
+                uint8_t row[3 * 4096];
+                int ok = 1;
+                for (int py = 0; py < S && ok; py++) {
+                    for (int px = 0; px < S; px++) {
+                        Color color = palette[frame[(size_t)py * S + px]];
+                        row[3 * px] = color.r;
+                        row[3 * px + 1] = color.g;
+                        row[3 * px + 2] = color.b;
+                    }
+                    ok = fwrite(row, 3, S, raw) == (size_t)S;
+                }
+                if (ok) n_written++;
+            }
+        }
+    }
+    
+    printf("Animation: %d/%d frames written to %s in %.2f s (synthesis %.2f s, raster+encode %.2f s)\n",
+           n_written, F, filename, wall_time() - start, synthesis_time, raster_time);
+    if (raw) {
+        printf("Encode with: ffmpeg -f rawvideo -pixel_format rgb24 -video_size %dx%d "
+               "-framerate %d -i %s %s/animation.mp4\n", S, S, opts.fps, filename, output_dir);
+    }
+    
+cleanup:
+    if (gif && gif_close(gif) != 0) {
+        fprintf(stderr, "Error: Failed to write animation\n");
+    }
+    if (raw) fclose(raw);
+    free(amplitude);
+    free(omega);
+    free(coeffs);
+    if (frames) mkl_free(frames);
+    free(indices);
+    free(encoded);
+    free(encoded_size);
+    free(stencils);
 }
@@ -0,0 +1,311 @@
+#include "wave_solver.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mkl/mkl.h>
+
+// Coefficients du stencil rangés par arête: une arête est partagée par ses deux points,
+// ce qui fait 4 flux de coefficients par point (ex, ey, s, sq) au lieu de 6
+typedef struct {
+    int N;
+    size_t P;          // Pas d'une ligne des champs, avec une couronne de zéros (u = 0 au bord)
+    double* ex;        // (N + 1) x N: arête entre (i - 1, j) et (i, j), p(i - 1/2, j) / h²
+    double* ey;        // N x (N + 1): arête entre (i, j - 1) et (i, j), p(i, j - 1/2) / h²
+    double* s;         // dt² / w
+    double* sq;        // dt² q / w
+    double* sf;        // dt² f / w (NULL sans charge)
+} WaveCoefficients;
+
+// Arête intérieure: moyenne de p; arête de bord: p du point intérieur (voisin nul),
+// comme les branches de bord de build_stiffness_matrix
+static double edge_x(const Mesh* mesh, int i, int j) {
+    int N = mesh->N;
+    const double* p = mesh->p_vals;
+    if (i == 0) return p[j];
+    if (i == N) return p[(size_t)(N - 1) * N + j];
+    return 0.5 * (p[(size_t)(i - 1) * N + j] + p[(size_t)i * N + j]);
+}
+
+static double edge_y(const Mesh* mesh, int i, int j) {
+    int N = mesh->N;
+    const double* p = mesh->p_vals + (size_t)i * N;
+    if (j == 0) return p[0];
+    if (j == N) return p[N - 1];
+    return 0.5 * (p[j - 1] + p[j]);
+}
+
+double wave_stable_dt(const Mesh* mesh) {
+    int N = mesh->N;
+    double inv_h2 = 1.0 / (mesh->h * mesh->h);
+    double bound = 0.0;
+    
+    // Ligne de W⁻¹A: diagonale + voisins = 2 Σ arêtes + q (arêtes de bord comptées deux fois)
+    #pragma omp parallel for reduction(max:bound) schedule(static)
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            size_t idx = (size_t)i * N + j;
+            double edges = edge_x(mesh, i, j) + edge_x(mesh, i + 1, j) +
+                           edge_y(mesh, i, j) + edge_y(mesh, i, j + 1);
+            double row = (2.0 * edges * inv_h2 + fabs(mesh->q_vals[idx])) / mesh->w_vals[idx];
+            if (row > bound) bound = row;
+        }
+    }
+    return bound > 0.0 ? 2.0 / sqrt(bound) : INFINITY;
+}
+
+int wave_plan(const Mesh* mesh, const WaveProblem* problem, WaveStats* stats) {
+    if (!(problem->t_end > 0.0) || problem->dt < 0.0 || problem->cfl < 0.0 ||
+        problem->sample_every < 0) {
+        fprintf(stderr, "Error: Wave integration needs t_end > 0, dt >= 0 and cfl >= 0\n");
+        return -1;
+    }
+    for (int k = 0; k < problem->n_sensors; k++) {
+        if (problem->sensors[k] < 0 || problem->sensors[k] >= mesh->total_points) {
+            fprintf(stderr, "Error: Sensor %d is outside the mesh\n", k + 1);
+            return -1;
+        }
+    }
+    
+    // Au-delà de la limite, le schéma diverge: refusé plutôt que de produire des NaN
+    double stable_dt = wave_stable_dt(mesh);
+    double cfl = problem->cfl > 0.0 ? problem->cfl : WAVE_DEFAULT_CFL;
+    double dt = problem->dt > 0.0 ? problem->dt : cfl * stable_dt;
+    if (cfl > 1.0 || dt > stable_dt) {
+        fprintf(stderr, "Error: dt = %.3e exceeds the stability bound %.3e (CFL %.3g)\n",
+                dt, stable_dt, dt / stable_dt);
+        return -1;
+    }
+    
+    // Pas ajusté pour tomber exactement sur t_end (jamais plus grand que demandé)
+    long n_steps = (long)ceil(problem->t_end / dt - 1e-9);
+    if (n_steps < 1) n_steps = 1;
+    int every = problem->sample_every > 0 ? problem->sample_every : 1;
+    
+    stats->dt = problem->t_end / n_steps;
+    stats->stable_dt = stable_dt;
+    stats->n_steps = n_steps;
+    stats->n_samples = n_steps / every + 1;
+    stats->seconds = 0.0;
+    stats->updates_per_second = 0.0;
+    return 0;
+}
+
+static void free_coefficients(WaveCoefficients* c) {
+    mkl_free(c->ex);
+    mkl_free(c->ey);
+    mkl_free(c->s);
+    mkl_free(c->sq);
+    mkl_free(c->sf);
+}
+
+static int build_coefficients(const Mesh* mesh, const double* load, double dt,
+                              WaveCoefficients* c) {
+    int N = mesh->N;
+    size_t n = (size_t)mesh->total_points;
+    double inv_h2 = 1.0 / (mesh->h * mesh->h);
+    double dt2 = dt * dt;
+    
+    c->N = N;
+    c->P = (size_t)N + 2;
+    c->ex = (double*)mkl_malloc((size_t)(N + 1) * N * sizeof(double), 64);
+    c->ey = (double*)mkl_malloc((size_t)N * (N + 1) * sizeof(double), 64);
+    c->s = (double*)mkl_malloc(n * sizeof(double), 64);
+    c->sq = (double*)mkl_malloc(n * sizeof(double), 64);
+    c->sf = load ? (double*)mkl_malloc(n * sizeof(double), 64) : NULL;
+    if (!c->ex || !c->ey || !c->s || !c->sq || (load && !c->sf)) {
+        free_coefficients(c);
+        return -1;
+    }
+    
+    // Première écriture par les threads qui balaient ensuite les mêmes lignes
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i <= N; i++) {
+        for (int j = 0; j < N; j++) c->ex[(size_t)i * N + j] = edge_x(mesh, i, j) * inv_h2;
+        if (i == N) continue;
+        for (int j = 0; j <= N; j++) c->ey[(size_t)i * (N + 1) + j] = edge_y(mesh, i, j) * inv_h2;
+        for (int j = 0; j < N; j++) {
+            size_t idx = (size_t)i * N + j;
+            double s = dt2 / mesh->w_vals[idx];
+            c->s[idx] = s;
+            c->sq[idx] = s * mesh->q_vals[idx];
+            if (load) c->sf[idx] = s * load[idx];
+        }
+    }
+    return 0;
+}
+
+// Une ligne de la tuile: out = 2u - out - half (s ∇·flux + sq u - sf g)
+static inline void wave_row(const WaveCoefficients* c, const double* restrict u,
+                            double* restrict out, int i, int j0, int j1, double g, double half) {
+    int N = c->N;
+    size_t P = c->P;
+    const double* restrict row = u + (size_t)(i + 1) * P + 1;
+    const double* restrict above = row - P;
+    const double* restrict below = row + P;
+    double* restrict next = out + (size_t)(i + 1) * P + 1;
+    const double* restrict ex0 = c->ex + (size_t)i * N;
+    const double* restrict ex1 = ex0 + N;
+    const double* restrict ey = c->ey + (size_t)i * (N + 1);
+    const double* restrict s = c->s + (size_t)i * N;
+    const double* restrict sq = c->sq + (size_t)i * N;
+    
+    if (c->sf) {
+        const double* restrict sf = c->sf + (size_t)i * N;
+        #pragma omp simd
+        for (int j = j0; j < j1; j++) {
+            double uc = row[j];
+            double flux = ex0[j] * (uc - above[j]) + ex1[j] * (uc - below[j]) +
+                          ey[j] * (uc - row[j - 1]) + ey[j + 1] * (uc - row[j + 1]);
+            next[j] = 2.0 * uc - next[j] - half * (s[j] * flux + sq[j] * uc - sf[j] * g);
+        }
+    } else {
+        #pragma omp simd
+        for (int j = j0; j < j1; j++) {
+            double uc = row[j];
+            double flux = ex0[j] * (uc - above[j]) + ex1[j] * (uc - below[j]) +
+                          ey[j] * (uc - row[j - 1]) + ey[j + 1] * (uc - row[j + 1]);
+            next[j] = 2.0 * uc - next[j] - half * (s[j] * flux + sq[j] * uc);
+        }
+    }
+}
+
+// u^{n+1} écrit à la place de u^{n-1}; half = 1/2 au premier pas (développement de Taylor)
+static void wave_step(const WaveCoefficients* c, const double* u, double* previous,
+                      double g, double half) {
+    int N = c->N;
+    int tile_rows = (N + WAVE_TILE_ROWS - 1) / WAVE_TILE_ROWS;
+    int tile_cols = (N + WAVE_TILE_COLS - 1) / WAVE_TILE_COLS;
+    
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int ti = 0; ti < tile_rows; ti++) {
+        for (int tj = 0; tj < tile_cols; tj++) {
+            int i1 = (ti + 1) * WAVE_TILE_ROWS < N ? (ti + 1) * WAVE_TILE_ROWS : N;
+            int j0 = tj * WAVE_TILE_COLS;
+            int j1 = j0 + WAVE_TILE_COLS < N ? j0 + WAVE_TILE_COLS : N;
+            for (int i = ti * WAVE_TILE_ROWS; i < i1; i++) {
+                wave_row(c, u, previous, i, j0, j1, g, half);
+            }
+        }
+    }
+}
+
+static double load_at(const WaveProblem* problem, double t) {
+    return problem->profile ? problem->profile(t, problem->profile_data) : 1.0;
+}
+
+int wave_solve(const Mesh* mesh, const WaveProblem* problem, WaveSensorSinkFn sink, void* data,
+               WaveStats* stats) {
+    WaveStats plan;
+    if (wave_plan(mesh, problem, &plan) != 0) return -1;
+    
+    int N = mesh->N;
+    size_t n = (size_t)mesh->total_points;
+    size_t P = (size_t)N + 2;
+    size_t padded = P * P;
+    int n_sensors = problem->n_sensors;
+    int every = problem->sample_every > 0 ? problem->sample_every : 1;
+    double dt = plan.dt;
+    
+    profiler_begin("wave");
+    profiler_begin("wave_setup");
+    WaveCoefficients c;
+    double* u = (double*)mkl_malloc(padded * sizeof(double), 64);
+    double* previous = (double*)mkl_malloc(padded * sizeof(double), 64);
+    size_t* taps = (size_t*)malloc((n_sensors > 0 ? n_sensors : 1) * sizeof(size_t));
+    if (!u || !previous || !taps || build_coefficients(mesh, problem->load, dt, &c) != 0) {
+        fprintf(stderr, "Error: Memory allocation failed for the wave solver\n");
+        mkl_free(u);
+        mkl_free(previous);
+        free(taps);
+        profiler_end();
+        profiler_end();
+        return -1;
+    }
+    
+    // u^0 et u^{-1} = u^0 - dt u̇^0: le premier pas (half = 1/2) donne alors
+    // u^1 = u^0 + dt u̇^0 + dt²/2 W⁻¹(f g(0) - A u^0)
+    #pragma omp parallel for schedule(static)
+    for (size_t r = 0; r < P; r++) {
+        for (size_t col = 0; col < P; col++) {
+            double u0 = 0.0, v0 = 0.0;
+            if (r >= 1 && r <= (size_t)N && col >= 1 && col <= (size_t)N) {
+                size_t idx = (r - 1) * N + (col - 1);
+                if (problem->initial_displacement) u0 = problem->initial_displacement[idx];
+                if (problem->initial_velocity) v0 = problem->initial_velocity[idx];
+            }
+            u[r * P + col] = u0;
+            previous[r * P + col] = u0 - dt * v0;
+        }
+    }
+    for (int k = 0; k < n_sensors; k++) {
+        size_t idx = (size_t)problem->sensors[k];
+        taps[k] = (idx / N + 1) * P + idx % N + 1;
+    }
+    profiler_end();
+    
+    // ============ BOUCLE EN TEMPS ============
+    // Les lots de capteurs partent au puits (écriture en arrière-plan) sans attendre
+    int status = 0;
+    double* batch = NULL;
+    int batch_count = 0;
+    long batch_first = 0;
+    double sink_seconds = 0.0;
+    double start = profiler_now();
+    profiler_begin("wave_steps");
+    for (long step = 0; step <= plan.n_steps && status == 0; step++) {
+        if (step > 0) {
+            wave_step(&c, u, previous, load_at(problem, (step - 1) * dt), step == 1 ? 0.5 : 1.0);
+            double* swap = u;
+            u = previous;
+            previous = swap;
+        }
+        if (n_sensors == 0 || step % every != 0) continue;
+    
+        if (!batch) {
+            batch = (double*)malloc((size_t)WAVE_SENSOR_BATCH * n_sensors * sizeof(double));
+            if (!batch) {
+                fprintf(stderr, "Error: Memory allocation failed for sensor samples\n");
+                status = -1;
+                break;
+            }
+            batch_first = step / every;
+            batch_count = 0;
+        }
+        for (int k = 0; k < n_sensors; k++) {
+            batch[(size_t)batch_count * n_sensors + k] = u[taps[k]];
+        }
+        batch_count++;
+    
+        if (batch_count == WAVE_SENSOR_BATCH || step + every > plan.n_steps) {
+            double sink_start = profiler_now();
+            if (sink) {
+                if (sink(batch_first, batch_count, batch, data) != 0) status = -1;
+            } else {
+                free(batch);
+            }
+            batch = NULL;
+            sink_seconds += profiler_now() - sink_start;
+        }
+    }
+    free(batch);
+    
+    // Par point et par pas: 4 flux (3 flops), s, sq, sf, 2u - u^{n-1}; 4 ou 5 tableaux de
+    // coefficients, u (voisins en cache) et u^{n-1} lus, u^{n+1} écrit
+    double updates = (double)n * plan.n_steps;
+    int streams = c.sf ? 8 : 7;
+    profiler_add_work(updates * (c.sf ? 21.0 : 19.0), updates * streams * sizeof(double));
+    profiler_end();
+    profiler_end();
+    
+    plan.seconds = profiler_now() - start - sink_seconds;
+    plan.updates_per_second = plan.seconds > 0.0 ? updates / plan.seconds : 0.0;
+    if (stats) *stats = plan;
+    
+    free_coefficients(&c);
+    mkl_free(u);
+    mkl_free(previous);
+    free(taps);
+    return status;
+}
@@ -0,0 +1,1493 @@
+// Vérification de non-régression: chaque solveur contre des spectres connus (analytique,
+// coefficients constants, potentiel séparable, tension p(x) par spectres 1D), contre le
+// solveur dense (coefficients variables), orthogonalité des modes, sensibilités contre différences finies, formats de
+// fichiers (allers-retours, fichiers corrompus refusés), puis budgets de temps et de mémoire
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include "membrane.h"
+#include "mesh.h"
+#include "matrix_builder.h"
+#include "solver.h"
+#include "membrane_context.h"
+#include "mode_archive.h"
+#include "sensitivity.h"
+#include "modal_response.h"
+#include "wave_solver.h"
+#include "frf.h"
+#include "profiler.h"
+#include "result_cache.h"
+#include "symmetry.h"
+
+#define CHECK_MAX_BUDGETS 64
+#define CHECK_MODES 8
+#define CHECK_TRIALS 3              // Meilleur temps sur CHECK_TRIALS exécutions
+#define CHECK_ITERATIVE_EPS 1e-10   // Tolérance demandée aux solveurs itératifs
+
+typedef struct {
+    const char* baseline;       // Budgets de référence
+    const char* write_baseline; // Budgets mesurés écrits ici (référence à régénérer)
+    double time_factor;         // Ralentissement toléré par rapport à la référence
+    double memory_factor;
+    int skip_performance;
+} CheckOptions;
+
+// Problème de référence: coefficients et spectre exact (NULL: solveur dense)
+typedef struct {
+    const char* name;
+    const char* p;
+    const char* w;
+    const char* q;
+    void (*spectrum)(int N, int k, double* values);
+} CheckCase;
+
+typedef struct {
+    char kernel[16];
+    char solver[16];
+    int N;
+    int k;
+    double seconds;
+    double megabytes;
+} Budget;
+
+static int n_checks = 0;
+static int n_failures = 0;
+
+static void report(int passed, const char* kind, const char* name, const char* solver,
+                   int N, const char* detail) {
+    n_checks++;
+    if (!passed) n_failures++;
+    printf("[%s] %-11s %-10s %-17s N=%-3d %s\n", passed ? "PASS" : "FAIL", kind, name, solver,
+           N, detail);
+}
+
+// ============ SPECTRES DE REFERENCE ============
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// k plus petites sommes mu[i] + nu[j] (opérateur séparable: somme de Kronecker)
+static void smallest_sums(int N, int k, const double* mu, const double* nu, double* values) {
+    double* all = (double*)malloc((size_t)N * N * sizeof(double));
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) all[i * N + j] = mu[i] + nu[j];
+    }
+    qsort(all, (size_t)N * N, sizeof(double), compare_double);
+    memcpy(values, all, k * sizeof(double));
+    free(all);
+}
+
+// Laplacien discret avec Dirichlet: (4/h²)(sin²(iπh/2) + sin²(jπh/2))
+static void laplacian_1d(int N, double* mu) {
+    double h = DOMAIN_SIZE / (N + 1);
+    for (int i = 0; i < N; i++) {
+        double s = sin((i + 1) * PI * h / 2.0);
+        mu[i] = 4.0 / (h * h) * s * s;
+    }
+}
+
+static void laplacian_spectrum(int N, int k, double* values) {
+    double* mu = (double*)malloc(N * sizeof(double));
+    laplacian_1d(N, mu);
+    smallest_sums(N, k, mu, mu, values);
+    free(mu);
+}
+
+// p = 2, w = 0.5, q = 3: (2 λ + 3) / 0.5
+static void scaled_spectrum(int N, int k, double* values) {
+    laplacian_spectrum(N, k, values);
+    for (int i = 0; i < k; i++) values[i] = (2.0 * values[i] + 3.0) / 0.5;
+}
+
+// Valeurs propres de -d²/dx² + a(x) sur la grille 1D (matrice tridiagonale, DSYEV)
+static void operator_1d(int N, double (*a)(double), double* mu) {
+    double h = DOMAIN_SIZE / (N + 1);
+    double* T = (double*)calloc((size_t)N * N, sizeof(double));
+    for (int i = 0; i < N; i++) {
+        T[i * N + i] = 2.0 / (h * h) + a((i + 1) * h);
+        if (i > 0) T[i * N + i - 1] = T[(i - 1) * N + i] = -1.0 / (h * h);
+    }
+    MKL_INT n = N, lwork = 3 * N, info;
+    double* work = (double*)malloc(lwork * sizeof(double));
+    dsyev("N", "U", &n, T, &n, mu, work, &lwork, &info);
+    free(work);
+    free(T);
+}
+
+static double potential_x(double x) { return 30.0 * x * x; }
+static double potential_y(double y) { return 10.0 * sin(PI * y); }
+
+// p = w = 1, q = a(x) + b(y): somme des spectres 1D
+static void separable_spectrum(int N, int k, double* values) {
+    double* mu = (double*)malloc(N * sizeof(double));
+    double* nu = (double*)malloc(N * sizeof(double));
+    operator_1d(N, potential_x, mu);
+    operator_1d(N, potential_y, nu);
+    smallest_sums(N, k, mu, nu, values);
+    free(mu);
+    free(nu);
+}
+
+static double tension_x(double x) { return 1.0 + x + 2.0 * x * x; }
+
+// p = p(x), w = 1, q = 0: sur chaque mode ν_j du laplacien 1D en y, le problème en x est
+// -(p u')' + ν_j p u (p aux demi-points par moyenne, bord u = 0: p(x_i)/h² sur la diagonale);
+// le spectre est la réunion des N spectres 1D
+static void tension_spectrum(int N, int k, double* values) {
+    double h = DOMAIN_SIZE / (N + 1);
+    double* nu = (double*)malloc(N * sizeof(double));
+    double* p = (double*)malloc(N * sizeof(double));
+    double* all = (double*)malloc((size_t)N * N * sizeof(double));
+    double* T = (double*)malloc((size_t)N * N * sizeof(double));
+    MKL_INT n = N, lwork = 3 * N, info;
+    double* work = (double*)malloc(lwork * sizeof(double));
+    laplacian_1d(N, nu);
+    for (int i = 0; i < N; i++) p[i] = tension_x((i + 1) * h);
+    
+    for (int j = 0; j < N; j++) {
+        memset(T, 0, (size_t)N * N * sizeof(double));
+        for (int i = 0; i < N; i++) {
+            double left = i > 0 ? 0.5 * (p[i] + p[i - 1]) : p[i];
+            double right = i < N - 1 ? 0.5 * (p[i] + p[i + 1]) : p[i];
+            T[i * N + i] = (left + right) / (h * h) + nu[j] * p[i];
+            if (i > 0) T[i * N + i - 1] = T[(i - 1) * N + i] = -left / (h * h);
+        }
+        dsyev("N", "U", &n, T, &n, all + (size_t)j * N, work, &lwork, &info);
+    }
+    qsort(all, (size_t)N * N, sizeof(double), compare_double);
+    memcpy(values, all, k * sizeof(double));
+    free(work);
+    free(T);
+    free(all);
+    free(p);
+    free(nu);
+}
+
+static const CheckCase check_cases[] = {
+    {"laplacian", "1", "1", "0", laplacian_spectrum},
+    {"scaled", "2", "0.5", "3", scaled_spectrum},
+    {"separable", "1", "1", "30*x^2 + 10*sin(pi*y)", separable_spectrum},
+    // Tension variable en x: termes p/h² du bord compris, contre des spectres 1D
+    {"tension", "1 + x + 2*x^2", "1", "0", tension_spectrum},
+    {"variable", "", "", "", NULL},    // Coefficients par défaut, référence dense
+    // Invariant par x <-> 1-x, y <-> 1-y, x <-> y: classes de symétrie contre la grille complète
+    {"symmetric", "1 + 0.5*cos(2*pi*x)*cos(2*pi*y)", "1 + x*(1-x) + y*(1-y)",
+     "50*exp(-50*((x-0.5)^2 + (y-0.5)^2))", NULL},
+};
+
+// ============ MESURES SUR LES MODES ============
+
+static void csr_apply(const SparseMatrixCSR* M, const double* x, double* y) {
+    for (MKL_INT i = 0; i < M->n_rows; i++) {
+        double sum = 0.0;
+        for (MKL_INT e = M->row_index[i]; e < M->row_index[i + 1]; e++) {
+            sum += M->values[e] * x[M->columns[e]];
+        }
+        y[i] = sum;
+    }
+}
+
+static double dot(int n, const double* x, const double* y) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += x[i] * y[i];
+    return sum;
+}
+
+// Plus grand résidu relatif |Av - λBv| / (|λ| |Bv|) et plus grand cosinus B-orthogonal
+// entre deux modes distincts (indépendant de la normalisation des modes)
+static void mode_quality(const SparseMatrixCSR* A, const SparseMatrixCSR* B,
+                         const EigenResults* results, double* residual, double* orthogonality) {
+    int n = results->n_dof;
+    int k = results->n_eigenvalues;
+    double* Av = (double*)malloc(n * sizeof(double));
+    double* BV = (double*)malloc((size_t)n * k * sizeof(double));
+    double* norms = (double*)malloc(k * sizeof(double));
+    
+    *residual = 0.0;
+    for (int i = 0; i < k; i++) {
+        const double* v = results->eigenvectors[i];
+        double* Bv = BV + (size_t)i * n;
+        csr_apply(A, v, Av);
+        csr_apply(B, v, Bv);
+        double lambda = results->eigenvalues[i];
+        double r2 = 0.0;
+        for (int j = 0; j < n; j++) {
+            double r = Av[j] - lambda * Bv[j];
+            r2 += r * r;
+        }
+        double relative = sqrt(r2) / (fabs(lambda) * sqrt(dot(n, Bv, Bv)));
+        if (relative > *residual) *residual = relative;
+        norms[i] = sqrt(dot(n, v, Bv));
+    }
+    
+    *orthogonality = 0.0;
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < i; j++) {
+            double c = fabs(dot(n, results->eigenvectors[i], BV + (size_t)j * n)) /
+                       (norms[i] * norms[j]);
+            if (c > *orthogonality) *orthogonality = c;
+        }
+    }
+    free(Av);
+    free(BV);
+    free(norms);
+}
+
+// Sorties des solveurs masquées pendant les vérifications
+static int saved_stdout = -1;
+
+static int silence(int fd) {
+    fflush(stdout);
+    fflush(stderr);
+    int saved = dup(fd);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, fd);
+        close(null_fd);
+    }
+    return saved;
+}
+
+static void restore(int fd, int saved) {
+    fflush(stdout);
+    fflush(stderr);
+    if (saved >= 0) {
+        dup2(saved, fd);
+        close(saved);
+    }
+}
+
+static void quiet_begin(void) {
+    saved_stdout = silence(STDOUT_FILENO);
+}
+
+static void quiet_end(void) {
+    restore(STDOUT_FILENO, saved_stdout);
+    saved_stdout = -1;
+}
+
+// ============ PRECISION ============
+
+static MembraneParams* case_params(const CheckCase* c) {
+    MembraneParams* params = create_default_params();
+    if (!params) return NULL;
+    if ((c->p[0] && set_coefficient_expression(params, 'p', c->p) != 0) ||
+        (c->w[0] && set_coefficient_expression(params, 'w', c->w) != 0) ||
+        (c->q[0] && set_coefficient_expression(params, 'q', c->q) != 0)) {
+        free_membrane_params(params);
+        return NULL;
+    }
+    return params;
+}
+
+// Tolérances: solveurs directs à la précision machine près, itératifs selon leur critère
+static double eigenvalue_tolerance(SolverType solver) {
+    return solver == SOLVER_LOBPCG || solver == SOLVER_MATRIX_FREE ? 1e-8 : 1e-10;
+}
+
+static double residual_tolerance(SolverType solver) {
+    return solver == SOLVER_LOBPCG || solver == SOLVER_MATRIX_FREE ? 1e-8 : 1e-10;
+}
+
+static void check_case(MembraneContext* context, const CheckCase* c, int N) {
+    MembraneParams* params = case_params(c);
+    Mesh* mesh = params ? create_mesh(N, params) : NULL;
+    SparseMatrixCSR* A = mesh ? build_stiffness_matrix(mesh) : NULL;
+    SparseMatrixCSR* B = mesh ? build_mass_matrix(mesh) : NULL;
+    if (!A || !B) {
+        report(0, "setup", c->name, "-", N, "cannot build the problem");
+        goto cleanup;
+    }
+    
+    int k = CHECK_MODES;
+    double reference[CHECK_MODES];
+    const char* reference_name = "analytic";
+    if (c->spectrum) {
+        c->spectrum(N, k, reference);
+    } else {
+        MembraneSolveRequest request;
+        membrane_request_init(&request, N, k);
+        request.solver = SOLVER_DENSE;
+        request.symmetry = 0;
+        quiet_begin();
+        const EigenResults* results = membrane_solve(context, params, &request);
+        quiet_end();
+        if (!results) {
+            report(0, "reference", c->name, "dense", N, "dense solve failed");
+            goto cleanup;
+        }
+        memcpy(reference, results->eigenvalues, k * sizeof(double));
+        reference_name = "dense";
+    }
+    
+    // Chaque solveur sur le problème complet puis, si la grille en a, par classes de symétrie
+    int runs = detect_mesh_symmetries(mesh, SYMMETRY_TOLERANCE) ? 2 * SOLVER_N_TYPES
+                                                                 : SOLVER_N_TYPES;
+    for (int run = 0; run < runs; run++) {
+        SolverType solver = (SolverType)(run % SOLVER_N_TYPES);
+        int symmetry = run / SOLVER_N_TYPES;
+        char label[32];
+        snprintf(label, sizeof(label), "%s%s", solver_type_name(solver), symmetry ? "/sym" : "");
+        MembraneSolveRequest request;
+        membrane_request_init(&request, N, k);
+        request.solver = solver;
+        request.eps = CHECK_ITERATIVE_EPS;
+        request.symmetry = symmetry;
+        quiet_begin();
+        const EigenResults* results = membrane_solve(context, params, &request);
+        quiet_end();
+    
+        char detail[160];
+        if (!results || results->n_eigenvalues < k) {
+            report(0, "eigenvalues", c->name, label, N, "solve failed");
+            continue;
+        }
+        double error = 0.0;
+        for (int i = 0; i < k; i++) {
+            double e = fabs(results->eigenvalues[i] - reference[i]) / fabs(reference[i]);
+            if (e > error) error = e;
+        }
+        snprintf(detail, sizeof(detail), "max rel. error %.2e vs %s (tol %.0e)", error,
+                 reference_name, eigenvalue_tolerance(solver));
+        report(error <= eigenvalue_tolerance(solver), "eigenvalues", c->name, label, N, detail);
+    
+        double residual, orthogonality;
+        mode_quality(A, B, results, &residual, &orthogonality);
+        snprintf(detail, sizeof(detail), "residual %.2e (tol %.0e), B-cosine %.2e (tol 1e-8)",
+                 residual, residual_tolerance(solver), orthogonality);
+        report(residual <= residual_tolerance(solver) && orthogonality <= 1e-8, "modes", c->name,
+               label, N, detail);
+    }
+
+cleanup:
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    free_mesh(mesh);
+    free_membrane_params(params);
+}
+
+#define CHECK_CONTEXT_CALLS 4
+
+// Classes de symétrie dans l'arène du contexte: mêmes valeurs d'un appel à l'autre, et plus
+// aucun segment créé une fois l'arène ajustée au pic (après le deuxième appel)
+static void check_context_reuse(const CheckCase* c, int N) {
+    MembraneParams* params = case_params(c);
+    for (int s = 0; s < SOLVER_N_TYPES && params; s++) {
+        SolverType solver = (SolverType)s;
+        MembraneContext* context = membrane_context_create(0);
+        MembraneSolveRequest request;
+        membrane_request_init(&request, N, CHECK_MODES);
+        request.solver = solver;
+        request.eps = CHECK_ITERATIVE_EPS;
+    
+        double first[CHECK_MODES];
+        long settled = 0, segments = 0;
+        int same = 1;
+        int call = 0;
+        for (; call < CHECK_CONTEXT_CALLS && context; call++) {
+            quiet_begin();
+            const EigenResults* results = membrane_solve(context, params, &request);
+            quiet_end();
+            if (!results || results->n_eigenvalues < CHECK_MODES) break;
+            if (call == 0) memcpy(first, results->eigenvalues, sizeof(first));
+            same = same && memcmp(first, results->eigenvalues, sizeof(first)) == 0;
+            MembraneContextStats stats;
+            membrane_context_stats(context, &stats);
+            if (call == 1) settled = stats.segments;
+            segments = stats.segments;
+        }
+    
+        char detail[160];
+        snprintf(detail, sizeof(detail), "%d calls, identical values: %s, new segments after "
+                 "the second: %ld", call, same ? "yes" : "no", segments - settled);
+        report(call == CHECK_CONTEXT_CALLS && same && segments == settled, "context", c->name,
+               solver_type_name(solver), N, detail);
+        membrane_context_destroy(context);
+    }
+    free_membrane_params(params);
+}
+
+// ============ BUDGETS DE PERFORMANCE ============
+
+static Budget measured[CHECK_MAX_BUDGETS];
+static int n_measured = 0;
+
+static int load_budgets(const char* filename, Budget* budgets, int max_budgets) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Warning: No baseline file %s, budgets not enforced\n", filename);
+        return 0;
+    }
+    char line[256];
+    int n = 0;
+    while (fgets(line, sizeof(line), file) && n < max_budgets) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        Budget* b = &budgets[n];
+        if (sscanf(line, "%15s %15s %d %d %lf %lf", b->kernel, b->solver, &b->N, &b->k,
+                   &b->seconds, &b->megabytes) == 6) {
+            n++;
+        }
+    }
+    fclose(file);
+    return n;
+}
+
+static int write_budgets(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot write baseline %s\n", filename);
+        return -1;
+    }
+    fprintf(file, "# Budgets de référence de make check (régénérer avec make check-baseline)\n");
+    fprintf(file, "# kernel     solver            N    k      seconds         MB\n");
+    for (int i = 0; i < n_measured; i++) {
+        const Budget* b = &measured[i];
+        fprintf(file, "%-12s %-14s %4d %4d %12.6f %10.3f\n", b->kernel, b->solver, b->N, b->k,
+                b->seconds, b->megabytes);
+    }
+    fclose(file);
+    printf("Baseline written to %s\n", filename);
+    return 0;
+}
+
+static const Budget* find_budget(const Budget* budgets, int n, const Budget* m) {
+    for (int i = 0; i < n; i++) {
+        if (strcmp(budgets[i].kernel, m->kernel) == 0 && strcmp(budgets[i].solver, m->solver) == 0 &&
+            budgets[i].N == m->N && budgets[i].k == m->k) {
+            return &budgets[i];
+        }
+    }
+    return NULL;
+}
+
+static void check_budget(const Budget* m, const Budget* budgets, int n_budgets,
+                         const CheckOptions* opts) {
+    if (n_measured < CHECK_MAX_BUDGETS) measured[n_measured++] = *m;
+    
+    char detail[160];
+    const Budget* b = find_budget(budgets, n_budgets, m);
+    if (!b) {
+        printf("[SKIP] %-11s %-10s %-14s N=%-3d %.4f s, %.2f MB (no baseline)\n", "budget",
+               m->kernel, m->solver, m->N, m->seconds, m->megabytes);
+        return;
+    }
+    int time_ok = m->seconds <= opts->time_factor * b->seconds;
+    int memory_ok = m->megabytes <= opts->memory_factor * b->megabytes + 1e-3;
+    snprintf(detail, sizeof(detail), "%.4f s (budget %.4f), %.2f MB (budget %.2f)", m->seconds,
+             opts->time_factor * b->seconds, m->megabytes, opts->memory_factor * b->megabytes);
+    report(time_ok && memory_ok, "budget", m->kernel, m->solver, m->N, detail);
+}
+
+static void performance_checks(const CheckOptions* opts) {
+    Budget budgets[CHECK_MAX_BUDGETS];
+    int n_budgets = opts->baseline ? load_budgets(opts->baseline, budgets, CHECK_MAX_BUDGETS) : 0;
+    
+    // Assemblage: meilleur temps, mémoire des deux matrices CSR
+    MembraneParams* params = create_default_params();
+    int N = 500;
+    Mesh* mesh = create_mesh(N, params);
+    Budget m = {"assembly", "-", N, 0, INFINITY, 0.0};
+    for (int t = 0; t < CHECK_TRIALS && mesh; t++) {
+        double start = profiler_now();
+        SparseMatrixCSR* A = build_stiffness_matrix(mesh);
+        SparseMatrixCSR* B = build_mass_matrix(mesh);
+        double seconds = profiler_now() - start;
+        if (seconds < m.seconds) m.seconds = seconds;
+        if (A && B) {
+            size_t bytes = ((size_t)A->nnz + B->nnz) * (sizeof(double) + sizeof(MKL_INT)) +
+                           ((size_t)A->n_rows + B->n_rows + 2) * sizeof(MKL_INT);
+            m.megabytes = bytes / 1048576.0;
+        }
+        free_sparse_matrix(A);
+        free_sparse_matrix(B);
+    }
+    check_budget(&m, budgets, n_budgets, opts);
+    free_mesh(mesh);
+    
+    // Résolutions: meilleur temps, pic de l'arène du contexte (espaces de travail et résultats)
+    for (int s = 0; s < SOLVER_N_TYPES; s++) {
+        SolverType solver = (SolverType)s;
+        int grid = solver == SOLVER_DENSE || solver == SOLVER_DENSE_PARTIAL ? 24 : 48;
+        MembraneContext* context = membrane_context_create(0);
+        MembraneSolveRequest request;
+        membrane_request_init(&request, grid, CHECK_MODES);
+        request.solver = solver;
+    
+        Budget e = {"eigensolve", "", grid, CHECK_MODES, INFINITY, 0.0};
+        snprintf(e.solver, sizeof(e.solver), "%s", solver_type_name(solver));
+        int status = 0;
+        for (int t = 0; t < CHECK_TRIALS && status == 0; t++) {
+            quiet_begin();
+            double start = profiler_now();
+            status = membrane_solve(context, params, &request) ? 0 : -1;
+            double seconds = profiler_now() - start;
+            quiet_end();
+            if (seconds < e.seconds) e.seconds = seconds;
+        }
+        MembraneContextStats stats;
+        membrane_context_stats(context, &stats);
+        e.megabytes = stats.peak / 1048576.0;
+        membrane_context_destroy(context);
+    
+        if (status != 0) report(0, "budget", "eigensolve", e.solver, grid, "solve failed");
+        else check_budget(&e, budgets, n_budgets, opts);
+    }
+    free_membrane_params(params);
+    
+    if (opts->write_baseline) write_budgets(opts->write_baseline);
+}
+
+// ============ SENSIBILITES ============
+
+#define CHECK_FD_MODES 4
+#define CHECK_FD_TOLERANCE 1e-6    // Erreur relative des différences centrées tolérée
+
+// Spectre dense de la grille telle qu'échantillonnée (p, w, q modifiables en place)
+static int dense_spectrum(Mesh* mesh, int k, double* values) {
+    SparseMatrixCSR* A = build_stiffness_matrix(mesh);
+    SparseMatrixCSR* B = build_mass_matrix(mesh);
+    SolverConfig* config = create_solver_config(k);
+    EigenResults* results = NULL;
+    if (A && B && config) {
+        config->solver = SOLVER_DENSE;
+        quiet_begin();
+        results = solve_eigenproblem(A, B, config);
+        quiet_end();
+    }
+    int status = results && results->n_eigenvalues >= k ? 0 : -1;
+    if (status == 0) memcpy(values, results->eigenvalues, k * sizeof(double));
+    free_eigen_results(results);
+    free_solver_config(config);
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    return status;
+}
+
+// Dérivée centrée de λ par rapport à une valeur nodale de p, w ou q
+static int nodal_difference(Mesh* mesh, double* field, int idx, double step, double* fd) {
+    double saved = field[idx];
+    double plus[CHECK_FD_MODES], minus[CHECK_FD_MODES];
+    field[idx] = saved + step;
+    int status = dense_spectrum(mesh, CHECK_FD_MODES, plus);
+    field[idx] = saved - step;
+    if (status == 0) status = dense_spectrum(mesh, CHECK_FD_MODES, minus);
+    field[idx] = saved;
+    for (int v = 0; status == 0 && v < CHECK_FD_MODES; v++) fd[v] = (plus[v] - minus[v]) / (2.0 * step);
+    return status;
+}
+
+// Dérivée centrée par rapport à un paramètre de l'obstacle (maillage rééchantillonné)
+static int obstacle_difference(MembraneParams* params, int N, double* parameter, double step,
+                               double* fd) {
+    double saved = *parameter;
+    double plus[CHECK_FD_MODES], minus[CHECK_FD_MODES];
+    int status = -1;
+    *parameter = saved + step;
+    Mesh* mesh = create_mesh(N, params);
+    if (mesh) status = dense_spectrum(mesh, CHECK_FD_MODES, plus);
+    free_mesh(mesh);
+    *parameter = saved - step;
+    mesh = status == 0 ? create_mesh(N, params) : NULL;
+    status = mesh ? dense_spectrum(mesh, CHECK_FD_MODES, minus) : -1;
+    free_mesh(mesh);
+    *parameter = saved;
+    for (int v = 0; status == 0 && v < CHECK_FD_MODES; v++) fd[v] = (plus[v] - minus[v]) / (2.0 * step);
+    return status;
+}
+
+static void report_gradient(const char* name, const char* quantity, int N, const double* fd,
+                            const double* exact, int count) {
+    double error = 0.0, scale = 0.0;
+    for (int i = 0; i < count; i++) {
+        if (fabs(fd[i] - exact[i]) > error) error = fabs(fd[i] - exact[i]);
+        if (fabs(exact[i]) > scale) scale = fabs(exact[i]);
+    }
+    error = scale > 0.0 ? error / scale : error;
+    char detail[160];
+    snprintf(detail, sizeof(detail), "max rel. error %.2e vs finite differences (tol %.0e)", error,
+             CHECK_FD_TOLERANCE);
+    report(error <= CHECK_FD_TOLERANCE, "gradient", name, quantity, N, detail);
+}
+
+// Dérivées analytiques de compute_eigen_sensitivities contre des différences centrées de
+// résolutions denses: p, w, q en un point intérieur et un point du bord, obstacle décentré
+static void check_sensitivities(void) {
+    const int N = 12;
+    const int nodes[2] = {(N / 2) * N + N / 3, N / 2};   // Intérieur, bord y = h
+    MembraneParams* params = create_default_params();
+    if (params) {
+        params->obstacle_center_x = 0.4;
+        params->obstacle_center_y = 0.6;
+    }
+    Mesh* mesh = params ? create_mesh(N, params) : NULL;
+    SparseMatrixCSR* A = mesh ? build_stiffness_matrix(mesh) : NULL;
+    SparseMatrixCSR* B = mesh ? build_mass_matrix(mesh) : NULL;
+    SolverConfig* config = create_solver_config(CHECK_FD_MODES);
+    EigenResults* results = NULL;
+    EigenSensitivities* sens = NULL;
+    if (A && B && config) {
+        config->solver = SOLVER_DENSE;
+        quiet_begin();
+        results = solve_eigenproblem(A, B, config);
+        quiet_end();
+    }
+    if (results) sens = compute_eigen_sensitivities(mesh, params, results);
+    if (!sens || !sens->has_obstacle) {
+        report(0, "setup", "sensitive", "-", N, "cannot compute the sensitivities");
+        goto cleanup;
+    }
+    
+    // Nodales: 2 points x CHECK_FD_MODES modes par coefficient
+    struct {
+        const char* name;
+        double* field;
+        const double* exact;
+    } nodal[3] = {{"dp", mesh->p_vals, sens->dp}, {"dw", mesh->w_vals, sens->dw},
+                  {"dq", mesh->q_vals, sens->dq}};
+    for (int c = 0; c < 3; c++) {
+        double fd[2 * CHECK_FD_MODES], exact[2 * CHECK_FD_MODES];
+        int status = 0;
+        for (int p = 0; status == 0 && p < 2; p++) {
+            int idx = nodes[p];
+            double step = 1e-3 * fmax(1.0, fabs(nodal[c].field[idx]));
+            status = nodal_difference(mesh, nodal[c].field, idx, step, fd + p * CHECK_FD_MODES);
+            for (int v = 0; v < CHECK_FD_MODES; v++) {
+                exact[p * CHECK_FD_MODES + v] = nodal[c].exact[(size_t)v * mesh->total_points + idx];
+            }
+        }
+        if (status != 0) {
+            report(0, "gradient", "sensitive", nodal[c].name, N, "dense solve failed");
+            continue;
+        }
+        report_gradient("sensitive", nodal[c].name, N, fd, exact, 2 * CHECK_FD_MODES);
+    }
+    
+    // Obstacle: centre x, centre y, intensité, largeur (ordre de sens->obstacle)
+    const char* names[SENSITIVITY_N_OBSTACLE] = {"center-x", "center-y", "strength", "width"};
+    double* parameters[SENSITIVITY_N_OBSTACLE] = {
+        &params->obstacle_center_x, &params->obstacle_center_y, &params->obstacle_strength,
+        &params->obstacle_width};
+    for (int t = 0; t < SENSITIVITY_N_OBSTACLE; t++) {
+        double fd[CHECK_FD_MODES], exact[CHECK_FD_MODES];
+        double step = 1e-5 * fmax(1.0, fabs(*parameters[t]));
+        if (obstacle_difference(params, N, parameters[t], step, fd) != 0) {
+            report(0, "gradient", "sensitive", names[t], N, "dense solve failed");
+            continue;
+        }
+        for (int v = 0; v < CHECK_FD_MODES; v++) {
+            exact[v] = sens->obstacle[v * SENSITIVITY_N_OBSTACLE + t];
+        }
+        report_gradient("sensitive", names[t], N, fd, exact, CHECK_FD_MODES);
+    }
+
+cleanup:
+    free_eigen_sensitivities(sens);
+    free_eigen_results(results);
+    free_solver_config(config);
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    free_mesh(mesh);
+    free_membrane_params(params);
+}
+
+// Obstacle centré sur p = w = 1 (D4): les modes 2 et 3 forment une paire. Leurs gradients
+// doivent être ceux de la moyenne de la paire (moyenne des différences centrées)
+static void check_cluster_sensitivities(void) {
+    const int N = 12;
+    MembraneParams* params = create_default_params();
+    if (params && (set_coefficient_expression(params, 'p', "1") != 0 ||
+                   set_coefficient_expression(params, 'w', "1") != 0)) {
+        free_membrane_params(params);
+        params = NULL;
+    }
+    Mesh* mesh = params ? create_mesh(N, params) : NULL;
+    SparseMatrixCSR* A = mesh ? build_stiffness_matrix(mesh) : NULL;
+    SparseMatrixCSR* B = mesh ? build_mass_matrix(mesh) : NULL;
+    SolverConfig* config = create_solver_config(CHECK_FD_MODES);
+    EigenResults* results = NULL;
+    EigenSensitivities* sens = NULL;
+    if (A && B && config) {
+        config->solver = SOLVER_DENSE;
+        quiet_begin();
+        results = solve_eigenproblem(A, B, config);
+        quiet_end();
+    }
+    if (results) sens = compute_eigen_sensitivities(mesh, params, results);
+    if (!sens || !sens->has_obstacle) {
+        report(0, "setup", "cluster", "-", N, "cannot compute the sensitivities");
+        goto cleanup;
+    }
+    
+    char detail[160];
+    snprintf(detail, sizeof(detail), "groups %d %d %d %d, %d clustered modes (expected 0 1 1 3, "
+             "2)", sens->cluster[0], sens->cluster[1], sens->cluster[2], sens->cluster[3],
+             sens->n_clustered);
+    report(sens->cluster[0] == 0 && sens->cluster[1] == 1 && sens->cluster[2] == 1 &&
+           sens->cluster[3] == 3 && sens->n_clustered == 2, "clusters", "cluster", "-", N, detail);
+    
+    // Point hors des axes de symétrie (la paire s'y sépare), intensité et largeur (la paire
+    // reste double); le gradient du centre est nul par symétrie
+    int node = (N / 3) * N + N / 4;
+    const char* names[4] = {"dp", "dq", "strength", "width"};
+    double* fields[2] = {mesh->p_vals, mesh->q_vals};
+    const double* nodal[2] = {sens->dp, sens->dq};
+    double* parameters[2] = {&params->obstacle_strength, &params->obstacle_width};
+    for (int t = 0; t < 4; t++) {
+        double fd[CHECK_FD_MODES], mean[CHECK_FD_MODES], exact[CHECK_FD_MODES];
+        int status;
+        if (t < 2) {
+            double step = 1e-3 * fmax(1.0, fabs(fields[t][node]));
+            status = nodal_difference(mesh, fields[t], node, step, fd);
+        } else {
+            double step = 1e-5 * fmax(1.0, fabs(*parameters[t - 2]));
+            status = obstacle_difference(params, N, parameters[t - 2], step, fd);
+        }
+        if (status != 0) {
+            report(0, "gradient", "cluster", names[t], N, "dense solve failed");
+            continue;
+        }
+        // Moyenne par groupe: les valeurs de la paire se séparent, pas leur moyenne
+        for (int v = 0; v < CHECK_FD_MODES; v++) {
+            double sum = 0.0;
+            int size = 0;
+            for (int u = 0; u < CHECK_FD_MODES; u++) {
+                if (sens->cluster[u] == sens->cluster[v]) {
+                    sum += fd[u];
+                    size++;
+                }
+            }
+            mean[v] = sum / size;
+            exact[v] = t < 2 ? nodal[t][(size_t)v * mesh->total_points + node]
+                             : sens->obstacle[v * SENSITIVITY_N_OBSTACLE + t];
+        }
+        report_gradient("cluster", names[t], N, mean, exact, CHECK_FD_MODES);
+    }
+
+cleanup:
+    free_eigen_sensitivities(sens);
+    free_eigen_results(results);
+    free_solver_config(config);
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    free_mesh(mesh);
+    free_membrane_params(params);
+}
+
+// ============ DYNAMIQUE ============
+
+#define CHECK_DYNAMICS_N 16
+#define CHECK_DYNAMICS_MODE 1       // Mode excité seul (le deuxième)
+
+// Grille par défaut et ses modes (solveur dense), partagés par les vérifications dynamiques
+typedef struct {
+    MembraneParams* params;
+    Mesh* mesh;
+    SparseMatrixCSR* A;
+    SparseMatrixCSR* B;
+    EigenResults* results;
+} DynamicsFixture;
+
+static int dynamics_setup(DynamicsFixture* f) {
+    memset(f, 0, sizeof(*f));
+    f->params = create_default_params();
+    f->mesh = f->params ? create_mesh(CHECK_DYNAMICS_N, f->params) : NULL;
+    f->A = f->mesh ? build_stiffness_matrix(f->mesh) : NULL;
+    f->B = f->mesh ? build_mass_matrix(f->mesh) : NULL;
+    SolverConfig* config = create_solver_config(CHECK_MODES);
+    if (f->A && f->B && config) {
+        config->solver = SOLVER_DENSE;
+        quiet_begin();
+        f->results = solve_eigenproblem(f->A, f->B, config);
+        quiet_end();
+    }
+    free_solver_config(config);
+    return f->results ? 0 : -1;
+}
+
+static void dynamics_cleanup(DynamicsFixture* f) {
+    free_eigen_results(f->results);
+    free_sparse_matrix(f->A);
+    free_sparse_matrix(f->B);
+    free_mesh(f->mesh);
+    free_membrane_params(f->params);
+}
+
+// u(0) = a φ et charge échelon f = B φ: seule la coordonnée du mode φ est excitée,
+// η'' + 2ζωη' + ω²η = 1, η(0) = a, η'(0) = 0 (force modale φᵀBφ / m = 1)
+typedef struct {
+    const double* phi;
+    int n;
+    double omega;
+    double damping;
+    double initial;
+    double dt;
+    double error;               // max |u - η φ|
+    double scale;               // max |η φ|
+    long received;              // Snapshots reçus
+} SingleModeCheck;
+
+static double single_mode_coordinate(const SingleModeCheck* c, double t) {
+    double omega_d = c->omega * sqrt(1.0 - c->damping * c->damping);
+    double static_value = 1.0 / (c->omega * c->omega);
+    return static_value + (c->initial - static_value) * exp(-c->damping * c->omega * t) *
+                          (cos(omega_d * t) + c->damping * c->omega / omega_d * sin(omega_d * t));
+}
+
+static int single_mode_sink(long first_step, int count, const double* U, void* data) {
+    SingleModeCheck* c = (SingleModeCheck*)data;
+    c->received += count;
+    for (int s = 0; s < count; s++) {
+        double eta = single_mode_coordinate(c, (first_step + s) * c->dt);
+        const double* u = U + (size_t)s * c->n;
+        for (int idx = 0; idx < c->n; idx++) {
+            double exact = eta * c->phi[idx];
+            if (fabs(u[idx] - exact) > c->error) c->error = fabs(u[idx] - exact);
+            if (fabs(exact) > c->scale) c->scale = fabs(exact);
+        }
+    }
+    return 0;
+}
+
+// Synthèse modale (plusieurs blocs de GEMM) contre la solution fermée de l'oscillateur
+static void check_modal_response(const DynamicsFixture* f) {
+    int n = f->mesh->total_points;
+    const double* phi = f->results->eigenvectors[CHECK_DYNAMICS_MODE];
+    double omega = sqrt(f->results->eigenvalues[CHECK_DYNAMICS_MODE]);
+    double* initial = (double*)malloc((size_t)n * sizeof(double));
+    double* load = (double*)malloc((size_t)n * sizeof(double));
+    if (!initial || !load) {
+        report(0, "setup", "response", "-", CHECK_DYNAMICS_N, "out of memory");
+        free(initial);
+        free(load);
+        return;
+    }
+    SingleModeCheck c = {phi, n, omega, 0.02, 2.0 / (omega * omega), 2.0 * PI / omega / 50.0,
+                         0.0, 0.0, 0};
+    for (int idx = 0; idx < n; idx++) {
+        initial[idx] = c.initial * phi[idx];
+        load[idx] = f->mesh->w_vals[idx] * phi[idx];
+    }
+    
+    ResponseProblem problem = {0};
+    problem.initial_displacement = initial;
+    problem.load = load;
+    problem.damping = c.damping;
+    problem.dt = c.dt;
+    problem.n_steps = 200;      // 4 périodes
+    problem.chunk = 32;
+    LinearOperator mass = csr_operator(f->B);
+    ResponseStats stats;
+    quiet_begin();
+    int status = modal_response(f->results, &mass, &problem, single_mode_sink, &c, &stats);
+    quiet_end();
+    
+    char detail[160];
+    if (status != 0 || c.received != problem.n_steps) {
+        report(0, "dynamics", "response", "modal", CHECK_DYNAMICS_N, "synthesis failed");
+    } else {
+        double error = c.scale > 0.0 ? c.error / c.scale : c.error;
+        snprintf(detail, sizeof(detail), "max rel. error %.2e vs single-mode solution (tol 1e-9)",
+                 error);
+        report(error <= 1e-9, "dynamics", "response", "modal", CHECK_DYNAMICS_N, detail);
+    }
+    free(initial);
+    free(load);
+}
+
+// Echantillons du saute-mouton sur tous les points, rangés par pas
+typedef struct {
+    double* samples;
+    long n_samples;
+    int n;
+} WaveRecording;
+
+static int record_wave(long first_sample, int count, double* samples, void* data) {
+    WaveRecording* r = (WaveRecording*)data;
+    if (first_sample + count <= r->n_samples) {
+        memcpy(r->samples + (size_t)first_sample * r->n, samples,
+               (size_t)count * r->n * sizeof(double));
+    }
+    free(samples);
+    return 0;
+}
+
+// Depuis u(0) = φ, u̇(0) = 0: le saute-mouton donne exactement φ cos(ω_h t), cos(ω_h dt) =
+// 1 - ω²dt²/2, donc φ cos(ωt) à |ω_h - ω| t près; un pas au-delà de la limite est refusé
+static void check_wave(const DynamicsFixture* f) {
+    int n = f->mesh->total_points;
+    const double* phi = f->results->eigenvectors[CHECK_DYNAMICS_MODE];
+    double omega = sqrt(f->results->eigenvalues[CHECK_DYNAMICS_MODE]);
+    int* sensors = (int*)malloc((size_t)n * sizeof(int));
+    WaveRecording recording = {NULL, 0, n};
+    WaveProblem problem;
+    memset(&problem, 0, sizeof(problem));
+    problem.initial_displacement = phi;
+    problem.t_end = 2.0 * 2.0 * PI / omega;   // 2 périodes
+    problem.cfl = 0.1;                         // Erreur de phase en (ω dt)²: ~1e-4
+    problem.sensors = sensors;
+    problem.n_sensors = n;
+    for (int idx = 0; sensors && idx < n; idx++) sensors[idx] = idx;
+    WaveStats plan;
+    if (sensors && wave_plan(f->mesh, &problem, &plan) == 0) {
+        recording.n_samples = plan.n_samples;
+        recording.samples = (double*)malloc((size_t)plan.n_samples * n * sizeof(double));
+    }
+    WaveStats stats;
+    int status = -1;
+    if (recording.samples) {
+        quiet_begin();
+        status = wave_solve(f->mesh, &problem, record_wave, &recording, &stats);
+        quiet_end();
+    }
+    
+    char detail[160];
+    if (status != 0) {
+        report(0, "dynamics", "wave", "leapfrog", CHECK_DYNAMICS_N, "integration failed");
+    } else {
+        double omega_h = acos(1.0 - 0.5 * omega * omega * stats.dt * stats.dt) / stats.dt;
+        double scale = 0.0, discrete = 0.0, continuous = 0.0;
+        for (int idx = 0; idx < n; idx++) scale = fmax(scale, fabs(phi[idx]));
+        for (long t = 0; t < recording.n_samples; t++) {
+            double time = t * stats.dt;
+            for (int idx = 0; idx < n; idx++) {
+                double u = recording.samples[(size_t)t * n + idx];
+                discrete = fmax(discrete, fabs(u - phi[idx] * cos(omega_h * time)));
+                continuous = fmax(continuous, fabs(u - phi[idx] * cos(omega * time)));
+            }
+        }
+        discrete /= scale;
+        continuous /= scale;
+        double phase = 1e-9 + fabs(omega_h - omega) * problem.t_end;
+        snprintf(detail, sizeof(detail), "max rel. error %.2e vs phi cos(w_h t) (tol 1e-9)",
+                 discrete);
+        report(discrete <= 1e-9, "dynamics", "wave", "leapfrog", CHECK_DYNAMICS_N, detail);
+        snprintf(detail, sizeof(detail), "max rel. error %.2e vs phi cos(wt) (tol %.1e: phase)",
+                 continuous, phase);
+        report(continuous <= phase, "dynamics", "wave", "leapfrog", CHECK_DYNAMICS_N, detail);
+    }
+    
+    // Pas imposé juste au-dessus de la limite, puis fraction CFL > 1: refusés
+    WaveProblem unstable = problem;
+    unstable.dt = 1.01 * wave_stable_dt(f->mesh);
+    int saved_stderr = silence(STDERR_FILENO);
+    int rejected = wave_plan(f->mesh, &unstable, &plan) != 0 &&
+                   wave_solve(f->mesh, &unstable, NULL, NULL, &stats) != 0;
+    unstable.dt = 0.0;
+    unstable.cfl = 1.2;
+    rejected = rejected && wave_solve(f->mesh, &unstable, NULL, NULL, &stats) != 0;
+    restore(STDERR_FILENO, saved_stderr);
+    report(rejected, "dynamics", "wave", "cfl", CHECK_DYNAMICS_N,
+           rejected ? "unstable time steps rejected" : "unstable time step accepted");
+    
+    free(sensors);
+    free(recording.samples);
+}
+
+// Somme modale avec flexibilité résiduelle contre la résolution directe (hystérétique), à
+// mi-chemin de la première résonance. Un mode tronqué i y contribue 1/λ_i (statique, corrigé
+// par le terme résiduel) + O(ω²/λ_i²): l'erreur de la somme tronquée doit baisser d'au moins
+// ω²/λ_k
+static double frf_deviation(const double* modal, const double* direct, int n_pairs) {
+    double diff = 0.0, norm = 0.0;
+    for (int pair = 0; pair < n_pairs; pair++) {
+        diff = fmax(diff, hypot(modal[2 * pair] - direct[2 * pair],
+                                modal[2 * pair + 1] - direct[2 * pair + 1]));
+        norm = fmax(norm, hypot(direct[2 * pair], direct[2 * pair + 1]));
+    }
+    return norm > 0.0 ? diff / norm : diff;
+}
+
+static void check_frf(const DynamicsFixture* f) {
+    const int N = CHECK_DYNAMICS_N;
+    int sensors[3] = {(N / 2) * N + N / 2, (N / 4) * N + 3 * N / 4, N + 1};
+    int actuators[2] = {(N / 3) * N + N / 3, (N / 2) * N + N / 4};
+    double omega = 0.5 * sqrt(f->results->eigenvalues[0]);
+    FrfProblem problem = {sensors, 3, actuators, 2, &omega, 1, 0.02, FRF_HYSTERETIC,
+                          1.0 / (f->mesh->h * f->mesh->h), f->A, 0};
+    double residual[12], truncated[12], direct[12];
+    LinearOperator mass = csr_operator(f->B);
+    quiet_begin();
+    int status = frf_modal(f->results, &mass, &problem, residual);
+    problem.A = NULL;
+    if (status == 0) status = frf_modal(f->results, &mass, &problem, truncated);
+    if (status == 0) status = frf_direct(f->A, f->B, &problem, omega, direct);
+    quiet_end();
+    
+    char detail[160];
+    if (status != 0) {
+        report(0, "dynamics", "frf", "residual", N, "FRF evaluation failed");
+        return;
+    }
+    double error = frf_deviation(residual, direct, 6);
+    double plain = frf_deviation(truncated, direct, 6);
+    double tolerance = omega * omega / f->results->eigenvalues[CHECK_MODES - 1] * plain;
+    snprintf(detail, sizeof(detail), "rel. error %.2e vs direct at w1/2 (tol %.1e, %.2e without)",
+             error, tolerance, plain);
+    report(error <= tolerance, "dynamics", "frf", "residual", N, detail);
+    
+    // Spectre complet: la somme modale est la solution directe, aux arrondis près
+    SolverConfig* config = create_solver_config(f->mesh->total_points);
+    EigenResults* all = NULL;
+    if (config) {
+        config->solver = SOLVER_DENSE;
+        quiet_begin();
+        all = solve_eigenproblem(f->A, f->B, config);
+        quiet_end();
+    }
+    problem.A = f->A;
+    quiet_begin();
+    status = all ? frf_modal(all, &mass, &problem, residual) : -1;
+    quiet_end();
+    if (status != 0) {
+        report(0, "dynamics", "frf", "complete", N, "FRF evaluation failed");
+    } else {
+        error = frf_deviation(residual, direct, 6);
+        snprintf(detail, sizeof(detail), "rel. error %.2e vs direct with all %d modes (tol 1e-9)",
+                 error, f->mesh->total_points);
+        report(error <= 1e-9, "dynamics", "frf", "complete", N, detail);
+    }
+    
+    // Budget d'un octet: le facteur bande est refusé, gradient conjugué à la place
+    double iterative[12];
+    problem.memory_budget = 1;
+    quiet_begin();
+    status = all ? frf_modal(all, &mass, &problem, iterative) : -1;
+    quiet_end();
+    if (status != 0) {
+        report(0, "dynamics", "frf", "iterative", N, "FRF evaluation failed");
+    } else {
+        error = frf_deviation(iterative, residual, 6);
+        snprintf(detail, sizeof(detail), "rel. error %.2e vs banded Cholesky (tol 1e-9)", error);
+        report(error <= 1e-9, "dynamics", "frf", "iterative", N, detail);
+    }
+    free_eigen_results(all);
+    free_solver_config(config);
+}
+
+// ============ FORMATS DE FICHIERS ============
+
+// Fichier .csrb réécrit puis un champ corrompu (en-tête: n_rows à 16, nnz à 32, offsets des
+// sections à 40 et 48); le chargement doit le refuser au lieu de lire hors des sections
+typedef enum {
+    CSRB_INTACT,
+    CSRB_TRUNCATED,
+    CSRB_HUGE_ROWS,
+    CSRB_OVERFLOW_NNZ,
+    CSRB_DECREASING_ROWS,
+    CSRB_BAD_COLUMN,
+    CSRB_ASYMMETRIC,
+    CSRB_N_CORRUPTIONS
+} CsrbCorruption;
+
+static const char* csrb_corruption_name(CsrbCorruption corruption) {
+    static const char* names[] = {"intact", "truncated", "huge-rows", "overflow-nnz",
+                                  "unsorted-rows", "bad-column", "asymmetric"};
+    return names[corruption];
+}
+
+static int corrupt_csrb(const char* path, CsrbCorruption corruption, const SparseMatrixCSR* A) {
+    int fd = open(path, O_RDWR);
+    if (fd < 0) return -1;
+    uint64_t offsets[3];
+    int status = pread(fd, offsets, sizeof(offsets), 40) == (ssize_t)sizeof(offsets) ? 0 : -1;
+    uint64_t huge;
+    MKL_INT index;
+    struct stat st;
+    switch (corruption) {
+        case CSRB_TRUNCATED:
+            if (status == 0 && fstat(fd, &st) == 0) status = ftruncate(fd, st.st_size / 2);
+            break;
+        case CSRB_HUGE_ROWS:
+            huge = (uint64_t)1 << 62;
+            if (status == 0) status = pwrite(fd, &huge, sizeof(huge), 16) == sizeof(huge) ? 0 : -1;
+            break;
+        case CSRB_OVERFLOW_NNZ:
+            huge = UINT64_MAX / 4 + 1;  // nnz · 8 dépasse uint64
+            if (status == 0) status = pwrite(fd, &huge, sizeof(huge), 32) == sizeof(huge) ? 0 : -1;
+            break;
+        case CSRB_DECREASING_ROWS:
+            index = A->nnz;             // row_index[1] > row_index[2]
+            if (status == 0) {
+                status = pwrite(fd, &index, sizeof(index), (off_t)(offsets[0] + sizeof(index))) ==
+                         sizeof(index) ? 0 : -1;
+            }
+            break;
+        case CSRB_BAD_COLUMN:
+            index = A->n_cols;
+            if (status == 0) {
+                status = pwrite(fd, &index, sizeof(index), (off_t)offsets[1]) == sizeof(index) ? 0 : -1;
+            }
+            break;
+        case CSRB_ASYMMETRIC:
+            // Premier élément de la ligne 0: hors diagonale dans la matrice de rigidité
+            if (status == 0) {
+                double value = 1.0;
+                status = pwrite(fd, &value, sizeof(value), (off_t)offsets[2]) == sizeof(value) ? 0 : -1;
+            }
+            break;
+        default:
+            break;
+    }
+    if (close(fd) != 0) status = -1;
+    return status;
+}
+
+static void check_csr_binary(void) {
+    const int N = 8;
+    MembraneParams* params = create_default_params();
+    Mesh* mesh = params ? create_mesh(N, params) : NULL;
+    SparseMatrixCSR* A = mesh ? build_stiffness_matrix(mesh) : NULL;
+    char path[] = "/tmp/membrane_check_XXXXXX";
+    int fd = A ? mkstemp(path) : -1;
+    if (fd < 0) {
+        report(0, "setup", "csrb", "-", N, "cannot build the matrix");
+        goto cleanup;
+    }
+    close(fd);
+    
+    for (int c = 0; c < CSRB_N_CORRUPTIONS; c++) {
+        CsrbCorruption corruption = (CsrbCorruption)c;
+        char detail[160];
+        if (save_matrix_csr_binary(A, path) != 0 || corrupt_csrb(path, corruption, A) != 0) {
+            report(0, "format", "csrb", csrb_corruption_name(corruption), N, "cannot write the file");
+            continue;
+        }
+        int saved_stderr = silence(STDERR_FILENO);
+        SparseMatrixCSR* loaded = load_matrix_csr_binary(path);
+        restore(STDERR_FILENO, saved_stderr);
+        if (corruption == CSRB_INTACT) {
+            int same = loaded && loaded->nnz == A->nnz &&
+                       memcmp(loaded->row_index, A->row_index, (A->n_rows + 1) * sizeof(MKL_INT)) == 0 &&
+                       memcmp(loaded->columns, A->columns, A->nnz * sizeof(MKL_INT)) == 0 &&
+                       memcmp(loaded->values, A->values, A->nnz * sizeof(double)) == 0;
+            snprintf(detail, sizeof(detail), "round trip %s", same ? "identical" : "differs");
+            report(same, "format", "csrb", csrb_corruption_name(corruption), N, detail);
+        } else {
+            snprintf(detail, sizeof(detail), "corrupted file %s", loaded ? "accepted" : "rejected");
+            report(!loaded, "format", "csrb", csrb_corruption_name(corruption), N, detail);
+        }
+        free_sparse_matrix(loaded);
+    }
+    
+    // Matrix Market "general": un seul triangle changé suffit à être refusé
+    FILE* file = fopen(path, "w");
+    if (file) {
+        fprintf(file, "%%%%MatrixMarket matrix coordinate real general\n2 2 4\n");
+        fprintf(file, "1 1 2.0\n1 2 -1.0\n2 1 -1.5\n2 2 2.0\n");
+        fclose(file);
+    }
+    int saved_stderr = silence(STDERR_FILENO);
+    SparseMatrixCSR* general = file ? load_matrix_market(path) : NULL;
+    restore(STDERR_FILENO, saved_stderr);
+    report(file && !general, "format", "mtx", "asymmetric", 2,
+           general ? "non-symmetric matrix accepted" : "non-symmetric matrix rejected");
+    free_sparse_matrix(general);
+    unlink(path);
+
+cleanup:
+    free_sparse_matrix(A);
+    free_mesh(mesh);
+    free_membrane_params(params);
+}
+
+// Archive .modz: chaque encodage et codec relu mode par mode, erreur ≤ ε max|φ| (float64
+// exact, float32 arrondi à 2⁻²⁴); puis archive tronquée et octet modifié dans un bloc
+typedef struct {
+    ModeEncoding encoding;
+    double error_bound;
+    double bound;               // Erreur relative garantie
+} ArchiveCase;
+
+static double archive_roundtrip(const char* path, int N, const EigenResults* results,
+                                double* worst) {
+    ModeArchive* archive = mode_archive_open(path);
+    double* values = (double*)malloc((size_t)N * N * sizeof(double));
+    double excess = archive && values ? 0.0 : INFINITY;
+    *worst = 0.0;
+    for (int m = 0; archive && values && m < results->n_eigenvalues; m++) {
+        if (mode_archive_read_mode(archive, m, values) != 0) {
+            excess = INFINITY;
+            break;
+        }
+        double error = 0.0, max_abs = 0.0;
+        const double* phi = results->eigenvectors[m];
+        for (int idx = 0; idx < N * N; idx++) {
+            if (fabs(values[idx] - phi[idx]) > error) error = fabs(values[idx] - phi[idx]);
+            if (fabs(phi[idx]) > max_abs) max_abs = fabs(phi[idx]);
+        }
+        if (error / max_abs > *worst) *worst = error / max_abs;
+    }
+    free(values);
+    mode_archive_close(archive);
+    return excess;
+}
+
+// Archive modifiée: 0 si elle est refusée à l'ouverture ou à la lecture d'un mode
+static int archive_rejected(const char* path, int N, int n_modes) {
+    int saved_stderr = silence(STDERR_FILENO);
+    ModeArchive* archive = mode_archive_open(path);
+    double* values = (double*)malloc((size_t)N * N * sizeof(double));
+    int rejected = !archive || !values;
+    for (int m = 0; !rejected && m < n_modes; m++) {
+        rejected = mode_archive_read_mode(archive, m, values) != 0;
+    }
+    free(values);
+    mode_archive_close(archive);
+    restore(STDERR_FILENO, saved_stderr);
+    return rejected;
+}
+
+static void check_mode_archive(void) {
+    const int N = 24;
+    static const ArchiveCase cases[] = {
+        {MODE_FLOAT64, 0.0, 0.0},
+        {MODE_FLOAT32, 0.0, 0x1p-24},
+        {MODE_QUANTIZED, 1e-3, 1e-3},
+        {MODE_QUANTIZED, 1e-6, 1e-6},
+    };
+    MembraneParams* params = create_default_params();
+    Mesh* mesh = params ? create_mesh(N, params) : NULL;
+    SparseMatrixCSR* A = mesh ? build_stiffness_matrix(mesh) : NULL;
+    SparseMatrixCSR* B = mesh ? build_mass_matrix(mesh) : NULL;
+    SolverConfig* config = create_solver_config(CHECK_MODES);
+    EigenResults* results = NULL;
+    if (A && B && config) {
+        config->solver = SOLVER_DENSE_PARTIAL;
+        quiet_begin();
+        results = solve_eigenproblem(A, B, config);
+        quiet_end();
+    }
+    char path[] = "/tmp/membrane_check_XXXXXX";
+    int fd = results ? mkstemp(path) : -1;
+    if (fd < 0) {
+        report(0, "setup", "modz", "-", N, "cannot compute the modes");
+        goto cleanup;
+    }
+    close(fd);
+    
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        for (int compress = 0; compress <= 1; compress++) {
+            ModeArchiveOptions options = {cases[c].encoding, cases[c].error_bound, compress};
+            char name[32], detail[160];
+            snprintf(name, sizeof(name), "%s%s", mode_encoding_name(cases[c].encoding),
+                     compress ? "+lz" : "");
+            double worst = 0.0;
+            quiet_begin();
+            int written = mode_archive_write(path, mesh, results, CHECK_MODES, &options, NULL) == 0;
+            quiet_end();
+            double excess = written ? archive_roundtrip(path, N, results, &worst) : INFINITY;
+            if (excess > 0.0) {
+                report(0, "archive", "modz", name, N, "write or read failed");
+                continue;
+            }
+            snprintf(detail, sizeof(detail), "max error %.2e of max|phi| (bound %.0e)", worst,
+                     cases[c].bound);
+            report(worst <= cases[c].bound, "archive", "modz", name, N, detail);
+        }
+    }
+    
+    // Dernière archive (quantized + LZ): tronquée, puis un octet du dernier bloc modifié
+    struct stat st;
+    int truncated = 0, corrupted = 0;
+    if (stat(path, &st) == 0 && truncate(path, st.st_size - 1) == 0) {
+        truncated = archive_rejected(path, N, CHECK_MODES);
+    }
+    ModeArchiveOptions options = {MODE_QUANTIZED, 1e-6, 1};
+    quiet_begin();
+    int written = mode_archive_write(path, mesh, results, CHECK_MODES, &options, NULL) == 0;
+    quiet_end();
+    fd = written && stat(path, &st) == 0 ? open(path, O_RDWR) : -1;
+    if (fd >= 0) {
+        uint8_t byte;
+        off_t offset = st.st_size - 3;
+        if (pread(fd, &byte, 1, offset) == 1) {
+            byte ^= 0x10;
+            corrupted = pwrite(fd, &byte, 1, offset) == 1;
+        }
+        close(fd);
+        corrupted = corrupted && archive_rejected(path, N, CHECK_MODES);
+    }
+    report(truncated, "archive", "modz", "truncated", N,
+           truncated ? "corrupted file rejected" : "corrupted file accepted");
+    report(corrupted, "archive", "modz", "corrupted", N,
+           corrupted ? "corrupted file rejected" : "corrupted file accepted");
+    unlink(path);
+
+cleanup:
+    free_eigen_results(results);
+    free_solver_config(config);
+    free_sparse_matrix(A);
+    free_sparse_matrix(B);
+    free_mesh(mesh);
+    free_membrane_params(params);
+}
+
+static int cache_has(const char* directory, ProblemKey key) {
+    char path[640];
+    struct stat st;
+    snprintf(path, sizeof(path), "%s/%016llx%016llx.eig", directory,
+             (unsigned long long)key.h[0], (unsigned long long)key.h[1]);
+    return stat(path, &st) == 0;
+}
+
+// Cache: écriture interrompue supprimée à l'ouverture, entrée plus grande que la limite
+// refusée, entrée juste écrite jamais évincée
+static void check_result_cache(void) {
+    const int n = 64, k = 2;
+    char directory[] = "/tmp/membrane_check_XXXXXX";
+    EigenResults* results = create_eigen_results(n, k, NULL);
+    SolverConfig* config = create_solver_config(k);
+    if (!results || !config || !mkdtemp(directory)) {
+        report(0, "setup", "cache", "-", n, "cannot create the cache");
+        free_eigen_results(results);
+        free_solver_config(config);
+        return;
+    }
+    for (int i = 0; i < k; i++) {
+        results->eigenvalues[i] = i + 1.0;
+        results->residuals[i] = 0.0;
+    }
+    memset(results->modes, 0, (size_t)n * k * sizeof(double));
+    
+    // Fichier temporaire d'un processus terminé, et d'un processus vivant (celui-ci)
+    char stale[640], live[640];
+    pid_t child = fork();
+    if (child == 0) _exit(0);
+    if (child > 0) waitpid(child, NULL, 0);
+    snprintf(stale, sizeof(stale), "%s/entry.eig.tmp.%ld", directory, (long)child);
+    snprintf(live, sizeof(live), "%s/entry.eig.tmp.%ld", directory, (long)getpid());
+    FILE* file = fopen(stale, "wb");
+    if (file) fclose(file);
+    file = fopen(live, "wb");
+    if (file) fclose(file);
+    
+    // Une entrée: 48 + (2k + n k) * 8 = 1104 octets; la limite en tient une, pas deux
+    ResultCache cache;
+    ProblemKey first = {{1, 2}}, second = {{3, 4}};
+    quiet_begin();
+    int ready = result_cache_init(&cache, directory, 1500) == 0;
+    struct stat st;
+    int swept = ready && stat(stale, &st) != 0 && stat(live, &st) == 0;
+    int stored = ready && result_cache_store(&cache, first, results, config) == 0;
+    if (stored) {
+        // Première entrée datée du futur: la LRU seule évincerait la nouvelle
+        char path[640];
+        snprintf(path, sizeof(path), "%s/%016llx%016llx.eig", directory, 1ULL, 2ULL);
+        struct timespec times[2] = {{time(NULL) + 3600, 0}, {time(NULL) + 3600, 0}};
+        utimensat(AT_FDCWD, path, times, 0);
+        stored = result_cache_store(&cache, second, results, config) == 0;
+    }
+    int kept = stored && cache_has(directory, second) && !cache_has(directory, first);
+    cache.max_bytes = 1000;
+    ProblemKey large = {{5, 6}};
+    int refused = ready && result_cache_store(&cache, large, results, config) == 0 &&
+                  !cache_has(directory, large) && cache_has(directory, second);
+    quiet_end();
+    
+    report(swept, "cache", "cache", "temporaries", n,
+           swept ? "stale temporary removed, live one kept" : "temporary files mishandled");
+    report(kept, "cache", "cache", "eviction", n,
+           kept ? "other entry evicted, new entry kept" : "wrong entry evicted");
+    report(refused, "cache", "cache", "oversized", n,
+           refused ? "entry above the limit not stored" : "oversized entry stored");
+    
+    DIR* dir = opendir(directory);
+    struct dirent* entry;
+    while (dir && (entry = readdir(dir)) != NULL) {
+        char path[640];
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        if (entry->d_name[0] != '.') unlink(path);
+    }
+    if (dir) closedir(dir);
+    rmdir(directory);
+    if (ready) pthread_mutex_destroy(&cache.lock);
+    free_eigen_results(results);
+    free_solver_config(config);
+}
+
+// ============ PROGRAMME ============
+
+static void print_usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --baseline FILE        Time and memory budgets to enforce\n");
+    printf("  --write-baseline FILE  Write the measured budgets (new reference)\n");
+    printf("  --time-factor F        Allowed slowdown over the baseline (default 2.0)\n");
+    printf("  --memory-factor F      Allowed memory growth over the baseline (default 1.25)\n");
+    printf("  --accuracy-only        Skip the performance budgets\n");
+}
+
+int main(int argc, char* argv[]) {
+    CheckOptions opts = {NULL, NULL, 2.0, 1.25, 0};
+    for (int a = 1; a < argc; a++) {
+        const char* arg = argv[a];
+        if (strcmp(arg, "--accuracy-only") == 0) {
+            opts.skip_performance = 1;
+            continue;
+        }
+        if (strcmp(arg, "--help") == 0 || a + 1 >= argc) {
+            print_usage(argv[0]);
+            return strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+        const char* value = argv[++a];
+        if (strcmp(arg, "--baseline") == 0) opts.baseline = value;
+        else if (strcmp(arg, "--write-baseline") == 0) opts.write_baseline = value;
+        else if (strcmp(arg, "--time-factor") == 0) opts.time_factor = atof(value);
+        else if (strcmp(arg, "--memory-factor") == 0) opts.memory_factor = atof(value);
+        else {
+            fprintf(stderr, "Error: Unknown option %s\n", arg);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    printf("=== Accuracy: every solver against known spectra ===\n");
+    static const int sizes[] = {8, 15, 24};
+    MembraneContext* context = membrane_context_create(0);
+    if (!context) return 1;
+    for (size_t c = 0; c < sizeof(check_cases) / sizeof(check_cases[0]); c++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            check_case(context, &check_cases[c], sizes[s]);
+        }
+    }
+    membrane_context_destroy(context);
+    check_context_reuse(&check_cases[sizeof(check_cases) / sizeof(check_cases[0]) - 1], 24);
+    
+    printf("\n=== Sensitivities: analytic gradients against finite differences ===\n");
+    check_sensitivities();
+    check_cluster_sensitivities();
+    
+    printf("\n=== Dynamics: responses against closed forms ===\n");
+    DynamicsFixture fixture;
+    if (dynamics_setup(&fixture) == 0) {
+        check_modal_response(&fixture);
+        check_wave(&fixture);
+        check_frf(&fixture);
+    } else {
+        report(0, "setup", "dynamics", "dense", CHECK_DYNAMICS_N, "cannot compute the modes");
+    }
+    dynamics_cleanup(&fixture);
+    
+    printf("\n=== File formats: round trips and corrupted files ===\n");
+    check_csr_binary();
+    check_mode_archive();
+    check_result_cache();
+    
+    if (!opts.skip_performance) {
+        printf("\n=== Performance budgets (x%.2f time, x%.2f memory) ===\n", opts.time_factor,
+               opts.memory_factor);
+        performance_checks(&opts);
+    }
+    
+    printf("\n%d checks, %d failed\n", n_checks, n_failures);
+    return n_failures == 0 ? 0 : 1;
+}